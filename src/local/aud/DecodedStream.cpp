@@ -0,0 +1,269 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // remove_if
+#include <atomic>
+#include <chrono> // milliseconds
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "../err/report.hpp" // ReportWarning, std::exception
+#include "../res/type/sound/AudioStream.hpp" // AudioStream::{~AudioStream,Read,Seek}
+#include "../util/container/SpscRing.hpp"
+#include "DecodedStream.hpp"
+
+namespace page { namespace aud
+{
+	/**
+	 * The part of a stream that is shared with the decoder thread, which
+	 * keeps it alive until it notices that the stream has been closed.
+	 */
+	struct DecodedStream::State
+	{
+		State(std::unique_ptr<res::AudioStream> stream, bool loop,
+			unsigned startSample, unsigned blockSize, unsigned blockCount) :
+			stream(std::move(stream)), loop(loop), startSample(startSample),
+			ring(blockCount, Block{std::vector<char>(blockSize)}) {}
+
+		// only accessed by the decoder thread
+		std::unique_ptr<res::AudioStream> stream;
+		bool loop, finished = false;
+		unsigned startSample;
+
+		util::SpscRing<Block> ring;
+		std::atomic<bool> closed{false};
+	};
+
+	namespace
+	{
+		/**
+		 * The thread that decodes every open stream.
+		 */
+		class DecoderThread
+		{
+			public:
+			DecoderThread() :
+				thread(&DecoderThread::Run, this) {}
+
+			~DecoderThread()
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					done = true;
+				}
+				condition.notify_one();
+				thread.join();
+			}
+
+			void Add(const std::shared_ptr<DecodedStream::State> &state)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					added.push_back(state);
+					wake = true;
+				}
+				condition.notify_one();
+			}
+
+			/**
+			 * Wakes the thread because a block has been freed.
+			 */
+			void Wake()
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					wake = true;
+				}
+				condition.notify_one();
+			}
+
+			private:
+			void Run()
+			{
+				// NOTE: streams is only accessed by this thread, so that the
+				// lock is only held while picking up new streams
+				std::vector<std::shared_ptr<DecodedStream::State>> streams;
+				for (;;)
+				{
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						// sleep when there is nothing to do, with a timeout
+						// in case a wakeup comes between the loops
+						if (!wake && !done)
+							condition.wait_for(lock, std::chrono::milliseconds(10),
+								[this] { return wake || done; });
+						if (done) return;
+						wake = false;
+						streams.insert(streams.end(), added.begin(), added.end());
+						added.clear();
+					}
+					streams.erase(
+						std::remove_if(streams.begin(), streams.end(),
+							[](const std::shared_ptr<DecodedStream::State> &state)
+							{
+								return state->closed.load(std::memory_order_acquire);
+							}),
+						streams.end());
+
+					// decode one block for each stream at a time, so that a
+					// new stream can't starve the others, until every ring
+					// is full
+					for (bool progress = true; progress;)
+					{
+						progress = false;
+						for (const auto &state : streams)
+							if (!state->finished && !state->closed.load(std::memory_order_relaxed))
+								if (DecodedStream::Block *block = state->ring.GetWriteSlot())
+								{
+									Decode(*state, *block);
+									state->ring.Push();
+									progress = true;
+								}
+					}
+				}
+			}
+
+			static void Decode(DecodedStream::State &state, DecodedStream::Block &block)
+			{
+				try
+				{
+					if (state.startSample)
+					{
+						state.stream->Seek(state.startSample);
+						state.startSample = 0;
+					}
+					block.size = 0;
+					for (bool rewound = false;;)
+					{
+						unsigned size = state.stream->Read(
+							block.data.data() + block.size,
+							block.data.size() - block.size);
+						block.size += size;
+						if (block.size == block.data.size()) break;
+						// stop at the end unless looping, or if the stream is
+						// empty even after seeking back to the start
+						if (!state.loop || (rewound && !size))
+						{
+							state.finished = true;
+							break;
+						}
+						state.stream->Seek(0);
+						rewound = true;
+					}
+				}
+				catch (const std::exception &e)
+				{
+					err::ReportWarning(e);
+					state.finished = true;
+				}
+				block.last = state.finished;
+			}
+
+			std::mutex mutex;
+			std::condition_variable condition;
+			std::vector<std::shared_ptr<DecodedStream::State>> added;
+			bool wake = false, done = false;
+
+			// NOTE: must be last, since the thread starts running before the
+			// constructor returns
+			std::thread thread;
+		};
+
+		DecoderThread &GetDecoderThread()
+		{
+			static DecoderThread decoder;
+			return decoder;
+		}
+	}
+
+	/*-------------+
+	| constructors |
+	+-------------*/
+
+	DecodedStream::DecodedStream(std::unique_ptr<res::AudioStream> stream, bool loop, unsigned startSample, unsigned blockSize, unsigned blockCount) :
+		state(std::make_shared<State>(std::move(stream), loop, startSample, blockSize, blockCount))
+	{
+		GetDecoderThread().Add(state);
+	}
+
+	DecodedStream::~DecodedStream()
+	{
+		state->closed.store(true, std::memory_order_release);
+	}
+
+	/*----------+
+	| observers |
+	+----------*/
+
+	std::size_t DecodedStream::GetFillLevel() const
+	{
+		return state->ring.GetSize();
+	}
+
+	std::size_t DecodedStream::GetCapacity() const
+	{
+		return state->ring.GetCapacity();
+	}
+
+	unsigned DecodedStream::GetUnderruns() const
+	{
+		return underruns;
+	}
+
+	unsigned DecodedStream::GetBlocks() const
+	{
+		return blocks;
+	}
+
+	float DecodedStream::GetAverageFillLevel() const
+	{
+		return blocks ? float(fillTotal) / blocks / GetCapacity() : 0;
+	}
+
+	/*-----------+
+	| operations |
+	+-----------*/
+
+	auto DecodedStream::GetBlock() -> const Block *
+	{
+		const Block *block = state->ring.GetReadSlot();
+		// NOTE: the ring is expected to be empty before the decoder has
+		// caught up with a new stream, and after the last block
+		if (!block && blocks && !ended) ++underruns;
+		return block;
+	}
+
+	void DecodedStream::PopBlock()
+	{
+		fillTotal += state->ring.GetSize();
+		++blocks;
+		ended = state->ring.GetReadSlot()->last;
+		state->ring.Pop();
+		GetDecoderThread().Wake();
+	}
+}}
@@ -0,0 +1,150 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_aud_DecodedStream_hpp
+#   define page_local_aud_DecodedStream_hpp
+
+#	include <cstddef> // size_t
+#	include <memory> // shared_ptr, unique_ptr
+#	include <vector>
+
+#	include "../util/class/special_member_functions.hpp" // Uncopyable
+
+namespace page { namespace res { class AudioStream; }}
+
+namespace page { namespace aud
+{
+	/**
+	 * An audio stream that is decoded ahead of playback by a shared
+	 * background thread.
+	 *
+	 * The decoder thread fills a lock-free ring of fixed-size blocks for each
+	 * stream, seeking back to the start when a looping stream runs out, so
+	 * the thread that plays the stream only has to hand the decoded blocks
+	 * to the audio device.
+	 */
+	class DecodedStream : public util::Uncopyable<DecodedStream>
+	{
+		/*-------------+
+		| nested types |
+		+-------------*/
+
+		public:
+		struct Block
+		{
+			std::vector<char> data;
+
+			/**
+			 * The number of bytes of @c data that were decoded, which is
+			 * only less than the size of @c data for the last block.
+			 */
+			unsigned size = 0;
+
+			/**
+			 * @c true if this is the last block of a stream that doesn't
+			 * loop.
+			 */
+			bool last = false;
+		};
+
+		struct State;
+
+		/*-------------+
+		| constructors |
+		+-------------*/
+
+		/**
+		 * @param blockSize The number of bytes in each block, which should
+		 *        be a multiple of the size of a sample frame.
+		 * @param blockCount The number of blocks that can be decoded ahead.
+		 */
+		DecodedStream(std::unique_ptr<res::AudioStream>, bool loop,
+			unsigned startSample = 0,
+			unsigned blockSize   = 16384,
+			unsigned blockCount  = 8);
+		~DecodedStream();
+
+		/*----------+
+		| observers |
+		+----------*/
+
+		/**
+		 * Returns the number of decoded blocks that are waiting to be
+		 * played.
+		 */
+		std::size_t GetFillLevel() const;
+
+		std::size_t GetCapacity() const;
+
+		/**
+		 * Returns the number of times that a block was requested before the
+		 * decoder had finished it, between the first block being played and
+		 * the last.
+		 */
+		unsigned GetUnderruns() const;
+
+		/**
+		 * Returns the number of blocks that have been played.
+		 */
+		unsigned GetBlocks() const;
+
+		/**
+		 * Returns the average fill level of the ring, as a fraction of its
+		 * capacity, at the times that blocks were played.
+		 */
+		float GetAverageFillLevel() const;
+
+		/*-----------+
+		| operations |
+		+-----------*/
+
+		/**
+		 * Returns the next decoded block, or @c nullptr if the decoder hasn't
+		 * finished it yet, which counts as an underrun if the stream has
+		 * started and hasn't ended.  The block remains valid until
+		 * PopBlock() is called.
+		 */
+		const Block *GetBlock();
+
+		/**
+		 * Releases the block returned by GetBlock() to the decoder.
+		 */
+		void PopBlock();
+
+		/*-------------+
+		| data members |
+		+-------------*/
+
+		private:
+		std::shared_ptr<State> state;
+		unsigned underruns = 0, blocks = 0;
+		std::size_t fillTotal = 0;
+		bool ended = false;
+	};
+}}
+
+#endif
@@ -25,7 +25,15 @@
  * of this software.
  */
 
+#include <algorithm> // find_if, max, partial_sort
+#include <unordered_map>
+#include <unordered_set>
+
 #include "../cfg/vars.hpp"
+#include "../math/float.hpp" // DecibelToLinear
+#include "../math/Vector.hpp" // Len, Vector
+#include "../phys/node/Sound.hpp" // Sound::{Get{Position,Priority,Volume},IsPlaying}
+#include "../phys/Scene.hpp" // Scene::{GetFocus,GetSounds}
 #include "channel/AmbientChannel.hpp"
 #include "channel/SpatialChannel.hpp"
 #include "Driver.hpp"
@@ -33,6 +41,35 @@
 
 namespace page { namespace aud
 {
+	namespace
+	{
+		/**
+		 * The factor by which the score of a voice that already has a
+		 * channel is increased, to prevent voices of similar audibility
+		 * from trading channels on every update.
+		 */
+		const float hysteresis = 1.5;
+
+		/**
+		 * A sound competing for a channel.
+		 */
+		template <typename T>
+			struct Voice
+		{
+			T *source;
+			int priority;
+			float score;
+
+			// ordered from most to least deserving of a channel
+			bool operator <(const Voice &other) const
+			{
+				return
+					priority != other.priority ? priority > other.priority :
+					score > other.score;
+			}
+		};
+	}
+
 	// construct/destroy
 	Driver::Driver(wnd::Window &window) : window(window), scene(0) {}
 	Driver::~Driver() {}
@@ -40,86 +77,20 @@ namespace page { namespace aud
 	// update
 	void Driver::Update(float deltaTime)
 	{
-		// update ambient sounds
-		for (Sounds::iterator iter(sounds.begin()); iter != sounds.end();)
-		{
-			Sound &sound(**iter);
-			sound.Update(deltaTime);
-			// remove dead sounds
-			if (!sound.IsAlive() && iter->unique())
-			{
-				iter = sounds.erase(iter);
-				continue;
-			}
-			if (sound.IsPlaying())
-			{
-				// assign channel if none already assigned
-				// NOTE: only used to resume from paused state
-				if (!sound.HasChannel() &&
-					ambientChannels.size() < MaxAmbientChannels())
-				{
-					std::shared_ptr<AmbientChannel> channel(MakeAmbientChannel(sound));
-					ambientChannels.push_back(channel);
-					sound.Bind(*channel);
-				}
-			}
-			else
-			{
-				// release channel if not in use
-				if (sound.HasChannel())
-					sound.ReleaseChannel();
-			}
-			++iter;
-		}
-		// update ambient channels
-		for (AmbientChannels::iterator iter(ambientChannels.begin()); iter != ambientChannels.end();)
-		{
-			AmbientChannel &channel(**iter);
-			channel.Update(deltaTime);
-			// remove dead channels
-			if (!channel.IsAlive())
-			{
-				iter = ambientChannels.erase(iter);
-				continue;
-			}
-			++iter;
-		}
-		// update spacial channels
+		UpdateAmbientVoices(deltaTime);
 		if (MaxPersistentSpatialChannels())
-		{
-			// update channels to represent closest sources
-			// FIXME: build list of n closest phys::Sounds
-			// FIXME: ensure sceneChannels is partitioned with dead channels
-			// on one side and living channels on the other, the more dead
-			// the further from the center
-			// FIXME: for each living channel, try to match it with a
-			// phys::Sound; if there's no match, kill the sound; if the
-			// ID is not invalid, meaning the phys::Sound still exists, but
-			// is out of range, fade out the channel
-			// FIXME: for each phys::Sound, try to match it to a living
-			// channel; if there's no match, try to match it with a dying
-			// channel; if there's no match, replace the deadest channel
-			// with a new channel representing the phys::Sound; if the
-			// phys::Sound has elapsed at all, fade in the new channel
-			// FIXME: update state of all channels, whether alive or dying,
-			// to match phys::Sound, including volume and paused state, and
-			// ensure that the playing position is reasonably close
-			for (SpatialChannels::iterator iter(spacialChannels.begin()); iter != spacialChannels.end(); ++iter)
-			{
-				SpatialChannel &channel(**iter);
-				channel.Update(deltaTime);
-				if (!channel.IsAudible()) iter = spacialChannels.erase(iter);
-			}
-		}
+			UpdateSpatialVoices(deltaTime);
 	}
 
 	// modifiers
-	SoundProxy Driver::Play(const cache::Proxy<res::Sound> &res, bool loop, bool fade, float fadeDuration)
+	SoundProxy Driver::Play(const cache::Proxy<res::Sound> &res, bool loop, bool fade, float fadeDuration, int priority)
 	{
-		std::shared_ptr<Sound> sound(new Sound(res, loop, fade, fadeDuration));
+		std::shared_ptr<Sound> sound(new Sound(res, loop, fade, fadeDuration, priority));
 		*sound->GetSound(); // dereference sound resource to ensure it loaded properly
 		sounds.push_back(sound);
 		// assign channel to sound, if available
+		// NOTE: if there are no free channels, the sound starts out virtual
+		// and competes for a channel on the next update
 		if (ambientChannels.size() < MaxAmbientChannels())
 		{
 			std::shared_ptr<AmbientChannel> channel(MakeAmbientChannel(*sound));
@@ -171,6 +142,171 @@ namespace page { namespace aud
 		}
 	}
 
+	// voice virtualization
+	void Driver::UpdateAmbientVoices(float deltaTime)
+	{
+		// update sounds
+		std::vector<Voice<Sound>> voices;
+		voices.reserve(sounds.size());
+		for (Sounds::iterator iter(sounds.begin()); iter != sounds.end();)
+		{
+			Sound &sound(**iter);
+			sound.Update(deltaTime);
+			// remove dead sounds
+			if (!sound.IsAlive() && iter->unique())
+			{
+				iter = sounds.erase(iter);
+				continue;
+			}
+			if (sound.IsPlaying())
+			{
+				float score = math::DecibelToLinear(sound.GetVolume());
+				if (sound.IsStopping()) score *= sound.GetLevel();
+				if (sound.HasChannel()) score *= hysteresis;
+				voices.push_back({&sound, sound.GetPriority(), score});
+			}
+			else
+			{
+				// release channel if not in use
+				if (sound.HasChannel())
+					sound.ReleaseChannel();
+			}
+			++iter;
+		}
+		// demote the least audible voices
+		unsigned maxChannels = MaxAmbientChannels();
+		if (voices.size() > maxChannels)
+		{
+			std::partial_sort(voices.begin(), voices.begin() + maxChannels, voices.end());
+			for (auto iter(voices.begin() + maxChannels); iter != voices.end(); ++iter)
+				if (iter->source->HasChannel())
+					iter->source->ReleaseChannel();
+			voices.resize(maxChannels);
+		}
+		// update ambient channels
+		for (AmbientChannels::iterator iter(ambientChannels.begin()); iter != ambientChannels.end();)
+		{
+			AmbientChannel &channel(**iter);
+			channel.Update(deltaTime);
+			// remove dead channels
+			if (!channel.IsAlive())
+			{
+				iter = ambientChannels.erase(iter);
+				continue;
+			}
+			++iter;
+		}
+		// promote the most audible voices
+		// NOTE: the new channel resumes from the virtual play position
+		for (const auto &voice : voices)
+		{
+			if (ambientChannels.size() >= maxChannels) break;
+			Sound &sound(*voice.source);
+			if (!sound.HasChannel())
+			{
+				std::shared_ptr<AmbientChannel> channel(MakeAmbientChannel(sound));
+				ambientChannels.push_back(channel);
+				sound.Bind(*channel);
+			}
+		}
+	}
+	void Driver::UpdateSpatialVoices(float deltaTime)
+	{
+		// map living channels to their sounds
+		std::unordered_map<util::Identifiable::Id, SpatialChannel *> channelsById;
+		for (SpatialChannels::iterator iter(spacialChannels.begin()); iter != spacialChannels.end();)
+		{
+			SpatialChannel &channel(**iter);
+			phys::Sound *sound = channel.GetSound();
+			// remove channels whose sounds no longer exist
+			if (!sound || !sound->IsPlaying())
+			{
+				iter = spacialChannels.erase(iter);
+				continue;
+			}
+			if (!channel.IsOccluded())
+				channelsById.insert(std::make_pair(channel.GetId(), &channel));
+			++iter;
+		}
+		// score sounds by audibility at the listener
+		std::vector<Voice<const phys::Sound>> voices;
+		if (scene)
+		{
+			const math::Vec3 &listener(scene->GetFocus());
+			for (const auto &sound : scene->GetSounds())
+			{
+				if (!sound.IsPlaying()) continue;
+				// NOTE: inverse distance attenuation, matching the default
+				// reference distance and rolloff factor of the channels
+				float distance = Len(sound.GetPosition() - listener);
+				float score =
+					math::DecibelToLinear(sound.GetVolume()) /
+					std::max(distance, 1.f);
+				if (channelsById.count(sound.GetId())) score *= hysteresis;
+				voices.push_back({&sound, sound.GetPriority(), score});
+			}
+		}
+		// demote the least audible voices
+		// NOTE: demoted channels fade out rather than stopping abruptly
+		unsigned maxVoices = MaxPersistentSpatialChannels();
+		if (voices.size() > maxVoices)
+		{
+			std::partial_sort(voices.begin(), voices.begin() + maxVoices, voices.end());
+			voices.resize(maxVoices);
+		}
+		std::unordered_set<util::Identifiable::Id> winners;
+		for (const auto &voice : voices)
+			winners.insert(voice.source->GetId());
+		for (const auto &kv : channelsById)
+			if (!winners.count(kv.first))
+				kv.second->Occlude();
+		// promote the most audible voices
+		for (const auto &voice : voices)
+		{
+			util::Identifiable::Id id = voice.source->GetId();
+			if (channelsById.count(id)) continue;
+			// revive a dying channel if one is still fading out, which
+			// avoids restarting the decoder
+			auto dying(std::find_if(spacialChannels.begin(), spacialChannels.end(),
+				[id](const std::shared_ptr<SpatialChannel> &channel)
+				{
+					return channel->IsOccluded() && channel->GetId() == id;
+				}));
+			if (dying != spacialChannels.end())
+			{
+				(*dying)->Reveal();
+				continue;
+			}
+			// make room by evicting the quietest dying channel
+			// NOTE: the new channel resumes from the virtual play position
+			if (spacialChannels.size() >= MaxSpatialChannels())
+			{
+				auto quietest(spacialChannels.end());
+				for (auto iter(spacialChannels.begin()); iter != spacialChannels.end(); ++iter)
+					if ((*iter)->IsOccluded() && (quietest == spacialChannels.end() ||
+						(*iter)->GetLevel() < (*quietest)->GetLevel()))
+						quietest = iter;
+				if (quietest == spacialChannels.end()) break;
+				spacialChannels.erase(quietest);
+			}
+			spacialChannels.push_back(
+				std::shared_ptr<SpatialChannel>(MakeSpatialChannel(*voice.source)));
+		}
+		// update spacial channels
+		for (SpatialChannels::iterator iter(spacialChannels.begin()); iter != spacialChannels.end();)
+		{
+			SpatialChannel &channel(**iter);
+			channel.Update(deltaTime);
+			// remove channels that have faded out
+			if (!channel.IsAudible())
+			{
+				iter = spacialChannels.erase(iter);
+				continue;
+			}
+			++iter;
+		}
+	}
+
 	// window access
 	wnd::Window &Driver::GetWindow()
 	{
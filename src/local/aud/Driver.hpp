@@ -63,7 +63,8 @@ namespace page { namespace aud
 
 		// modifiers
 		SoundProxy Play(const cache::Proxy<res::Sound> &,
-			bool loop = false, bool fade = false, float fadeDuration = 1);
+			bool loop = false, bool fade = false, float fadeDuration = 1,
+			int priority = 0);
 		void Stop();
 		void Pause();
 		void Resume();
@@ -85,6 +86,13 @@ namespace page { namespace aud
 		const phys::Scene *GetScene() const;
 
 		private:
+		// voice virtualization
+		// NOTE: sounds compete for channels by priority and audibility;
+		// sounds without a channel remain virtual, advancing their play
+		// position until they are promoted
+		void UpdateAmbientVoices(float deltaTime);
+		void UpdateSpatialVoices(float deltaTime);
+
 		// limits
 		virtual unsigned MaxAmbientChannels() const = 0;
 		virtual unsigned MaxSpatialChannels() const = 0;
@@ -34,10 +34,10 @@
 namespace page { namespace aud
 {
 	// construct
-	Sound::Sound(const cache::Proxy<res::Sound> &sound, bool loop, bool fade, float fadeDuration) :
+	Sound::Sound(const cache::Proxy<res::Sound> &sound, bool loop, bool fade, float fadeDuration, int priority) :
 		sound(sound), playing(true), paused(false), loop(loop),
 		fade(fade), fadeDuration(fadeDuration), level(!fade),
-		playPosition(0), volume(0), channel(0) {}
+		playPosition(0), volume(0), priority(priority), channel(0) {}
 
 	// attributes
 	const cache::Proxy<res::Sound> &Sound::GetSound() const
@@ -78,6 +78,10 @@ namespace page { namespace aud
 	{
 		return volume;
 	}
+	int Sound::GetPriority() const
+	{
+		return priority;
+	}
 
 	// update
 	void Sound::Update(float deltaTime)
@@ -40,7 +40,7 @@ namespace page { namespace aud
 	{
 		// construct
 		explicit Sound(const cache::Proxy<res::Sound> &, bool loop,
-			bool fade, float fadeDuration);
+			bool fade, float fadeDuration, int priority = 0);
 
 		// attributes
 		const cache::Proxy<res::Sound> &GetSound() const;
@@ -54,6 +54,9 @@ namespace page { namespace aud
 		float GetLevel() const;
 		float GetPlayPosition() const;
 		float GetVolume() const;
+		// NOTE: sounds with a higher priority are given channels before
+		// any sound with a lower priority, regardless of volume
+		int GetPriority() const;
 
 		// update
 		void Update(float deltaTime);
@@ -77,6 +80,7 @@ namespace page { namespace aud
 		cache::Proxy<res::Sound> sound;
 		bool playing, paused, loop, fade;
 		float fadeDuration, level, playPosition, volume;
+		int priority;
 		AmbientChannel *channel;
 	};
 }}
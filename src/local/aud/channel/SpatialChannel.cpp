@@ -25,7 +25,7 @@
  * of this software.
  */
 
-#include <algorithm> // max
+#include <algorithm> // max, min
 
 #include "../../math/float.hpp" // DecibelToLinear, Inf
 #include "../../math/interp.hpp" // HermiteScale
@@ -46,12 +46,21 @@ namespace page { namespace aud
 	{
 		return level;
 	}
+	bool SpatialChannel::IsOccluded() const
+	{
+		return occluded;
+	}
+	float SpatialChannel::GetLevel() const
+	{
+		return level;
+	}
 
 	// update
 	void SpatialChannel::DoUpdate(float deltaTime)
 	{
-		if (occluded)
-			level = std::max(level - deltaTime / fadeOutDuration, 0.f);
+		level = occluded ?
+			std::max(level - deltaTime / fadeOutDuration, 0.f) :
+			std::min(level + deltaTime / fadeOutDuration, 1.f);
 	}
 
 	// modifiers
@@ -59,6 +68,10 @@ namespace page { namespace aud
 	{
 		occluded = true;
 	}
+	void SpatialChannel::Reveal()
+	{
+		occluded = false;
+	}
 
 	// sound access
 	phys::Sound *SpatialChannel::GetSound() const
@@ -42,12 +42,17 @@ namespace page { namespace aud
 
 		// state
 		bool IsAudible() const;
+		bool IsOccluded() const;
+		float GetLevel() const;
 
 		// update
 		void DoUpdate(float deltaTime);
 
 		// modifiers
+		// NOTE: an occluded channel fades out, and fades back in if it is
+		// revealed before it becomes inaudible
 		void Occlude();
+		void Reveal();
 
 		// sound access
 		phys::Sound *GetSound() const;
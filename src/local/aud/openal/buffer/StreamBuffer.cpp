@@ -28,33 +28,31 @@
 #include <cassert>
 
 #include "../../../err/Exception.hpp"
+#include "../../../log/Stats.hpp"
 #include "../../../res/type/Sound.hpp" // Sound::{decoder,frequency}, GetDuration
 #include "../../../res/type/sound/AudioDecoder.hpp" // AudioDecoder::Open
-#include "../../../res/type/sound/AudioStream.hpp" // AudioStream::{~AudioStream,Read,Seek}
+#include "../../../res/type/sound/AudioStream.hpp" // AudioStream::~AudioStream
 #include "../../../res/type/sound/openal.hpp" // GetFormat
 #include "StreamBuffer.hpp"
 
 namespace page { namespace aud { namespace openal
 {
-	const unsigned bufferSize = 65536;
-
 	// construct/destroy
 	StreamBuffer::StreamBuffer(ALuint source, const res::Sound &sound, bool loop, float playPosition) :
-		source(source), stream(sound.decoder->Open()),
+		source(source),
+		stream(sound.decoder->Open(), loop, playPosition * sound.frequency),
 		format(res::openal::GetFormat(sound)),
-		frequency(sound.frequency), loop(loop), end(false),
-		bufferData(bufferSize)
+		frequency(sound.frequency), end(false)
 	{
+		assert(playPosition <= GetDuration(sound));
 		alGenBuffers(buffers.size(), &*buffers.begin());
 		if (alGetError())
 			THROW((err::Exception<err::AudModuleTag, err::OpenalPlatformTag>("failed to create buffer") <<
 				boost::errinfo_api_function("alGenBuffers")))
-		if (playPosition)
-		{
-			assert(playPosition <= GetDuration(sound));
-			stream->Seek(playPosition * sound.frequency);
-		}
-		Queue(&*buffers.begin(), buffers.size());
+		freeBuffers.assign(buffers.begin(), buffers.end());
+		// NOTE: the decoder thread has probably not decoded anything yet, in
+		// which case Update will start the source once it has
+		Queue();
 	}
 	StreamBuffer::~StreamBuffer()
 	{
@@ -67,18 +65,19 @@ namespace page { namespace aud { namespace openal
 	void StreamBuffer::Update()
 	{
 		if (end) return;
-		// refill processed buffers
+		// recycle processed buffers
 		ALint processed = 0;
 		alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
 		if (processed)
 		{
-			std::vector<ALuint> buffers(processed);
-			alSourceUnqueueBuffers(source, processed, &*buffers.begin());
+			std::size_t size = freeBuffers.size();
+			freeBuffers.resize(size + processed);
+			alSourceUnqueueBuffers(source, processed, &freeBuffers[size]);
 			if (alGetError())
 				THROW((err::Exception<err::AudModuleTag, err::OpenalPlatformTag>("failed to unqueue buffer") <<
 					boost::errinfo_api_function("alSourceUnqueueBuffers")))
-			Queue(&*buffers.begin(), buffers.size());
 		}
+		Queue();
 		// restart starved source
 		ALint state = AL_STOPPED;
 		alGetSourcei(source, AL_SOURCE_STATE, &state);
@@ -91,38 +90,36 @@ namespace page { namespace aud { namespace openal
 	}
 
 	// buffering
-	void StreamBuffer::Queue(const ALuint *buffers, unsigned n)
+	void StreamBuffer::Queue()
 	{
-		for (const ALuint *buffer = buffers; buffer != buffers + n; ++buffer)
+		while (!freeBuffers.empty())
 		{
-			if (loop)
-			{
-				for (BufferData::iterator iter(bufferData.begin());;)
-				{
-					iter += stream->Read(&*iter, bufferData.end() - iter);
-					if (iter == bufferData.end()) break;
-					stream->Seek(0);
-				}
-				alBufferData(*buffer, format, &*bufferData.begin(), bufferData.size(), frequency);
-			}
-			else
+			unsigned underruns = stream.GetUnderruns();
+			const DecodedStream::Block *block = stream.GetBlock();
+			if (!block)
 			{
-				unsigned size = stream->Read(&*bufferData.begin(), bufferData.size());
-				alBufferData(*buffer, format, &*bufferData.begin(), size, frequency);
-				if (size != bufferData.size())
-				{
-					n = buffer - buffers + 1;
-					end = true;
-					break;
-				}
+				if (stream.GetUnderruns() != underruns)
+					GLOBAL(log::Stats).IncAudioUnderruns();
+				break;
 			}
+			ALuint buffer = freeBuffers.back();
+			alBufferData(buffer, format, block->data.data(), block->size, frequency);
 			if (alGetError())
 				THROW((err::Exception<err::AudModuleTag, err::OpenalPlatformTag>("failed to initialize buffer") <<
 					boost::errinfo_api_function("alBufferData")))
+			alSourceQueueBuffers(source, 1, &buffer);
+			if (alGetError())
+				THROW((err::Exception<err::AudModuleTag, err::OpenalPlatformTag>("failed to queue buffer") <<
+					boost::errinfo_api_function("alSourceQueueBuffers")))
+			freeBuffers.pop_back();
+			GLOBAL(log::Stats).IncAudioBlocks(float(stream.GetFillLevel()) / stream.GetCapacity());
+			bool last = block->last;
+			stream.PopBlock();
+			if (last)
+			{
+				end = true;
+				break;
+			}
 		}
-		alSourceQueueBuffers(source, n, buffers);
-		if (alGetError())
-			THROW((err::Exception<err::AudModuleTag, err::OpenalPlatformTag>("failed to queue buffer") <<
-				boost::errinfo_api_function("alSourceQueueBuffers")))
 	}
 }}}
@@ -29,13 +29,11 @@
 #   define page_local_aud_openal_buffer_StreamBuffer_hpp
 
 #	include <array>
-#	include <memory> // unique_ptr
 #	include <vector>
 
+#	include "../../DecodedStream.hpp"
 #	include "../Buffer.hpp"
 
-namespace page { namespace res { class AudioStream; }}
-
 namespace page { namespace aud { namespace openal
 {
 	struct StreamBuffer : Buffer
@@ -49,17 +47,16 @@ namespace page { namespace aud { namespace openal
 
 		private:
 		// buffering
-		void Queue(const ALuint *buffers, unsigned n);
+		void Queue();
 
 		ALuint source;
-		std::unique_ptr<res::AudioStream> stream;
+		DecodedStream stream;
 		ALenum format;
 		unsigned frequency;
-		bool loop, end;
-		typedef std::array<ALuint, 2> Buffers;
+		bool end;
+		typedef std::array<ALuint, 4> Buffers;
 		Buffers buffers;
-		typedef std::vector<char> BufferData;
-		BufferData bufferData;
+		std::vector<ALuint> freeBuffers;
 	};
 }}}
 
@@ -26,15 +26,19 @@
  */
 
 #include <cassert>
+#include <cstdint> // uint64_t
+#include <functional> // function
 #include <iostream> // cout
+#include <unordered_map>
 
 #include <boost/algorithm/hex.hpp>
 #include <boost/optional.hpp>
 
-#include "../cfg/vars.hpp"
+#include "../cfg/Snapshot.hpp"
 #include "../err/report.hpp" // ReportWarning, std::exception
 #include "../log/Indenter.hpp"
 #include "../log/Stats.hpp"
+#include "../res/node/path.hpp" // NormPath
 #include "Cache.hpp"
 
 namespace page { namespace cache
@@ -53,9 +57,10 @@ namespace page { namespace cache
 	std::shared_ptr<const void>
 		Cache::Fetch(
 			const Signature &signature,
-			const std::type_info &type) const
+			const std::type_info &type,
+			std::uint64_t version) const
 	{
-		GLOBAL(log::Stats).IncCacheTries();
+		GLOBAL(log::Stats).IncCacheTries(type);
 
 		// look for a matching datum
 		auto iter(pool.find(signature));
@@ -64,14 +69,25 @@ namespace page { namespace cache
 			const auto &datum(iter->second);
 			assert(*datum.type == type);
 
-			// if the datum is invalid, we need to repair it
-			if (datum.invalid)
+			// if the datum is out of date and can't be repaired, it needs to
+			// be recreated
+			if (datum.version != version && !datum.repair)
+			{
+				if (CSNAP(logCache) && CSNAP(logCacheUpdate))
+					std::cout << "dropping outdated cached object: " << signature << std::endl;
+				const_cast<Cache &>(*this).Erase(iter);
+				GLOBAL(log::Stats).IncCacheMisses(type);
+				return nullptr;
+			}
+
+			// if the datum is invalid or out of date, we need to repair it
+			if (datum.invalid || datum.version != version)
 			{
 				assert(datum.repair);
 
 				// write to the log
 				boost::optional<log::Indenter> indenter;
-				if (*CVAR(logCache) && *CVAR(logCacheUpdate))
+				if (CSNAP(logCache) && CSNAP(logCacheUpdate))
 				{
 					std::cout << "updating cached object: " << signature << std::endl;
 					indenter = boost::in_place();
@@ -82,23 +98,24 @@ namespace page { namespace cache
 				{
 					datum.repair();
 					datum.invalid = false;
+					datum.version = version;
 				}
 				catch (const std::exception &e)
 				{
 					err::ReportWarning(e);
-					const_cast<decltype(pool) &>(pool).erase(iter);
+					const_cast<Cache &>(*this).Erase(iter);
 					return nullptr;
 				}
 			}
 
 			// update the access time and return the data
-			datum.atime = time;
+			Refresh(datum);
 			return datum.data;
 		}
 
 		// no matching datum was found
-		GLOBAL(log::Stats).IncCacheMisses();
-		if (*CVAR(logCache) && *CVAR(logVerbose))
+		GLOBAL(log::Stats).IncCacheMisses(type);
+		if (CSNAP(logCache) && CSNAP(logVerbose))
 			std::cout << "cache missing object: " << signature << std::endl;
 		return nullptr;
 	}
@@ -107,24 +124,34 @@ namespace page { namespace cache
 		const Signature &signature,
 		const std::shared_ptr<const void> &data,
 		const std::type_info &type,
-		const std::function<void ()> &repair)
+		std::size_t size,
+		const std::function<void ()> &repair,
+		std::uint64_t version)
 	{
 		// write to the log
 		boost::optional<log::Indenter> indenter;
-		if (*CVAR(logCache))
+		if (CSNAP(logCache))
 		{
 			std::cout << "caching object: " << signature << std::endl;
 			indenter = boost::in_place();
 		}
 
-		pool.insert({signature, Datum(data, type, repair, time)});
+		auto result(pool.insert({signature, Datum(data, type, size, repair, version, time)}));
+		if (result.second)
+		{
+			auto &datum(result.first->second);
+			datum.signature = &result.first->first;
+			recency.push_back(datum);
+			this->size += size;
+			GLOBAL(log::Stats).IncCacheStores(type, size);
+		}
 	}
 
 	void Cache::Touch(const Signature &signature)
 	{
 		// write to the log
 		boost::optional<log::Indenter> indenter;
-		if (*CVAR(logCache) && *CVAR(logCacheUpdate) && *CVAR(logVerbose))
+		if (CSNAP(logCache) && CSNAP(logCacheUpdate) && CSNAP(logVerbose))
 		{
 			std::cout << "touching cached object: " << signature << std::endl;
 			indenter = boost::in_place();
@@ -132,17 +159,14 @@ namespace page { namespace cache
 
 		auto iter(pool.find(signature));
 		if (iter != pool.end())
-		{
-			auto &datum(iter->second);
-			datum.atime = time;
-		}
+			Refresh(iter->second);
 	}
 
 	void Cache::Invalidate(const Signature &signature)
 	{
 		// write to the log
 		boost::optional<log::Indenter> indenter;
-		if (*CVAR(logCache) && *CVAR(logCacheUpdate) && *CVAR(logVerbose))
+		if (CSNAP(logCache) && CSNAP(logCacheUpdate) && CSNAP(logVerbose))
 		{
 			std::cout << "invalidating cached object: " << signature << std::endl;
 			indenter = boost::in_place();
@@ -153,7 +177,7 @@ namespace page { namespace cache
 		{
 			auto &datum(iter->second);
 			if (datum.repair) datum.invalid = true;
-			else pool.erase(iter);
+			else Erase(iter);
 		}
 	}
 
@@ -161,13 +185,14 @@ namespace page { namespace cache
 	{
 		// write to the log
 		boost::optional<log::Indenter> indenter;
-		if (*CVAR(logCache))
+		if (CSNAP(logCache))
 		{
 			std::cout << "purging cache" << std::endl;
 			indenter = boost::in_place();
 		}
 
-		pool.clear();
+		while (!pool.empty())
+			Erase(pool.begin());
 		time = {};
 	}
 
@@ -175,18 +200,70 @@ namespace page { namespace cache
 	{
 		// write to the log
 		boost::optional<log::Indenter> indenter;
-		if (*CVAR(logCache))
+		if (CSNAP(logCache))
 		{
 			std::cout << "purging cached object: " << signature << std::endl;
 			indenter = boost::in_place();
 		}
 
-		pool.erase(signature);
+		auto iter(pool.find(signature));
+		if (iter != pool.end())
+			Erase(iter);
 	}
 
 	void Cache::PurgeResource(const std::string &path)
 	{
-		// FIXME: implement
+		// write to the log
+		boost::optional<log::Indenter> indenter;
+		if (CSNAP(logCache))
+		{
+			std::cout << "purging cached resource: " << path << std::endl;
+			indenter = boost::in_place();
+		}
+
+		// find the data that depend on the resource, directly or through
+		// other signatures, remembering the result for each signature so
+		// that shared dependencies are only checked once
+		std::string normPath(res::NormPath(path));
+		std::unordered_map<std::uint64_t, bool> dependents;
+		std::function<bool (const Signature &)> dependsOnResource;
+		dependsOnResource = [&](const Signature &signature)
+		{
+			auto result(dependents.insert({signature.GetId(), false}));
+			if (!result.second) return result.first->second;
+			const auto &deps(signature.GetDependencies());
+			bool depends =
+				signature.GetType() == "resource" && deps.size() == 2 &&
+				deps[1].kind == detail::SignatureDependency::textKind &&
+				res::NormPath(deps[1].text) == normPath;
+			for (const auto &dep : deps)
+			{
+				if (depends) break;
+				if (dep.kind == detail::SignatureDependency::signatureKind)
+					depends = dependsOnResource(dep.signature);
+			}
+			return dependents[signature.GetId()] = depends;
+		};
+
+		for (auto iter(pool.begin()); iter != pool.end();)
+		{
+			if (dependsOnResource(iter->first))
+			{
+				if (CSNAP(logCache) && CSNAP(logVerbose))
+					std::cout << "purging cached object: " << iter->first << std::endl;
+				Erase(iter++);
+			}
+			else ++iter;
+		}
+	}
+
+	/*----------+
+	| observers |
+	+----------*/
+
+	std::size_t Cache::GetSize() const noexcept
+	{
+		return size;
 	}
 
 	/*----------------+
@@ -199,23 +276,70 @@ namespace page { namespace cache
 		time.time += deltaTime;
 		++time.frame;
 
-		// drop expired datums
-		for (auto iter(pool.begin()); iter != pool.end();)
+		// the budget is specified in megabytes, where zero means unlimited
+		std::size_t budget = CSNAP(cacheBudget) * std::size_t(1024 * 1024);
+
+		// if the cache is still over budget because all of the remaining
+		// data was in use last time, and nothing has been stored or dropped
+		// since, we only look for expired data until the size changes; data
+		// that is released in the meantime is dropped when it expires
+		bool checkBudget = budget && size > budget && size != pinnedSize;
+
+		// drop data, starting with the least recently used, until the
+		// remaining data is neither expired nor over budget
+		RecencyList inUse;
+		while (!recency.empty())
 		{
-			Datum &datum(iter->second);
-			if (time - datum.atime > lifetime && datum.data.unique())
+			Datum &datum(recency.front());
+			bool expired = time - datum.atime > lifetime;
+			bool overBudget = checkBudget && size > budget;
+			if (!expired && !overBudget) break;
+
+			// data that is still in use cannot be dropped, so we consider it
+			// to have been accessed and move it out of the way
+			if (!datum.data.unique())
 			{
-				// write to the log
-				boost::optional<log::Indenter> indenter;
-				if (*CVAR(logCache) && *CVAR(logVerbose))
-				{
-					std::cout << "cached object timed out: " << iter->first << std::endl;
-					indenter = boost::in_place();
-				}
+				datum.atime = time;
+				recency.pop_front();
+				inUse.push_back(datum);
+				continue;
+			}
 
-				pool.erase(iter++);
+			// write to the log
+			boost::optional<log::Indenter> indenter;
+			if (CSNAP(logCache) && CSNAP(logVerbose))
+			{
+				std::cout << (expired ?
+					"cached object timed out: " :
+					"cache over budget, dropping object: ") <<
+					*datum.signature << std::endl;
+				indenter = boost::in_place();
 			}
-			else ++iter;
+
+			Erase(pool.find(*datum.signature));
 		}
+		recency.splice(recency.end(), inUse);
+
+		if (!budget || size <= budget) pinnedSize = 0;
+		else if (checkBudget) pinnedSize = size;
+	}
+
+	/*---------------+
+	| implementation |
+	+---------------*/
+
+	void Cache::Refresh(const Datum &datum) const
+	{
+		datum.atime = time;
+		datum.recencyHook.unlink();
+		recency.push_back(const_cast<Datum &>(datum));
+	}
+
+	void Cache::Erase(Pool::const_iterator iter)
+	{
+		const auto &datum(iter->second);
+		size -= datum.size;
+		GLOBAL(log::Stats).IncCacheEvictions(*datum.type, datum.size);
+		pool.erase(iter);
 	}
 }}
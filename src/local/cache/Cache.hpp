@@ -28,12 +28,16 @@
 #ifndef    page_local_cache_Cache_hpp
 #   define page_local_cache_Cache_hpp
 
+#	include <cstddef> // size_t
+#	include <cstdint> // uint64_t
 #	include <functional> // function
 #	include <memory> // shared_ptr
 #	include <string>
 #	include <typeinfo> // type_info
 #	include <unordered_map>
 
+#	include <boost/intrusive/list.hpp>
+
 #	include "../util/class/Monostate.hpp"
 #	include "Signature.hpp"
 
@@ -121,13 +125,15 @@ namespace page { namespace cache
 	 * Temporary storage for objects that take up resources and can be re-
 	 * created on-demand.
 	 *
+	 * Data is dropped when it has not been accessed for the length of its
+	 * lifetime, or when the total size of the data exceeds the budget given by
+	 * @c cache.budget, in which case the least recently used data is dropped
+	 * first.  Data that is still referenced outside of the cache is never
+	 * dropped.
+	 *
 	 * @note It is not usually necessary to interact with the cache directly.
 	 *       Check out Proxy and its related classes, which have been provided
 	 *       to simplify the process of caching resources.
-	 *
-	 * @fixme This class should track the usage patterns of its data and adjust
-	 *        their lifetimes for optimal balancing between cache coherence and
-	 *        memory management.
 	 */
 	class Cache : public util::Monostate<Cache>
 	{
@@ -147,18 +153,27 @@ namespace page { namespace cache
 		 *
 		 * @param[in] signature A signature that uniquely identifies the datum.
 		 * @param[in] type The type of the datum.
+		 * @param[in] version The current version of whatever the datum was
+		 *            built from.  If the datum was stored with a different
+		 *            version, it is repaired, or dropped if it can't be
+		 *            repaired.
 		 */
 		std::shared_ptr<const void> Fetch(
 			Signature      const& signature,
-			std::type_info const& type) const;
+			std::type_info const& type,
+			std::uint64_t         version = 0) const;
 
 		/**
 		 * Fetches an object from the cache.
 		 *
 		 * @param[in] signature A signature that uniquely identifies the datum.
+		 * @param[in] version The current version of whatever the datum was
+		 *            built from.
 		 */
 		template <typename T>
-			std::shared_ptr<const T> Fetch(const Signature &signature) const;
+			std::shared_ptr<const T> Fetch(
+				Signature const& signature,
+				std::uint64_t    version = 0) const;
 
 		/**
 		 * Stores data in the cache.
@@ -166,14 +181,20 @@ namespace page { namespace cache
 		 * @param[in] signature A signature that uniquely identifies the datum.
 		 * @param[in] data The data to store.
 		 * @param[in] type The type of the datum.
+		 * @param[in] size The number of bytes of memory used by the datum.
 		 * @param[in] repair A function that can be used to restore the datum
 		 *            after it has been invalidated.
+		 * @param[in] version The version of whatever the datum was built
+		 *            from, which is compared with the version passed to
+		 *            Fetch().
 		 */
 		void Store(
 			Signature                   const& signature,
 			std::shared_ptr<const void> const& data,
 			std::type_info              const& type,
-			std::function<void ()>      const& repair = nullptr);
+			std::size_t                        size,
+			std::function<void ()>      const& repair  = nullptr,
+			std::uint64_t                      version = 0);
 
 		/**
 		 * Stores an object in the cache.
@@ -182,12 +203,18 @@ namespace page { namespace cache
 		 * @param[in] data The data to store.
 		 * @param[in] repair A function that can be used to restore the datum
 		 *            after it has been invalidated.
+		 * @param[in] version The version of whatever the datum was built
+		 *            from, which is compared with the version passed to
+		 *            Fetch().
+		 *
+		 * @note The size of the object is determined by calling GetSize().
 		 */
 		template <typename T>
 			void Store(
 				Signature                const& signature,
 				std::shared_ptr<const T> const& data,
-				std::function<void ()>   const& repair = nullptr);
+				std::function<void ()>   const& repair  = nullptr,
+				std::uint64_t                   version = 0);
 
 		/**
 		 * Touches the matching datum, updating its access time.
@@ -222,15 +249,28 @@ namespace page { namespace cache
 		 */
 		void PurgeResource(const std::string &path);
 
+		/*----------+
+		| observers |
+		+----------*/
+
+		/**
+		 * Returns the number of bytes of memory used by the data in the cache.
+		 */
+		std::size_t GetSize() const noexcept;
+
 		/*----------------+
 		| other functions |
 		+----------------*/
 
 		/**
-		 * Updates the cache, purging expired data.
+		 * Updates the cache, purging expired data and enforcing the budget.
 		 *
 		 * @note This function should be called by the main loop, exactly once
 		 *       every frame.
+		 *
+		 * @note The cost of this function is proportional to the number of
+		 *       data being dropped, not to the total number of data in the
+		 *       cache.
 		 */
 		void Update(float deltaTime);
 
@@ -239,6 +279,12 @@ namespace page { namespace cache
 		+-------------*/
 
 		private:
+		/**
+		 * A hook for linking a Datum into the recency list.
+		 */
+		using RecencyHook = boost::intrusive::list_member_hook<
+			boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+
 		/**
 		 * A cached object.
 		 */
@@ -247,11 +293,15 @@ namespace page { namespace cache
 			Datum(
 				std::shared_ptr<const void> const& data,
 				std::type_info              const& type,
+				std::size_t                        size,
 				std::function<void ()>      const& repair,
+				std::uint64_t                      version,
 				detail::CacheTime           const& atime = {}) :
 					data(data),
 					type(&type),
+					size(size),
 					repair(repair),
+					version(version),
 					atime(atime) {}
 
 			/**
@@ -264,11 +314,23 @@ namespace page { namespace cache
 			 */
 			const std::type_info *type;
 
+			/**
+			 * The number of bytes of memory used by the datum.
+			 */
+			std::size_t size;
+
 			/**
 			 * A callback used to repair an invalid datum.
 			 */
 			std::function<void ()> repair;
 
+			/**
+			 * The version of whatever the datum was built from.  If it
+			 * doesn't match the version passed to Fetch(), the datum is out
+			 * of date.
+			 */
+			mutable std::uint64_t version;
+
 			/**
 			 * The time when the datum was last accessed.
 			 */
@@ -278,13 +340,73 @@ namespace page { namespace cache
 			 * true if the datum has been invalidated.
 			 */
 			mutable bool invalid = false;
+
+			/**
+			 * The signature of the datum, which is the key of the datum in
+			 * Cache::pool.
+			 */
+			const Signature *signature = nullptr;
+
+			/**
+			 * The position of the datum in Cache::recency.
+			 *
+			 * @note The hook is unlinked automatically when the datum is
+			 *       erased from Cache::pool.
+			 */
+			mutable RecencyHook recencyHook;
 		};
 
+		/**
+		 * A list of data, ordered from least to most recently accessed.
+		 */
+		using RecencyList = boost::intrusive::list<Datum,
+			boost::intrusive::member_hook<Datum, RecencyHook, &Datum::recencyHook>,
+			boost::intrusive::constant_time_size<false>>;
+
+		using Pool = std::unordered_map<Signature, Datum>;
+
+		/*----------------+
+		| implementation |
+		+----------------*/
+
+		/**
+		 * Updates the access time of the datum, moving it to the back of the
+		 * recency list.
+		 */
+		void Refresh(const Datum &) const;
+
+		/**
+		 * Erases the datum from the pool, updating the size of the cache.
+		 */
+		void Erase(Pool::const_iterator);
+
+		/*-------------+
+		| data members |
+		+-------------*/
+
 		/**
 		 * A pool containing all of the cached data, where each datum is keyed
 		 * by its signature.
 		 */
-		std::unordered_map<Signature, Datum> pool;
+		Pool pool;
+
+		/**
+		 * The data in the pool, ordered by their access time.
+		 */
+		mutable RecencyList recency;
+
+		/**
+		 * The number of bytes of memory used by the data in the pool.
+		 */
+		std::size_t size = 0;
+
+		/**
+		 * The size of the cache after the last call to Update() that left it
+		 * over budget because the remaining data was in use, or zero.  While
+		 * the size is unchanged, scanning for data to drop would only find
+		 * the same data in use again.
+		 */
+		std::size_t pinnedSize = 0;
 
 		/**
 		 * The length of time that data will remain in the cache before being
@@ -26,6 +26,7 @@
  */
 
 #include "../util/class/typeinfo.hpp" // GetIncompleteTypeInfo
+#include "size.hpp" // GetSize
 
 namespace page { namespace cache
 {
@@ -35,10 +36,10 @@ namespace page { namespace cache
 
 	template <typename T>
 		std::shared_ptr<const T>
-			Cache::Fetch(const Signature &signature) const
+			Cache::Fetch(const Signature &signature, std::uint64_t version) const
 	{
 		return std::static_pointer_cast<const T>(
-			Fetch(signature, util::GetIncompleteTypeInfo<T>()));
+			Fetch(signature, util::GetIncompleteTypeInfo<T>(), version));
 	}
 
 	/*----------+
@@ -49,8 +50,9 @@ namespace page { namespace cache
 		void Cache::Store(
 			const Signature &signature,
 			const std::shared_ptr<const T> &data,
-			const std::function<void ()> &repair)
+			const std::function<void ()> &repair,
+			std::uint64_t version)
 	{
-		Store(signature, data, util::GetIncompleteTypeInfo<T>(), repair);
+		Store(signature, data, util::GetIncompleteTypeInfo<T>(), cache::GetSize(*data), repair, version);
 	}
 }}
@@ -25,96 +25,322 @@
  * of this software.
  */
 
+#include <cassert>
 #include <functional> // hash
-#include <istream>
+#include <memory> // shared_ptr, unique_ptr
+#include <mutex> // call_once, lock_guard, mutex, once_flag
 #include <ostream>
+#include <string> // to_string
+#include <unordered_map>
+#include <utility> // move
 
+#include "../util/hash.hpp" // combine_hash
 #include "Signature.hpp"
 
 namespace page { namespace cache
 {
+	/*-------------+
+	| symbol table |
+	+-------------*/
+
+	namespace detail
+	{
+		struct SignatureEntry
+		{
+			/**
+			 * The type part of the signature.
+			 */
+			std::string type;
+
+			/**
+			 * The source part of the signature.
+			 */
+			std::vector<SignatureDependency> dependencies;
+
+			/**
+			 * A number that uniquely identifies the entry.  IDs are never
+			 * reused, so they remain unique after the entry is destroyed.
+			 */
+			std::uint64_t id;
+
+			/**
+			 * The precomputed hash of the entry.
+			 */
+			std::size_t hash;
+
+			/**
+			 * The textual form of the signature, which is generated on demand.
+			 */
+			mutable std::string text;
+			mutable std::once_flag textFlag;
+		};
+
+		bool operator ==(const SignatureDependency &a, const SignatureDependency &b)
+		{
+			return
+				a.kind  == b.kind  &&
+				a.value == b.value &&
+				a.text  == b.text;
+		}
+
+		namespace
+		{
+			/**
+			 * Computes the hash of a signature from its type and dependencies.
+			 */
+			std::size_t Hash(const std::string &type, const std::vector<SignatureDependency> &deps)
+			{
+				std::size_t hash = std::hash<std::string>()(type);
+				for (const auto &dep : deps)
+				{
+					hash = util::combine_hash(hash, dep.kind);
+					hash = util::combine_hash(hash,
+						dep.kind == SignatureDependency::textKind ?
+						std::hash<std::string>()(dep.text) :
+						std::hash<std::uint64_t>()(dep.value));
+				}
+				return hash;
+			}
+
+			/**
+			 * A reference to the key of an entry in the symbol table, which
+			 * is used to look up an entry without constructing one.
+			 */
+			struct SymbolKey
+			{
+				const std::string                      *type;
+				const std::vector<SignatureDependency> *dependencies;
+				std::size_t                             hash;
+			};
+
+			struct SymbolKeyHash
+			{
+				std::size_t operator ()(const SymbolKey &key) const noexcept
+				{
+					return key.hash;
+				}
+			};
+
+			struct SymbolKeyEqual
+			{
+				bool operator ()(const SymbolKey &a, const SymbolKey &b) const
+				{
+					return
+						a.hash          == b.hash &&
+						*a.type         == *b.type &&
+						*a.dependencies == *b.dependencies;
+				}
+			};
+
+			/**
+			 * The global symbol table, which maps the key of each signature to
+			 * its entry.
+			 */
+			class SymbolTable
+			{
+				public:
+				static SymbolTable &GetGlobalInstance()
+				{
+					// NOTE: the table is never destroyed, so that signatures
+					// with static storage duration can be safely destroyed
+					static SymbolTable *instance = new SymbolTable;
+					return *instance;
+				}
+
+				std::shared_ptr<const SignatureEntry> Intern(
+					const std::string &type,
+					std::vector<SignatureDependency> &&deps)
+				{
+					std::size_t hash = Hash(type, deps);
+					std::lock_guard<std::mutex> lock(mutex);
+
+					// look for an existing entry
+					auto iter(entries.find({&type, &deps, hash}));
+					if (iter != entries.end())
+					{
+						if (auto entry = iter->second.lock())
+							return entry;
+
+						// the entry is being destroyed, so we will replace it
+						entries.erase(iter);
+					}
+
+					// create a new entry
+					std::unique_ptr<SignatureEntry> entry(new SignatureEntry);
+					entry->type         = type;
+					entry->dependencies = std::move(deps);
+					entry->id           = ++lastId;
+					entry->hash         = hash;
+					std::shared_ptr<const SignatureEntry> result(entry.release(),
+						[this](const SignatureEntry *entry) { Release(entry); });
+					entries.emplace(SymbolKey{&result->type, &result->dependencies, hash}, result);
+					return result;
+				}
+
+				private:
+				/**
+				 * Removes the entry from the table and destroys it.
+				 */
+				void Release(const SignatureEntry *entry)
+				{
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+
+						// remove the entry from the table, unless it has
+						// already been replaced by a new entry
+						auto iter(entries.find({&entry->type, &entry->dependencies, entry->hash}));
+						if (iter != entries.end() && iter->first.type == &entry->type)
+							entries.erase(iter);
+					}
+
+					// NOTE: the entry is destroyed outside of the lock, because
+					// it may release nested signatures
+					delete entry;
+				}
+
+				std::mutex mutex;
+				std::unordered_map<SymbolKey, std::weak_ptr<const SignatureEntry>, SymbolKeyHash, SymbolKeyEqual> entries;
+				std::uint64_t lastId = 0;
+			};
+		}
+
+		Signature MakeSignature(const std::string &type, std::vector<SignatureDependency> &&deps)
+		{
+			return Signature(SymbolTable::GetGlobalInstance().Intern(type, std::move(deps)));
+		}
+	}
+
 	/*-------------+
 	| constructors |
 	+-------------*/
 
 	Signature::Signature(std::nullptr_t) {}
 
+	Signature::Signature(std::shared_ptr<const detail::SignatureEntry> &&entry) :
+		entry(std::move(entry)) {}
+
 	/*----------+
 	| observers |
 	+----------*/
 
-	std::string &Signature::str()
+	const std::string &Signature::str() const
 	{
-		return s;
+		static const std::string empty;
+		if (!entry) return empty;
+		std::call_once(entry->textFlag, [this]
+		{
+			std::string &text(entry->text);
+			if (!entry->type.empty())
+			{
+				text = entry->type;
+				text += '(';
+				text += GetSource();
+				text += ')';
+			}
+			else text = '[' + GetSource() + ']';
+		});
+		return entry->text;
 	}
 
-	const std::string &Signature::str() const
+	Signature::operator bool() const noexcept
+	{
+		return entry != nullptr;
+	}
+
+	std::uint64_t Signature::GetId() const noexcept
 	{
-		return s;
+		return entry ? entry->id : 0;
 	}
 
-	Signature::operator bool() const
+	std::size_t Signature::GetHash() const noexcept
 	{
-		return !s.empty();
+		return entry ? entry->hash : 0;
 	}
 
 	std::string Signature::GetType() const
 	{
-		return s.substr(0, s.find('(') - 1);
+		return entry ? entry->type : std::string();
 	}
 
 	std::string Signature::GetSource() const
 	{
-		auto i = s.find('(') + 1;
-		return s.substr(i, s.size() - i - 1);
-	}
+		std::string source;
+		if (entry)
+		{
+			for (const auto &dep : entry->dependencies)
+			{
+				if (&dep != &entry->dependencies.front())
+					source += ',';
+				switch (dep.kind)
+				{
+					case detail::SignatureDependency::signatureKind:
+					source += dep.signature.str();
+					break;
 
-	/*----------------------------+
-	| stream insertion/extraction |
-	+----------------------------*/
+					case detail::SignatureDependency::signedKind:
+					source += std::to_string(static_cast<std::int64_t>(dep.value));
+					break;
 
-	std::ostream &operator <<(std::ostream &os, const Signature &signature)
+					case detail::SignatureDependency::unsignedKind:
+					source += std::to_string(dep.value);
+					break;
+
+					case detail::SignatureDependency::textKind:
+					source += dep.text;
+					break;
+				}
+			}
+		}
+		return source;
+	}
+
+	const std::vector<detail::SignatureDependency> &Signature::GetDependencies() const
 	{
-		return os << signature.str();
+		static const std::vector<detail::SignatureDependency> empty;
+		return entry ? entry->dependencies : empty;
 	}
 
-	std::istream &operator >>(std::istream &is, Signature &signature)
+	/*-----------------+
+	| stream insertion |
+	+-----------------*/
+
+	std::ostream &operator <<(std::ostream &os, const Signature &signature)
 	{
-		return is >> signature.str();
+		return os << signature.str();
 	}
 
 	/*-----------+
 	| comparison |
 	+-----------*/
 
-	bool operator ==(const Signature &a, const Signature &b)
+	bool operator ==(const Signature &a, const Signature &b) noexcept
 	{
-		return a.str() == b.str();
+		return a.GetId() == b.GetId();
 	}
 
-	bool operator !=(const Signature &a, const Signature &b)
+	bool operator !=(const Signature &a, const Signature &b) noexcept
 	{
-		return a.str() != b.str();
+		return a.GetId() != b.GetId();
 	}
 
-	bool operator <(const Signature &a, const Signature &b)
+	bool operator <(const Signature &a, const Signature &b) noexcept
 	{
-		return a.str() < b.str();
+		return a.GetId() < b.GetId();
 	}
 
-	bool operator >(const Signature &a, const Signature &b)
+	bool operator >(const Signature &a, const Signature &b) noexcept
 	{
-		return a.str() > b.str();
+		return a.GetId() > b.GetId();
 	}
 
-	bool operator <=(const Signature &a, const Signature &b)
+	bool operator <=(const Signature &a, const Signature &b) noexcept
 	{
-		return a.str() <= b.str();
+		return a.GetId() <= b.GetId();
 	}
 
-	bool operator >=(const Signature &a, const Signature &b)
+	bool operator >=(const Signature &a, const Signature &b) noexcept
 	{
-		return a.str() >= b.str();
+		return a.GetId() >= b.GetId();
 	}
 }}
 
@@ -125,6 +351,6 @@ namespace std
 	auto hash<::page::cache::Signature>::operator ()(
 		const argument_type &x) const noexcept -> result_type
 	{
-		return hash<string>()(x.str());
+		return x.GetHash();
 	}
 }
@@ -28,18 +28,42 @@
 #ifndef    page_local_cache_Signature_hpp
 #   define page_local_cache_Signature_hpp
 
-#	include <cstddef> // nullptr_t
-#	include <iosfwd> // [io]stream
+#	include <cstddef> // nullptr_t, size_t
+#	include <cstdint> // uint64_t
+#	include <iosfwd> // ostream
+#	include <memory> // shared_ptr
 #	include <string>
+#	include <vector>
 
 namespace page { namespace cache
 {
+	class Signature;
+
+	namespace detail
+	{
+		struct SignatureDependency;
+		struct SignatureEntry;
+
+		/**
+		 * Interns a signature with the specified type and dependencies.
+		 */
+		Signature MakeSignature(const std::string &type, std::vector<SignatureDependency> &&);
+	}
+
 	/**
-	 * A string wrapper that uniquely identifies a resource based on its type
+	 * An interned key that uniquely identifies a resource based on its type
 	 * and source.
 	 *
-	 * The signature is formatted like a function call:
-	 * <tt>type(dependency1, dependency2...)</tt>.
+	 * Equal signatures share the same entry in a global symbol table, so
+	 * comparison is an integer comparison and the hash is computed only once,
+	 * when the signature is interned.  An entry is removed from the table when
+	 * the last signature referring to it is destroyed.
+	 *
+	 * Dependencies that are themselves signatures (or proxies) are stored by
+	 * reference, rather than being serialized.  The textual form of the
+	 * signature, which is formatted like a function call:
+	 * <tt>type(dependency1,dependency2...)</tt>, is produced on demand for
+	 * logging.
 	 *
 	 * A dependency represents a secondary resource that is needed to acquire
 	 * the primary resource.  Together, the dependencies define the source of
@@ -58,17 +82,38 @@ namespace page { namespace cache
 		template <typename... Args>
 			explicit Signature(const std::string &type, Args &&...);
 
+		private:
+		friend Signature detail::MakeSignature(const std::string &, std::vector<detail::SignatureDependency> &&);
+
+		explicit Signature(std::shared_ptr<const detail::SignatureEntry> &&);
+
 		/*----------+
 		| observers |
 		+----------*/
 
-		std::string &str();
+		public:
+		/**
+		 * Returns the textual form of the signature.
+		 *
+		 * @note The text is generated on the first call and remembered.
+		 */
 		const std::string &str() const;
 
 		/**
 		 * Returns @c true if the signature is not empty.
 		 */
-		explicit operator bool() const;
+		explicit operator bool() const noexcept;
+
+		/**
+		 * Returns a number that uniquely identifies the signature for as long
+		 * as it exists, or zero if the signature is empty.
+		 */
+		std::uint64_t GetId() const noexcept;
+
+		/**
+		 * Returns the precomputed hash of the signature.
+		 */
+		std::size_t GetHash() const noexcept;
 
 		/**
 		 * Returns the type part of the signature.
@@ -80,31 +125,81 @@ namespace page { namespace cache
 		 */
 		std::string GetSource() const;
 
+		/**
+		 * Returns the dependencies that make up the source part of the
+		 * signature.
+		 */
+		const std::vector<detail::SignatureDependency> &GetDependencies() const;
+
 		/*-------------+
 		| data members |
 		+-------------*/
 
 		private:
-		std::string s;
+		std::shared_ptr<const detail::SignatureEntry> entry;
 	};
 
-	/*----------------------------+
-	| stream insertion/extraction |
-	+----------------------------*/
+	namespace detail
+	{
+		/**
+		 * A dependency of a signature, which is either another signature, an
+		 * integer, or a string of text.
+		 */
+		struct SignatureDependency
+		{
+			enum Kind
+			{
+				signatureKind,
+				signedKind,
+				unsignedKind,
+				textKind
+			};
+
+			Kind kind;
+
+			/**
+			 * The value of an integer dependency, or the ID of a signature
+			 * dependency.
+			 */
+			std::uint64_t value;
+
+			/**
+			 * The value of a text dependency.
+			 */
+			std::string text;
+
+			/**
+			 * The value of a signature dependency.
+			 */
+			Signature signature;
+		};
+	}
+
+	/*-----------------+
+	| stream insertion |
+	+-----------------*/
 
 	std::ostream &operator <<(std::ostream &, const Signature &);
-	std::istream &operator >>(std::istream &, Signature &);
 
 	/*-----------+
 	| comparison |
 	+-----------*/
 
-	bool operator ==(const Signature &, const Signature &);
-	bool operator !=(const Signature &, const Signature &);
-	bool operator < (const Signature &, const Signature &);
-	bool operator > (const Signature &, const Signature &);
-	bool operator <=(const Signature &, const Signature &);
-	bool operator >=(const Signature &, const Signature &);
+	/**
+	 * @defgroup signature-comparison Comparison
+	 *
+	 * Signatures are compared by their IDs.  The order is consistent for the
+	 * lifetime of the signatures, but it is not related to the textual form.
+	 *
+	 * @{
+	 */
+	bool operator ==(const Signature &, const Signature &) noexcept;
+	bool operator !=(const Signature &, const Signature &) noexcept;
+	bool operator < (const Signature &, const Signature &) noexcept;
+	bool operator > (const Signature &, const Signature &) noexcept;
+	bool operator <=(const Signature &, const Signature &) noexcept;
+	bool operator >=(const Signature &, const Signature &) noexcept;
+	///@}
 }}
 
 ////////// std::hash<Signature> ////////////////////////////////////////////////
@@ -120,7 +215,7 @@ namespace std
 	template <>
 		struct hash<::page::cache::Signature>
 	{
-		using result_type   = typename hash<string>::result_type;
+		using result_type   = size_t;
 		using argument_type = ::page::cache::Signature;
 
 		result_type operator ()(const argument_type &x) const noexcept;
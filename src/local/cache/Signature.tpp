@@ -26,10 +26,12 @@
  */
 
 #include <sstream> // ostringstream
-#include <utility> // forward
+#include <type_traits> // decay, is_{base_of,enum,integral,same,signed}, underlying_type
+#include <utility> // forward, move
 
 #include "../util/type_traits/range.hpp" // is_range
 #include "../util/type_traits/sfinae.hpp" // ENABLE_IF
+#include "proxy/BasicProxyInterface.hpp"
 
 namespace page { namespace cache
 {
@@ -39,44 +41,99 @@ namespace page { namespace cache
 
 	namespace detail
 	{
+		using SignatureDependencies = std::vector<SignatureDependency>;
+
+		inline void AddDependency(SignatureDependencies &deps, const Signature &x)
+		{
+			deps.push_back({SignatureDependency::signatureKind, x.GetId(), {}, x});
+		}
+
+		inline void AddDependency(SignatureDependencies &deps, const std::string &x)
+		{
+			deps.push_back({SignatureDependency::textKind, 0, x, nullptr});
+		}
+
+		inline void AddDependency(SignatureDependencies &deps, const char *x)
+		{
+			deps.push_back({SignatureDependency::textKind, 0, x, nullptr});
+		}
+
+		inline void AddDependency(SignatureDependencies &deps, char x)
+		{
+			deps.push_back({SignatureDependency::textKind, 0, std::string(1, x), nullptr});
+		}
+
+		/**
+		 * Adds the signature of a proxy.
+		 */
 		template <typename T>
-			void SerializeDependency(std::ostream &os, T x,
-				ENABLE_IF(!util::is_range<T>::value))
+			void AddDependency(SignatureDependencies &deps, const T &x,
+				ENABLE_IF((std::is_base_of<BasicProxyInterface, T>::value)))
 		{
-			os << x;
+			AddDependency(deps, x.GetSignature());
 		}
 
-		template <typename InputRange>
-			void SerializeDependency(std::ostream &os, InputRange range,
-				ENABLE_IF(util::is_range<InputRange>::value))
+		/**
+		 * Adds an integer or an enumerator, which is stored without being
+		 * serialized.
+		 */
+		template <typename T>
+			void AddDependency(SignatureDependencies &deps, T x,
+				ENABLE_IF((
+					(std::is_integral<T>::value || std::is_enum<T>::value) &&
+					!std::is_same<T, char>::value)))
 		{
-			for (const auto &x : range)
-				SerializeDependency(os, x);
+			using Integer = typename std::conditional<std::is_enum<T>::value,
+				std::underlying_type<T>, std::decay<T>>::type::type;
+			deps.push_back({
+				std::is_signed<Integer>::value ?
+					SignatureDependency::signedKind :
+					SignatureDependency::unsignedKind,
+				static_cast<std::uint64_t>(static_cast<Integer>(x)), {}, nullptr});
 		}
 
-		template <typename Arg>
-			void MakeSource(std::ostream &os, Arg &&arg)
+		/**
+		 * Adds a range as a nested signature without a type.
+		 */
+		template <typename InputRange>
+			void AddDependency(SignatureDependencies &deps, const InputRange &range,
+				ENABLE_IF((
+					util::is_range<InputRange>::value &&
+					!std::is_convertible<const InputRange &, const std::string &>::value)))
 		{
-			SerializeDependency(os, std::forward<Arg>(arg));
+			SignatureDependencies elements;
+			for (const auto &x : range)
+				AddDependency(elements, x);
+			AddDependency(deps, MakeSignature({}, std::move(elements)));
 		}
 
-		template <typename Arg, typename Arg2, typename... Args>
-			void MakeSource(std::ostream &os, Arg &&arg, Arg2 &&arg2, Args &&... args)
+		/**
+		 * Adds any other type by serializing it.
+		 */
+		template <typename T>
+			void AddDependency(SignatureDependencies &deps, const T &x,
+				ENABLE_IF((
+					!std::is_convertible<const T &, const Signature &>::value &&
+					!std::is_convertible<const T &, const std::string &>::value &&
+					!std::is_base_of<BasicProxyInterface, T>::value &&
+					!std::is_integral<T>::value &&
+					!std::is_enum<T>::value &&
+					!util::is_range<T>::value)))
 		{
-			SerializeDependency(os, std::forward<Arg>(arg));
-			MakeSource(os << ',',
-				std::forward<Arg2>(arg2),
-				std::forward<Args>(args)...);
+			std::ostringstream ss;
+			ss << x;
+			AddDependency(deps, ss.str());
 		}
 	}
 
 	template <typename... Args>
 		Signature::Signature(const std::string &type, Args &&... args)
 	{
-		std::ostringstream ss;
-		ss << type << '(';
-		detail::MakeSource(ss, std::forward<Args>(args)...);
-		ss << ')';
-		s = ss.str();
+		detail::SignatureDependencies deps;
+		deps.reserve(sizeof...(Args));
+		// NOTE: braced initialization guarantees left-to-right evaluation
+		int expand[] = {0, (detail::AddDependency(deps, args), 0)...};
+		static_cast<void>(expand);
+		*this = detail::MakeSignature(type, std::move(deps));
 	}
 }}
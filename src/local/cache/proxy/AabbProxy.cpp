@@ -25,29 +25,20 @@
  * of this software.
  */
 
+#include <cstdint> // uint64_t
+#include <memory> // make_shared
+
 #include "../../phys/aabb.hpp" // MakeAabb
-#include "../../phys/attrib/Pose.hpp" // Pose->util::Identifiable, Pose::dirty{Pose,Transform}Sig
+#include "../../phys/attrib/Pose.hpp" // Pose->util::Identifiable, Pose::Get{Pose,Transform}Version
 #include "../../phys/Bounds.hpp" // Bounds::bones
 #include "../../phys/node/Form.hpp" // Form::GetModel
+#include "../../util/class/Monostate.hpp" // GLOBAL
+#include "../Cache.hpp"
 #include "AabbProxy.hpp"
 #include "BoundsProxy.hpp"
 
 namespace page { namespace cache
 {
-	/*--------+
-	| deleter |
-	+--------*/
-
-	namespace
-	{
-		void Delete(const math::Aabb<3> *aabb, boost::signals::connection &poseCon, boost::signals::connection &transformCon)
-		{
-			poseCon.disconnect();
-			transformCon.disconnect();
-			delete aabb;
-		}
-	}
-
 	/*-------------+
 	| constructors |
 	+-------------*/
@@ -68,16 +59,22 @@ namespace page { namespace cache
 
 	auto AabbProxy::DoLock() const -> pointer
 	{
-		phys::attrib::Pose &pose(util::GetReferenceById<phys::attrib::Pose>(poseId));
+		const phys::attrib::Pose &pose(util::GetReferenceById<phys::attrib::Pose>(poseId));
 		const phys::Bounds &bounds(*this->bounds);
-		boost::signals::scoped_connection
-			poseCon(
-				pose.IsPosed() && !bounds.bones.empty() ?
-				pose.dirtyPoseSig.connect(GetInvalidateFunction()) :
-				boost::signals::connection()),
-			transformCon(pose.dirtyTransformSig.connect(GetInvalidateFunction()));
-		return pointer(new math::Aabb<3>(MakeAabb(bounds, pose)),
-			std::bind(Delete, std::placeholders::_1,
-				poseCon.release(), transformCon.release()));
+
+		// the bounding box only depends on the bones if the bounds are
+		// skeletal, so that unposed bounds survive animation
+		std::uint64_t version =
+			std::uint64_t(pose.IsPosed() && !bounds.bones.empty() ?
+				pose.GetPoseVersion() : 0) << 32 |
+			pose.GetTransformVersion();
+
+		auto &cache(GLOBAL(Cache));
+		if (auto aabb = cache.Fetch<math::Aabb<3>>(GetSignature(), version))
+			return aabb;
+
+		pointer aabb(std::make_shared<math::Aabb<3>>(MakeAabb(bounds, pose)));
+		cache.Store(GetSignature(), aabb, nullptr, version);
+		return aabb;
 	}
 }}
@@ -69,6 +69,7 @@ namespace page { namespace cache
 
 		private:
 		virtual pointer DoLock() const = 0;
+		virtual bool DoIsReady() const;
 		const Signature &DoGetSignature() const noexcept;
 
 		/*-------------+
@@ -39,6 +39,12 @@ namespace page { namespace cache
 	| ProxyInterface implementation |
 	+------------------------------*/
 
+	template <typename T>
+		bool BasicProxy<T>::DoIsReady() const
+	{
+		return true;
+	}
+
 	template <typename T>
 		const Signature &BasicProxy<T>::DoGetSignature() const noexcept
 	{
@@ -67,6 +67,7 @@ namespace page { namespace cache
 
 		private:
 		pointer DoLock() const;
+		bool DoIsReady() const;
 		const Signature &DoGetSignature() const noexcept;
 
 		/*-------------+
@@ -80,5 +81,18 @@ namespace page { namespace cache
 	};
 }}
 
+////////// std::hash<Proxy> ////////////////////////////////////////////////////
+
+namespace std
+{
+	/**
+	 * A specialization of std::hash for ::page::cache::Proxy, which allows it
+	 * to be used as a key without naming its interface.
+	 */
+	template <typename T>
+		struct hash<::page::cache::Proxy<T>> :
+			hash<::page::cache::ProxyInterface<::page::cache::Proxy<T>, T>> {};
+}
+
 #	include "Proxy.tpp"
 #endif
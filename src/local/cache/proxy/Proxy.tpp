@@ -52,6 +52,12 @@ namespace page { namespace cache
 		return impl ? impl->DoLock() : nullptr;
 	}
 
+	template <typename T>
+		bool Proxy<T>::DoIsReady() const
+	{
+		return impl ? impl->DoIsReady() : true;
+	}
+
 	template <typename T>
 		const Signature &Proxy<T>::DoGetSignature() const noexcept
 	{
@@ -28,6 +28,7 @@
 #ifndef    page_local_cache_proxy_ProxyInterface_hpp
 #   define page_local_cache_proxy_ProxyInterface_hpp
 
+#	include <cstddef> // size_t
 #	include <iosfwd> // basic_ostream
 #	include <memory> // shared_ptr
 
@@ -41,8 +42,8 @@ namespace page { namespace cache
 	 * The interface for proxies of cached objects.
 	 *
 	 * @note Uses the "Curiously-Recurring Template" and "Non-Virtual Interface"
-	 *       patterns.  The derived class must implement DoLock() and
-	 *       DoGetSignature().
+	 *       patterns.  The derived class must implement DoLock(),
+	 *       DoIsReady(), and DoGetSignature().
 	 */
 	template <typename Derived, typename T>
 		class ProxyInterface : public BasicProxyInterface
@@ -86,6 +87,15 @@ namespace page { namespace cache
 		 */
 		pointer lock() const;
 
+		/**
+		 * @return Derived::DoIsReady(), which is @c true if lock() can return
+		 *         without waiting for the object to be loaded.
+		 *
+		 * @note The object may start loading in the background, so that it
+		 *       will eventually be ready.
+		 */
+		bool IsReady() const;
+
 		/**
 		 * @return !GetSignature().empty().
 		 */
@@ -203,7 +213,7 @@ namespace std
 	template <typename D, typename T>
 		struct hash<::page::cache::ProxyInterface<D, T>>
 	{
-		using result_type   = typename hash<string>::result_type;
+		using result_type   = size_t;
 		using argument_type = ::page::cache::ProxyInterface<D, T>;
 
 		result_type operator ()(const argument_type &) const noexcept;
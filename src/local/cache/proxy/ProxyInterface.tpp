@@ -59,6 +59,12 @@ namespace page { namespace cache
 		return r;
 	}
 
+	template <typename D, typename T>
+		bool ProxyInterface<D, T>::IsReady() const
+	{
+		return static_cast<const D &>(*this).DoIsReady();
+	}
+
 	template <typename D, typename T>
 		ProxyInterface<D, T>::operator bool() const noexcept
 	{
@@ -204,6 +210,6 @@ namespace std
 	template <typename D, typename T>
 		auto hash<::page::cache::ProxyInterface<D, T>>::operator ()(const argument_type &proxy) const noexcept -> result_type
 	{
-		return hash<string>()(proxy.GetSignature());
+		return proxy.GetSignature().GetHash();
 	}
 }
@@ -30,6 +30,7 @@
 
 #	include <string>
 
+#	include "../../res/LoadFuture.hpp"
 #	include "BasicProxy.hpp"
 
 namespace page { namespace cache
@@ -63,12 +64,20 @@ namespace page { namespace cache
 
 		private:
 		pointer DoLock() const override;
+		bool DoIsReady() const override;
 
 		/*-------------+
 		| data members |
 		+-------------*/
 
 		std::string path;
+
+		/**
+		 * The background load that was started by IsReady(), which keeps the
+		 * resource alive until the next lock takes it, so that polling doesn't
+		 * start another load and the lock doesn't load it again.
+		 */
+		mutable res::LoadFuture<T> future;
 	};
 }}
 
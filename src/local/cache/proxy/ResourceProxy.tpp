@@ -25,7 +25,9 @@
  * of this software.
  */
 
-#include "../../res/Index.hpp" // Index::Load
+#include <utility> // swap
+
+#include "../../res/Index.hpp" // Index::{Load,LoadAsync}
 #include "../../res/type/TypeRegistry.hpp"
 
 namespace page { namespace cache
@@ -51,6 +53,22 @@ namespace page { namespace cache
 	template <typename T>
 		auto ResourceProxy<T>::DoLock() const -> pointer
 	{
+		// NOTE: the background load is only used by the first lock after it
+		// was started, so that later locks pick up reloaded resources and a
+		// failed load can be retried
+		if (future)
+		{
+			res::LoadFuture<T> future;
+			std::swap(future, this->future);
+			return future.Get();
+		}
 		return GLOBAL(res::Index).Load<T>(path);
 	}
+
+	template <typename T>
+		bool ResourceProxy<T>::DoIsReady() const
+	{
+		if (!future) future = GLOBAL(res::Index).LoadAsync<T>(path);
+		return future.IsReady();
+	}
 }}
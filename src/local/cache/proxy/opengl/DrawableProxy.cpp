@@ -25,10 +25,14 @@
  * of this software.
  */
 
-#include <memory> // unique_ptr
+#include <functional> // bind, ref
+#include <memory> // shared_ptr
 
+#include "../../../phys/Skin.hpp"
+#include "../../../util/class/Monostate.hpp" // GLOBAL
 #include "../../../vid/opengl/Drawable.hpp"
-#include "../Skin.hpp"
+#include "../../Cache.hpp"
+#include "../SkinProxy.hpp"
 #include "DrawableProxy.hpp"
 
 namespace page { namespace cache { namespace opengl
@@ -39,13 +43,7 @@ namespace page { namespace cache { namespace opengl
 
 	namespace
 	{
-		void Delete(const vid::opengl::Drawable *drawable, boost::signals::connection &con)
-		{
-			con.disconnect();
-			delete drawable;
-		}
-
-		void Repair(vid::opengl::Drawable &drawable, const Skin &skin)
+		void Repair(vid::opengl::Drawable &drawable, const std::shared_ptr<const phys::Skin> &skin)
 		{
 			drawable.Update(*skin);
 		}
@@ -73,21 +71,31 @@ namespace page { namespace cache { namespace opengl
 	{
 		if (partId)
 		{
+			const phys::Form::Part &part(util::GetReferenceById<phys::Form::Part>(partId));
+			const phys::Form &form(part.GetForm());
+			bool dynamic = form.IsPosed() || part.IsDeformed();
+
+			// a dynamic drawable is repaired in place when the pose changes
+			auto &cache(GLOBAL(Cache));
+			if (auto drawable = cache.Fetch<vid::opengl::Drawable>(
+				GetSignature(), dynamic ? form.GetPoseVersion() : 0))
+				return drawable;
+
 			// create drawable
-			phys::Form::Part &part(util::GetReferenceById<phys::Form::Part>(partId));
-			bool dynamic = part.GetForm().IsPosed() || part.IsDeformed();
-			std::unique_ptr<vid::opengl::Drawable> drawable(
+			std::shared_ptr<vid::opengl::Drawable> drawable(
 				vid::opengl::MakeDrawable(*mesh, dynamic));
-
-			// update to current pose
 			if (dynamic)
-				drawable->Update(*Skin(part.GetMesh(), part.GetForm()));
+			{
+				// update to current pose
+				auto skin(SkinProxy(part.GetMesh(), form).lock());
+				drawable->Update(*skin);
 
-			std::bind(opengl::Repair, std::placeholders::_1, Skin(part.GetMesh(), part.GetForm()))),
-			// bind dirty signal handler
-			boost::signals::scoped_connection con(part.GetForm().dirtyPoseSig.connect(GetInvalidateFunction()));
-			return pointer(drawable.release(),
-				std::bind(Delete, std::placeholders::_1, con.release()));
+				cache.Store<vid::opengl::Drawable>(GetSignature(), drawable,
+					std::bind(opengl::Repair, std::ref(*drawable), skin),
+					form.GetPoseVersion());
+			}
+			else cache.Store<vid::opengl::Drawable>(GetSignature(), drawable);
+			return drawable;
 		}
 		return pointer(vid::opengl::MakeDrawable(*mesh));
 	}
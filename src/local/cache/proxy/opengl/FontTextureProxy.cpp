@@ -44,6 +44,6 @@ namespace page { namespace cache { namespace opengl
 
 	auto FontTextureProxy::DoLock() const -> pointer
 	{
-		return pointer(new vid::opengl::FontTexture(*font, fontSize));
+		return pointer(new vid::opengl::FontTexture(font.lock(), fontSize));
 	}
 }}}
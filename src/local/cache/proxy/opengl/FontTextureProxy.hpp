@@ -59,7 +59,7 @@ namespace page { namespace cache { namespace opengl
 		| constructors |
 		+-------------*/
 
-		explicit FontTexture(const Proxy<res::Font> &, unsigned fontSize);
+		explicit FontTextureProxy(const Proxy<res::Font> &, unsigned fontSize);
 
 		/*--------------------------+
 		| BasicProxy implementation |
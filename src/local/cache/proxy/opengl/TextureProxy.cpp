@@ -26,7 +26,7 @@
  */
 
 #include <cassert>
-#include <sstream> // ostringstream
+#include <string>
 
 #include "../../../vid/opengl/Texture.hpp"
 #include "Texture.hpp"
@@ -43,23 +43,25 @@ namespace page { namespace cache { namespace opengl
 
 	Signature TextureProxy::MakeSignature(const Proxy<res::Image> &image, vid::opengl::TextureFormat format, vid::opengl::TextureFlags flags, const math::Vector<2, bool> &clamp)
 	{
-		std::ostringstream ss(image.GetSignature());
+		std::string options;
 		switch (format)
 		{
 			case vid::opengl::defaultTextureFormat: break;
-			case vid::opengl::alphaTextureFormat:     ss << ":alpha";     break;
-			case vid::opengl::luminanceTextureFormat: ss << ":luminance"; break;
+			case vid::opengl::alphaTextureFormat:     options += ":alpha";     break;
+			case vid::opengl::luminanceTextureFormat: options += ":luminance"; break;
 			default: assert(!"invalid texture format");
 		}
-		if (flags & vid::opengl::filterTextureFlag) ss << ":filter";
-		if (flags & vid::opengl::mipmapTextureFlag) ss << ":mipmap";
+		if (flags & vid::opengl::filterTextureFlag) options += ":filter";
+		if (flags & vid::opengl::mipmapTextureFlag) options += ":mipmap";
 		if (Any(clamp))
 		{
-			ss << ":clamp";
-			if      (!clamp.x) ss << ".y";
-			else if (!clamp.y) ss << ".x";
+			options += ":clamp";
+			if      (!clamp.x) options += ".y";
+			else if (!clamp.y) options += ".x";
 		}
-		return Signature("OpenGL texture", ss.str());
+		return options.empty() ?
+			Signature("OpenGL texture", image) :
+			Signature("OpenGL texture", image, options);
 	}
 
 	/*--------------------------+
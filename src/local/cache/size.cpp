@@ -0,0 +1,104 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include "../phys/Skin.hpp"
+#include "../res/type/Animation.hpp"
+#include "../res/type/Image.hpp"
+#ifdef USE_OPENGL
+#	include "../vid/opengl/Drawable.hpp"
+#	include "../vid/opengl/Texture.hpp"
+#endif
+#include "size.hpp"
+
+namespace page { namespace cache
+{
+	std::size_t GetSize(const phys::Skin &skin)
+	{
+		return
+			sizeof skin +
+			skin.bones.capacity() * sizeof *skin.bones.data() +
+			(skin.co.x.capacity() + skin.co.y.capacity() + skin.co.z.capacity() +
+			 skin.no.x.capacity() + skin.no.y.capacity() + skin.no.z.capacity()) * sizeof(float) +
+			(skin.boneIndices.capacity() + skin.weights.capacity()) * sizeof(std::uint16_t);
+	}
+
+	namespace
+	{
+		template <typename T> std::size_t GetSize(const res::Animation::Channel<T> &channel)
+		{
+			return
+				channel.frames.capacity() * sizeof *channel.frames.data() +
+				channel.packedFrames.capacity() * sizeof *channel.packedFrames.data();
+		}
+	}
+
+	std::size_t GetSize(const res::Animation &anim)
+	{
+		std::size_t size =
+			sizeof anim +
+			GetSize(anim.ambient)  + GetSize(anim.aspect)      + GetSize(anim.attenuation) +
+			GetSize(anim.cutoff)   + GetSize(anim.depth)       + GetSize(anim.diffuse)     +
+			GetSize(anim.exposure) + GetSize(anim.falloff)     + GetSize(anim.fov)         +
+			GetSize(anim.normal)   + GetSize(anim.opacity)     + GetSize(anim.orientation) +
+			GetSize(anim.position) + GetSize(anim.range)       + GetSize(anim.scale)       +
+			GetSize(anim.size)     + GetSize(anim.specular)    + GetSize(anim.texCoord)    +
+			GetSize(anim.volume);
+		for (const auto &kv : anim.bones)
+			size +=
+				sizeof kv + kv.first.capacity() +
+				GetSize(kv.second.position) +
+				GetSize(kv.second.orientation) +
+				GetSize(kv.second.scale);
+		for (const auto &kv : anim.vertices)
+			size +=
+				sizeof kv +
+				GetSize(kv.second.position) +
+				GetSize(kv.second.normal) +
+				GetSize(kv.second.texCoord);
+		return size;
+	}
+
+	std::size_t GetSize(const res::Image &image)
+	{
+		return
+			sizeof image +
+			image.channels.capacity() * sizeof(res::Image::Channel) +
+			image.data.capacity();
+	}
+
+#ifdef USE_OPENGL
+	std::size_t GetSize(const vid::opengl::Drawable &drawable)
+	{
+		return drawable.GetMemorySize();
+	}
+
+	std::size_t GetSize(const vid::opengl::Texture &texture)
+	{
+		return sizeof texture + texture.GetMemorySize();
+	}
+#endif
+}}
@@ -0,0 +1,81 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_cache_size_hpp
+#   define page_local_cache_size_hpp
+
+#	include <cstddef> // size_t
+
+namespace page
+{
+	namespace phys { struct Skin; }
+	namespace res
+	{
+		struct Animation;
+		struct Image;
+	}
+#	ifdef USE_OPENGL
+	namespace vid
+	{
+		namespace opengl
+		{
+			struct Drawable;
+			struct Texture;
+		}
+	}
+#	endif
+}
+
+namespace page { namespace cache
+{
+	/**
+	 * @defgroup cache-size Cache size accounting
+	 *
+	 * Functions for estimating the amount of memory that is used by an object
+	 * in the cache, which is used to keep the cache within its budget.
+	 *
+	 * The generic implementation only accounts for the object itself.  Types
+	 * that own a significant amount of memory outside of the object should
+	 * provide an overload.
+	 *
+	 * @{
+	 */
+	template <typename T>
+		std::size_t GetSize(const T &);
+
+	std::size_t GetSize(const phys::Skin &);
+	std::size_t GetSize(const res::Animation &);
+	std::size_t GetSize(const res::Image &);
+#	ifdef USE_OPENGL
+	std::size_t GetSize(const vid::opengl::Drawable &);
+	std::size_t GetSize(const vid::opengl::Texture &);
+#	endif
+	///@}
+}}
+
+#	include "size.tpp"
+#endif
@@ -28,10 +28,12 @@
 #include <algorithm> // find
 #include <array>
 #include <cstdlib> // exit
+#include <exception>
 #include <iostream> // cout
 #include <tuple> // tie
 
 #include "../util/cpp.hpp" // STRINGIZE
+#include "../util/io/deserialize.hpp" // Deserialize
 #include "../util/path/filesystem.hpp" // Basename
 #include "../util/string/operations.hpp" // Partition
 #include "CmdlineParser.hpp"
@@ -48,9 +50,11 @@ namespace page { namespace cfg
 		/**
 		 * An array of the long options having arguments.
 		 */
-		const std::array<std::string, 1> longOptsWithArgs =
+		const std::array<std::string, 3> longOptsWithArgs =
 		{
-			"config"
+			"benchmark",
+			"config",
+			"headless"
 		};
 	}
 
@@ -113,8 +117,21 @@ namespace page { namespace cfg
 			const std::string
 				&opt(optArg.first),
 				&arg(optArg.second);
-			if      (opt == "-c" || opt == "--config")  cfgSources.push_back(arg);
-			if      (opt == "-d" || opt == "--data")    resSources.push_back(arg);
+			if      (opt == "--benchmark")              benchmark = arg;
+			else if (opt == "-c" || opt == "--config")  cfgSources.push_back(arg);
+			else if (opt == "-d" || opt == "--data")    resSources.push_back(arg);
+			else if (opt == "--headless")
+			{
+				try
+				{
+					util::Deserialize(arg, headlessTicks);
+				}
+				catch (const std::exception &)
+				{
+					PrintErrorInvalidArgument(arg0, opt, arg);
+				}
+				if (!headlessTicks) PrintErrorInvalidArgument(arg0, opt, arg);
+			}
 			else if (opt == "-h" || opt == "--help")    PrintUsage(arg0);
 			else if (opt == "-q" || opt == "--quiet")   cfgVars["log.quiet"] = "true";
 			else if (opt == "-s" || opt == "--sync")    cfgVars["log.sync"] = "true";
@@ -145,8 +162,10 @@ namespace page { namespace cfg
 	{
 		std::cout << "Usage: " << arg0 << " [options] [cvars] [archives]" << std::endl;
 		std::cout << "Options:" << std::endl;
+		std::cout << "  --benchmark=NAME   Run benchmark NAME instead of the game" << std::endl;
 		std::cout << "  -c --config=FILE   Read configuration from FILE" << std::endl;
 		std::cout << "  -d --data=FILE     Load content from FILE" << std::endl;
+		std::cout << "  --headless=TICKS   Run TICKS simulation ticks without a window" << std::endl;
 		std::cout << "  -h --help          Print command line usage information" << std::endl;
 		std::cout << "  -q --quiet         Suppress progress information" << std::endl;
 		std::cout << "  -s --sync          Synchronize stdout and stderr" << std::endl;
@@ -43,6 +43,24 @@ namespace page { namespace cfg
 		+----------*/
 
 		public:
+		/**
+		 * Returns the name of the benchmark to run instead of the game, or
+		 * an empty string if none was requested.
+		 */
+		const std::string &GetBenchmark() const
+		{
+			return benchmark;
+		}
+
+		/**
+		 * Returns the number of simulation ticks to run without a window
+		 * instead of the game, or 0 if none were requested.
+		 */
+		unsigned GetHeadlessTicks() const
+		{
+			return headlessTicks;
+		}
+
 		/**
 		 * @todo Use @c decltype(auto) in C++14.
 		 */
@@ -130,6 +148,16 @@ namespace page { namespace cfg
 		| data members |
 		+-------------*/
 
+		/**
+		 * The name of the benchmark to run.
+		 */
+		std::string benchmark;
+
+		/**
+		 * The number of simulation ticks to run without a window.
+		 */
+		unsigned headlessTicks = 0;
+
 		/**
 		 * A list of configuration sources.
 		 */
@@ -0,0 +1,135 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <map>
+#include <mutex> // lock_guard, mutex, unique_lock
+
+#include "Snapshot.hpp"
+#include "vars.hpp"
+
+namespace page { namespace cfg
+{
+	namespace
+	{
+		/**
+		 * The published snapshot, which is only accessed through
+		 * std::atomic_load and std::atomic_store.
+		 */
+		std::shared_ptr<const Snapshot> currentSnapshot;
+
+		/**
+		 * Prevents threads that read right after a variable has been set
+		 * from taking the same snapshot concurrently.
+		 */
+		std::mutex snapshotMutex;
+
+		/**
+		 * The functions added with AddSnapshotCallback, in the order that
+		 * they were added.
+		 */
+		std::map<unsigned, SnapshotCallback> snapshotCallbacks;
+		unsigned nextSnapshotCallbackId = 0;
+
+		/**
+		 * Protects the callbacks, and serializes calls to them.
+		 */
+		std::mutex snapshotCallbackMutex;
+
+		/**
+		 * Calls the callbacks with a snapshot that was just published,
+		 * unless it has already been replaced by a newer one, whose
+		 * publisher will call them instead.
+		 *
+		 * @note Called without holding snapshotMutex, so that a callback can
+		 *       read a variable that has been set again meanwhile.
+		 */
+		void NotifySnapshot(const std::shared_ptr<const Snapshot> &snapshot)
+		{
+			std::lock_guard<std::mutex> lock(snapshotCallbackMutex);
+			if (std::atomic_load(&currentSnapshot) != snapshot) return;
+			for (const auto &callback : snapshotCallbacks)
+				callback.second(*snapshot);
+		}
+	}
+
+	std::shared_ptr<const Snapshot> LoadSnapshot()
+	{
+		auto generation = BasicVar::GetGeneration();
+		auto snapshot(std::atomic_load(&currentSnapshot));
+		if (snapshot && snapshot->GetGeneration() == generation) return snapshot;
+
+		std::unique_lock<std::mutex> lock(snapshotMutex);
+		snapshot = std::atomic_load(&currentSnapshot);
+		if (snapshot && snapshot->GetGeneration() == generation) return snapshot;
+
+		// NOTE: if a variable is set while copying, the copies may be newer
+		// than the generation, which only causes another snapshot
+		auto newSnapshot(std::make_shared<Snapshot>());
+		newSnapshot->generation         = generation;
+		newSnapshot->cacheBudget        = *CVAR(cacheBudget);
+		newSnapshot->debugDrawBounds    = *CVAR(debugDrawBounds);
+		newSnapshot->debugDrawCollision = *CVAR(debugDrawCollision);
+		newSnapshot->debugDrawSkeleton  = *CVAR(debugDrawSkeleton);
+		newSnapshot->debugDrawTrack     = *CVAR(debugDrawTrack);
+		newSnapshot->logCache           = *CVAR(logCache);
+		newSnapshot->logCacheUpdate     = *CVAR(logCacheUpdate);
+		newSnapshot->logVerbose         = *CVAR(logVerbose);
+		newSnapshot->resourceExcludes   = *CVAR(resourceExcludes);
+
+#ifdef USE_OPENGL
+		newSnapshot->renderGlow        = *CVAR(renderGlow);
+		newSnapshot->renderMedian      = *CVAR(renderMedian);
+		newSnapshot->renderMedianLevel = *CVAR(renderMedianLevel);
+		newSnapshot->renderMultipass   = *CVAR(renderMultipass);
+		newSnapshot->renderOutline     = *CVAR(renderOutline);
+		newSnapshot->renderShader      = *CVAR(renderShader);
+		newSnapshot->renderShadow      = *CVAR(renderShadow);
+		newSnapshot->renderShadowBlur  = *CVAR(renderShadowBlur);
+#endif
+
+		snapshot = newSnapshot;
+		std::atomic_store(&currentSnapshot, snapshot);
+		lock.unlock();
+
+		NotifySnapshot(snapshot);
+		return snapshot;
+	}
+
+	unsigned AddSnapshotCallback(const SnapshotCallback &callback)
+	{
+		std::lock_guard<std::mutex> lock(snapshotCallbackMutex);
+		auto id = nextSnapshotCallbackId++;
+		snapshotCallbacks.emplace(id, callback);
+		return id;
+	}
+
+	void RemoveSnapshotCallback(unsigned id)
+	{
+		std::lock_guard<std::mutex> lock(snapshotCallbackMutex);
+		snapshotCallbacks.erase(id);
+	}
+}}
@@ -0,0 +1,157 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_cfg_Snapshot_hpp
+#   define page_local_cfg_Snapshot_hpp
+
+#	include <functional> // function
+#	include <memory> // shared_ptr
+#	include <vector>
+
+#	include <boost/regex.hpp>
+
+namespace page { namespace cfg
+{
+	/**
+	 * Plain copies of the configuration variables that are read in hot code,
+	 * which avoid the filter call and the copy made by @c Var::Get.
+	 *
+	 * A snapshot is never modified after it is published.  When a variable
+	 * has been set, which is detected by comparing generations, a new
+	 * snapshot is taken and swapped in atomically, so that threads that are
+	 * still reading the old one, such as the loader workers, are unaffected.
+	 *
+	 * @note To access the value of a variable, use:
+	 *       @code CSNAP(name) @endcode
+	 */
+	class Snapshot
+	{
+		/*------------------------+
+		| configuration variables |
+		+------------------------*/
+
+		public:
+		unsigned cacheBudget = 0;
+		bool debugDrawBounds = false;
+		bool debugDrawCollision = false;
+		bool debugDrawSkeleton = false;
+		bool debugDrawTrack = false;
+		bool logCache = false;
+		bool logCacheUpdate = false;
+		bool logVerbose = false;
+		std::vector<boost::regex> resourceExcludes;
+
+#	ifdef USE_OPENGL
+		bool renderGlow = false;
+		bool renderMedian = false;
+		unsigned renderMedianLevel = 0;
+		bool renderMultipass = false;
+		bool renderOutline = false;
+		bool renderShader = false;
+		bool renderShadow = false;
+		bool renderShadowBlur = false;
+#	endif
+
+		/*----------+
+		| observers |
+		+----------*/
+
+		public:
+		/**
+		 * @return The generation of the configuration variables that the
+		 *         copies were taken from.
+		 *
+		 * @sa BasicVar::GetGeneration
+		 */
+		unsigned GetGeneration() const;
+
+		/*-------------+
+		| data members |
+		+-------------*/
+
+		private:
+		friend std::shared_ptr<const Snapshot> LoadSnapshot();
+
+		/**
+		 * The generation of the variables when the copies were taken.
+		 */
+		unsigned generation = 0;
+	};
+
+	/**
+	 * @return The current global snapshot, which is taken again if a
+	 *         configuration variable has been set since it was last taken.
+	 *
+	 * @note The calling thread keeps the returned snapshot alive until its
+	 *       next call.  Copy the pointer to keep a snapshot across calls,
+	 *       such as while iterating over one of its containers.
+	 */
+	const std::shared_ptr<const Snapshot> &GetSnapshot();
+
+	/**
+	 * @return The current global snapshot, after taking it again if a
+	 *         configuration variable has been set.  Use GetSnapshot(), which
+	 *         only calls this when the generation has changed.
+	 */
+	std::shared_ptr<const Snapshot> LoadSnapshot();
+
+	/**
+	 * A function that is called with each new snapshot.
+	 */
+	typedef std::function<void (const Snapshot &)> SnapshotCallback;
+
+	/**
+	 * Adds a function to be called with each new snapshot after it has been
+	 * published.
+	 *
+	 * @return An identifier for @c RemoveSnapshotCallback.
+	 *
+	 * @note The function is called on the thread that took the snapshot,
+	 *       which may be a loader worker, but never concurrently with
+	 *       another callback.  If snapshots are taken in quick succession,
+	 *       only the newest one may be passed.  The function may read
+	 *       variables, but must not add or remove callbacks.
+	 */
+	unsigned AddSnapshotCallback(const SnapshotCallback &);
+
+	/**
+	 * Removes a function that was added with @c AddSnapshotCallback.
+	 */
+	void RemoveSnapshotCallback(unsigned id);
+}}
+
+	/**
+	 * @return The value of the specified configuration variable from the
+	 *         global @c Snapshot.
+	 *
+	 * @note Only the variables that are copied into @c Snapshot are
+	 *       available.  Use @c CVAR for the others, and to set a variable.
+	 */
+#	define CSNAP(x) (::page::cfg::GetSnapshot()->x)
+
+#	include "Snapshot.tpp"
+#endif
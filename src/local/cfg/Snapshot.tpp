@@ -0,0 +1,51 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include "var/BasicVar.hpp" // BasicVar::GetGeneration
+
+namespace page { namespace cfg
+{
+	// NOTE: inline because it is called on every access
+	inline const std::shared_ptr<const Snapshot> &GetSnapshot()
+	{
+		// each thread keeps its own reference, so that an access doesn't
+		// touch the shared reference count unless the snapshot has changed
+		thread_local std::shared_ptr<const Snapshot> snapshot;
+		if (!snapshot || snapshot->GetGeneration() != BasicVar::GetGeneration())
+			snapshot = LoadSnapshot();
+		return snapshot;
+	}
+
+	/*----------+
+	| observers |
+	+----------*/
+
+	inline unsigned Snapshot::GetGeneration() const
+	{
+		return generation;
+	}
+}}
@@ -99,6 +99,18 @@ namespace page { namespace cfg
 			return value * 100;
 		}
 
+		/*-------------------------+
+		| clip.queue.depth filters |
+		+-------------------------*/
+
+		/**
+		 * Ensures that @c clip.queue.depth has room for at least one frame.
+		 */
+		unsigned SetClipQueueDepth(unsigned value)
+		{
+			return std::max(value, 1u);
+		}
+
 		/*---------------------+
 		| install.path filters |
 		+---------------------*/
@@ -123,6 +135,19 @@ namespace page { namespace cfg
 			return util::AbsolutePath(path, *installPath);
 		}
 
+		/*----------------------------+
+		| resource.index.path filters |
+		+----------------------------*/
+
+		/**
+		 * Returns @c resource.index.path as an absolute path, unless it is
+		 * empty.
+		 */
+		std::string GetResourceIndexPath(const std::string &path, const Var<std::string> &installPath)
+		{
+			return !path.empty() ? util::AbsolutePath(path, *installPath) : path;
+		}
+
 		/*-----------------------------+
 		| screenshot.file.path filters |
 		+-----------------------------*/
@@ -131,6 +156,30 @@ namespace page { namespace cfg
 		{
 			return util::AbsolutePath(path, *installPath);
 		}
+
+		/*----------------------+
+		| sim.max.ticks filters |
+		+----------------------*/
+
+		/**
+		 * Ensures that @c sim.max.ticks allows at least one tick per frame.
+		 */
+		unsigned SetSimMaxTicks(unsigned value)
+		{
+			return std::max(value, 1u);
+		}
+
+		/*----------------------+
+		| sim.tick.rate filters |
+		+----------------------*/
+
+		/**
+		 * Limits @c sim.tick.rate to a reasonable range.
+		 */
+		float SetSimTickRate(float value)
+		{
+			return std::min(std::max(value, 1.f), 1000.f);
+		}
 	}
 
 	/*-------------+
@@ -138,11 +187,17 @@ namespace page { namespace cfg
 	+-------------*/
 
 	CommonState::CommonState() :
+		animationCompress  (*this, "animation.compress",    false),
+		animationTolerance (*this, "animation.tolerance",   .001f),
 		audioVolume        (*this, "audio.volume",          1),
+		cacheBudget        (*this, "cache.budget",          256),
+		clipDropFrames     (*this, "clip.drop.frames",      false),
 		clipFilePath       (*this, "clip.file.path",        "clip-%i",                 std::bind(GetClipFilePath, std::placeholders::_1, installPath)),
 		clipFormat         (*this, "clip.format",           ""),
 		clipFramerate      (*this, "clip.framerate",        30,                        nullptr, SetClipFrameRate),
 		clipQuality        (*this, "clip.quality",          .75f,                      nullptr, SetClipQuality, ConvertInClipQuality, ConvertOutClipQuality),
+		clipQueueDepth     (*this, "clip.queue.depth",      8,                         nullptr, SetClipQueueDepth),
+		clipThreads        (*this, "clip.threads",          2),
 		clipVideoResolution(*this, "clip.video.resolution", {480, 360}),
 		debugDrawBounds    (*this, "debug.draw.bounds",     false),
 		debugDrawCollision (*this, "debug.draw.collision",  false),
@@ -150,6 +205,7 @@ namespace page { namespace cfg
 		debugDrawSkeleton  (*this, "debug.draw.skeleton",   false),
 		debugDrawTrack     (*this, "debug.draw.track",      false),
 		installPath        (*this, "install.path",          "",                        GetInstallPath),
+		logAsync           (*this, "log.async",             false),
 		logCache           (*this, "log.cache",             false),
 		logCacheUpdate     (*this, "log.cache.update",      false),
 		logConsole         (*this, "log.console",           LOG_CONSOLE_DEFAULT),
@@ -164,10 +220,15 @@ namespace page { namespace cfg
 		logTimeChange      (*this, "log.time.change",       true),
 		logVerbose         (*this, "log.verbose",           LOG_VERBOSE_DEFAULT),
 		resourceExcludes   (*this, "resource.excludes",     {}),
+		resourceIndexPath  (*this, "resource.index.path",   "resource.index",          std::bind(GetResourceIndexPath, std::placeholders::_1, installPath)),
+		resourceLoadThreads(*this, "resource.load.threads", 2),
 		resourceSources    (*this, "resource.sources",      {"data"}),
 		screenshotFilePath (*this, "screenshot.file.path",  "screenshot-%i",           std::bind(GetScreenshotFilePath, std::placeholders::_1, installPath)),
 		screenshotFormat   (*this, "screenshot.format",     ""),
 		screenshotSize     (*this, "screenshot.size",       {800, 600}),
+		simMaxTicks        (*this, "sim.max.ticks",         5,                         nullptr, SetSimMaxTicks),
+		simTickRate        (*this, "sim.tick.rate",         60,                        nullptr, SetSimTickRate),
+		skinThreads        (*this, "skin.threads",          2),
 		videoRefresh       (*this, "video.refresh",         0),
 		videoResolution    (*this, "video.resolution",      {640, 480}),
 		windowFullscreen   (*this, "window.fullscreen",     false),
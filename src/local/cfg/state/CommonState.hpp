@@ -52,12 +52,39 @@ namespace page { namespace cfg
 		| configuration variables |
 		+------------------------*/
 
+		/**
+		 * A configuration variable specifying whether to compress animations
+		 * when they are loaded, by removing redundant frames and quantizing
+		 * the orientations and vectors.
+		 */
+		Var<bool>                                    animationCompress;
+
+		/**
+		 * A configuration variable specifying the largest error that the
+		 * animation compression can introduce, in the units of each channel,
+		 * or in radians for orientations.
+		 */
+		Var<float>                                   animationTolerance;
+
 		/**
 		 * A configuration variable specifying the master audio volume in
 		 * decibels.
 		 */
 		Var<float>                                   audioVolume;
 
+		/**
+		 * A configuration variable specifying the amount of memory, in
+		 * megabytes, that the cache will try to stay within.  A value of 0
+		 * means that there is no limit.
+		 */
+		Var<unsigned>                                cacheBudget;
+
+		/**
+		 * A configuration variable specifying whether to drop frames when
+		 * recording, rather than waiting, when the encoder falls behind.
+		 */
+		Var<bool>                                    clipDropFrames;
+
 		/**
 		 * A configuration variable specifying the file path for in-game
 		 * recordings.  If it is a relative path, it is interpreted as being
@@ -87,6 +114,20 @@ namespace page { namespace cfg
 		 */
 		Var<float, int>                              clipQuality;
 
+		/**
+		 * A configuration variable specifying the number of frames that can
+		 * be waiting to be encoded when recording.
+		 */
+		Var<unsigned>                                clipQueueDepth;
+
+		/**
+		 * A configuration variable specifying the number of worker threads
+		 * for converting frames to the color space of the encoder when
+		 * recording.  A value of 0 means that frames are converted on the
+		 * encoding thread.
+		 */
+		Var<unsigned>                                clipThreads;
+
 		/**
 		 * A configuration variable specifying the video resolution for in-game
 		 * recordings.
@@ -130,6 +171,12 @@ namespace page { namespace cfg
 		 */
 		Var<std::string>                             installPath;
 
+		/**
+		 * A configuration variable specifying whether to write the log from a
+		 * background thread, so that logging doesn't hold up the game.
+		 */
+		Var<bool>                                    logAsync;
+
 		/**
 		 * A configuration variable specifying whether to include cache events
 		 * in the log.
@@ -217,6 +264,20 @@ namespace page { namespace cfg
 		 */
 		Var<std::vector<boost::regex>>               resourceExcludes;
 
+		/**
+		 * A configuration variable specifying the path of the file that
+		 * stores the resource index between runs.  If it is a relative path,
+		 * it is interpreted as being relative to @c installPath.  An empty
+		 * path disables the persistent index.
+		 */
+		Var<std::string>                             resourceIndexPath;
+
+		/**
+		 * A configuration variable specifying the number of threads for
+		 * loading resources in the background.
+		 */
+		Var<unsigned>                                resourceLoadThreads;
+
 		/**
 		 * A configuration variable specifying a list of resource sources.
 		 */
@@ -242,6 +303,28 @@ namespace page { namespace cfg
 		 */
 		Var<math::Vec2u>                             screenshotSize;
 
+		/**
+		 * A configuration variable specifying the maximum number of
+		 * simulation ticks to run in a single frame when catching up after a
+		 * slow frame.  Any remaining time is dropped, which slows down the
+		 * simulation rather than letting it fall further behind.
+		 */
+		Var<unsigned>                                simMaxTicks;
+
+		/**
+		 * A configuration variable specifying the number of simulation ticks
+		 * per second.  The simulation always advances by the same time step,
+		 * independent of the frame rate.
+		 */
+		Var<float>                                   simTickRate;
+
+		/**
+		 * A configuration variable specifying the number of worker threads
+		 * for skinning large meshes.  A value of 0 means that meshes are
+		 * skinned on the calling thread.
+		 */
+		Var<unsigned>                                skinThreads;
+
 		/**
 		 * A configuration variable specifying the video refresh rate.  A value
 		 * of 0 means to use the default refresh rate.
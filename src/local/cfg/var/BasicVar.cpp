@@ -33,6 +33,8 @@
 
 namespace page { namespace cfg
 {
+	std::atomic<unsigned> BasicVar::generation{0};
+
 	/*-------------+
 	| constructors |
 	+-------------*/
@@ -64,6 +66,16 @@ namespace page { namespace cfg
 		return ss.str();
 	}
 
+	/*----------+
+	| modifiers |
+	+----------*/
+
+	void BasicVar::MarkModified()
+	{
+		modified = true;
+		generation.fetch_add(1, std::memory_order_release);
+	}
+
 	/*---------+
 	| ordering |
 	+---------*/
@@ -28,6 +28,7 @@
 #ifndef    page_local_cfg_var_BasicVar_hpp
 #   define page_local_cfg_var_BasicVar_hpp
 
+#	include <atomic>
 #	include <iosfwd> // {,w}[io]stream
 #	include <istream> // basic_istream
 #	include <ostream> // basic_ostream
@@ -83,6 +84,11 @@ namespace page { namespace cfg
 		 */
 		bool IsModified() const;
 
+		/**
+		 * @return @copydoc generation
+		 */
+		static unsigned GetGeneration();
+
 		/*----------+
 		| modifiers |
 		+----------*/
@@ -100,6 +106,12 @@ namespace page { namespace cfg
 		 */
 		void ClearModified();
 
+		protected:
+		/**
+		 * Sets the variable's "modified" state and advances the generation.
+		 */
+		void MarkModified();
+
 		/*--------------+
 		| serialization |
 		+--------------*/
@@ -137,6 +149,13 @@ namespace page { namespace cfg
 		 * @c true if the configuration variable been modified.
 		 */
 		bool modified;
+
+		private:
+		/**
+		 * A number which changes whenever any configuration variable is set,
+		 * so that copies of their values can tell when they are out of date.
+		 */
+		static std::atomic<unsigned> generation;
 	};
 
 	/*---------+
@@ -27,6 +27,16 @@
 
 namespace page { namespace cfg
 {
+	/*----------+
+	| observers |
+	+----------*/
+
+	// NOTE: inline because it is checked on every snapshot access
+	inline unsigned BasicVar::GetGeneration()
+	{
+		return generation.load(std::memory_order_acquire);
+	}
+
 	/*----------------------------+
 	| stream insertion/extraction |
 	+----------------------------*/
@@ -89,7 +89,7 @@ namespace page { namespace cfg
 		void Var<T, ExternT>::Set(const T &value)
 	{
 		this->value = setFilter(value);
-		modified = true;
+		MarkModified();
 	}
 
 	template <typename T, typename ExternT>
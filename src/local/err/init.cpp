@@ -29,7 +29,7 @@
 #include <exception> // set_terminate, set_unexpected
 #include <iostream> // cerr
 
-#include "../log/manip.hpp" // Clear
+#include "../log/manip.hpp" // Clear, Sync
 #include "../util/gcc/init_priority.hpp" // LOG_INIT_PRIORITY
 #include "../wnd/message.hpp" // Message
 
@@ -37,14 +37,14 @@ namespace page { namespace err { namespace
 {
 	void unexpected()
 	{
-		std::cerr << log::Clear;
+		std::cerr << log::Clear << log::Sync;
 		wnd::Message("unexpected exception", wnd::MessageType::error);
 		std::abort();
 	}
 
 	void terminate()
 	{
-		std::cerr << log::Clear;
+		std::cerr << log::Clear << log::Sync;
 		wnd::Message("abnormal termination", wnd::MessageType::error);
 		std::abort();
 	}
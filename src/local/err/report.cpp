@@ -31,7 +31,7 @@
 #include <boost/exception/diagnostic_information.hpp>
 
 #include "../log/Indenter.hpp"
-#include "../log/manip.hpp" // Error, Warning
+#include "../log/manip.hpp" // Error, Sync, Warning
 #include "../wnd/message.hpp" // Message
 
 namespace page { namespace err
@@ -41,7 +41,9 @@ namespace page { namespace err
 		std::cerr << log::Error << '\n';
 		log::Indenter indenter;
 		auto info = boost::diagnostic_information(e);
-		std::cerr << info << std::endl;
+		// make sure that the error is in the log before showing it, in case
+		// the program doesn't survive
+		std::cerr << info << std::endl << log::Sync;
 		wnd::Message(info, wnd::MessageType::error);
 	}
 
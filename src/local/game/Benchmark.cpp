@@ -0,0 +1,1805 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // max, min
+#include <chrono> // steady_clock
+#include <cmath> // asin, sin
+#include <cstdlib> // abs
+#include <functional> // function
+#include <iostream> // cout
+#include <map>
+#include <memory> // {shared,unique}_ptr
+#include <ostream>
+#include <random> // mt19937, uniform_{int,real}_distribution
+#include <thread> // this_thread::sleep_{for,until}, thread
+#include <utility> // pair
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp> // ofstream
+#include <boost/filesystem/operations.hpp> // create_directories, remove{,_all}, temp_directory_path, unique_path
+
+#include "../aud/DecodedStream.hpp"
+#include "../cache/Cache.hpp" // Cache::{GetSize,Update}
+#include "../cache/size.hpp" // GetSize
+#include "../cache/proxy/Proxy.hpp"
+#include "../cache/proxy/ResourceProxy.hpp"
+#include "../cfg/Snapshot.hpp"
+#include "../cfg/vars.hpp"
+#include "../err/Exception.hpp"
+#include "../gui/widget/container/ArrayContainer.hpp"
+#include "../log/AsyncQueue.hpp"
+#include "../log/filter/IndentFilter.hpp"
+#include "../log/filter/IndentFilterState.hpp"
+#include "../log/filter/TimeFilter.hpp"
+#include "../log/Indenter.hpp"
+#include "../log/sink/Sink.hpp"
+#include "../log/stream/AsyncStream.hpp"
+#include "../math/algorithm.hpp" // GetSimdLevel, RgbLayout, RgbToYcbcr420, SimdLevel
+#include "../math/Euler.hpp"
+#include "../math/Quat.hpp"
+#include "../phys/attrib/Pose.hpp"
+#include "../phys/controller/AnimationController.hpp"
+#include "../phys/controller/animation/Interpolator.hpp"
+#include "../phys/node/Body.hpp"
+#include "../phys/node/Emitter.hpp"
+#include "../phys/node/Form.hpp"
+#include "../phys/ParticlePool.hpp" // GetInstances, ParticleInstance
+#include "../phys/Scene.hpp"
+#include "../phys/Skin.hpp"
+#include "../res/clip/Stream.hpp"
+#include "../res/Index.hpp"
+#include "../res/source/DirectorySource.hpp"
+#include "../res/source/IndexCache.hpp"
+#include "../res/type/Animation.hpp"
+#include "../res/type/Character.hpp"
+#include "../res/type/Gait.hpp"
+#include "../res/type/Mesh.hpp"
+#include "../res/type/Model.hpp"
+#include "../res/type/Scene.hpp"
+#include "../res/type/Skeleton.hpp"
+#include "../res/type/Theme.hpp"
+#include "../res/type/sound/AudioStream.hpp"
+#include "../res/type/Font.hpp"
+#include "../res/type/Image.hpp"
+#include "../res/type/Track.hpp"
+#include "../sys/info.hpp" // GetPeakMemoryUsage
+#include "../util/class/Monostate.hpp" // GLOBAL
+#include "../util/thread/WorkerPool.hpp"
+#include "../vid/GlyphAtlas.hpp"
+#include "../vid/TextLayout.hpp" // GetTextVertices, LayoutText, TextLayoutCache, TextVertex
+#include "Benchmark.hpp"
+#include "Character.hpp"
+
+namespace page { namespace game
+{
+	namespace
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		/**
+		 * Returns the average number of microseconds that each call to @a f
+		 * takes over @a iterations calls.
+		 */
+		template <typename F>
+			double Time(unsigned iterations, F f)
+		{
+			auto start(Clock::now());
+			for (unsigned i = 0; i < iterations; ++i) f();
+			return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations;
+		}
+
+		/*--------------+
+		| gui benchmark |
+		+--------------*/
+
+		/**
+		 * A widget with a fixed size, standing in for an inventory slot or a
+		 * line of dialogue, which doesn't need any resources.
+		 */
+		class FixedWidget : public gui::Widget
+		{
+			IMPLEMENT_CLONEABLE(FixedWidget, gui::Widget)
+
+			public:
+			explicit FixedWidget(const math::Vec2 &size) : size(size) {}
+
+			private:
+			WidgetSize CalcSize(const res::Theme &) const override
+			{
+				return WidgetSize(size);
+			}
+			void DoDraw(gui::DrawContext &) const override {}
+
+			math::Vec2 size;
+		};
+
+		/**
+		 * Checks the layout and hit-testing of an inventory grid and a
+		 * dialogue log with thousands of widgets, including relayout after
+		 * a leaf changes size, and then times them.
+		 */
+		void RunGuiBenchmark()
+		{
+			const unsigned
+				iterations = 100,
+				picks      = 10000;
+
+			res::Theme theme;
+			theme.scale  = 1;
+			theme.margin = .01;
+
+			// an inventory grid of slots, and a dialogue log of lines with a
+			// portrait beside each one
+			// the leaves in the middle of each container are invalidated to
+			// measure relayout
+			const unsigned rows = 50, columns = 40, lines = 2000;
+			gui::ArrayContainer inventory(false), dialogue(false);
+			std::shared_ptr<FixedWidget> inventoryLeaf, dialogueLeaf;
+			for (unsigned row = 0; row < rows; ++row)
+			{
+				auto slots(std::make_shared<gui::ArrayContainer>(true));
+				for (unsigned column = 0; column < columns; ++column)
+				{
+					auto slot(std::make_shared<FixedWidget>(math::Vec2(.1)));
+					if (row == rows / 2 && column == columns / 2) inventoryLeaf = slot;
+					slots->Insert(slot);
+				}
+				inventory.Insert(slots);
+			}
+			for (unsigned line = 0; line < lines; ++line)
+			{
+				auto entry(std::make_shared<gui::ArrayContainer>(true));
+				auto text(std::make_shared<FixedWidget>(math::Vec2(2, .05 * (1 + line % 3))));
+				if (line == lines / 2) dialogueLeaf = text;
+				entry->Insert(FixedWidget(math::Vec2(.2)));
+				entry->Insert(text);
+				dialogue.Insert(entry);
+			}
+
+			std::cout << "conformance" << std::endl;
+			{
+				log::Indenter indenter;
+				unsigned cases = 0, failures = 0;
+				auto Check([&](const std::string &name, bool passed)
+				{
+					++cases;
+					if (!passed)
+					{
+						++failures;
+						std::cout << "failed: " << name << std::endl;
+					}
+				});
+				// layout accumulates rounding error in proportion to the
+				// distance from the container's origin
+				auto IsNear([](const math::Vec2 &a, const math::Vec2 &b, float distance)
+				{
+					return All(Abs(a - b) <= std::max(distance, 1.f) * 1e-4f);
+				});
+				const float pitch = .1 + theme.margin;
+				const math::Vec2 inventorySize(
+					columns * pitch - theme.margin,
+					rows    * pitch - theme.margin);
+
+				// the containers are as big as their children and margins
+				const math::Vec2 dialogueSize(
+					.2 + theme.margin + 2,
+					lines * (.2 + theme.margin) - theme.margin);
+				Check("inventory size", IsNear(inventory.GetSize(theme).minSize, inventorySize, Max(inventorySize)));
+				Check("dialogue size", IsNear(dialogue.GetSize(theme).minSize, dialogueSize, Max(dialogueSize)));
+
+				// picking goes down to the leaf, and reports the position
+				// relative to it
+				math::Vec2 pos, hitPos;
+				pos = math::Vec2(columns / 2, rows / 2) * pitch + .025;
+				Check("pick inventory slot",
+					inventory.Pick(pos, theme, &hitPos) == inventoryLeaf.get() &&
+					IsNear(hitPos, math::Vec2(.025), Max(pos)));
+				pos = math::Vec2(.2 + theme.margin + 1, lines / 2 * (.2 + theme.margin) + .05);
+				Check("pick dialogue line",
+					dialogue.Pick(pos, theme, &hitPos) == dialogueLeaf.get() &&
+					IsNear(hitPos, math::Vec2(1, .05), Max(pos)));
+
+				// the margin between slots belongs to the row
+				gui::Widget *gap = inventory.Pick(math::Vec2(columns / 2 * pitch - theme.margin / 2, rows / 2 * pitch + .05), theme);
+				Check("pick margin", gap && gap != &inventory && !dynamic_cast<FixedWidget *>(gap));
+
+				// resizing a leaf lays out its ancestors again
+				inventoryLeaf->SetMinSize(math::Vec2(.2));
+				Check("relayout after growing a leaf", IsNear(inventory.GetSize(theme).minSize, inventorySize + .1f, Max(inventorySize)));
+				inventoryLeaf->SetMinSize(math::Vec2(0));
+				Check("relayout after shrinking a leaf", IsNear(inventory.GetSize(theme).minSize, inventorySize, Max(inventorySize)));
+
+				std::cout << "cases: " << cases << std::endl;
+				std::cout << "failures: " << failures << std::endl;
+				if (failures)
+					THROW((err::Exception<err::GameModuleTag>("gui layout or picking is wrong")))
+			}
+
+			const std::pair<gui::ArrayContainer *, gui::Widget *> cases[] =
+			{
+				{&inventory, inventoryLeaf.get()},
+				{&dialogue,  dialogueLeaf.get()}
+			};
+			for (const auto &pair : cases)
+			{
+				gui::ArrayContainer *container = pair.first;
+				gui::Widget *leaf = pair.second;
+				double coldTime = Time(iterations, [&]
+				{
+					gui::Widget::InvalidateAllLayouts();
+					container->GetSize(theme);
+				});
+				double warmTime = Time(iterations, [&]
+				{
+					container->GetSize(theme);
+				});
+				math::Vec2 size(container->GetSize(theme).minSize);
+				double leafTime = Time(iterations, [&]
+				{
+					leaf->InvalidateLayout();
+					container->GetSize(theme);
+				});
+				std::mt19937 random;
+				std::uniform_real_distribution<float>
+					xDistribution(0, size.x),
+					yDistribution(0, size.y);
+				std::size_t hits = 0;
+				double pickTime = Time(picks, [&]
+				{
+					math::Vec2 pos(xDistribution(random), yDistribution(random));
+					if (container->Pick(pos, theme) != container) ++hits;
+				});
+
+				std::cout << (container == &inventory ? "inventory" : "dialogue") << std::endl;
+				log::Indenter indenter;
+				std::cout << "cold layout: " << coldTime << "us" << std::endl;
+				std::cout << "cached layout: " << warmTime << "us" << std::endl;
+				std::cout << "layout after invalidating a leaf: " << leafTime << "us" << std::endl;
+				std::cout << "pick: " << pickTime << "us (" << hits * 100. / picks << "% hits)" << std::endl;
+			}
+		}
+
+		/*----------------+
+		| index benchmark |
+		+----------------*/
+
+		/**
+		 * Indexes a generated directory tree without the persistent index,
+		 * as on the first run, and again with it, as on later runs.
+		 */
+		void RunIndexBenchmark()
+		{
+			namespace fs = boost::filesystem;
+			const unsigned
+				directories = 40,
+				iterations  = 5;
+
+			res::IndexCache &cache(GLOBAL(res::IndexCache));
+			for (unsigned files : {1000, 10000})
+			{
+				fs::path root(fs::temp_directory_path() / fs::unique_path());
+				fs::path cachePath(root.string() + ".index");
+				for (unsigned i = 0; i < files; ++i)
+				{
+					fs::path directory(root / std::to_string(i % directories));
+					fs::create_directories(directory);
+					fs::ofstream(directory / (std::to_string(i) + ".txt")) << "resource " << i << std::endl;
+				}
+
+				double cold = Time(iterations, [&]
+				{
+					cache.Clear();
+					res::DirectorySource source(root.string());
+				});
+				cache.Save(cachePath.string());
+				double warm = Time(iterations, [&]
+				{
+					cache.Load(cachePath.string());
+					res::DirectorySource source(root.string());
+				});
+				cache.Clear();
+				fs::remove_all(root);
+				fs::remove(cachePath);
+
+				std::cout << "files " << files << std::endl;
+				log::Indenter indenter;
+				std::cout << "cold startup: " << cold / 1000 << "ms" << std::endl;
+				std::cout << "warm startup: " << warm / 1000 << "ms" << std::endl;
+			}
+		}
+
+		/*-------------------+
+		| particle benchmark |
+		+-------------------*/
+
+		/**
+		 * Runs an emitter at a steady population of particles and measures
+		 * how quickly it can update them and pack them for the renderer.
+		 */
+		void RunParticleBenchmark()
+		{
+			const float
+				minLifetime = 1,
+				maxLifetime = 3,
+				frameTime   = 1.f / 60;
+			const unsigned frames = 120;
+
+			for (unsigned count : {10000, 100000, 1000000})
+			{
+				phys::Emitter emitter;
+				emitter.SetLifetimeRange(minLifetime, maxLifetime);
+				emitter.SetSpeedRange(1, 5);
+				emitter.SetSizeRange(.05, .2);
+				emitter.SetCutoff(30);
+				emitter.SetAcceleration(math::Vec3(0, -9.8, 0));
+				emitter.SetDrag(.1);
+				emitter.SetRate(count / ((minLifetime + maxLifetime) / 2));
+
+				// warm up until the population is steady
+				for (float time = 0; time < maxLifetime * 2; time += frameTime)
+					emitter.Update(frameTime);
+
+				std::size_t particles = 0;
+				double updateTime = Time(frames, [&]
+				{
+					emitter.Update(frameTime);
+					particles += emitter.GetParticles().GetSize();
+				});
+				std::vector<phys::ParticleInstance> instances;
+				double instanceTime = Time(frames, [&]
+				{
+					instances.clear();
+					phys::GetInstances(emitter.GetParticles(), instances);
+				});
+
+				double average = double(particles) / frames;
+				std::cout << "particles " << count << std::endl;
+				log::Indenter indenter;
+				std::cout << "live particles (average): " << average << std::endl;
+				std::cout << "update: " << updateTime << "us (" << average / updateTime * 1000 << " particles/ms)" << std::endl;
+				std::cout << "instance stream: " << instanceTime << "us (" << average / instanceTime * 1000 << " particles/ms)" << std::endl;
+			}
+		}
+
+		/*---------------+
+		| skin benchmark |
+		+---------------*/
+
+		/**
+		 * The per-vertex skinning path that was used before @c phys::Skin
+		 * was packed, which looks up the skinning matrices of every influence
+		 * of every vertex.  It is kept here as a baseline.
+		 */
+		struct LegacySkin
+		{
+			LegacySkin(const res::Mesh &mesh, const phys::attrib::Pose &pose)
+			{
+				vertices.reserve(mesh.vertices.size());
+				for (const auto &meshVertex : mesh.vertices)
+				{
+					Vertex vertex = {meshVertex.co, meshVertex.no};
+					for (const auto &meshInfluence : meshVertex.influences)
+						if (const phys::attrib::Pose::Bone *bone = pose.GetBone(*meshInfluence.bone))
+							vertex.influences.push_back({bone, meshInfluence.weight});
+					vertices.push_back(vertex);
+				}
+			}
+
+			void Update(std::vector<math::Vec3> &co, std::vector<math::Vec3> &no) const
+			{
+				for (std::size_t i = 0; i < vertices.size(); ++i)
+				{
+					const Vertex &vertex(vertices[i]);
+					co[i] = no[i] = 0;
+					float weight = 1;
+					for (const auto &influence : vertex.influences)
+					{
+						co[i] += influence.bone->GetSkinMatrix() * vertex.co * influence.weight;
+						no[i] += influence.bone->GetNormSkinMatrix() * vertex.no * influence.weight;
+						weight -= influence.weight;
+					}
+					if (weight > 0)
+					{
+						co[i] += vertex.co * weight;
+						no[i] += vertex.no * weight;
+					}
+				}
+			}
+
+			struct Vertex
+			{
+				math::Vec3 co, no;
+				struct Influence
+				{
+					const phys::attrib::Pose::Bone *bone;
+					float weight;
+				};
+				std::vector<Influence> influences;
+			};
+			std::vector<Vertex> vertices;
+		};
+
+		/**
+		 * Compares the legacy and packed skinning paths on the meshes of the
+		 * player character.
+		 */
+		void RunSkinBenchmark()
+		{
+			const unsigned iterations = 200;
+
+			std::cout << "initializing resources" << std::endl;
+			{
+				log::Indenter indenter;
+				GLOBAL(res::Index); // build the resource index
+			}
+
+			cache::ResourceProxy<res::Character> character("character/male-1/male.char");
+			const res::Model &model(*character->model);
+			phys::attrib::Pose pose(*model.skeleton);
+
+			std::size_t totalVertices = 0;
+			double totalLegacy = 0, totalPacked = 0;
+			for (const auto &meshProxy : res::GetGeometricallyDistinctMeshes(model))
+			{
+				const res::Mesh &mesh(*meshProxy);
+				LegacySkin legacySkin(mesh, pose);
+				phys::Skin skin(mesh, pose);
+
+				std::vector<math::Vec3>
+					co(mesh.vertices.size()),
+					no(mesh.vertices.size());
+				double legacy = Time(iterations, [&] { legacySkin.Update(co, no); });
+				double packed = Time(iterations, [&]
+				{
+					phys::Update(skin, &co.data()->x, &no.data()->x, sizeof *co.data());
+				});
+
+				std::cout << "mesh " << meshProxy.GetSignature().GetSource() << std::endl;
+				log::Indenter indenter;
+				std::cout << "vertices: " << skin.GetSize() << std::endl;
+				std::cout << "bones: "    << skin.bones.size() - 1 << std::endl;
+				std::cout << "legacy: "   << legacy << "us" << std::endl;
+				std::cout << "packed: "   << packed << "us" << std::endl;
+				if (packed) std::cout << "speedup: " << legacy / packed << "x" << std::endl;
+
+				totalVertices += skin.GetSize();
+				totalLegacy   += legacy;
+				totalPacked   += packed;
+			}
+			std::cout << "total" << std::endl;
+			log::Indenter indenter;
+			std::cout << "vertices: " << totalVertices << std::endl;
+			std::cout << "legacy: "   << totalLegacy << "us" << std::endl;
+			std::cout << "packed: "   << totalPacked << "us" << std::endl;
+			if (totalPacked) std::cout << "speedup: " << totalLegacy / totalPacked << "x" << std::endl;
+		}
+
+		/*---------------+
+		| text benchmark |
+		+---------------*/
+
+		/**
+		 * Lays out and generates the vertices for a screen of paragraphs in a
+		 * synthetic font, with and without the layout cache.  Glyph images
+		 * aren't rendered, so no GPU is needed.
+		 */
+		void RunTextBenchmark()
+		{
+			const unsigned
+				fontSize   = 24,
+				iterations = 200,
+				paragraphs = 20;
+
+			// generate a font with glyphs for ASCII, Latin-1 and Greek
+			std::mt19937 random;
+			std::uniform_real_distribution<float>
+				widthDistribution(.3, .7),
+				heightDistribution(.5, .8);
+			auto font(std::make_shared<res::Font>());
+			for (char32_t c = 0; c < 0x400; ++c)
+			{
+				if (c && (c < 0x20 || (c >= 0x7f && c < 0xa0) || (c >= 0x180 && c < 0x370))) continue;
+				res::Font::Glyph glyph;
+				glyph.size = math::Vec2(widthDistribution(random), heightDistribution(random));
+				glyph.bearing = math::Vec2(.05, glyph.size.y);
+				glyph.advance = glyph.size.x + .1;
+				font->glyphs.insert(std::make_pair(c, glyph));
+				font->maxSize    = Max(glyph.size,    font->maxSize);
+				font->maxBearing = Max(glyph.bearing, font->maxBearing);
+			}
+			font->maxAdvance = .8;
+			font->lineHeight = 1.2;
+
+			// pack the glyphs, as the font texture would
+			vid::GlyphAtlas atlas(math::Vec2u(128));
+			unsigned grows = 0;
+			double packTime = Time(1, [&]
+			{
+				for (const auto &glyph : font->glyphs)
+				{
+					math::Vec2u pos;
+					while (!atlas.Insert(glyph.first, math::Vec2u(Ceil(glyph.second.size * fontSize)), pos))
+					{
+						atlas.Grow();
+						++grows;
+					}
+				}
+			});
+
+			std::vector<std::string> texts;
+			for (unsigned i = 0; i < paragraphs; ++i)
+				texts.push_back(
+					"Paragraph " + std::to_string(i) + ": the quick brown fox "
+					"jumps over the lazy dog.  Na\xc3\xafve caf\xc3\xa9 "
+					"\xce\xb1\xce\xb2\xce\xb3 r\xc3\xa9sum\xc3\xa9, with "
+					"enough words that it has to be wrapped across several lines "
+					"of the text box.");
+			const float width = 20;
+
+			std::size_t glyphs = 0;
+			double layoutTime = Time(iterations, [&]
+			{
+				glyphs = 0;
+				for (const auto &text : texts)
+					glyphs += vid::LayoutText(*font, text, width, true, res::justifyTextAlign).glyphs.size();
+			});
+			vid::TextLayoutCache cache;
+			double cachedLayoutTime = Time(iterations, [&]
+			{
+				for (const auto &text : texts)
+					cache.Get(font, text, width, true, res::justifyTextAlign);
+			});
+			std::vector<vid::TextVertex> vertices;
+			auto GenerateVertices = [&](float borderSize)
+			{
+				for (const auto &text : texts)
+					vid::GetTextVertices(
+						*cache.Get(font, text, width, true, res::justifyTextAlign),
+						atlas, math::Vec2(), math::Vec2(.02), 1, 0, borderSize, 0, vertices);
+			};
+			double vertexTime = Time(iterations, [&] { GenerateVertices(0); });
+			double borderVertexTime = Time(iterations, [&] { GenerateVertices(.1); });
+
+			std::cout << "glyphs " << font->glyphs.size() << std::endl;
+			{
+				log::Indenter indenter;
+				std::cout << "packing: " << packTime << "us" << std::endl;
+				std::cout << "atlas size: " << atlas.GetSize().x << "x" << atlas.GetSize().y << " (" << grows << " grows)" << std::endl;
+			}
+			std::cout << "paragraphs " << paragraphs << " (" << glyphs << " glyphs)" << std::endl;
+			log::Indenter indenter;
+			std::cout << "layout: " << layoutTime << "us" << std::endl;
+			std::cout << "cached layout: " << cachedLayoutTime << "us" << std::endl;
+			std::cout << "vertices: " << vertexTime << "us" << std::endl;
+			std::cout << "vertices with border: " << borderVertexTime << "us" << std::endl;
+		}
+
+		/*----------------+
+		| track benchmark |
+		+----------------*/
+
+		/**
+		 * Generates a flat track of @a size by @a size squares, each split
+		 * into two faces, with a fraction of the edges between squares
+		 * walled off to make the paths less direct.
+		 */
+		res::Track MakeGridTrack(unsigned size, float wallFraction, std::mt19937 &random)
+		{
+			res::Track track;
+			track.faces.resize(size * size * 2);
+			auto getFace([&track, size](unsigned x, unsigned y, unsigned half) -> res::Track::Face *
+			{
+				return x < size && y < size ? &track.faces[(y * size + x) * 2 + half] : nullptr;
+			});
+			for (unsigned y = 0; y < size; ++y)
+				for (unsigned x = 0; x < size; ++x)
+				{
+					math::Vec3
+						a(x,     0, y),
+						b(x + 1, 0, y),
+						c(x + 1, 0, y + 1),
+						d(x,     0, y + 1);
+					res::Track::Face
+						&lower(*getFace(x, y, 0)),
+						&upper(*getFace(x, y, 1));
+					lower.vertices = {{a, b, c}};
+					upper.vertices = {{a, c, d}};
+					lower.neighbours = {{getFace(x, y - 1, 1), getFace(x + 1, y, 1), &upper}};
+					upper.neighbours = {{&lower, getFace(x, y + 1, 0), getFace(x - 1, y, 0)}};
+				}
+			std::uniform_real_distribution<float> chance;
+			for (unsigned y = 0; y < size; ++y)
+				for (unsigned x = 0; x + 1 < size; ++x)
+					if (chance(random) < wallFraction)
+					{
+						getFace(x,     y, 0)->neighbours[1] = nullptr;
+						getFace(x + 1, y, 1)->neighbours[2] = nullptr;
+					}
+			return track;
+		}
+
+		/**
+		 * Measures point location and pathfinding on generated tracks of
+		 * increasing size, comparing point location against a linear scan
+		 * of the faces.
+		 */
+		void RunTrackBenchmark()
+		{
+			const unsigned
+				pointQueries = 10000,
+				linearPointQueries = 100,
+				pathQueries = 100;
+
+			std::mt19937 random(1);
+			for (unsigned size : {64, 256, 1024})
+			{
+				res::Track track(MakeGridTrack(size, .2f, random));
+				std::cout << "track " << size << "x" << size << std::endl;
+				log::Indenter indenter;
+				std::cout << "faces: " << track.faces.size() << std::endl;
+				std::cout << "build navigation: " << Time(1, [&] { res::BuildNavigation(track); }) << "us" << std::endl;
+
+				std::uniform_real_distribution<float> coordinate(0, size);
+				std::vector<math::Vec3> points;
+				for (unsigned i = 0; i < pointQueries; ++i)
+					points.emplace_back(coordinate(random), 1, coordinate(random));
+				std::size_t query = 0, found = 0;
+				double grid = Time(pointQueries, [&]
+				{
+					found += res::GetBestFace(track, points[query++ % points.size()]) != nullptr;
+				});
+				res::Track linearTrack(track);
+				linearTrack.navigation = res::Track::Navigation();
+				double linear = Time(linearPointQueries, [&]
+				{
+					found += res::GetBestFace(linearTrack, points[query++ % points.size()]) != nullptr;
+				});
+				std::cout << "point location (grid): "   << grid   << "us" << std::endl;
+				std::cout << "point location (linear): " << linear << "us" << std::endl;
+
+				std::uniform_int_distribution<std::size_t> face(0, track.faces.size() - 1);
+				std::size_t reached = 0, faces = 0, waypoints = 0;
+				double smoothing = 0;
+				double pathfinding = Time(pathQueries, [&]
+				{
+					const res::Track::Face
+						&source(track.faces[face(random)]),
+						&target(track.faces[face(random)]);
+					res::TrackPath path(res::FindPath(track, source, target, .25f));
+					if (path.empty()) return;
+					++reached;
+					faces += path.size();
+					auto start(Clock::now());
+					waypoints += res::SmoothPath(track, source, res::GetCenter(source),
+						path, res::GetCenter(target), .25f).size();
+					smoothing += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+				});
+				std::cout << "pathfinding: " << pathfinding - smoothing / pathQueries << "us" << std::endl;
+				if (reached)
+				{
+					std::cout << "path smoothing: " << smoothing / reached << "us" << std::endl;
+					std::cout << "reached: " << reached << "/" << pathQueries << std::endl;
+					std::cout << "average faces: " << faces / reached << std::endl;
+					std::cout << "average waypoints: " << waypoints / reached << std::endl;
+				}
+			}
+		}
+
+		/*----------------+
+		| audio benchmark |
+		+----------------*/
+
+		/**
+		 * An audio stream that synthesizes a 16-bit stereo tone, which costs
+		 * about as much to produce as decoding a compressed stream.
+		 */
+		class ToneStream : public res::AudioStream
+		{
+			public:
+			ToneStream(unsigned frames, float pitch) :
+				frames(frames), pitch(pitch) {}
+
+			unsigned Read(void *data, unsigned size) override
+			{
+				unsigned n = std::min(size / 4, frames - position);
+				auto *samples = static_cast<std::int16_t *>(data);
+				for (unsigned i = 0; i < n; ++i, ++position)
+					samples[i * 2] = samples[i * 2 + 1] =
+						std::sin(position * pitch * 6.2831853f / 44100) * 0x3fff;
+				return n * 4;
+			}
+
+			void Seek(unsigned sample) override
+			{
+				position = std::min(sample, frames);
+			}
+
+			private:
+			unsigned frames, position = 0;
+			float pitch;
+		};
+
+		/**
+		 * Plays many decoded streams at once without an audio device,
+		 * simulating the buffer queue of each source, and measures the time
+		 * that the game thread spends on them and how often the decoder
+		 * falls behind.
+		 */
+		void RunAudioBenchmark()
+		{
+			const unsigned
+				frequency   = 44100,
+				frameSize   = 4,
+				blockSize   = 16384,
+				blockCount  = 8,
+				queueBlocks = 4;
+			const float
+				duration  = 3,
+				frameTime = 1.f / 60;
+
+			std::mt19937 random(1);
+			std::uniform_real_distribution<float> length(1, 4), pitch(110, 880);
+			for (unsigned count : {16, 64, 256})
+			{
+				struct Voice
+				{
+					std::unique_ptr<aud::DecodedStream> stream;
+					float queued;
+					bool started, end;
+				};
+				std::vector<Voice> voices;
+				for (unsigned i = 0; i < count; ++i)
+					voices.push_back(Voice{
+						std::unique_ptr<aud::DecodedStream>(new aud::DecodedStream(
+							std::unique_ptr<res::AudioStream>(new ToneStream(length(random) * frequency, pitch(random))),
+							i % 2, 0, blockSize, blockCount)),
+						0, false, false});
+
+				unsigned frames = 0, starvations = 0;
+				double totalUpdate = 0, maxUpdate = 0;
+				auto next(Clock::now());
+				for (float time = 0; time < duration; time += frameTime, ++frames)
+				{
+					auto start(Clock::now());
+					for (auto &voice : voices)
+					{
+						if (voice.end) continue;
+
+						// play
+						voice.queued -= frequency * frameSize * frameTime;
+						if (voice.queued < 0)
+						{
+							if (voice.started) ++starvations;
+							voice.queued = 0;
+						}
+
+						// refill the queue
+						while (voice.queued + blockSize <= queueBlocks * blockSize)
+						{
+							const aud::DecodedStream::Block *block = voice.stream->GetBlock();
+							if (!block) break;
+							voice.queued += block->size;
+							voice.started = true;
+							voice.end = block->last;
+							voice.stream->PopBlock();
+							if (voice.end) break;
+						}
+					}
+					double update = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+					totalUpdate += update;
+					maxUpdate = std::max(maxUpdate, update);
+					std::this_thread::sleep_until(next += std::chrono::microseconds(unsigned(frameTime * 1000000)));
+				}
+
+				unsigned underruns = 0, blocks = 0;
+				float fillLevel = 0;
+				for (const auto &voice : voices)
+				{
+					underruns += voice.stream->GetUnderruns();
+					blocks    += voice.stream->GetBlocks();
+					fillLevel += voice.stream->GetAverageFillLevel();
+				}
+				std::cout << "streams " << count << std::endl;
+				log::Indenter indenter;
+				std::cout << "update (average): "    << totalUpdate / frames << "us" << std::endl;
+				std::cout << "update (maximum): "    << maxUpdate << "us" << std::endl;
+				std::cout << "blocks: "              << blocks << std::endl;
+				std::cout << "ring underruns: "      << underruns << std::endl;
+				std::cout << "queue starvations: "   << starvations << std::endl;
+				std::cout << "average fill level: "  << fillLevel / count * 100 << "%" << std::endl;
+			}
+		}
+
+		/*--------------+
+		| log benchmark |
+		+--------------*/
+
+		/**
+		 * A sink that discards its output, so that only the cost of getting
+		 * records to it is measured.
+		 */
+		class NullSink : public log::Sink
+		{
+			public:
+			std::size_t GetSize() const { return size; }
+
+			private:
+			void DoWrite(const std::string &s) override { size += s.size(); }
+
+			std::size_t size = 0;
+		};
+
+		/**
+		 * Writes a record for each cached object, like the cache does when
+		 * @c log.cache is enabled, through the usual filters.  The records
+		 * are written directly, and through an asynchronous queue from one
+		 * and several threads, and the records per second are measured on
+		 * the producing threads and once they have reached the sink.
+		 */
+		void RunLogBenchmark()
+		{
+			const unsigned records = 100000;
+
+			auto Write = [](std::ostream &os, unsigned first, unsigned last)
+			{
+				for (unsigned i = first; i < last; ++i)
+					os << "caching object: texture " << i << std::endl;
+			};
+			auto Rate = [](unsigned records, Clock::duration duration)
+			{
+				return records / std::chrono::duration<double>(duration).count();
+			};
+
+			{
+				auto sink(std::make_shared<NullSink>());
+				auto filters(std::make_shared<log::IndentFilter>(std::make_shared<log::TimeFilter>(sink)));
+				std::ostream os(&filters->streambuf());
+				auto start(Clock::now());
+				Write(os, 0, records);
+				std::cout << "synchronous: " << Rate(records, Clock::now() - start) << " records/s" << std::endl;
+			}
+
+			struct Case
+			{
+				const char *name;
+				unsigned threads;
+				std::size_t capacity;
+				bool deferred;
+			};
+			for (const auto &c : {
+				Case{"asynchronous",                   1, 1024,    false},
+				Case{"asynchronous (4 threads)",       4, 1024,    false},
+				Case{"asynchronous (unbounded)",       1, records, false},
+				Case{"asynchronous (deferred format)", 1, 1024,    true}})
+			{
+				auto sink(std::make_shared<NullSink>());
+				const auto indentState(std::make_shared<log::IndentFilterState>());
+				auto filters(std::make_shared<log::IndentFilter>(indentState, std::make_shared<log::TimeFilter>(sink)));
+				std::unique_ptr<log::AsyncQueue> queue(new log::AsyncQueue(c.capacity));
+				log::AsyncStream stream(*queue, indentState, filters);
+
+				auto start(Clock::now());
+				if (c.deferred)
+				{
+					for (unsigned i = 0; i < records; ++i)
+						stream.Defer([i](std::ostream &os) { os << "caching object: texture " << i << '\n'; });
+				}
+				else if (c.threads == 1)
+				{
+					std::ostream os(&stream.streambuf());
+					Write(os, 0, records);
+				}
+				else
+				{
+					std::vector<std::thread> threads;
+					for (unsigned i = 0; i < c.threads; ++i)
+						threads.emplace_back([&, i]
+						{
+							std::ostream os(&stream.streambuf());
+							Write(os, records * i / c.threads, records * (i + 1) / c.threads);
+						});
+					for (auto &thread : threads) thread.join();
+				}
+				auto produced(Clock::now());
+				stream.Drain();
+				auto drained(Clock::now());
+
+				std::cout << c.name << std::endl;
+				log::Indenter indenter;
+				std::cout << "producer: "    << Rate(records, produced - start) << " records/s" << std::endl;
+				std::cout << "end to end: "  << Rate(records, drained  - start) << " records/s" << std::endl;
+				std::cout << "dropped: "     << queue->GetDropCount() << std::endl;
+				std::cout << "sink bytes: "  << sink->GetSize() << std::endl;
+
+				// NOTE: the queue has to be destroyed before the stream
+				queue.reset();
+			}
+		}
+
+		/*---------------+
+		| cvar benchmark |
+		+---------------*/
+
+		/**
+		 * Measures the cost of reading configuration variables through
+		 * @c CVAR, which calls the get filter and copies the value, and
+		 * through the snapshot.
+		 */
+		void RunCvarBenchmark()
+		{
+			const unsigned
+				iterations = 100000,
+				reads      = 16;
+
+			// the reads are repeated to amortize the loop, and summed so
+			// that they aren't optimized away
+			std::size_t sum = 0;
+			auto Read = [&](const char *name, auto read)
+			{
+				double time = Time(iterations, [&]
+				{
+					for (unsigned i = 0; i < reads; ++i) sum += read();
+				});
+				std::cout << name << ": " << time * 1000 / reads << "ns" << std::endl;
+			};
+
+			std::cout << "resource.excludes patterns: " << CSNAP(resourceExcludes).size() << std::endl;
+			Read("CVAR(logCache)",          [] { return *CVAR(logCache); });
+			Read("CSNAP(logCache)",         [] { return CSNAP(logCache); });
+			Read("CVAR(cacheBudget)",       [] { return *CVAR(cacheBudget); });
+			Read("CSNAP(cacheBudget)",      [] { return CSNAP(cacheBudget); });
+			Read("CVAR(resourceExcludes)",  [] { return CVAR(resourceExcludes)->size(); });
+			Read("CSNAP(resourceExcludes)", [] { return CSNAP(resourceExcludes).size(); });
+			std::cout << "checksum: " << sum << std::endl;
+		}
+
+		/*---------------+
+		| pose benchmark |
+		+---------------*/
+
+		/**
+		 * Animates a crowd of characters while polling their versions the
+		 * way the spatial index does every frame, and counts the dirty-signal
+		 * emissions and slot calls that the versions replaced.
+		 */
+		void RunPoseBenchmark()
+		{
+			const unsigned
+				characters = 16,
+				frames     = 200;
+
+			std::cout << "initializing resources" << std::endl;
+			{
+				log::Indenter indenter;
+				GLOBAL(res::Index); // build the resource index
+			}
+
+			cache::ResourceProxy<res::Character> character("character/male-1/male.char");
+			struct Walker
+			{
+				std::unique_ptr<phys::Form> form;
+				std::vector<phys::attrib::Pose::Bone *> bones;
+				unsigned transformVersion, poseVersion;
+			};
+			std::vector<Walker> crowd(characters);
+			for (auto &walker : crowd)
+			{
+				walker.form.reset(new phys::Form(character->model));
+				for (const auto &bone : walker.form->GetBones())
+					walker.bones.push_back(walker.form->GetBone(bone.GetName()));
+				walker.transformVersion = walker.form->GetTransformVersion();
+				walker.poseVersion      = walker.form->GetPoseVersion();
+			}
+
+			// the number of dirty transformations, and the number of
+			// characters that the spatial index would have refitted
+			std::size_t boneChanges = 0, formChanges = 0, refits = 0;
+			auto Poll([&]
+			{
+				for (auto &walker : crowd)
+				{
+					unsigned
+						transformVersion = walker.form->GetTransformVersion(),
+						poseVersion      = walker.form->GetPoseVersion();
+					if (transformVersion != walker.transformVersion ||
+						poseVersion      != walker.poseVersion)
+					{
+						formChanges += transformVersion - walker.transformVersion;
+						boneChanges += poseVersion      - walker.poseVersion;
+						walker.transformVersion = transformVersion;
+						walker.poseVersion      = poseVersion;
+						++refits;
+					}
+				}
+			});
+
+			// animate every bone and walk forward, as the walking gait does
+			unsigned frame = 0;
+			double animated = Time(frames, [&]
+			{
+				float t = frame++ / 60.f;
+				for (unsigned i = 0; i < crowd.size(); ++i)
+				{
+					auto &walker(crowd[i]);
+					for (unsigned j = 0; j < walker.bones.size(); ++j)
+					{
+						auto &bone(*walker.bones[j]);
+						bone.SetOrientation(bone.GetBindOrientation() *
+							math::Quat<>(math::Euler<>(0, std::sin(t * 6 + i + j) * .25f, 0)));
+					}
+					walker.form->SetPosition(math::Vec3(i, 0, t));
+				}
+				Poll();
+			});
+			double idle = Time(frames, Poll);
+
+			// each bone change used to emit the bone's dirty-transform
+			// signal, whose slot emitted the pose's dirty-pose signal, which
+			// called the spatial index, the posed bounding box, and the
+			// drawable of each part; each change to the form's own
+			// transformation called the spatial index and the bounding box
+			std::size_t parts = crowd.front().form->GetParts().size();
+			double
+				emissions = (2. * boneChanges + formChanges) / frames,
+				slotCalls = (boneChanges * (1. + 2 + parts) + 2. * formChanges) / frames;
+
+			std::cout << "characters: " << characters << std::endl;
+			std::cout << "bones: " << crowd.front().bones.size() << std::endl;
+			std::cout << "parts: " << parts << std::endl;
+			std::cout << "refits per frame: " << double(refits) / frames << std::endl;
+			std::cout << "signal emissions saved per frame: " << emissions << std::endl;
+			std::cout << "slot calls saved per frame: " << slotCalls << std::endl;
+			std::cout << "animated frame: " << animated << "us" << std::endl;
+			std::cout << "idle poll: " << idle << "us" << std::endl;
+		}
+
+		/*----------------+
+		| blend benchmark |
+		+----------------*/
+
+		/**
+		 * Blends the walking and turning animations of a crowd of characters
+		 * and applies them to their poses, the way the controllers do every
+		 * tick, once with the bones keyed by name and once with the bones
+		 * indexed by the pose's layout, and checks that both give the same
+		 * pose.
+		 */
+		void RunBlendBenchmark()
+		{
+			const unsigned
+				characters = 16,
+				frames     = 200;
+
+			std::cout << "initializing resources" << std::endl;
+			{
+				log::Indenter indenter;
+				GLOBAL(res::Index); // build the resource index
+			}
+
+			cache::ResourceProxy<res::Character> character("character/male-1/male.char");
+			const auto &gait(*character->gait);
+			auto walk(gait.walk.animation.lock());
+			auto turn(gait.turn.animation ? gait.turn.animation.lock() : walk);
+			struct Walker
+			{
+				std::unique_ptr<phys::Form> form;
+				std::vector<phys::attrib::Pose::Bone *> bones;
+				std::vector<phys::AnimationController> animations;
+			};
+			std::vector<Walker> crowd(characters);
+			for (unsigned i = 0; i < crowd.size(); ++i)
+			{
+				auto &walker(crowd[i]);
+				walker.form.reset(new phys::Form(character->model));
+				for (const auto &bone : walker.form->GetBones())
+					walker.bones.push_back(walker.form->GetBone(bone.GetName()));
+				walker.animations.emplace_back(walk);
+				walker.animations.emplace_back(turn);
+				for (auto &animation : walker.animations)
+					animation.SetPlayPosition(i * .1f);
+			}
+
+			// builds the frame that the pose gives to its controllers
+			auto GetBaseFrame([](const phys::Form &form, bool indexed)
+			{
+				phys::Frame frame;
+				const auto &bones(form.GetBones());
+				if (indexed)
+				{
+					auto &boneFrame(frame.indexedBones);
+					boneFrame.Bind(form.GetBoneLayout());
+					for (std::size_t i = 0; i < bones.size(); ++i)
+					{
+						boneFrame.position.Set   (i, bones[i].GetPosition());
+						boneFrame.orientation.Set(i, bones[i].GetOrientation());
+						boneFrame.scale.Set      (i, bones[i].GetScale());
+					}
+				}
+				else for (const auto &bone : bones)
+				{
+					auto &boneFrame(frame.bones[bone.GetName()]);
+					boneFrame.position    = bone.GetPosition();
+					boneFrame.orientation = bone.GetOrientation();
+					boneFrame.scale       = bone.GetScale();
+				}
+				return frame;
+			});
+			auto BlendAnimations([&](const Walker &walker, bool indexed)
+			{
+				phys::Frame base(GetBaseFrame(*walker.form, indexed)), accum;
+				accum.indexedBones.Bind(base.indexedBones.layout);
+				for (unsigned i = 0; i < walker.animations.size(); ++i)
+					phys::Blend(accum, walker.animations[i].GetFrame(base, accum), i ? .5f : 1.f);
+				return accum;
+			});
+			auto Apply([](Walker &walker, const phys::Frame &frame)
+			{
+				for (const auto &kv : frame.bones)
+					if (auto bone = walker.form->GetBone(kv.first))
+					{
+						const auto &boneFrame(kv.second);
+						if (boneFrame.position)    bone->SetPosition   (*boneFrame.position);
+						if (boneFrame.orientation) bone->SetOrientation(*boneFrame.orientation);
+						if (boneFrame.scale)       bone->SetScale      (*boneFrame.scale);
+					}
+				const auto &boneFrame(frame.indexedBones);
+				for (std::size_t i = 0; i < boneFrame.position.values.size(); ++i)
+				{
+					auto &bone(*walker.bones[i]);
+					if (boneFrame.position.Has(i))    bone.SetPosition   (boneFrame.position.values[i]);
+					if (boneFrame.orientation.Has(i)) bone.SetOrientation(boneFrame.orientation.values[i]);
+					if (boneFrame.scale.Has(i))       bone.SetScale      (boneFrame.scale.values[i]);
+				}
+			});
+			auto Animate([&](bool indexed)
+			{
+				for (auto &walker : crowd)
+				{
+					for (auto &animation : walker.animations)
+						animation.Update(1 / 60.f);
+					Apply(walker, BlendAnimations(walker, indexed));
+				}
+			});
+
+			// compare the two paths on the same frame
+			float maxError = 0;
+			{
+				const auto &walker(crowd.front());
+				phys::Frame
+					named  (BlendAnimations(walker, false)),
+					indexed(BlendAnimations(walker, true));
+				const auto &boneFrame(indexed.indexedBones);
+				for (std::size_t i = 0; i < walker.bones.size(); ++i)
+				{
+					auto iter(named.bones.find(walker.bones[i]->GetName()));
+					bool isNamed = iter != named.bones.end() && iter->second.orientation;
+					if (isNamed != boneFrame.orientation.Has(i))
+						maxError = std::max(maxError, 1.f);
+					else if (isNamed)
+						maxError = std::max(maxError, 1 - std::abs(Dot(
+							*iter->second.orientation,
+							boneFrame.orientation.values[i])));
+				}
+			}
+
+			double named = Time(frames, [&] { Animate(false); });
+			double indexed = Time(frames, [&] { Animate(true); });
+
+			std::cout << "characters: " << characters << std::endl;
+			std::cout << "bones: " << crowd.front().bones.size() << std::endl;
+			std::cout << "animated bones: " << walk->bones.size() << std::endl;
+			std::cout << "max orientation error: " << maxError << std::endl;
+			std::cout << "named frame: " << named << "us" << std::endl;
+			std::cout << "indexed frame: " << indexed << "us";
+			if (indexed) std::cout << " (" << named / indexed << "x)";
+			std::cout << std::endl;
+		}
+
+		/*----------------+
+		| scene benchmark |
+		+----------------*/
+
+		/**
+		 * Steps the village scene with a crowd of characters walking around
+		 * its track, without a window or any drivers, and prints the time
+		 * spent in each phase of the update and the memory high-water marks
+		 * as @c name=value lines, which can be compared between versions.
+		 *
+		 * @note The characters are sent to random faces of the track, but
+		 *       the generator is seeded, and the simulation advances by the
+		 *       fixed tick time, so every run does the same work.
+		 */
+		void RunSceneBenchmark()
+		{
+			const unsigned
+				characters    = 32,
+				ticks         = 1200,
+				retargetTicks = 300;
+			const float tickTime = 1 / *CVAR(simTickRate);
+
+			std::cout << "initializing resources" << std::endl;
+			{
+				log::Indenter indenter;
+				GLOBAL(res::Index); // build the resource index
+			}
+
+			cache::ResourceProxy<res::Scene> sceneResource("scene/village/village.scene");
+			cache::ResourceProxy<res::Character> characterResource("character/male-1/male.char");
+			phys::Scene scene(*sceneResource);
+
+			std::mt19937 random(1);
+			auto RandomPoint([&]
+			{
+				const auto &faces(scene.GetTrack().faces);
+				return res::GetCenter(faces[std::uniform_int_distribution<std::size_t>(0, faces.size() - 1)(random)]);
+			});
+			std::vector<std::shared_ptr<Character>> crowd;
+			for (unsigned i = 0; i < characters; ++i)
+			{
+				auto character(std::make_shared<Character>(*characterResource));
+				auto body(character->GetBodyPtr());
+				scene.Insert(body);
+				if (scene.HasTrack())
+				{
+					body->SetPosition(RandomPoint());
+					body->SetTrack(scene.GetTrack());
+				}
+				crowd.push_back(character);
+			}
+
+			phys::Scene::UpdateTimes times;
+			std::size_t cachePeakSize = GLOBAL(cache::Cache).GetSize();
+			auto start(Clock::now());
+			for (unsigned tick = 0; tick < ticks; ++tick)
+			{
+				if (tick % retargetTicks == 0 && scene.HasTrack())
+					for (const auto &character : crowd)
+						character->Goto(RandomPoint());
+				scene.Update(tickTime, &times);
+				GLOBAL(cache::Cache).Update(tickTime);
+				cachePeakSize = std::max(cachePeakSize, GLOBAL(cache::Cache).GetSize());
+			}
+			double total = std::chrono::duration<double>(Clock::now() - start).count();
+
+			// print per-tick timings in microseconds
+			auto PrintPhase([&](const std::string &name, double seconds)
+			{
+				std::cout << "scene.phase." << name << ".us=" << seconds * 1000000 / ticks << std::endl;
+			});
+			std::cout << "scene.characters=" << characters << std::endl;
+			std::cout << "scene.ticks=" << ticks << std::endl;
+			std::cout << "scene.tick.us=" << total * 1000000 / ticks << std::endl;
+			PrintPhase("controllables",   times.controllables);
+			PrintPhase("forces",          times.forces);
+			PrintPhase("collision",       times.collision);
+			PrintPhase("trackables",      times.trackables);
+			PrintPhase("deltas",          times.deltas);
+			PrintPhase("camera.tracking", times.cameraTracking);
+			PrintPhase("objects",         times.objects);
+			PrintPhase("spatial.index",   times.spatialIndex);
+			std::cout << "scene.memory.peak.bytes=" << sys::GetPeakMemoryUsage() << std::endl;
+			std::cout << "scene.memory.cache.peak.bytes=" << cachePeakSize << std::endl;
+		}
+
+		/*---------------+
+		| clip benchmark |
+		+---------------*/
+
+		/**
+		 * Records generated frames to a temporary file as fast as they can
+		 * be written, blocking and dropping frames when the encoder falls
+		 * behind, and compares the time that the writing thread spends on
+		 * each frame with the time that each frame takes to be encoded.
+		 * Checks that every frame is either encoded or dropped, that none
+		 * are dropped while blocking, and that the file isn't empty.
+		 */
+		void RunClipBenchmark()
+		{
+			namespace fs = boost::filesystem;
+			const math::Vec2u size(640, 360);
+			const unsigned
+				frames     = 300,
+				queueDepth = 8;
+
+			// a few frames of a moving gradient, so that the encoder has
+			// something to predict
+			std::vector<res::Image> images(8);
+			for (unsigned i = 0; i < images.size(); ++i)
+			{
+				auto &image(images[i]);
+				image.size = size;
+				image.channels =
+				{
+					res::Image::Channel(res::Image::Channel::red,   8),
+					res::Image::Channel(res::Image::Channel::green, 8),
+					res::Image::Channel(res::Image::Channel::blue,  8)
+				};
+				image.alignment = 1;
+				image.data.resize(Content(size) * 3);
+				for (unsigned y = 0; y < size.y; ++y)
+					for (unsigned x = 0; x < size.x; ++x)
+					{
+						auto pixel(&image.data[(y * size.x + x) * 3]);
+						pixel[0] = x + i * 4;
+						pixel[1] = y + i * 2;
+						pixel[2] = x + y;
+					}
+			}
+
+			unsigned failures = 0;
+			for (bool dropFrames : {false, true})
+			{
+				std::cout << (dropFrames ? "dropping" : "blocking") << std::endl;
+				log::Indenter indenter;
+				fs::path path(fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.ogv"));
+				unsigned encodedFrames, droppedFrames;
+				{
+					res::clip::Stream stream(path.string(), "", size, 30, .5, queueDepth, dropFrames);
+					unsigned frame = 0;
+					std::cout << "write: " << Time(frames, [&]
+					{
+						stream.Write(images[frame++ % images.size()]);
+					}) << "us" << std::endl;
+					// let the encoder catch up before reading the statistics
+					while (stream.GetQueueDepth())
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					encodedFrames = stream.GetEncodedFrameCount();
+					droppedFrames = stream.GetDroppedFrameCount();
+					std::cout << "encoded frames: " << encodedFrames << std::endl;
+					std::cout << "dropped frames: " << droppedFrames << std::endl;
+					std::cout << "max queue depth: " << stream.GetMaxQueueDepth() << std::endl;
+					std::cout << "encode latency: " << stream.GetAverageEncodeLatency() * 1000000 << "us" << std::endl;
+				}
+				// the stream has been destroyed, so the file is complete
+				auto fileSize(fs::exists(path) ? fs::file_size(path) : 0);
+				fs::remove(path);
+
+				if (dropFrames ?
+					encodedFrames + droppedFrames != frames :
+					encodedFrames != frames || droppedFrames)
+				{
+					++failures;
+					std::cout << "failed: frames lost" << std::endl;
+				}
+				if (!fileSize)
+				{
+					++failures;
+					std::cout << "failed: empty file" << std::endl;
+				}
+			}
+			if (failures)
+				THROW((err::Exception<err::GameModuleTag>("clip recording lost frames or output")))
+		}
+
+		/*----------------+
+		| image benchmark |
+		+----------------*/
+
+		/**
+		 * Returns the largest difference between the bytes of two images, or
+		 * 256 if their sizes or layouts differ.
+		 */
+		unsigned GetMaxDifference(const res::Image &a, const res::Image &b)
+		{
+			if (Any(a.size != b.size) || a.channels != b.channels ||
+				a.alignment != b.alignment || a.data.size() != b.data.size())
+				return 256;
+			unsigned difference = 0;
+			for (std::size_t i = 0; i < a.data.size(); ++i)
+				difference = std::max<unsigned>(difference, std::abs(int(a.data[i]) - int(b.data[i])));
+			return difference;
+		}
+
+		/**
+		 * Checks the specialized kernels for 8-bit images against the general
+		 * implementations of res::Convert, res::Flip, res::Scale and
+		 * res::Align across formats, odd sizes and alignments, and then
+		 * compares their speed on a texture-sized image.
+		 */
+		void RunImageBenchmark()
+		{
+			typedef res::Image::Channel Channel;
+			const std::vector<std::pair<std::string, res::Image::Channels>> formats =
+			{
+				{"gray",       {Channel(Channel::gray, 8)}},
+				{"gray-alpha", {Channel(Channel::gray, 8), Channel(Channel::alpha, 8)}},
+				{"rgb",        {Channel(Channel::red,  8), Channel(Channel::green, 8), Channel(Channel::blue, 8)}},
+				{"bgr",        {Channel(Channel::blue, 8), Channel(Channel::green, 8), Channel(Channel::red,  8)}},
+				{"rgba",       {Channel(Channel::red,  8), Channel(Channel::green, 8), Channel(Channel::blue, 8), Channel(Channel::alpha, 8)}},
+				{"bgra",       {Channel(Channel::blue, 8), Channel(Channel::green, 8), Channel(Channel::red,  8), Channel(Channel::alpha, 8)}}
+			};
+			std::mt19937 random;
+			std::uniform_int_distribution<unsigned> byte(0, 255);
+			auto MakeImage([&](const math::Vec2u &size, const res::Image::Channels &channels, unsigned alignment)
+			{
+				res::Image image;
+				image.size = size;
+				image.channels = channels;
+				image.alignment = 1;
+				image.data.resize(Content(size) * channels.size());
+				for (auto &c : image.data) c = byte(random);
+				return res::Align(image, alignment);
+			});
+
+			// NOTE: the scaling kernel rounds where the general code
+			// truncates, so averaged values can differ by one; the other
+			// kernels must match exactly
+			std::cout << "conformance" << std::endl;
+			{
+				log::Indenter indenter;
+				unsigned cases = 0, mismatches = 0, maxDifference = 0;
+				auto Check([&](const res::Image &fast, const res::Image &general, unsigned tolerance = 0)
+				{
+					unsigned difference = GetMaxDifference(fast, general);
+					maxDifference = std::max(maxDifference, difference);
+					++cases;
+					if (difference > tolerance) ++mismatches;
+				});
+				for (math::Vec2u size : {math::Vec2u(1, 1), math::Vec2u(7, 3), math::Vec2u(34, 18), math::Vec2u(64, 64)})
+					for (unsigned alignment : {0u, 1u, 4u})
+						for (const auto &format : formats)
+						{
+							res::Image image(MakeImage(size, format.second, alignment));
+							for (const auto &destFormat : formats)
+								for (unsigned destAlignment : {1u, 4u})
+									Check(
+										res::Convert       (image, destFormat.second, destAlignment),
+										res::ConvertGeneral(image, destFormat.second, destAlignment));
+							for (math::Vector<2, bool> flip : {math::Vector<2, bool>(true, false), math::Vector<2, bool>(false, true), math::Vector<2, bool>(true, true)})
+								Check(res::Flip(image, flip), res::FlipGeneral(image, flip));
+							if (All(size % 2u == 0u))
+								Check(res::Scale(image, size / 2u), res::ScaleGeneral(image, size / 2u), 1);
+							for (unsigned destAlignment : {0u, 1u, 4u, 8u})
+								Check(res::Align(image, destAlignment), res::AlignGeneral(image, destAlignment));
+						}
+				std::cout << "cases: " << cases << std::endl;
+				std::cout << "mismatches: " << mismatches << std::endl;
+				std::cout << "max difference: " << maxDifference << std::endl;
+			}
+
+			const unsigned iterations = 5;
+			const math::Vec2u size(1024, 1024);
+			auto Compare([&](const std::string &name, const std::function<void ()> &fast, const std::function<void ()> &general)
+			{
+				double
+					fastTime    = Time(iterations, fast),
+					generalTime = Time(iterations, general);
+				std::cout << name << std::endl;
+				log::Indenter indenter;
+				std::cout << "general: " << generalTime << "us" << std::endl;
+				std::cout << "fast: "    << fastTime    << "us" << std::endl;
+				if (fastTime) std::cout << "speedup: " << generalTime / fastTime << "x" << std::endl;
+			});
+			res::Image
+				rgb (MakeImage(size, formats[2].second, 4)),
+				rgba(MakeImage(size, formats[4].second, 4)),
+				gray(MakeImage(size, formats[0].second, 4));
+			Compare("convert rgb to rgba",
+				[&] { res::Convert       (rgb, formats[4].second, 4); },
+				[&] { res::ConvertGeneral(rgb, formats[4].second, 4); });
+			Compare("convert rgba to bgra",
+				[&] { res::Convert       (rgba, formats[5].second, 4); },
+				[&] { res::ConvertGeneral(rgba, formats[5].second, 4); });
+			Compare("convert gray to rgba",
+				[&] { res::Convert       (gray, formats[4].second, 4); },
+				[&] { res::ConvertGeneral(gray, formats[4].second, 4); });
+			Compare("flip rgba vertically",
+				[&] { res::Flip       (rgba, math::Vector<2, bool>(false, true)); },
+				[&] { res::FlipGeneral(rgba, math::Vector<2, bool>(false, true)); });
+			Compare("scale rgba by half",
+				[&] { res::Scale       (rgba, size / 2u); },
+				[&] { res::ScaleGeneral(rgba, size / 2u); });
+			Compare("align rgb to 1",
+				[&] { res::Align       (rgb, 1); },
+				[&] { res::AlignGeneral(rgb, 1); });
+		}
+
+		/*----------------+
+		| ycbcr benchmark |
+		+----------------*/
+
+		/**
+		 * Returns the name of a SIMD level, for printing.
+		 */
+		const char *GetSimdLevelName(math::SimdLevel level)
+		{
+			switch (level)
+			{
+				case math::SimdLevel::none:  return "scalar";
+				case math::SimdLevel::ssse3: return "ssse3";
+				case math::SimdLevel::avx2:  return "avx2";
+			}
+			return "unknown";
+		}
+
+		/**
+		 * Checks that every SIMD kernel of math::RgbToYcbcr420 matches the
+		 * scalar kernel for each pixel layout, including odd sizes that
+		 * leave pixels for the scalar tail, and then compares their
+		 * throughput at common video resolutions, with and without splitting
+		 * the image into bands on worker threads.
+		 */
+		void RunYcbcrBenchmark()
+		{
+			const unsigned iterations = 20;
+			std::vector<math::SimdLevel> levels;
+			for (auto level : {math::SimdLevel::none, math::SimdLevel::ssse3, math::SimdLevel::avx2})
+				if (level <= math::GetSimdLevel()) levels.push_back(level);
+
+			// converts an image with each level into a separate buffer
+			struct Planes
+			{
+				explicit Planes(const math::Vec2u &size) :
+					stride(size.x + size.x % 2),
+					data(stride * (size.y + size.y % 2) * 3 / 2) {}
+
+				unsigned char *Y()  { return data.data(); }
+				unsigned char *Cb() { return Y() + data.size() / 3 * 2; }
+				unsigned char *Cr() { return Cb() + data.size() / 6; }
+
+				unsigned stride;
+				std::vector<unsigned char> data;
+			};
+			std::mt19937 random;
+			std::uniform_int_distribution<unsigned> byte(0, 255);
+
+			std::cout << "conformance" << std::endl;
+			{
+				log::Indenter indenter;
+				std::cout << "supported: " << GetSimdLevelName(math::GetSimdLevel()) << std::endl;
+				unsigned cases = 0, mismatches = 0;
+				for (auto layout : {math::RgbLayout::rgb, math::RgbLayout::rgba, math::RgbLayout::bgra})
+				{
+					unsigned pixelSize = layout == math::RgbLayout::rgb ? 3 : 4;
+					for (math::Vec2u size : {math::Vec2u(1, 1), math::Vec2u(7, 3), math::Vec2u(33, 17), math::Vec2u(641, 361)})
+					{
+						std::vector<unsigned char> rgb(Content(size) * pixelSize);
+						for (auto &c : rgb) c = byte(random);
+						Planes expected(size);
+						math::RgbToYcbcr420(rgb.data(), expected.Y(), expected.Cb(), expected.Cr(),
+							size, size.x * pixelSize, expected.stride, layout, math::SimdLevel::none);
+						for (auto level : levels)
+						{
+							Planes actual(size);
+							math::RgbToYcbcr420(rgb.data(), actual.Y(), actual.Cb(), actual.Cr(),
+								size, size.x * pixelSize, actual.stride, layout, level);
+							++cases;
+							if (actual.data != expected.data) ++mismatches;
+						}
+					}
+				}
+				std::cout << "cases: " << cases << std::endl;
+				std::cout << "mismatches: " << mismatches << std::endl;
+			}
+
+			util::WorkerPool workers;
+			for (math::Vec2u size : {math::Vec2u(1280, 720), math::Vec2u(1920, 1080), math::Vec2u(3840, 2160)})
+			{
+				std::cout << size.x << "x" << size.y << std::endl;
+				log::Indenter indenter;
+				std::vector<unsigned char> rgb(Content(size) * 3);
+				for (auto &c : rgb) c = byte(random);
+				Planes planes(size);
+
+				double scalar = 0;
+				for (auto level : levels)
+				{
+					double time = Time(iterations, [&]
+					{
+						math::RgbToYcbcr420(rgb.data(), planes.Y(), planes.Cb(), planes.Cr(),
+							size, size.x * 3, planes.stride, math::RgbLayout::rgb, level);
+					});
+					if (level == math::SimdLevel::none) scalar = time;
+					std::cout << GetSimdLevelName(level) << ": " << time << "us";
+					if (time) std::cout << " (" << scalar / time << "x)";
+					std::cout << std::endl;
+				}
+
+				// NOTE: each band is a whole number of pairs of rows
+				const std::size_t rowPairsPerJob = 32;
+				double banded = Time(iterations, [&]
+				{
+					workers.ParallelFor((size.y + 1) / 2, rowPairsPerJob, [&](std::size_t first, std::size_t last)
+					{
+						unsigned
+							row    = first * 2,
+							endRow = std::min<std::size_t>(last * 2, size.y);
+						math::RgbToYcbcr420(
+							rgb.data() + row * size.x * 3,
+							planes.Y()  + row * planes.stride,
+							planes.Cb() + row / 2 * (planes.stride / 2),
+							planes.Cr() + row / 2 * (planes.stride / 2),
+							math::Vec2u(size.x, endRow - row), size.x * 3, planes.stride);
+					});
+				});
+				std::cout << GetSimdLevelName(math::GetSimdLevel()) << " (" << std::thread::hardware_concurrency() << " threads): " << banded << "us";
+				if (banded) std::cout << " (" << scalar / banded << "x)";
+				std::cout << std::endl;
+			}
+		}
+
+		/*--------------------+
+		| animation benchmark |
+		+--------------------*/
+
+		/**
+		 * Compresses the animations of a character, and prints how much
+		 * memory they use before and after, the largest difference that
+		 * compression makes to the played bones, and the cost of evaluating
+		 * the bones with the time advancing a tick at a time, as when the
+		 * animations are playing, and with the time jumping around.
+		 */
+		void RunAnimationBenchmark()
+		{
+			const unsigned evaluations = 10000;
+
+			std::cout << "initializing resources" << std::endl;
+			{
+				log::Indenter indenter;
+				GLOBAL(res::Index); // build the resource index
+			}
+
+			cache::ResourceProxy<res::Character> character("character/male-1/male.char");
+			const auto &gait(*character->gait);
+			std::vector<std::pair<std::string, std::shared_ptr<const res::Animation>>> animations;
+			for (const auto &kv : std::vector<std::pair<std::string, const cache::ResourceProxy<res::Animation> *>>{
+				{"ambient", &character->animation.ambient},
+				{"run",     &gait.run.animation},
+				{"sneak",   &gait.sneak.animation},
+				{"turn",    &gait.turn.animation},
+				{"walk",    &gait.walk.animation}})
+				if (*kv.second) animations.emplace_back(kv.first, kv.second->lock());
+
+			// the rotation angle between two orientations
+			auto GetAngle([](const math::Quat<> &a, const math::Quat<> &b)
+			{
+				float chord = Len(Dot(a, b) < 0 ? a + b : a - b);
+				return 4 * std::asin(std::min(chord / 2, 1.f));
+			});
+
+			const float tolerance = *CVAR(animationTolerance);
+			std::cout << "tolerance: " << tolerance << std::endl;
+			std::size_t totalSize = 0, totalCompressedSize = 0;
+			for (const auto &kv : animations)
+			{
+				const auto &anim(kv.second);
+				auto compressed(std::make_shared<res::Animation>(*anim));
+				res::Compress(*compressed, tolerance);
+				std::size_t
+					size           = cache::GetSize(*anim),
+					compressedSize = cache::GetSize(*compressed);
+				totalSize           += size;
+				totalCompressedSize += compressedSize;
+
+				// compare the bones at every tick of the animation
+				float maxAngle = 0, maxDistance = 0;
+				for (const auto &bone : anim->bones)
+				{
+					const auto &compressedBone(compressed->bones.at(bone.first));
+					phys::Interpolator<math::Quat<>>
+						orientation          (std::shared_ptr<const res::Animation::Bone::Orientation>(anim,       &bone.second.orientation)),
+						compressedOrientation(std::shared_ptr<const res::Animation::Bone::Orientation>(compressed, &compressedBone.orientation));
+					phys::Interpolator<math::Vec3>
+						position          (std::shared_ptr<const res::Animation::Bone::Position>(anim,       &bone.second.position)),
+						compressedPosition(std::shared_ptr<const res::Animation::Bone::Position>(compressed, &compressedBone.position));
+					for (float time = 0; time <= anim->duration; time += 1 / 60.f)
+					{
+						if (orientation) maxAngle = std::max(maxAngle,
+							GetAngle(orientation.Get(time), compressedOrientation.Get(time)));
+						if (position) maxDistance = std::max(maxDistance,
+							Len(position.Get(time) - compressedPosition.Get(time)));
+					}
+				}
+
+				std::cout << kv.first << std::endl;
+				log::Indenter indenter;
+				std::cout << "bones: " << anim->bones.size() << std::endl;
+				std::cout << "size: " << size << " bytes" << std::endl;
+				std::cout << "compressed size: " << compressedSize << " bytes";
+				if (compressedSize) std::cout << " (" << double(size) / compressedSize << "x)";
+				std::cout << std::endl;
+				std::cout << "max orientation error: " << maxAngle << " rad" << std::endl;
+				std::cout << "max position error: " << maxDistance << std::endl;
+			}
+			std::cout << "total size: " << totalSize << " bytes" << std::endl;
+			std::cout << "total compressed size: " << totalCompressedSize << " bytes" << std::endl;
+
+			// evaluate the orientations of the walk, which are what the
+			// controllers spend most of their time on
+			if (!gait.walk.animation) return;
+			auto walk(gait.walk.animation.lock());
+			auto compressedWalk(std::make_shared<res::Animation>(*walk));
+			res::Compress(*compressedWalk, tolerance);
+			std::vector<float> jumps(evaluations);
+			{
+				std::mt19937 random;
+				std::uniform_real_distribution<float> time(0, walk->duration);
+				for (auto &jump : jumps) jump = time(random);
+			}
+			// the orientations are summed so that they aren't optimized away
+			float sum = 0;
+			auto Evaluate([&](const std::shared_ptr<const res::Animation> &anim, bool jump)
+			{
+				std::vector<phys::Interpolator<math::Quat<>>> interpolators;
+				for (const auto &bone : anim->bones)
+					if (bone.second.orientation.GetSize())
+						interpolators.emplace_back(std::shared_ptr<const res::Animation::Bone::Orientation>(anim, &bone.second.orientation));
+				float time = 0;
+				unsigned i = 0;
+				double elapsed = Time(evaluations, [&]
+				{
+					if (jump) time = jumps[i++];
+					else if ((time += 1 / 60.f) > anim->duration) time = 0;
+					for (const auto &interpolator : interpolators)
+						sum += interpolator.Get(time).w;
+				});
+				return interpolators.empty() ? 0 : elapsed * 1000 / interpolators.size();
+			});
+			std::cout << "walk evaluation" << std::endl;
+			log::Indenter indenter;
+			std::cout << "playing: " << Evaluate(walk, false) << "ns" << std::endl;
+			std::cout << "jumping: " << Evaluate(walk, true) << "ns" << std::endl;
+			std::cout << "compressed playing: " << Evaluate(compressedWalk, false) << "ns" << std::endl;
+			std::cout << "compressed jumping: " << Evaluate(compressedWalk, true) << "ns" << std::endl;
+			std::cout << "checksum: " << sum << std::endl;
+		}
+
+		/**
+		 * The available benchmarks, by name.
+		 */
+		const std::map<std::string, std::function<void ()>> benchmarks =
+		{
+			{"animation", RunAnimationBenchmark},
+			{"audio",     RunAudioBenchmark},
+			{"blend",     RunBlendBenchmark},
+			{"clip",      RunClipBenchmark},
+			{"cvar",      RunCvarBenchmark},
+			{"gui",       RunGuiBenchmark},
+			{"image",     RunImageBenchmark},
+			{"index",     RunIndexBenchmark},
+			{"log",       RunLogBenchmark},
+			{"particles", RunParticleBenchmark},
+			{"pose",      RunPoseBenchmark},
+			{"scene",     RunSceneBenchmark},
+			{"skin",      RunSkinBenchmark},
+			{"text",      RunTextBenchmark},
+			{"track",     RunTrackBenchmark},
+			{"ycbcr",     RunYcbcrBenchmark}
+		};
+	}
+
+	void RunBenchmark(const std::string &name)
+	{
+		auto iter(benchmarks.find(name));
+		if (iter == benchmarks.end())
+			THROW((err::Exception<err::GameModuleTag, err::KeyNotFoundTag>("benchmark not found")))
+
+		std::cout << "running benchmark: " << name << std::endl;
+		log::Indenter indenter;
+		iter->second();
+	}
+}}
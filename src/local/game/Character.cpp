@@ -64,7 +64,7 @@ namespace page { namespace game
 		if (phys::LipsyncController::IsCompatibleWith(body))
 			body.AttachController(phys::LipsyncController(body));
 		if (character.animation.ambient)
-			body.AttachController(phys::AnimationController(*character.animation.ambient));
+			body.AttachController(phys::AnimationController(character.animation.ambient.lock()));
 		if (character.gait)
 			body.AttachController(phys::GaitController(body, character.gait));
 	}
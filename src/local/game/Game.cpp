@@ -26,6 +26,8 @@
  */
 
 #include <algorithm> // max, min
+#include <chrono> // steady_clock
+#include <cmath> // fmod
 #include <functional> // bind
 #include <iostream> // cout
 
@@ -43,7 +45,7 @@
 #include "../phys/node/Body.hpp" // Body->Node
 #include "../phys/Scene.hpp"
 #include "../res/clip/Stream.hpp"
-#include "../res/Index.hpp" // Index::Refresh
+#include "../res/Index.hpp" // Index::{Poll,Refresh,Update}
 #include "../res/save/SaverRegistry.hpp"
 #include "../res/type/Scene.hpp"
 #include "../script/Driver.hpp"
@@ -74,7 +76,7 @@ namespace page { namespace game
 	| constructors |
 	+-------------*/
 
-	Game::Game()
+	Game::Game(bool headless)
 	{
 		// NOTE: resources must be indexed before initializing the video
 		// driver, which uses GLSL shader resources
@@ -83,32 +85,35 @@ namespace page { namespace game
 			log::Indenter indenter;
 			GLOBAL(res::Index); // build the resource index
 		}
-		std::cout << "creating window" << std::endl;
+		if (!headless)
 		{
-			log::Indenter indenter;
-			window = GLOBAL(wnd::WindowRegistry).Make(STRINGIZE(NAME));
-			// bind signal handlers
-			using namespace std::placeholders;
-			window->exitSig.connect(std::bind(&Game::OnExit, this));
-			window->focusSig.connect(std::bind(&Game::OnFocus, this, _1));
-		}
-		std::cout << "initializing video driver" << std::endl;
-		{
-			log::Indenter indenter;
-			vid::Driver &driver(window->GetVideoDriver());
-		}
-		std::cout << "initializing audio driver" << std::endl;
-		{
-			log::Indenter indenter;
-			aud::Driver &driver(window->GetAudioDriver());
-		}
-		std::cout << "initializing input driver" << std::endl;
-		{
-			log::Indenter indenter;
-			inp::Driver &driver(window->GetInputDriver());
-			// bind signal handlers
-			using namespace std::placeholders;
-			driver.keySig.connect(std::bind(&Game::OnKey, this, _1));
+			std::cout << "creating window" << std::endl;
+			{
+				log::Indenter indenter;
+				window = GLOBAL(wnd::WindowRegistry).Make(STRINGIZE(NAME));
+				// bind signal handlers
+				using namespace std::placeholders;
+				window->exitSig.connect(std::bind(&Game::OnExit, this));
+				window->focusSig.connect(std::bind(&Game::OnFocus, this, _1));
+			}
+			std::cout << "initializing video driver" << std::endl;
+			{
+				log::Indenter indenter;
+				vid::Driver &driver(window->GetVideoDriver());
+			}
+			std::cout << "initializing audio driver" << std::endl;
+			{
+				log::Indenter indenter;
+				aud::Driver &driver(window->GetAudioDriver());
+			}
+			std::cout << "initializing input driver" << std::endl;
+			{
+				log::Indenter indenter;
+				inp::Driver &driver(window->GetInputDriver());
+				// bind signal handlers
+				using namespace std::placeholders;
+				driver.keySig.connect(std::bind(&Game::OnKey, this, _1));
+			}
 		}
 		std::cout << "initializing script driver" << std::endl;
 		{
@@ -146,10 +151,20 @@ namespace page { namespace game
 
 	void Game::LoadScene(const res::Scene &scene)
 	{
-		this->scene->Reset(scene);
+		// start loading the player in the background
+		cache::ResourceProxy<res::Character> playerCharacter("character/male-1/male.char");
+		playerCharacter.IsReady();
+
+		if (this->scene)
+			this->scene->Reset(scene);
+		else
+			this->scene.reset(new phys::Scene(scene));
+		tickAccumulator = 0;
+		if (window)
+			window->GetAudioDriver().Imbue(this->scene.get());
 
 		// start music
-		if (scene.music)
+		if (window && scene.music)
 		{
 			boost::optional<log::Indenter> indenter;
 			if (*CVAR(logVerbose))
@@ -170,7 +185,7 @@ namespace page { namespace game
 		}
 
 		// create player
-		player.reset(new Player(std::make_shared<Character>(*cache::ResourceProxy<res::Character>("character/male-1/male.char"))));
+		player.reset(new Player(std::make_shared<Character>(*playerCharacter)));
 		auto playerBody(player->GetCharacter()->GetBodyPtr());
 		this->scene->Insert(playerBody);
 		playerBody->SetTrack(this->scene->GetTrack());
@@ -196,6 +211,8 @@ namespace page { namespace game
 			{
 				window->Update();
 				timer->Update();
+				GLOBAL(res::Index).Poll(); // apply changes to resources
+				GLOBAL(res::Index).Update(); // run deferred loads
 				if (window->HasFocus())
 				{
 					if (float deltaTime = FixDeltaTime(timer->GetDelta()))
@@ -204,14 +221,7 @@ namespace page { namespace game
 						UpdateCursor();
 //						gui->Update(deltaTime);
 						UpdatePause(deltaTime);
-						if (timeScale)
-						{
-							float deltaTimeScaled = deltaTime * timeScale;
-							scriptDriver->Update(deltaTimeScaled);
-							if (player)
-								player->Update(window->GetInputDriver());
-							scene->Update(deltaTimeScaled);
-						}
+						UpdateSimulation(deltaTime * timeScale);
 //						window->GetVideoDriver().Render(*gui);
 						window->GetAudioDriver().Update(deltaTime);
 						UpdateRecording();
@@ -223,10 +233,58 @@ namespace page { namespace game
 		}
 	}
 
+	void Game::RunHeadless(unsigned ticks)
+	{
+		// NOTE: the frame rate is irrelevant here, so we tick back-to-back
+		// without polling the resource index or sleeping, which makes the
+		// results depend only on the tick rate and the number of ticks
+		const float tickTime = 1 / *CVAR(simTickRate);
+		std::cout << "running " << ticks << " simulation ticks" << std::endl;
+		{
+			log::Indenter indenter;
+			typedef std::chrono::steady_clock Clock;
+			auto start(Clock::now());
+			for (unsigned i = 0; i < ticks && !exit; ++i)
+			{
+				Tick(tickTime);
+				GLOBAL(cache::Cache).Update(tickTime);
+			}
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			std::cout << "simulated " << ticks * tickTime << "s in " << seconds << "s" << std::endl;
+			std::cout << ticks / seconds << " ticks/s" << std::endl;
+		}
+	}
+
 	/*-------+
 	| update |
 	+-------*/
 
+	void Game::UpdateSimulation(float deltaTime)
+	{
+		const float tickTime = 1 / *CVAR(simTickRate);
+		tickAccumulator += deltaTime;
+		for (unsigned ticks = 0; tickAccumulator >= tickTime; tickAccumulator -= tickTime)
+		{
+			if (ticks++ == *CVAR(simMaxTicks))
+			{
+				// drop the time we can't catch up on, rather than falling
+				// further behind with every frame
+				tickAccumulator = std::fmod(tickAccumulator, tickTime);
+				break;
+			}
+			Tick(tickTime);
+		}
+		scene->SetTickInterpolation(tickAccumulator / tickTime);
+	}
+
+	void Game::Tick(float tickTime)
+	{
+		scriptDriver->Update(tickTime);
+		if (player && window)
+			player->Update(window->GetInputDriver());
+		scene->Update(tickTime);
+	}
+
 	void Game::UpdateCursor()
 	{
 /*		if (window->GetInputDriver().GetCursorMode() == inp::Driver::CursorMode::point)
@@ -356,7 +414,9 @@ namespace page { namespace game
 					*CVAR(clipFormat),
 					*CVAR(clipVideoResolution),
 					*CVAR(clipFramerate),
-					clipQuality = *CVAR(clipQuality)));
+					clipQuality = *CVAR(clipQuality),
+					*CVAR(clipQueueDepth),
+					*CVAR(clipDropFrames)));
 				clipDeltaTime = 0;
 			}
 			else
@@ -69,7 +69,11 @@ namespace page { namespace game
 		+-------------*/
 
 		public:
-		Game();
+		/**
+		 * @param headless Runs the game without a window, which leaves out
+		 *        video, audio, and input, for use with @c RunHeadless.
+		 */
+		explicit Game(bool headless = false);
 		~Game();
 
 		/*----------+
@@ -92,7 +96,26 @@ namespace page { namespace game
 		 */
 		void Run();
 
+		/**
+		 * Runs the specified number of simulation ticks as fast as possible,
+		 * without waiting for real time to pass, for deterministic
+		 * benchmarking of the simulation.
+		 */
+		void RunHeadless(unsigned ticks);
+
 		private:
+		/**
+		 * Advances the simulation by the time that has passed, in a whole
+		 * number of fixed ticks, and updates the interpolation that is used
+		 * to render between the last two ticks.
+		 */
+		void UpdateSimulation(float deltaTime);
+
+		/**
+		 * Advances the simulation by a single fixed tick.
+		 */
+		void Tick(float tickTime);
+
 		/**
 		 * Provides the GUI with an updated cursor position, which is used to
 		 * recognize when the cursor is hovering over a widget.
@@ -184,6 +207,12 @@ namespace page { namespace game
 		 */
 		float pauseScale = 0;
 
+		/**
+		 * The simulation time that has passed since the last tick, which is
+		 * carried over to the next frame.
+		 */
+		float tickAccumulator = 0;
+
 		/**
 		 * The clip stream for recording.
 		 */
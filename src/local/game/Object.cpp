@@ -44,6 +44,6 @@ namespace page { namespace game
 
 		// initialize controllers
 		if (object.animation.ambient)
-			body.AttachController(phys::AnimationController(*object.animation.ambient));
+			body.AttachController(phys::AnimationController(object.animation.ambient.lock()));
 	}
 }}
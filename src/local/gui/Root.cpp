@@ -29,7 +29,7 @@
 #include "../vid/DrawContext.hpp" // DrawContext::{FrameSaver,GetFrameAspect,PushFrame}
 #include "DrawContext.hpp"
 #include "Root.hpp"
-#include "Widget.hpp" // Widget::{Draw,Get{Position,Size},OnOver,Update}
+#include "widget/Widget.hpp" // Widget::{Click,Draw,Get{Lifetime,Position,Size},InvalidateAllLayouts,on{CursorEnter,CursorLeave},Pick,Update}
 
 namespace page { namespace gui
 {
@@ -52,6 +52,7 @@ namespace page { namespace gui
 	void Root::SetTheme(const std::shared_ptr<const res::Theme> &theme)
 	{
 		this->theme = theme;
+		Widget::InvalidateAllLayouts();
 	}
 
 	/*--------+
@@ -65,11 +66,11 @@ namespace page { namespace gui
 
 	math::Aabb<2> Root::GetBounds(const Widget &widget, float aspect) const
 	{
-		Widget::Size widgetSize(widget.GetSize(*theme));
+		Widget::WidgetSize widgetSize(widget.GetSize(*theme));
 		math::Vec2
 			scale(1 / (theme->scale * math::Vec2(aspect, 1))),
-			size((widgetSize.min + theme->margin * 2) * scale);
-		size = Select(widgetSize.mode == Widget::Size::max, Max(size, 1), size);
+			size((widgetSize.minSize + theme->margin * 2) * scale);
+		size = Select(widgetSize.fillMode == WidgetSizeConstraints::FillMode::fill, Max(size, 1), size);
 		math::Vec2 pos(widget.GetPosition() * (1 - size));
 		return Shrink(AabbPositionSize(pos, size), theme->margin * scale);
 	}
@@ -98,15 +99,54 @@ namespace page { namespace gui
 	}
 	bool Root::UpdateCursor(const math::Vec2 &pos, float aspect)
 	{
-		bool result = false;
-		for (Widgets::iterator iter(widgets.begin()); iter != widgets.end(); ++iter)
+		math::Vec2 hitPos;
+		Widget *hit = Pick(pos, aspect, hitPos);
+		// notify widgets that the cursor entered or left
+		Widget *lastHit = GetCursorWidget();
+		if (hit != lastHit)
+		{
+			if (lastHit) lastHit->onCursorLeave();
+			cursorWidget = hit;
+			cursorWidgetLifetime.reset();
+			if (hit)
+			{
+				cursorWidgetLifetime = hit->GetLifetime();
+				hit->onCursorEnter();
+			}
+		}
+		return hit;
+	}
+
+	Widget *Root::GetCursorWidget() const
+	{
+		return cursorWidgetLifetime.expired() ? nullptr : cursorWidget;
+	}
+
+	bool Root::Click(const math::Vec2 &pos, float aspect, unsigned button)
+	{
+		math::Vec2 hitPos;
+		Widget *hit = Pick(pos, aspect, hitPos);
+		if (hit) hit->Click(hitPos, *theme, button);
+		return hit;
+	}
+
+	/*---------------+
+	| implementation |
+	+---------------*/
+
+	Widget *Root::Pick(const math::Vec2 &pos, float aspect, math::Vec2 &hitPos)
+	{
+		Widget *hit = nullptr;
+		math::Vec2
+			scale(theme->scale * math::Vec2(aspect, 1)),
+			themePos(pos * scale);
+		for (Widgets::reverse_iterator iter(widgets.rbegin()); iter != widgets.rend() && !hit; ++iter)
 		{
 			Widget &widget(**iter);
-			math::Vec2 themePos(pos * theme->scale * math::Vec2(aspect, 1));
-			math::Aabb<2> bounds(GetBounds(widget, aspect) * theme->scale * math::Vec2(aspect, 1));
+			math::Aabb<2> bounds(GetBounds(widget, aspect) * scale);
 			if (Contains(bounds, themePos))
-				result |= widget.OnOver(themePos - bounds.min, *theme, Size(bounds));
+				hit = widget.Pick(themePos - bounds.min, *theme, &hitPos);
 		}
-		return result;
+		return hit;
 	}
 }}
@@ -28,6 +28,8 @@
 #ifndef    page_local_gui_Root_hpp
 #   define page_local_gui_Root_hpp
 
+#	include <memory> // weak_ptr
+
 #	include "../math/Aabb.hpp"
 #	include "../util/class/special_member_functions.hpp" // Polymorphic
 #	include "widget/container/WidgetContainer.hpp"
@@ -91,19 +93,55 @@ namespace page { namespace gui
 		void Update(float deltaTime);
 
 		/**
-		 * Updates the mouse-over state of child widgets.
+		 * Finds the widget under the cursor and notifies the widgets that the
+		 * cursor enters and leaves.
+		 *
+		 * @return @c true if the cursor is over a widget.
 		 */
 		bool UpdateCursor(const math::Vec2 &cursorPosition, float aspect);
 
+		/**
+		 * @return The widget under the cursor, or @c nullptr.
+		 */
+		Widget *GetCursorWidget() const;
+
+		/**
+		 * Clicks the widget under the cursor.
+		 *
+		 * @return @c true if the cursor is over a widget.
+		 */
+		bool Click(const math::Vec2 &cursorPosition, float aspect, unsigned button);
+
+		/*---------------+
+		| implementation |
+		+---------------*/
+
+		private:
+		/**
+		 * Finds the widget at the cursor position, starting with the
+		 * top-level widget that was drawn last.
+		 *
+		 * @param[out] hitPosition The position relative to the widget that
+		 *             was hit, in theme units.
+		 */
+		Widget *Pick(const math::Vec2 &cursorPosition, float aspect, math::Vec2 &hitPosition);
+
 		/*-------------+
 		| data members |
 		+-------------*/
 
-		private:
 		/**
 		 * The GUI's theme.
 		 */
 		std::shared_ptr<const res::Theme> theme;
+
+		/**
+		 * The widget that was under the cursor after the last call to
+		 * UpdateCursor(), which is only valid while @c cursorWidgetLifetime
+		 * hasn't expired, since the widget may have been destroyed since.
+		 */
+		Widget *cursorWidget = nullptr;
+		std::weak_ptr<const void> cursorWidgetLifetime;
 	};
 }}
 
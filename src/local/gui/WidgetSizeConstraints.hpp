@@ -28,6 +28,8 @@
 #ifndef    page_local_gui_WidgetSizeConstraints_hpp
 #   define page_local_gui_WidgetSizeConstraints_hpp
 
+#	include "../math/Vector.hpp"
+
 namespace page { namespace gui
 {
 	/**
@@ -58,6 +60,12 @@ namespace page { namespace gui
 			growToFit
 		};
 
+		WidgetSizeConstraints() = default;
+		explicit WidgetSizeConstraints(
+			math::Vec2                const& minSize,
+			math::Vector<2, FillMode> const& fillMode = FillMode::shrinkWrap) :
+				minSize(minSize), fillMode(fillMode) {}
+
 		/**
 		 * The widget's minimum size.
 		 */
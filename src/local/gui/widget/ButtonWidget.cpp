@@ -36,10 +36,10 @@ namespace page { namespace gui
 	| Widget overrides |
 	+-----------------*/
 
-	WidgetSize ButtonWidget::CalcSize(const res::Theme &theme) const
+	auto ButtonWidget::CalcSize(const res::Theme &theme) const -> WidgetSize
 	{
 		// FIXME: implement
-		return WidgetSize(0);
+		return WidgetSize();
 	}
 
 	void ButtonWidget::DoDraw(DrawContext &context) const
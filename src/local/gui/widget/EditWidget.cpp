@@ -33,10 +33,10 @@ namespace page { namespace gui
 	| Widget overrides |
 	+-----------------*/
 
-	WidgetSize EditWidget::CalcSize(const res::Theme &theme) const
+	auto EditWidget::CalcSize(const res::Theme &theme) const -> WidgetSize
 	{
 		// FIXME: implement
-		return WidgetSize(0);
+		return WidgetSize();
 	}
 
 	void EditWidget::DoDraw(DrawContext &context) const
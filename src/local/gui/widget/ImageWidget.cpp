@@ -50,15 +50,17 @@ namespace page { namespace gui
 	| Widget overrides |
 	+-----------------*/
 
-	WidgetSize ImageWidget::CalcSize(const res::Theme &theme) const
+	auto ImageWidget::CalcSize(const res::Theme &theme) const -> WidgetSize
 	{
-		return WidgetSize(
-			Select(size, size * theme.scale, (*img)->size),
-			Select(size, WidgetSize::Mode::grow, WidgetSize::Mode::shrink));
+		// NOTE: the image grows along the axes where it was given a size
+		WidgetSize result(Select(size, size * theme.scale, image->size));
+		for (unsigned i = 0; i < 2; ++i)
+			if (size[i]) result.fillMode[i] = WidgetSize::FillMode::growToFit;
+		return result;
 	}
 
 	void ImageWidget::DoDraw(DrawContext &context) const
 	{
-		context.DrawImage(*img, 0, 1);
+		context.DrawImage(image, 0, 1);
 	}
 }}
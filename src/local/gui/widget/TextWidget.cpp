@@ -56,18 +56,19 @@ namespace page { namespace gui
 	void TextWidget::SetText(const std::string &text)
 	{
 		this->text = text;
+		InvalidateLayout();
 	}
 
 	/*-----------------+
 	| Widget overrides |
 	+-----------------*/
 
-	WidgetSize TextWidget::CalcSize(const res::Theme &theme) const
+	auto TextWidget::CalcSize(const res::Theme &theme) const -> WidgetSize
 	{
 		return WidgetSize(Select(size, size * theme.scale,
 			GetTextSize(*theme.text.font, text.begin(), text.end(),
 				wrap ? size.x * theme.scale : 0) * theme.text.size),
-			WidgetSize::Mode::grow);
+			WidgetSize::FillMode::growToFit);
 	}
 
 	void TextWidget::DoDraw(DrawContext &context) const
@@ -27,9 +27,10 @@
 
 #include <algorithm> // max, min
 
-#include "../math/interp.hpp" // HermiteScale
-#include "../vid/DrawContext.hpp" // DrawContext::{alphaFilter,GetFilterCaps,PushAlphaFilter}
-#include "DrawContext.hpp" // DrawContext::GetBase
+#include "../../math/interp.hpp" // HermiteScale
+#include "../../res/type/Theme.hpp" // Theme::scale
+#include "../../vid/DrawContext.hpp" // DrawContext::{alphaFilter,GetFilterCaps,PushAlphaFilter}
+#include "../DrawContext.hpp" // DrawContext::GetBase
 #include "Widget.hpp"
 
 namespace page { namespace gui
@@ -45,6 +46,8 @@ namespace page { namespace gui
 	const float Widget::visibilityFadeOutDuration = 0.5;
 	const float Widget::visibilityFadeExponent    = 1.5;
 
+	unsigned Widget::layoutGeneration = 0;
+
 	/*-------------+
 	| constructors |
 	+-------------*/
@@ -71,11 +74,17 @@ namespace page { namespace gui
 		return minSize;
 	}
 
-	WidgetSizeConstraints Widget::GetSizeConstraints(const res::Theme &theme) const
+	auto Widget::GetSize(const res::Theme &theme) const -> WidgetSize
 	{
-		auto size(GetSizeConstraints(theme));
-		size.min = Max(size.min, minSize * theme.scale);
-		return size;
+		if (!layout.valid || layout.theme != &theme || layout.generation != layoutGeneration)
+		{
+			layout.size = CalcSize(theme);
+			layout.size.minSize = Max(layout.size.minSize, minSize * theme.scale);
+			layout.valid = true;
+			layout.theme = &theme;
+			layout.generation = layoutGeneration;
+		}
+		return layout.size;
 	}
 
 	void Widget::SetPosition(const math::Vec2 &position)
@@ -86,6 +95,54 @@ namespace page { namespace gui
 	void Widget::SetMinSize(const math::Vec2 &minSize)
 	{
 		this->minSize = minSize;
+		InvalidateLayout();
+	}
+
+	/*-------+
+	| layout |
+	+-------*/
+
+	void Widget::InvalidateLayout()
+	{
+		for (const Widget *widget = this; widget; widget = widget->layout.parent)
+			widget->layout.valid = false;
+	}
+
+	void Widget::InvalidateAllLayouts()
+	{
+		++layoutGeneration;
+	}
+
+	/*------------+
+	| hit testing |
+	+------------*/
+
+	Widget *Widget::Pick(const math::Vec2 &position, const res::Theme &theme, math::Vec2 *hitPosition)
+	{
+		if (!IsVisible()) return nullptr;
+		math::Vec2 localPosition;
+		Widget *widget = DoPick(position, theme, localPosition);
+		if (hitPosition) *hitPosition = localPosition;
+		return widget;
+	}
+
+	/*------------+
+	| interaction |
+	+------------*/
+
+	void Widget::Click(const math::Vec2 &position, const res::Theme &theme, unsigned button)
+	{
+		DoClick(position, theme, button);
+		onClick(button);
+	}
+
+	/*---------+
+	| lifetime |
+	+---------*/
+
+	std::weak_ptr<const void> Widget::GetLifetime() const
+	{
+		return lifetime.token;
 	}
 
 	/*-----------+
@@ -113,7 +170,7 @@ namespace page { namespace gui
 		if (!fade) visibility = visible;
 	}
 
-	bool Widget::GetOpacity() const
+	float Widget::GetOpacity() const
 	{
 		return opacity;
 	}
@@ -135,7 +192,7 @@ namespace page { namespace gui
 	void Widget::SetGlow(bool glow, bool fade)
 	{
 		this->glow = glow;
-		if (!fade) glowiness = glow;
+		if (!fade) glowTransitionState = glow;
 	}
 
 	float Widget::GetGlowIntensity() const
@@ -163,8 +220,8 @@ namespace page { namespace gui
 			context.GetBase().PushAlphaFilter(math::HermiteScale(visibility, visibilityFadeExponent) * opacity);
 
 		// apply glow filter
-		if (glowiness * glowIntensity > 0 && (context.GetBase().GetFilterCaps() & DrawContext::Base::glowFilter))
-			context.GetBase().PushGlowFilter(math::HermiteScale(glowiness, glowFadeExponent) * glowIntensity);
+		if (glowTransitionState * glowIntensity > 0 && (context.GetBase().GetFilterCaps() & DrawContext::Base::glowFilter))
+			context.GetBase().PushGlowFilter(math::HermiteScale(glowTransitionState, glowFadeExponent) * glowIntensity);
 
 		DoDraw(context);
 	}
@@ -174,14 +231,14 @@ namespace page { namespace gui
 		DoUpdate(deltaTime);
 
 		// update visibility
-		visbility = visible ?
+		visibility = visible ?
 			std::min(visibility + deltaTime / visibilityFadeInDuration,  1.f) :
 			std::max(visibility - deltaTime / visibilityFadeOutDuration, 0.f);
 
-		// update glowiness
-		glowiness = cursorOver ?
-			std::min(glowiness + deltaTime / glowFadeInDuration,  1.f) :
-			std::max(glowiness - deltaTime / glowFadeOutDuration, 0.f);
+		// update glow
+		glowTransitionState = glow ?
+			std::min(glowTransitionState + deltaTime / glowFadeInDuration,  1.f) :
+			std::max(glowTransitionState - deltaTime / glowFadeOutDuration, 0.f);
 	}
 
 	/*------------------+
@@ -189,4 +246,21 @@ namespace page { namespace gui
 	+------------------*/
 
 	void Widget::DoUpdate(float) {}
+
+	Widget *Widget::DoPick(const math::Vec2 &position, const res::Theme &, math::Vec2 &hitPosition)
+	{
+		hitPosition = position;
+		return this;
+	}
+
+	void Widget::DoClick(const math::Vec2 &, const res::Theme &, unsigned) {}
+
+	/*------------------+
+	| container support |
+	+------------------*/
+
+	void Widget::Adopt(const Widget &child) const
+	{
+		child.layout.parent = const_cast<Widget *>(this);
+	}
 }}
@@ -28,10 +28,13 @@
 #ifndef    page_local_gui_widget_Widget_hpp
 #   define page_local_gui_widget_Widget_hpp
 
+#	include <memory> // {shared,weak}_ptr
+
 #	include "../../math/Vector.hpp"
 #	include "../../util/class/Cloneable.hpp"
 #	include "../../util/copyable_signal.hpp"
 #	include "../../inp/Key.hpp"
+#	include "../WidgetSizeConstraints.hpp"
 
 namespace page { namespace res { class Theme; }}
 
@@ -44,11 +47,20 @@ namespace page { namespace gui
 	 */
 	class Widget : public util::Cloneable<Widget>
 	{
+		/*------+
+		| types |
+		+------*/
+
+		public:
+		/**
+		 * The size constraints that are calculated for a widget.
+		 */
+		typedef WidgetSizeConstraints WidgetSize;
+
 		/*-------------+
 		| constructors |
 		+-------------*/
 
-		public:
 		explicit Widget(
 			math::Vec2 const& position = 0.5,
 			math::Vec2 const& minSize  = 0,
@@ -69,9 +81,12 @@ namespace page { namespace gui
 		const math::Vec2 &GetMinSize() const;
 
 		/**
-		 * Returns the widget's size constraints.
+		 * Returns the widget's size constraints, including its minimum size.
+		 *
+		 * The constraints are cached, and are only calculated again after the
+		 * widget's layout is invalidated or when the theme changes.
 		 */
-		WidgetSizeConstraints GetSizeConstraints(const res::Theme &) const;
+		WidgetSize GetSize(const res::Theme &) const;
 
 		/**
 		 * Sets the widget's position.
@@ -110,13 +125,73 @@ namespace page { namespace gui
 		/**
 		 * @return The widget's opacity.
 		 */
-		bool GetOpacity() const;
+		float GetOpacity() const;
 
 		/**
 		 * Sets the widget's opacity.
 		 */
 		void SetOpacity(float);
 
+		/*-------+
+		| layout |
+		+-------*/
+
+		/**
+		 * Marks the cached layout of the widget as out of date, along with
+		 * the layouts of its ancestors.  A widget must call this when any of
+		 * its content that affects its size changes.
+		 */
+		void InvalidateLayout();
+
+		/**
+		 * Marks the cached layouts of every widget as out of date, such as
+		 * when a theme is reloaded in place.
+		 */
+		static void InvalidateAllLayouts();
+
+		/*------------+
+		| hit testing |
+		+------------*/
+
+		/**
+		 * Returns the deepest visible widget at the position, which is
+		 * relative to the top-left corner of this widget, in theme units.
+		 *
+		 * @param[out] hitPosition If not @c nullptr, receives the position
+		 *             relative to the widget that was hit.
+		 *
+		 * @return The widget that was hit, which may be this widget, or @c
+		 *         nullptr if this widget isn't visible.
+		 *
+		 * @note Picking doesn't change the state of any widget, so it can be
+		 *       used for hovering.
+		 */
+		Widget *Pick(const math::Vec2 &position, const res::Theme &, math::Vec2 *hitPosition = nullptr);
+
+		/*------------+
+		| interaction |
+		+------------*/
+
+		/**
+		 * Clicks the widget at the position, which is relative to the
+		 * top-left corner of the widget, in theme units, such as the
+		 * position returned by Pick().
+		 *
+		 * @param[in] button The mouse button that was clicked.
+		 */
+		void Click(const math::Vec2 &position, const res::Theme &, unsigned button);
+
+		/*---------+
+		| lifetime |
+		+---------*/
+
+		/**
+		 * Returns a reference that expires when the widget is destroyed, so
+		 * that a plain pointer to the widget, like the one returned by
+		 * Pick(), can be checked before it is used.
+		 */
+		std::weak_ptr<const void> GetLifetime() const;
+
 		/*----------------+
 		| special effects |
 		+----------------*/
@@ -202,15 +277,39 @@ namespace page { namespace gui
 		+-----------------------*/
 
 		private:
-		virtual WidgetSizeConstraints GetSizeConstraints(const res::Theme &) const = 0;
+		/**
+		 * Calculates the widget's size constraints.  Containers also lay out
+		 * their children here, so that the layout is cached along with the
+		 * size.
+		 */
+		virtual WidgetSize CalcSize(const res::Theme &) const = 0;
 		virtual void DoDraw(DrawContext &) const = 0;
 		virtual void DoUpdate(float deltaTime);
 
-		/*---------------+
-		| event handling |
-		+---------------*/
+		/**
+		 * Returns the deepest widget at the position, and sets @a hitPosition
+		 * to the position relative to that widget.  The default
+		 * implementation returns this widget.
+		 */
+		virtual Widget *DoPick(const math::Vec2 &position, const res::Theme &, math::Vec2 &hitPosition);
+
+		/**
+		 * Responds to a click at the position, before @c onClick is called.
+		 * The default implementation does nothing.
+		 */
+		virtual void DoClick(const math::Vec2 &position, const res::Theme &, unsigned button);
+
+		/*------------------+
+		| container support |
+		+------------------*/
 
-		virtual void OnClick();
+		protected:
+		/**
+		 * Makes this widget the parent of a child widget, so that it is
+		 * invalidated along with the child.  Containers call this for each
+		 * of their children when they are laid out.
+		 */
+		void Adopt(const Widget &child) const;
 
 		/*----------+
 		| constants |
@@ -308,6 +407,52 @@ namespace page { namespace gui
 		 */
 		float glowIntensity = 1.0;
 		///@}
+
+		/**
+		 * The widget's cached layout, which is not copied with the widget.
+		 */
+		struct LayoutCache
+		{
+			LayoutCache() = default;
+			LayoutCache(const LayoutCache &) {}
+			LayoutCache &operator =(const LayoutCache &)
+			{
+				valid = false;
+				return *this;
+			}
+
+			/**
+			 * The container that most recently laid out the widget.
+			 */
+			Widget *parent = nullptr;
+
+			/**
+			 * @c true if @c size is up to date for @c theme.
+			 */
+			bool valid = false;
+			const res::Theme *theme = nullptr;
+			unsigned generation = 0;
+			WidgetSize size;
+		};
+		mutable LayoutCache layout;
+
+		/**
+		 * The token that GetLifetime() refers to, which is unique to each
+		 * widget, including copies.
+		 */
+		struct Lifetime
+		{
+			Lifetime() = default;
+			Lifetime(const Lifetime &) {}
+			Lifetime &operator =(const Lifetime &) { return *this; }
+
+			std::shared_ptr<const void> token = std::make_shared<char>();
+		} lifetime;
+
+		/**
+		 * A counter that is incremented by InvalidateAllLayouts().
+		 */
+		static unsigned layoutGeneration;
 	};
 }}
 
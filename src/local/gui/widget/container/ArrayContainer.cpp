@@ -25,8 +25,7 @@
  * of this software.
  */
 
-#include <algorithm> // max
-#include <functional> // bind
+#include <algorithm> // max, upper_bound
 
 #include "../../../res/type/Theme.hpp" // Theme::margin
 #include "../../../vid/DrawContext.hpp" // DrawContext::{FrameSaver,PushFrame}
@@ -39,71 +38,44 @@ namespace page { namespace gui
 	ArrayContainer::ArrayContainer(bool horizontal, bool margin) :
 		horizontal(horizontal), margin(margin) {}
 
-	// cursor event notification
-	bool ArrayContainer::OnOver(const math::Vec2 &pos, const res::Theme &theme, const math::Vec2 &size)
-	{
-		using namespace std::placeholders;
-		return CheckHit(pos, theme, size,
-			std::bind(&Widget::OnOver, _1, _2, theme, _3));
-	}
-	bool ArrayContainer::OnDown(const math::Vec2 &pos, const res::Theme &theme, const math::Vec2 &size)
-	{
-		using namespace std::placeholders;
-		return CheckHit(pos, theme, size,
-			std::bind(&Widget::OnDown, _1, _2, theme, _3));
-	}
-	bool ArrayContainer::OnClick(const math::Vec2 &pos, const res::Theme &theme, const math::Vec2 &size)
-	{
-		using namespace std::placeholders;
-		return CheckHit(pos, theme, size,
-			std::bind(&Widget::OnClick, _1, _2, theme, _3));
-	}
-
 	// metrics
 	auto ArrayContainer::CalcSize(const res::Theme &theme) const -> WidgetSize
 	{
 		// FIXME: support different sizing modes
 		WidgetSize size;
-		if (!widgets.empty())
-			for (Widgets::const_iterator iter(widgets.begin());;)
-			{
-				const Widget &child(**iter);
-				auto childSize(child.GetSize(theme));
-				size.min[!horizontal] += childSize.min[!horizontal];
-				size.min[horizontal] = std::max(childSize.min[horizontal], size.min[horizontal]);
-				if (++iter == widgets.end()) break;
-				if (margin) size.min[!horizontal] += theme.margin;
-			}
+		boxes.clear();
+		boxes.reserve(widgets.size());
+		math::Vec2 pen;
+		for (Widgets::const_iterator iter(widgets.begin()); iter != widgets.end(); ++iter)
+		{
+			const Widget &child(**iter);
+			Adopt(child);
+			auto childSize(child.GetSize(theme));
+			boxes.push_back(AabbPositionSize(pen, childSize.minSize));
+			pen[!horizontal] += childSize.minSize[!horizontal];
+			size.minSize[horizontal] = std::max(childSize.minSize[horizontal], size.minSize[horizontal]);
+			if (margin && iter + 1 != widgets.end()) pen[!horizontal] += theme.margin;
+		}
+		size.minSize[!horizontal] = pen[!horizontal];
 		return size;
 	}
 
 	// rendering
 	void ArrayContainer::DoDraw(DrawContext &context) const
 	{
-		const res::Theme &theme(context.GetTheme());
-		math::Vec2 scale(context.GetScale());
-		// build child size array
-		typedef std::vector<math::Vec2> Sizes;
-		Sizes sizes;
-		sizes.reserve(widgets.size());
-		for (Widgets::const_iterator iter(widgets.begin()); iter != widgets.end(); ++iter)
-		{
-			const Widget &child(**iter);
-			sizes.push_back(child.GetSize(theme).min * scale);
-		}
+		// bring the layout up to date
+		GetSize(context.GetTheme());
 		// calculate child positions from size modes
 		// FIXME: implement; support different sizing modes
 		// draw children
-		math::Vec2 pen;
-		Sizes::const_iterator size(sizes.begin());
-		for (Widgets::const_iterator iter(widgets.begin()); iter != widgets.end(); ++iter, ++size)
+		math::Vec2 scale(context.GetScale());
+		std::vector<math::Aabb<2>>::const_iterator box(boxes.begin());
+		for (Widgets::const_iterator iter(widgets.begin()); iter != widgets.end(); ++iter, ++box)
 		{
 			const Widget &child(**iter);
 			DrawContext::Base::FrameSaver frameSaver(context.GetBase());
-			context.GetBase().PushFrame(AabbPositionSize(pen, *size));
+			context.GetBase().PushFrame(*box * scale);
 			child.Draw(context);
-			pen[!horizontal] += (*size)[!horizontal];
-			if (margin) pen[!horizontal] += theme.margin * scale[!horizontal];
 		}
 	}
 
@@ -117,22 +89,27 @@ namespace page { namespace gui
 		}
 	}
 
-	// child hit detection
-	bool ArrayContainer::CheckHit(const math::Vec2 &pos, const res::Theme &theme, const math::Vec2 &size, const HitCallback &cb)
+	// hit testing
+	Widget *ArrayContainer::DoPick(const math::Vec2 &pos, const res::Theme &theme, math::Vec2 &hitPos)
 	{
-		bool result = false;
-		math::Vec2 pen;
-		for (Widgets::const_iterator iter(widgets.begin()); iter != widgets.end(); ++iter)
-		{
-			Widget &child(**iter);
-			auto childSize(child.GetSize(theme));
-			// FIXME: support different sizing modes
-			math::Aabb<2> aabb(AabbPositionSize(pen, childSize.min));
-			if (Contains(aabb, pos))
-				result |= cb(&child, pos - aabb.min, math::Size(aabb));
-			pen[!horizontal] += childSize.min[!horizontal];
-			if (margin) pen[!horizontal] += theme.margin;
-		}
-		return result;
+		// bring the layout up to date
+		GetSize(theme);
+		// find the only child that could contain the position
+		unsigned axis = !horizontal;
+		std::vector<math::Aabb<2>>::const_iterator box(
+			std::upper_bound(boxes.begin(), boxes.end(), pos[axis],
+				[axis](float pos, const math::Aabb<2> &box) { return pos < box.max[axis]; }));
+		if (box != boxes.end() && Contains(*box, pos))
+			if (Widget *widget = widgets[box - boxes.begin()]->Pick(pos - box->min, theme, &hitPos))
+				return widget;
+		hitPos = pos;
+		return this;
+	}
+
+	// notification
+	void ArrayContainer::OnInsert(Widget &child)
+	{
+		Adopt(child);
+		InvalidateLayout();
 	}
 }}
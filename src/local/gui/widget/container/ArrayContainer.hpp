@@ -28,7 +28,10 @@
 #ifndef    page_local_ui_widget_container_ArrayContainer_hpp
 #   define page_local_ui_widget_container_ArrayContainer_hpp
 
-#	include "Widget.hpp"
+#	include <vector>
+
+#	include "../../../math/Aabb.hpp"
+#	include "../Widget.hpp"
 #	include "WidgetContainer.hpp"
 
 namespace page { namespace gui
@@ -46,26 +49,28 @@ namespace page { namespace gui
 		public:
 		explicit ArrayContainer(bool horizontal, bool margin = true);
 
-		// cursor event notification
-		bool OnOver(const math::Vec2 &position, const res::Theme &, const math::Vec2 &size);
-		bool OnDown(const math::Vec2 &position, const res::Theme &, const math::Vec2 &size);
-		bool OnClick(const math::Vec2 &position, const res::Theme &, const math::Vec2 &size);
-
 		private:
 		// metrics
-		WidgetSize CalcSize(const res::Theme &) const;
+		WidgetSize CalcSize(const res::Theme &) const override;
 
 		// rendering
-		void DoDraw(DrawContext &) const;
+		void DoDraw(DrawContext &) const override;
 
 		// update
-		void DoUpdate(float deltaTime);
+		void DoUpdate(float deltaTime) override;
 
-		// child hit detection
-		typedef std::function<bool (Widget *, const math::Vec2 &position, const math::Vec2 &size)> HitCallback;
-		bool CheckHit(const math::Vec2 &position, const res::Theme &, const math::Vec2 &size, const HitCallback &);
+		// hit testing
+		Widget *DoPick(const math::Vec2 &position, const res::Theme &, math::Vec2 &hitPosition) override;
+
+		// notification
+		void OnInsert(Widget &) override;
 
 		bool horizontal, margin;
+
+		// the boxes of the children, in theme units, which are calculated
+		// along with the size of the container, and which are sorted along
+		// the axis of the container so that they can be binary searched
+		mutable std::vector<math::Aabb<2>> boxes;
 	};
 }}
 
@@ -55,16 +55,7 @@ namespace page { namespace gui
 		Items::difference_type index = selection - items.begin();
 		items.push_back(item);
 		selection = items.begin() + index;
-	}
-
-	// cursor event notification
-	bool ListContainer::OnOver(const math::Vec2 &pos, const res::Theme &theme, const math::Vec2 &size)
-	{
-		// FIXME: implement
-	}
-	bool ListContainer::OnClick(const math::Vec2 &pos, const res::Theme &theme, const math::Vec2 &size)
-	{
-		// FIXME: implement
+		InvalidateLayout();
 	}
 
 	// metrics
@@ -72,7 +63,7 @@ namespace page { namespace gui
 	{
 		// FIXME: when size is zero, calculate it using the maximum line
 		// width and number of list items
-		return WidgetSize(Select(size, size * theme.scale, 0), WidgetSize::Mode::grow);
+		return WidgetSize(Select(size, size * theme.scale, 0), WidgetSize::FillMode::growToFit);
 	}
 
 	// rendering
@@ -122,4 +113,21 @@ namespace page { namespace gui
 		// draw foreground decorations
 		// FIXME: implement
 	}
+
+	// interaction
+	void ListContainer::DoClick(const math::Vec2 &pos, const res::Theme &theme, unsigned button)
+	{
+		// select the item that was clicked, using the same line spacing as
+		// DoDraw, in theme units
+		const res::Font &font(*theme.list.text.font);
+		float
+			lineHeight = font.lineHeight * theme.list.text.size,
+			maxBearing = font.maxBearing.y * theme.list.text.size,
+			halfLineGap = (lineHeight - maxBearing) / 2;
+		if (pos.y >= 0)
+		{
+			Items::size_type index = pos.y / (lineHeight + halfLineGap);
+			if (index < items.size()) selection = items.begin() + index;
+		}
+	}
 }}
@@ -48,16 +48,16 @@ namespace page { namespace gui
 		// modifiers
 		void Insert(const std::string &);
 
-		// cursor event notification
-		bool OnOver(const math::Vec2 &position, const res::Theme &, const math::Vec2 &size);
-		bool OnClick(const math::Vec2 &position, const res::Theme &, const math::Vec2 &size);
-
 		private:
 		// metrics
-		WidgetSize CalcSize(const res::Theme &) const;
+		WidgetSize CalcSize(const res::Theme &) const override;
 
 		// rendering
-		void DoDraw(DrawContext &) const;
+		void DoDraw(DrawContext &) const override;
+
+		// interaction
+		// selects the item that was clicked
+		void DoClick(const math::Vec2 &position, const res::Theme &, unsigned button) override;
 
 		math::Vec2 size;
 		typedef std::vector<std::string> Items;
@@ -27,22 +27,38 @@
 
 #include <cassert>
 
-#include "../Widget.hpp" // Widget::Set{Clone,MinSize,Position,Visible}
+#include "../Widget.hpp" // Widget::{Clone,Set{MinSize,Position,Visible}}
 #include "WidgetContainer.hpp"
 
 namespace page { namespace gui
 {
+	// construct/copy
+	WidgetContainer::WidgetContainer(const WidgetContainer &other)
+	{
+		widgets.reserve(other.widgets.size());
+		for (Widgets::const_iterator iter(other.widgets.begin()); iter != other.widgets.end(); ++iter)
+			widgets.push_back((*iter)->Clone());
+	}
+	WidgetContainer &WidgetContainer::operator =(const WidgetContainer &other)
+	{
+		WidgetContainer copy(other);
+		widgets.swap(copy.widgets);
+		return *this;
+	}
+
 	// modifiers
 	void WidgetContainer::Insert(const Widget &widget)
 	{
 		std::shared_ptr<Widget> clone(widget.Clone());
 		widgets.push_back(clone);
+		OnInsert(*clone);
 	}
 	void WidgetContainer::Insert(const Widget &widget, const math::Vec2 &pos)
 	{
 		std::shared_ptr<Widget> clone(widget.Clone());
 		clone->SetPosition(pos);
 		widgets.push_back(clone);
+		OnInsert(*clone);
 	}
 	void WidgetContainer::Insert(const Widget &widget, const math::Vec2 &pos, const math::Vec2 &minSize)
 	{
@@ -50,6 +66,7 @@ namespace page { namespace gui
 		clone->SetPosition(pos);
 		clone->SetMinSize(minSize);
 		widgets.push_back(clone);
+		OnInsert(*clone);
 	}
 	void WidgetContainer::Insert(const Widget &widget, const math::Vec2 &pos, const math::Vec2 &minSize, bool visible)
 	{
@@ -58,17 +75,20 @@ namespace page { namespace gui
 		clone->SetMinSize(minSize);
 		clone->SetVisible(visible, false);
 		widgets.push_back(clone);
+		OnInsert(*clone);
 	}
 	void WidgetContainer::Insert(const std::shared_ptr<Widget> &widget)
 	{
 		assert(widget);
 		widgets.push_back(widget);
+		OnInsert(*widget);
 	}
 	void WidgetContainer::Insert(const std::shared_ptr<Widget> &widget, const math::Vec2 &pos)
 	{
 		assert(widget);
 		widget->SetPosition(pos);
 		widgets.push_back(widget);
+		OnInsert(*widget);
 	}
 	void WidgetContainer::Insert(const std::shared_ptr<Widget> &widget, const math::Vec2 &pos, const math::Vec2 &minSize)
 	{
@@ -76,6 +96,7 @@ namespace page { namespace gui
 		widget->SetPosition(pos);
 		widget->SetMinSize(minSize);
 		widgets.push_back(widget);
+		OnInsert(*widget);
 	}
 	void WidgetContainer::Insert(const std::shared_ptr<Widget> &widget, const math::Vec2 &pos, const math::Vec2 &minSize, bool visible)
 	{
@@ -84,5 +105,9 @@ namespace page { namespace gui
 		widget->SetMinSize(minSize);
 		widget->SetVisible(visible, false);
 		widgets.push_back(widget);
+		OnInsert(*widget);
 	}
+
+	// notification
+	void WidgetContainer::OnInsert(Widget &) {}
 }}
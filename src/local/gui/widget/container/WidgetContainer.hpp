@@ -39,6 +39,12 @@ namespace page { namespace gui
 
 	struct WidgetContainer
 	{
+		// construct/copy
+		WidgetContainer() = default;
+		virtual ~WidgetContainer() = default;
+		WidgetContainer(const WidgetContainer &);
+		WidgetContainer &operator =(const WidgetContainer &);
+
 		// modifiers
 		void Insert(const Widget &);
 		void Insert(const Widget &, const math::Vec2 &position);
@@ -49,7 +55,15 @@ namespace page { namespace gui
 		void Insert(const std::shared_ptr<Widget> &, const math::Vec2 &position, const math::Vec2 &minSize);
 		void Insert(const std::shared_ptr<Widget> &, const math::Vec2 &position, const math::Vec2 &minSize, bool visible);
 
+		private:
+		// notification
+		// called after a widget has been inserted
+		virtual void OnInsert(Widget &);
+
 		protected:
+		// NOTE: a widget should only be inserted into one container, so
+		// that it invalidates the layout of the right container; copies of
+		// the container get copies of its widgets
 		typedef std::vector<std::shared_ptr<Widget>> Widgets;
 		Widgets widgets;
 	};
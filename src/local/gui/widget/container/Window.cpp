@@ -46,32 +46,57 @@ namespace page { namespace gui
 		Window(title, content.Clone()) {}
 
 	Window::Window(const std::string &title, const std::shared_ptr<Widget> &content) :
-		title(title), content(content),
-		onClickConnection(onClick.connect(std::bind(OnClick, this))) {}
+		title(title), content(content)
+	{
+		if (content) Adopt(*content);
+	}
+
+	Window::Window(const Window &other) :
+		Widget(other), WidgetContainer(other), title(other.title),
+		content(other.content ? other.content->Clone() : nullptr)
+	{
+		if (content) Adopt(*content);
+	}
+
+	Window &Window::operator =(const Window &other)
+	{
+		Widget::operator =(other);
+		WidgetContainer::operator =(other);
+		title = other.title;
+		SetContent(other.content ? other.content->Clone() : nullptr);
+		return *this;
+	}
+
+	/*-----------+
+	| properties |
+	+-----------*/
 
-	/*----------------+
-	| signal handlers |
-	+----------------*/
+	const std::string &Window::GetTitle() const
+	{
+		return title;
+	}
+
+	const Widget &Window::GetContent() const
+	{
+		return *content;
+	}
 
-	void Window::OnClick(unsigned button)
+	void Window::SetTitle(const std::string &title)
 	{
-		using namespace std::placeholders;
-		return CheckHit(pos, theme, size,
-			std::bind(&Widget::OnClick, _1, _2, theme, _3));
+		this->title = title;
+		InvalidateLayout();
 	}
 
-	void Window::OnCursorEnter()
+	void Window::SetContent(const Widget &content)
 	{
-		using namespace std::placeholders;
-		return CheckHit(pos, theme, size,
-			std::bind(&Widget::OnOver, _1, _2, theme, _3));
+		SetContent(content.Clone());
 	}
 
-	void Window::OnCursorLeave()
+	void Window::SetContent(const std::shared_ptr<Widget> &content)
 	{
-		using namespace std::placeholders;
-		return CheckHit(pos, theme, size,
-			std::bind(&Widget::OnDown, _1, _2, theme, _3));
+		this->content = content;
+		if (content) Adopt(*content);
+		InvalidateLayout();
 	}
 
 	// metrics
@@ -79,19 +104,20 @@ namespace page { namespace gui
 	{
 		// account for frame and margin
 		math::Aabb<2> frameThickness(GetThickness(theme.window.frame));
-		auto size(frameThickness.min + frameThickness.max + theme.window.margin * 2);
+		WidgetSize size(frameThickness.min + frameThickness.max + theme.window.margin * 2);
 		// account for title
 		math::Vec2 titleSize(GetTitleSize(theme));
-		size.min.y += titleSize.y;
+		size.minSize.y += titleSize.y;
 		// account for child widget
-		if (child)
+		if (content)
 		{
-			auto childSize(child->GetSize(theme));
-			size.min.x += std::max(childSize.min.x, titleSize.x);
-			size.min.y += childSize.min.y;
-			size.mode = Max(childSize.mode, size.mode);
+			Adopt(*content);
+			auto childSize(content->GetSize(theme));
+			size.minSize.x += std::max(childSize.minSize.x, titleSize.x);
+			size.minSize.y += childSize.minSize.y;
+			size.fillMode = childSize.fillMode;
 		}
-		else size.min.x = titleSize.x;
+		else size.minSize.x += titleSize.x;
 		return size;
 	}
 
@@ -133,14 +159,14 @@ namespace page { namespace gui
 			childBox.min.y = titleBox.max.y + theme.window.margin * scale.y;
 		}
 		// draw child widget
-		if (child)
+		if (content)
 		{
 			// FIXME: handle the case where the title is wider than the
 			// child widget, but the child widget doesn't want to expand
 			// to fill the extra space
 			DrawContext::Base::FrameSaver frameSaver(context.GetBase());
 			context.GetBase().PushFrame(childBox);
-			child->Draw(context);
+			content->Draw(context);
 		}
 		// draw frame
 		context.DrawFrame(theme.window.frame);
@@ -151,7 +177,7 @@ namespace page { namespace gui
 	// update
 	void Window::DoUpdate(float deltaTime)
 	{
-		if (child) child->Update(deltaTime);
+		if (content) content->Update(deltaTime);
 	}
 
 	// internal metrics
@@ -175,29 +201,27 @@ namespace page { namespace gui
 			(std::count(title.begin(), title.end(), '\n') + 1) * lineHeight;
 	}
 
-	// child hit detection
-	bool Window::CheckHit(const math::Vec2 &pos, const res::Theme &theme, const math::Vec2 &size)
+	// hit testing
+	Widget *Window::DoPick(const math::Vec2 &pos, const res::Theme &theme, math::Vec2 &hitPos)
 	{
-		bool result = false;
-		if (child)
+		if (content)
 		{
 			// account for frame and margin
 			math::Aabb<2>
 				frameThickness(GetThickness(theme.window.frame)),
-				aabb(Shrink(math::Aabb<2>(0, size),
+				aabb(Shrink(math::Aabb<2>(0, GetSize(theme).minSize),
 					frameThickness.min + theme.window.margin,
 					frameThickness.max + theme.window.margin));
 			// account for title
+			// NOTE: the child widget fills the rest of the window, the same
+			// as in DoDraw
 			aabb.min.y += GetTitleHeight(theme);
-			// account for child widget
-			auto childSize(child->GetSize(theme));
-			float width = aabb.max.x - aabb.min.x;
-			if (width > childSize.min.x && childSize.mode.y == Size::shrink)
-				aabb = Shrink(aabb, math::Vec2(width - childSize.min.x, 0));
 			// test intersection
 			if (Contains(aabb, pos))
-				result |= cb(child.get(), pos - aabb.min, math::Size(aabb));
+				if (Widget *widget = content->Pick(pos - aabb.min, theme, &hitPos))
+					return widget;
 		}
-		return result;
+		hitPos = pos;
+		return this;
 	}
 }}
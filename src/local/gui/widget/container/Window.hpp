@@ -28,6 +28,7 @@
 #ifndef    page_local_ui_widget_container_Window_hpp
 #   define page_local_ui_widget_container_Window_hpp
 
+#	include <memory> // shared_ptr
 #	include <string>
 
 #	include "../Widget.hpp"
@@ -53,6 +54,12 @@ namespace page { namespace gui
 		Window(const std::string &title, const Widget &content);
 		Window(const std::string &title, const std::shared_ptr<Widget> &content);
 
+		/**
+		 * Copies the window, along with a copy of its content.
+		 */
+		Window(const Window &);
+		Window &operator =(const Window &);
+
 		/*-----------+
 		| properties |
 		+-----------*/
@@ -73,14 +80,14 @@ namespace page { namespace gui
 		void SetTitle(const std::string &);
 
 		/**
-		 * Sets @c content.
+		 * Sets @c content to a copy of the widget.
 		 */
 		void SetContent(const Widget &);
 
 		/**
 		 * Sets @c content.
 		 */
-		void SetContent(Widget &&);
+		void SetContent(const std::shared_ptr<Widget> &);
 
 		/*-----------------+
 		| Widget overrides |
@@ -90,14 +97,7 @@ namespace page { namespace gui
 		WidgetSize CalcSize(const res::Theme &) const override;
 		void DoDraw(DrawContext &) const override;
 		void DoUpdate(float deltaTime) override;
-
-		/*----------------+
-		| signal handlers |
-		+----------------*/
-
-		void OnClick(unsigned button);
-		void OnCursorEnter();
-		void OnCursorLeave();
+		Widget *DoPick(const math::Vec2 &position, const res::Theme &, math::Vec2 &hitPosition) override;
 
 		/*-----------------+
 		| internal metrics |
@@ -106,13 +106,6 @@ namespace page { namespace gui
 		math::Vec2 GetTitleSize(const res::Theme &) const;
 		float GetTitleHeight(const res::Theme &) const;
 
-		/*--------------------+
-		| child hit detection |
-		+--------------------*/
-
-		typedef std::function<bool (Widget *, const math::Vec2 &position, const math::Vec2 &size)> HitCallback;
-		bool CheckHit(const math::Vec2 &position, const res::Theme &, const math::Vec2 &size, const HitCallback &);
-
 		/*-------------+
 		| data members |
 		+-------------*/
@@ -123,13 +116,10 @@ namespace page { namespace gui
 		std::string title;
 
 		/**
-		 * The window's content.
+		 * The window's content, which is copied along with the window, so
+		 * that it is only laid out by one window.
 		 */
-		std::unique_ptr<Widget> content;
-
-		boost::signals::scoped_connection onClickConnection;
-		boost::signals::scoped_connection onCursorEnterConnection;
-		boost::signals::scoped_connection onCursorLeaveConnection;
+		std::shared_ptr<Widget> content;
 	};
 }}
 
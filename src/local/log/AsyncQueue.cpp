@@ -0,0 +1,351 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // find
+#include <chrono> // milliseconds
+#include <iterator> // begin, end
+
+#include "../err/Exception.hpp"
+#include "AsyncQueue.hpp"
+#include "stream/AsyncStream.hpp" // AsyncStream::Consume
+
+namespace page
+{
+	namespace log
+	{
+		namespace
+		{
+			/**
+			 * The queues that are alive, so that they can all be drained
+			 * before reporting an error.
+			 */
+			std::mutex registryMutex;
+			AsyncQueue *registry[8];
+
+			std::atomic<unsigned> nextSerial{1};
+		}
+
+		/*---------+
+		| channels |
+		+---------*/
+
+		/**
+		 * The ring that one producer thread writes its records to.
+		 */
+		struct AsyncQueue::Channel
+		{
+			explicit Channel(std::size_t capacity) :
+				ring(capacity) {}
+
+			util::SpscRing<Record> ring;
+
+			// only accessed by the producer
+			Record *open = nullptr;
+			bool dropping = false;
+			unsigned dropped = 0;
+
+			/**
+			 * @c false once the producer thread has exited, so that the
+			 * channel can be reused by another thread.
+			 */
+			std::atomic<bool> owned{true};
+		};
+
+		/**
+		 * Publishes the open records of a thread and releases its channels
+		 * when the thread exits.
+		 */
+		struct AsyncQueue::Reaper
+		{
+			~Reaper()
+			{
+				for (const auto &channel : channels)
+				{
+					if (channel->open)
+					{
+						channel->open->flush = true;
+						channel->ring.Push();
+						channel->open = nullptr;
+					}
+					channel->owned.store(false, std::memory_order_release);
+				}
+			}
+
+			// NOTE: the channels are shared, so that they survive the queue
+			std::vector<std::shared_ptr<Channel>> channels;
+		};
+
+		thread_local AsyncQueue::CachedChannel AsyncQueue::channelCache[maxQueues];
+
+		/*-------------+
+		| constructors |
+		+-------------*/
+
+		AsyncQueue::AsyncQueue(std::size_t capacity) :
+			capacity(capacity), serial(nextSerial++),
+			creator(std::this_thread::get_id()),
+			thread(&AsyncQueue::Run, this)
+		{
+			static_assert(sizeof registry / sizeof *registry == maxQueues, "");
+			{
+				std::lock_guard<std::mutex> lock(registryMutex);
+				auto iter(std::find(std::begin(registry), std::end(registry), nullptr));
+				if (iter != std::end(registry))
+				{
+					*iter = this;
+					slot = iter - std::begin(registry);
+					return;
+				}
+			}
+
+			// stop the thread before throwing, since it can't be joined by
+			// the destructor
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				done = true;
+			}
+			condition.notify_one();
+			thread.join();
+			THROW((err::Exception<err::LogModuleTag, err::RangeTag>("too many asynchronous log queues")))
+		}
+
+		AsyncQueue::~AsyncQueue()
+		{
+			{
+				std::lock_guard<std::mutex> lock(registryMutex);
+				registry[slot] = nullptr;
+			}
+			if (FindChannel()) Publish();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				done = true;
+			}
+			condition.notify_one();
+			thread.join();
+		}
+
+		/*----------+
+		| observers |
+		+----------*/
+
+		std::size_t AsyncQueue::GetDropCount() const
+		{
+			return dropCount.load(std::memory_order_relaxed);
+		}
+
+		/*----------------+
+		| synchronization |
+		+----------------*/
+
+		void AsyncQueue::Drain()
+		{
+			if (std::this_thread::get_id() == thread.get_id()) return;
+			if (FindChannel()) Publish();
+
+			// wait for two passes, since the current one may have started
+			// before the last record was published
+			std::unique_lock<std::mutex> lock(mutex);
+			auto target = passes + 2;
+			wake = true;
+			condition.notify_one();
+			drained.wait(lock, [this, target] { return passes >= target; });
+		}
+
+		void AsyncQueue::DrainAll()
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+			for (auto queue : registry)
+				if (queue) queue->Drain();
+		}
+
+		/*--------------------+
+		| producer operations |
+		+--------------------*/
+
+		AsyncQueue::Record *AsyncQueue::Open(AsyncStream &stream, Record::Kind kind, unsigned level)
+		{
+			auto &channel(GetChannel());
+			if (auto record = channel.open)
+			{
+				if (record->stream == &stream &&
+					record->kind == Record::Kind::text &&
+					kind == Record::Kind::text &&
+					record->level == level) return record;
+				Publish();
+			}
+
+			auto record = channel.ring.GetWriteSlot();
+			if (!record)
+			{
+				// text records are counted when they would have been
+				// published, since they are written a piece at a time
+				if (kind == Record::Kind::text) channel.dropping = true;
+				else
+				{
+					++channel.dropped;
+					++dropCount;
+				}
+				return nullptr;
+			}
+
+			// the ring was drained part way through a dropped record
+			if (channel.dropping)
+			{
+				++channel.dropped;
+				++dropCount;
+				channel.dropping = false;
+			}
+
+			record->stream = &stream;
+			record->kind = kind;
+			record->flush = false;
+			record->level = level;
+			record->dropped = channel.dropped;
+			record->text.clear();
+			record->format = nullptr;
+			channel.dropped = 0;
+			return channel.open = record;
+		}
+
+		void AsyncQueue::Publish(bool flush)
+		{
+			auto &channel(GetChannel());
+			if (channel.open)
+			{
+				channel.open->flush = flush;
+				channel.ring.Push();
+				channel.open = nullptr;
+
+				// leave the background thread asleep until there is enough
+				// work to be worth waking it for
+				if (channel.ring.GetSize() * 2 >= capacity) Wake();
+			}
+			else if (flush && channel.dropping)
+			{
+				++channel.dropped;
+				++dropCount;
+				channel.dropping = false;
+			}
+		}
+
+		/*--------------------+
+		| consumer operations |
+		+--------------------*/
+
+		void AsyncQueue::Run()
+		{
+			std::vector<std::shared_ptr<Channel>> snapshot;
+			for (;;)
+			{
+				bool finishing;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					// sleep when there is nothing to do, with a timeout in
+					// case a wakeup comes between the loops
+					if (!wake && !done)
+						condition.wait_for(lock, std::chrono::milliseconds(5),
+							[this] { return wake || done; });
+					wake = false;
+					finishing = done;
+					snapshot = channels;
+				}
+
+				for (const auto &channel : snapshot)
+					while (auto record = channel->ring.GetReadSlot())
+					{
+						// NOTE: there is nowhere to report a failing sink
+						try
+						{
+							record->stream->Consume(*record);
+						}
+						catch (...) {}
+						channel->ring.Pop();
+					}
+
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					++passes;
+				}
+				drained.notify_all();
+				if (finishing) return;
+			}
+		}
+
+		/*---------+
+		| channels |
+		+---------*/
+
+		AsyncQueue::Channel &AsyncQueue::GetChannel()
+		{
+			if (auto channel = FindChannel())
+				return *channel;
+
+			// reuse the channel of a thread that has exited
+			std::shared_ptr<Channel> channel;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (const auto &candidate : channels)
+				{
+					bool owned = false;
+					if (candidate->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+					{
+						channel = candidate;
+						break;
+					}
+				}
+				if (!channel)
+				{
+					channel = std::make_shared<Channel>(capacity);
+					channels.push_back(channel);
+				}
+			}
+
+			// NOTE: the creating thread keeps its channel, since it may still
+			// be logging after its thread-local objects have been destroyed
+			if (std::this_thread::get_id() != creator)
+			{
+				thread_local Reaper reaper;
+				reaper.channels.push_back(channel);
+			}
+
+			channelCache[slot] = {serial, channel.get()};
+			return *channel;
+		}
+
+		AsyncQueue::Channel *AsyncQueue::FindChannel() const
+		{
+			const auto &cached(channelCache[slot]);
+			return cached.serial == serial ? cached.channel : nullptr;
+		}
+
+		void AsyncQueue::Wake()
+		{
+			if (!wake.exchange(true))
+				condition.notify_one();
+		}
+	}
+}
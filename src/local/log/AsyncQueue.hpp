@@ -0,0 +1,244 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_log_AsyncQueue_hpp
+#   define page_local_log_AsyncQueue_hpp
+
+#	include <atomic>
+#	include <condition_variable>
+#	include <cstddef> // max_align_t, size_t
+#	include <iosfwd> // ostream
+#	include <memory> // shared_ptr
+#	include <mutex>
+#	include <string>
+#	include <thread>
+#	include <vector>
+
+#	include "../util/class/special_member_functions.hpp" // Uncopyable
+#	include "../util/container/SpscRing.hpp"
+
+namespace page
+{
+	namespace log
+	{
+		class AsyncStream;
+
+		/**
+		 * Moves log output off of the threads that produce it.
+		 *
+		 * Every producer thread gets its own lock-free ring of records, which
+		 * a background thread drains into the @c AsyncStream that each record
+		 * was written to.  The producers never wait for the background
+		 * thread.  When a ring is full, the record is dropped, and the number
+		 * of dropped records is written to the log with the next record that
+		 * gets through.
+		 *
+		 * @note Any @c AsyncStream that writes to the queue must outlive it.
+		 */
+		class AsyncQueue : public util::Uncopyable<AsyncQueue>
+		{
+			friend class AsyncStream;
+
+			/*-------------+
+			| constructors |
+			+-------------*/
+
+			public:
+			/**
+			 * @param capacity The number of records that can be waiting in
+			 *        each producer thread's ring.
+			 */
+			explicit AsyncQueue(std::size_t capacity = 1024);
+
+			/**
+			 * Writes any remaining records before stopping the background
+			 * thread.
+			 */
+			~AsyncQueue();
+
+			/*----------+
+			| observers |
+			+----------*/
+
+			public:
+			/**
+			 * Returns the number of records that have been dropped because a
+			 * ring was full.
+			 */
+			std::size_t GetDropCount() const;
+
+			/*----------------+
+			| synchronization |
+			+----------------*/
+
+			public:
+			/**
+			 * Waits until every record that has been published, including the
+			 * calling thread's unflushed output, has been written to the
+			 * sinks.
+			 *
+			 * @note Does nothing when called from the background thread.
+			 */
+			void Drain();
+
+			/**
+			 * Drains every live queue.
+			 */
+			static void DrainAll();
+
+			/*--------+
+			| records |
+			+--------*/
+
+			private:
+			struct Record
+			{
+				enum class Kind
+				{
+					text,
+					deferred,
+					clear
+				};
+
+				AsyncStream *stream = nullptr;
+				Kind kind = Kind::text;
+				bool flush = false;
+
+				/**
+				 * The indentation level when the record was opened.
+				 */
+				unsigned level = 0;
+
+				/**
+				 * The number of records that were dropped before this one.
+				 */
+				unsigned dropped = 0;
+
+				std::string text;
+
+				/**
+				 * Formats a deferred record from the value stored in @c args.
+				 */
+				void (*format)(std::ostream &, const void *) = nullptr;
+				alignas(std::max_align_t) unsigned char args[64];
+			};
+
+			/*--------------------+
+			| producer operations |
+			+--------------------*/
+
+			private:
+			/**
+			 * Returns the calling thread's open record for the stream, or
+			 * @c nullptr if the ring is full.  Records can't be extended with
+			 * a different kind or indentation level, so the open record is
+			 * published first if it doesn't match.
+			 */
+			Record *Open(AsyncStream &, Record::Kind, unsigned level);
+
+			/**
+			 * Hands the calling thread's open record to the background
+			 * thread.
+			 */
+			void Publish(bool flush = false);
+
+			/*--------------------+
+			| consumer operations |
+			+--------------------*/
+
+			private:
+			void Run();
+
+			/*---------+
+			| channels |
+			+---------*/
+
+			private:
+			struct Channel;
+			struct Reaper;
+
+			/**
+			 * Returns the calling thread's channel, registering one if this
+			 * is the first time that the thread has written to the queue.
+			 */
+			Channel &GetChannel();
+
+			/**
+			 * Returns the calling thread's channel, or @c nullptr if it
+			 * hasn't written to the queue.
+			 */
+			Channel *FindChannel() const;
+
+			/**
+			 * Wakes the background thread without taking the lock.
+			 */
+			void Wake();
+
+			/*-------------+
+			| data members |
+			+-------------*/
+
+			private:
+			static const unsigned maxQueues = 8;
+
+			/**
+			 * The channels that the calling thread has registered, indexed by
+			 * the queue's slot.  The cache is trivially destructible, so that
+			 * it can still be used while static objects are being destroyed.
+			 */
+			static thread_local struct CachedChannel
+			{
+				unsigned serial;
+				Channel *channel;
+			} channelCache[maxQueues];
+
+			std::size_t capacity;
+
+			/**
+			 * The queue's slot in the table of live queues and the per-thread
+			 * channel cache, along with a serial number to tell it apart from
+			 * earlier queues that used the same slot.
+			 */
+			unsigned slot, serial;
+
+			std::vector<std::shared_ptr<Channel>> channels;
+			std::thread::id creator;
+			std::atomic<bool> wake{false};
+			std::atomic<std::size_t> dropCount{0};
+			std::mutex mutex;
+			std::condition_variable condition, drained;
+			unsigned long passes = 0;
+			bool done = false;
+
+			// NOTE: must be last, since the thread starts running before the
+			// constructor returns
+			std::thread thread;
+		};
+	}
+}
+
+#endif
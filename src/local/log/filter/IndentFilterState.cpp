@@ -56,5 +56,10 @@ namespace page
 				THROW((err::Exception<err::LogModuleTag, err::RangeTag>("indentation level out of range")))
 			--level;
 		}
+
+		void IndentFilterState::SetLevel(unsigned level)
+		{
+			this->level = level;
+		}
 	}
 }
@@ -52,6 +52,12 @@ namespace page
 			void Indent();
 			void Dedent();
 
+			/**
+			 * Sets the indentation level directly, which is used to replay the
+			 * level that was captured with asynchronous log output.
+			 */
+			void SetLevel(unsigned);
+
 			/*-------------+
 			| data members |
 			+-------------*/
@@ -26,17 +26,20 @@
  */
 
 #include <iostream> // c{err,log,out}, ios_base::Init, streambuf
-#include <memory> // shared_ptr
+#include <memory> // {shared,unique}_ptr
 
 #include "../cfg/vars.hpp"
 #include "../util/cpp.hpp" // STRINGIZE
 #include "../util/gcc/init_priority.hpp" // LOG_INIT_PRIORITY
+#include "AsyncQueue.hpp"
 #include "filter/IndentFilter.hpp"
+#include "filter/IndentFilterState.hpp"
 #include "filter/TimeFilter.hpp"
 #include "sink/ConsoleSink.hpp"
 #include "sink/FileSink.hpp"
 #include "sink/StderrSink.hpp"
 #include "sink/StdoutSink.hpp"
+#include "stream/AsyncStream.hpp"
 #include "stream/BufferStream.hpp"
 
 namespace page
@@ -101,9 +104,27 @@ namespace page
 					errStream = std::make_shared<TimeFilter>(errStream);
 					logStream = std::make_shared<TimeFilter>(logStream);
 
-					outStream = std::make_shared<IndentFilter>(outStream);
-					errStream = std::make_shared<IndentFilter>(errStream);
-					logStream = std::make_shared<IndentFilter>(logStream);
+					if (*CVAR(logAsync))
+					{
+						// run the filter chains on a background thread, where
+						// the indentation level of each record is replayed
+						asyncQueue.reset(new AsyncQueue);
+						const auto indentState(std::make_shared<IndentFilterState>());
+
+						outStream = std::make_shared<IndentFilter>(indentState, outStream);
+						errStream = std::make_shared<IndentFilter>(indentState, errStream);
+						logStream = std::make_shared<IndentFilter>(indentState, logStream);
+
+						outStream = std::make_shared<AsyncStream>(*asyncQueue, indentState, outStream);
+						errStream = std::make_shared<AsyncStream>(*asyncQueue, indentState, errStream);
+						logStream = std::make_shared<AsyncStream>(*asyncQueue, indentState, logStream);
+					}
+					else
+					{
+						outStream = std::make_shared<IndentFilter>(outStream);
+						errStream = std::make_shared<IndentFilter>(errStream);
+						logStream = std::make_shared<IndentFilter>(logStream);
+					}
 
 					/*---------------------------------------------------+
 					| replace std::streambuf for standard output streams |
@@ -148,6 +169,10 @@ namespace page
 					errStream,
 					logStream;
 
+				// NOTE: must come after the streams, since the queue writes
+				// its remaining records to them when it is destroyed
+				std::unique_ptr<AsyncQueue> asyncQueue;
+
 				std::streambuf
 					*const origCoutBuf,
 					*const origCerrBuf,
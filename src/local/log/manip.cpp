@@ -28,6 +28,7 @@
 #include <ostream>
 #include <typeinfo> // bad_cast
 
+#include "AsyncQueue.hpp" // AsyncQueue::DrainAll
 #include "filter/IndentFilterState.hpp"
 #include "stream/Stream.hpp" // Stream::Clear
 
@@ -78,5 +79,16 @@ namespace page
 		{
 			return os << Clear << "warning: ";
 		}
+
+		/*----------------+
+		| synchronization |
+		+----------------*/
+
+		std::ostream &Sync(std::ostream &os)
+		{
+			os.flush();
+			AsyncQueue::DrainAll();
+			return os;
+		}
 	}
 }
@@ -53,6 +53,16 @@ namespace page
 
 		std::ostream &Error(std::ostream &);
 		std::ostream &Warning(std::ostream &);
+
+		/*----------------+
+		| synchronization |
+		+----------------*/
+
+		/**
+		 * Flushes the stream and waits until any asynchronous log output has
+		 * reached the sinks.
+		 */
+		std::ostream &Sync(std::ostream &);
 	}
 }
 
@@ -25,6 +25,8 @@
  * of this software.
  */
 
+#include <algorithm> // max
+
 #include "Stats.hpp"
 
 namespace page
@@ -73,6 +75,33 @@ namespace page
 			return float(cacheTries - cacheMisses) / cacheTries;
 		}
 
+		auto Stats::GetCacheStats(const std::type_info &type) const -> const CacheStats &
+		{
+			static const CacheStats empty;
+			auto iter(cacheStats.find(type));
+			return iter != cacheStats.end() ? iter->second : empty;
+		}
+
+		auto Stats::GetCacheStats() const -> const CacheStatsMap &
+		{
+			return cacheStats;
+		}
+
+		unsigned Stats::GetAudioUnderruns() const
+		{
+			return audioUnderruns;
+		}
+
+		unsigned Stats::GetAudioBlocks() const
+		{
+			return audioBlocks;
+		}
+
+		float Stats::GetAudioFillLevel() const
+		{
+			return audioBlocks ? audioFillTotal / audioBlocks : 0;
+		}
+
 		/*----------+
 		| modifiers |
 		+----------*/
@@ -94,10 +123,57 @@ namespace page
 			++cacheMisses;
 		}
 
+		void Stats::IncCacheTries(const std::type_info &type)
+		{
+			IncCacheTries();
+			++cacheStats[type].tries;
+		}
+
+		void Stats::IncCacheMisses(const std::type_info &type)
+		{
+			IncCacheMisses();
+			++cacheStats[type].misses;
+		}
+
+		void Stats::IncCacheStores(const std::type_info &type, std::size_t size)
+		{
+			auto &stats(cacheStats[type]);
+			++stats.stores;
+			stats.size += size;
+			stats.peakSize = std::max(stats.peakSize, stats.size);
+		}
+
+		void Stats::IncCacheEvictions(const std::type_info &type, std::size_t size)
+		{
+			auto &stats(cacheStats[type]);
+			++stats.evictions;
+			stats.size -= size;
+		}
+
+		void Stats::IncAudioUnderruns()
+		{
+			++audioUnderruns;
+		}
+
+		void Stats::IncAudioBlocks(float fillLevel)
+		{
+			++audioBlocks;
+			audioFillTotal += fillLevel;
+		}
+
 		void Stats::Reset()
 		{
 			runTime = frameCount = cacheTries = cacheMisses = 0;
-			frameRate = 0;
+			audioUnderruns = audioBlocks = 0;
+			frameRate = audioFillTotal = 0;
+
+			// the cache still holds its data, so keep the current sizes
+			for (auto &pair : cacheStats)
+			{
+				auto &stats(pair.second);
+				stats.tries = stats.misses = stats.stores = stats.evictions = 0;
+				stats.peakSize = stats.size;
+			}
 		}
 	}
 }
@@ -28,6 +28,11 @@
 #ifndef    page_local_log_Stats_hpp
 #   define page_local_log_Stats_hpp
 
+#	include <cstddef> // size_t
+#	include <typeindex>
+#	include <typeinfo> // type_info
+#	include <unordered_map>
+
 #	include "../util/class/Monostate.hpp"
 
 namespace page
@@ -37,6 +42,34 @@ namespace page
 		class Stats :
 			public util::Monostate<Stats>
 		{
+			/*-------------+
+			| nested types |
+			+-------------*/
+
+			public:
+			/**
+			 * Statistics for one type of object in the cache.
+			 */
+			struct CacheStats
+			{
+				unsigned    tries     = 0;
+				unsigned    misses    = 0;
+				unsigned    stores    = 0;
+				unsigned    evictions = 0;
+
+				/**
+				 * The number of bytes currently used by this type of object.
+				 */
+				std::size_t size      = 0;
+
+				/**
+				 * The largest value that CacheStats::size has reached.
+				 */
+				std::size_t peakSize  = 0;
+			};
+
+			using CacheStatsMap = std::unordered_map<std::type_index, CacheStats>;
+
 			/*-------------+
 			| constructors |
 			+-------------*/
@@ -55,6 +88,17 @@ namespace page
 			unsigned GetCacheTries() const;
 			unsigned GetCacheMisses() const;
 			float GetCacheCoherence() const;
+			const CacheStats &GetCacheStats(const std::type_info &) const;
+			const CacheStatsMap &GetCacheStats() const;
+			unsigned GetAudioUnderruns() const;
+			unsigned GetAudioBlocks() const;
+
+			/**
+			 * Returns the average fill level of the audio decoding rings, as
+			 * a fraction of their capacity, at the times that blocks were
+			 * played.
+			 */
+			float GetAudioFillLevel() const;
 
 			/*----------+
 			| modifiers |
@@ -64,6 +108,12 @@ namespace page
 			void IncFrame(float deltaTime);
 			void IncCacheTries();
 			void IncCacheMisses();
+			void IncCacheTries(const std::type_info &);
+			void IncCacheMisses(const std::type_info &);
+			void IncCacheStores(const std::type_info &, std::size_t size);
+			void IncCacheEvictions(const std::type_info &, std::size_t size);
+			void IncAudioUnderruns();
+			void IncAudioBlocks(float fillLevel);
 			void Reset();
 
 			/*-------------+
@@ -76,6 +126,10 @@ namespace page
 			unsigned cacheTries  = 0;
 			unsigned cacheMisses = 0;
 			float    frameRate   = 0;
+			CacheStatsMap cacheStats;
+			unsigned audioUnderruns = 0;
+			unsigned audioBlocks    = 0;
+			float    audioFillTotal = 0;
 		};
 	}
 }
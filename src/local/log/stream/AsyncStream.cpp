@@ -0,0 +1,129 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <cassert>
+#include <string> // to_string
+
+#include "../filter/IndentFilterState.hpp"
+#include "AsyncStream.hpp"
+
+namespace page
+{
+	namespace log
+	{
+		namespace
+		{
+			/**
+			 * The size at which unflushed data is handed to the background
+			 * thread anyway.
+			 */
+			const std::string::size_type publishSize = 1024;
+		}
+
+		/*-------------+
+		| constructors |
+		+-------------*/
+
+		AsyncStream::AsyncStream(AsyncQueue &queue,
+			const std::shared_ptr<IndentFilterState> &replayState,
+			const std::shared_ptr<Stream> &branch) :
+				BranchableStream(branch),
+				queue(queue), replayState(replayState)
+		{
+			assert(replayState);
+		}
+
+		/*----------+
+		| interface |
+		+----------*/
+
+		void AsyncStream::Drain()
+		{
+			queue.Drain();
+		}
+
+		/*----------------------+
+		| Stream implementation |
+		+----------------------*/
+
+		void AsyncStream::DoWrite(const std::string &s)
+		{
+			auto level = GLOBAL(IndentFilterState).GetLevel();
+			if (auto record = queue.Open(*this, AsyncQueue::Record::Kind::text, level))
+			{
+				record->text.append(s);
+				if (record->text.size() >= publishSize)
+					queue.Publish();
+			}
+		}
+
+		void AsyncStream::DoFlush()
+		{
+			queue.Open(*this, AsyncQueue::Record::Kind::text, GLOBAL(IndentFilterState).GetLevel());
+			queue.Publish(true);
+		}
+
+		void AsyncStream::DoClear()
+		{
+			queue.Open(*this, AsyncQueue::Record::Kind::clear, GLOBAL(IndentFilterState).GetLevel());
+			queue.Publish();
+		}
+
+		/*--------------------+
+		| consumer operations |
+		+--------------------*/
+
+		void AsyncStream::Consume(AsyncQueue::Record &record)
+		{
+			replayState->SetLevel(record.level);
+			if (record.dropped)
+			{
+				BranchableStream::DoClear();
+				BranchableStream::DoWrite("(" + std::to_string(record.dropped) + " log records dropped)\n");
+			}
+
+			switch (record.kind)
+			{
+				case AsyncQueue::Record::Kind::text:
+				if (!record.text.empty())
+					BranchableStream::DoWrite(record.text);
+				break;
+				case AsyncQueue::Record::Kind::deferred:
+				formatStream.str(std::string());
+				record.format(formatStream, record.args);
+				BranchableStream::DoWrite(formatStream.str());
+				break;
+				case AsyncQueue::Record::Kind::clear:
+				BranchableStream::DoClear();
+				break;
+			}
+
+			if (record.flush)
+				BranchableStream::DoFlush();
+		}
+	}
+}
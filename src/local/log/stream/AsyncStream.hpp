@@ -0,0 +1,120 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_log_stream_AsyncStream_hpp
+#   define page_local_log_stream_AsyncStream_hpp
+
+#	include <memory> // shared_ptr
+#	include <sstream> // ostringstream
+
+#	include "../AsyncQueue.hpp"
+#	include "BranchableStream.hpp"
+
+namespace page
+{
+	namespace log
+	{
+		class IndentFilterState;
+
+		/**
+		 * A stream which passes the data written to it onto its branches from
+		 * the background thread of an @c AsyncQueue.
+		 *
+		 * Data is handed to the background thread when the stream is
+		 * flushed.  The indentation level that each piece of data was written
+		 * with is replayed into a separate @c IndentFilterState, which should
+		 * be the one used by the @c IndentFilter on the other side.
+		 *
+		 * @note The stream must outlive the queue.
+		 */
+		class AsyncStream final : public BranchableStream
+		{
+			friend class AsyncQueue;
+
+			/*-------------+
+			| constructors |
+			+-------------*/
+
+			public:
+			AsyncStream(AsyncQueue &,
+				const std::shared_ptr<IndentFilterState> &replayState,
+				const std::shared_ptr<Stream> &branch);
+
+			/*----------+
+			| interface |
+			+----------*/
+
+			public:
+			/**
+			 * Writes a record that is formatted on the background thread by
+			 * calling @a format with an @c std::ostream.  @a format must be
+			 * trivially copyable, so values should be captured by copy.
+			 */
+			template <typename Format>
+				void Defer(Format format);
+
+			/**
+			 * Waits until everything written to the queue has reached the
+			 * branches.
+			 */
+			void Drain();
+
+			/*----------------------+
+			| Stream implementation |
+			+----------------------*/
+
+			private:
+			void DoWrite(const std::string &) override;
+			void DoFlush() override;
+			void DoClear() override;
+
+			/*--------------------+
+			| consumer operations |
+			+--------------------*/
+
+			private:
+			/**
+			 * Writes a record to the branches from the background thread.
+			 */
+			void Consume(AsyncQueue::Record &);
+
+			/*-------------+
+			| data members |
+			+-------------*/
+
+			private:
+			AsyncQueue &queue;
+			std::shared_ptr<IndentFilterState> replayState;
+
+			// only accessed by the background thread
+			std::ostringstream formatStream;
+		};
+	}
+}
+
+#	include "AsyncStream.tpp"
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <new> // placement new
+#include <ostream>
+#include <type_traits> // is_trivially_copyable
+
+#include "../filter/IndentFilterState.hpp"
+
+namespace page
+{
+	namespace log
+	{
+		/*----------+
+		| interface |
+		+----------*/
+
+		template <typename Format>
+			void AsyncStream::Defer(Format format)
+		{
+			static_assert(std::is_trivially_copyable<Format>::value,
+				"deferred log format must be trivially copyable");
+			static_assert(sizeof(Format) <= sizeof AsyncQueue::Record::args,
+				"deferred log format is too large");
+
+			auto level = GLOBAL(IndentFilterState).GetLevel();
+			if (auto record = queue.Open(*this, AsyncQueue::Record::Kind::deferred, level))
+			{
+				new (record->args) Format(format);
+				record->format = [](std::ostream &os, const void *args)
+				{
+					(*static_cast<const Format *>(args))(os);
+				};
+				queue.Publish();
+			}
+		}
+	}
+}
@@ -30,7 +30,8 @@
 #include "cfg/CmdlineParser.hpp"
 #include "cfg/state/State.hpp"
 #include "err/report.hpp" // ReportError, std::exception
-#include "game/Game.hpp" // Game::{{,~}Game,Run}
+#include "game/Benchmark.hpp" // RunBenchmark
+#include "game/Game.hpp" // Game::{{,~}Game,Run,RunHeadless}
 #include "log/print.hpp" // Print{Info,Stats}
 #include "sys/info.hpp" // PrintInfo
 
@@ -52,7 +53,13 @@ int main(int argc, char *argv[])
 		sys::PrintInfo();
 		log::PrintInfo();
 
-		game::Game().Run();
+		const auto &benchmark(GLOBAL(cfg::CmdlineParser).GetBenchmark());
+		if (!benchmark.empty())
+			game::RunBenchmark(benchmark);
+		else if (unsigned ticks = GLOBAL(cfg::CmdlineParser).GetHeadlessTicks())
+			game::Game(true).RunHeadless(ticks);
+		else
+			game::Game().Run();
 
 		GLOBAL(cfg::State).Commit();
 		log::PrintStats();
@@ -28,6 +28,7 @@
 #ifndef    page_math_ArithmeticConversion_hpp
 #   define page_math_ArithmeticConversion_hpp
 
+#	include <type_traits> // is_{arithmetic,convertible,enum}
 #	include <utility> // declval
 
 namespace page { namespace math
@@ -36,10 +37,13 @@ namespace page { namespace math
 	{
 		/**
 		 * The implementation of @c ArithmeticConversion.
+		 *
+		 * @note Scoped enumerations don't take part in arithmetic conversions,
+		 *       so they are treated like any other non-arithmetic type.
 		 */
 		template <typename L, typename R, bool =
-			(std::is_arithmetic<L>::value || std::is_enum<L>::value) &&
-			(std::is_arithmetic<R>::value || std::is_enum<R>::value)> class ArithmeticConversionImpl;
+			(std::is_arithmetic<L>::value || (std::is_enum<L>::value && std::is_convertible<L, int>::value)) &&
+			(std::is_arithmetic<R>::value || (std::is_enum<R>::value && std::is_convertible<R, int>::value))> class ArithmeticConversionImpl;
 		template <typename L, typename R> struct ArithmeticConversionImpl<L, R, true>
 		{
 			typedef decltype(std::declval<L>() + std::declval<R>()) Result;
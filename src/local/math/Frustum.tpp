@@ -33,6 +33,19 @@
 
 namespace page { namespace math
 {
+	namespace detail
+	{
+		/**
+		 * Converts a homogeneous plane, which is inside where the dot product
+		 * with a point is positive, to a normalized @c Plane.
+		 */
+		template <typename T> Plane<3, T> MakeFrustumPlane(const Vector<4, T> &v)
+		{
+			T len = Len(Vector<3, T>(v));
+			return Plane<3, T>(Vector<3, T>(v) / len, -v.w / len);
+		}
+	}
+
 	// constructors
 	template <typename T> Frustum<T>::Frustum(const Plane &p) :
 		left(_data[0]), right(_data[1]), bottom(_data[2]), top(_data[3]), near(_data[4]), far(_data[5])
@@ -41,7 +54,7 @@ namespace page { namespace math
 	}
 	template <typename T> Frustum<T>::Frustum(const Plane &left, const Plane &right, const Plane &bottom, const Plane &top, const Plane &near, const Plane &far) :
 		left(_data[0]), right(_data[1]), bottom(_data[2]), top(_data[3]), near(_data[4]), far(_data[5]),
-		left(left), right(right), bottom(bottom), top(top), near(near), far(far) {}
+		_data{left, right, bottom, top, near, far} {}
 	template <typename T> Frustum<T>::Frustum(const Frustum &other) :
 		left(_data[0]), right(_data[1]), bottom(_data[2]), top(_data[3]), near(_data[4]), far(_data[5])
 	{
@@ -56,36 +69,18 @@ namespace page { namespace math
 		left(_data[0]), right(_data[1]), bottom(_data[2]), top(_data[3]), near(_data[4]), far(_data[5])
 	{
 		// Gribb and Hartmann, Fast Extraction of Viewing Planes, 2001
-		left = Plane(Norm(Vector<3, T>(
-			m[0][3] + m[0][0],
-			m[1][3] + m[1][0],
-			m[2][3] + m[2][0])),
-			m[3][3] + m[3][0]);
-		right = Plane(Norm(Vector<3, T>(
-			m[0][3] - m[0][0],
-			m[1][3] - m[1][0],
-			m[2][3] - m[2][0])),
-			m[3][3] - m[3][0]);
-		bottom = Plane(Norm(Vector<3, T>(
-			m[0][3] + m[0][1],
-			m[1][3] + m[1][1],
-			m[2][3] + m[2][1])),
-			m[3][3] + m[3][1]);
-		top = Plane(Norm(Vector<3, T>(
-			m[0][3] - m[0][1],
-			m[1][3] - m[1][1],
-			m[2][3] - m[2][1])),
-			m[3][3] - m[3][1]);
-		near = Plane(Norm(Vector<3, T>(
-			m[0][2],
-			m[1][2],
-			m[2][2])),
-			m[3][2]);
-		far = Plane(Norm(Vector<3, T>(
-			m[0][3] - m[0][2],
-			m[1][3] - m[1][2],
-			m[2][3] - m[2][2])),
-			m[3][3] - m[3][2]);
+		// NOTE: the planes face inwards, so Dot(no, v) - d >= 0 inside
+		Vector<4, T>
+			x(m.Row(0)),
+			y(m.Row(1)),
+			z(m.Row(2)),
+			w(m.Row(3));
+		left   = detail::MakeFrustumPlane(w + x);
+		right  = detail::MakeFrustumPlane(w - x);
+		bottom = detail::MakeFrustumPlane(w + y);
+		top    = detail::MakeFrustumPlane(w - y);
+		near   = detail::MakeFrustumPlane(w + z);
+		far    = detail::MakeFrustumPlane(w - z);
 	}
 
 	// assignment
@@ -505,6 +505,18 @@ namespace page { namespace math
 	template <unsigned n, typename T, typename U> Vector<n, typename ArithmeticConversion<T, U>::Result> Min(T, const Vector<n, U> &);
 	template <unsigned n, typename T, typename U> Vector<n, typename ArithmeticConversion<T, U>::Result> Max(T, const Vector<n, U> &);
 
+	/*----------+
+	| selection |
+	+----------*/
+
+	/**
+	 * Builds a vector, taking each element from @a a where the matching
+	 * element of @a condition evaluates to @c true, and from @a b elsewhere.
+	 */
+	template <unsigned n, typename C, typename T, typename U> Vector<n, typename ArithmeticConversion<T, U>::Result> Select(const Vector<n, C> &condition, const Vector<n, T> &a, const Vector<n, U> &b);
+	template <unsigned n, typename C, typename T, typename U> Vector<n, typename ArithmeticConversion<T, U>::Result> Select(const Vector<n, C> &condition, const Vector<n, T> &a, U b);
+	template <unsigned n, typename C, typename T, typename U> Vector<n, typename ArithmeticConversion<T, U>::Result> Select(const Vector<n, C> &condition, T a, const Vector<n, U> &b);
+
 	/*--------+
 	| swizzle |
 	+--------*/
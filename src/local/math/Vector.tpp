@@ -1039,6 +1039,31 @@ namespace page { namespace math
 		return r;
 	}
 
+	/*----------+
+	| selection |
+	+----------*/
+
+	template <unsigned n, typename C, typename T, typename U> Vector<n, typename ArithmeticConversion<T, U>::Result> Select(const Vector<n, C> &condition, const Vector<n, T> &a, const Vector<n, U> &b)
+	{
+		Vector<n, typename ArithmeticConversion<T, U>::Result> r;
+		for (unsigned i = 0; i < n; ++i) r[i] = condition[i] ? a[i] : b[i];
+		return r;
+	}
+
+	template <unsigned n, typename C, typename T, typename U> Vector<n, typename ArithmeticConversion<T, U>::Result> Select(const Vector<n, C> &condition, const Vector<n, T> &a, U b)
+	{
+		Vector<n, typename ArithmeticConversion<T, U>::Result> r;
+		for (unsigned i = 0; i < n; ++i) r[i] = condition[i] ? a[i] : b;
+		return r;
+	}
+
+	template <unsigned n, typename C, typename T, typename U> Vector<n, typename ArithmeticConversion<T, U>::Result> Select(const Vector<n, C> &condition, T a, const Vector<n, U> &b)
+	{
+		Vector<n, typename ArithmeticConversion<T, U>::Result> r;
+		for (unsigned i = 0; i < n; ++i) r[i] = condition[i] ? a : b[i];
+		return r;
+	}
+
 	/*--------+
 	| swizzle |
 	+--------*/
@@ -26,6 +26,7 @@
  */
 
 #include <algorithm> // swap
+#include <cmath> // tan
 
 namespace page { namespace math
 {
@@ -72,15 +73,22 @@ namespace page { namespace math
 	// frustum conversion
 	template <typename T> Frustum<T> GetFrustum(const ViewFrustum<T> &vf)
 	{
-		return Frustum<T>(GetMatrix(vf));
-		// FIXME: it might be faster to calculate the planes directly
-		/*return Frustum(
-			Plane(),                            // left
-			Plane(),                            // right
-			Plane(),                            // bottom
-			Plane(),                            // top
-			Plane(vf.no, vf.co + vf.no * near), // near
-			Plane(vf.no, vf.co + vf.no * far)); // far*/
+		// calculate the planes directly from the view parameters, which is
+		// faster than extracting them from the matrix and copes with an
+		// infinite far distance
+		// NOTE: the planes face inwards, so Dot(no, v) - d >= 0 inside
+		typedef typename Frustum<T>::Plane Plane;
+		T
+			ty = std::tan(vf.fov / 2),
+			tx = ty * vf.aspect;
+		Vector<3, T> forward(vf.dir * -NormVector<3, T>());
+		return Frustum<T>(
+			Plane(Norm(vf.dir * Vector<3, T>( 1,  0, -tx)), vf.co), // left
+			Plane(Norm(vf.dir * Vector<3, T>(-1,  0, -tx)), vf.co), // right
+			Plane(Norm(vf.dir * Vector<3, T>( 0,  1, -ty)), vf.co), // bottom
+			Plane(Norm(vf.dir * Vector<3, T>( 0, -1, -ty)), vf.co), // top
+			Plane( forward,  Dot(forward, vf.co) + vf.near),        // near
+			Plane(-forward, -Dot(forward, vf.co) - vf.far));        // far
 	}
 
 	// stream insertion/extraction
@@ -25,6 +25,16 @@
  * of this software.
  */
 
+#include <algorithm> // min
+#include <cmath> // lround
+#include <cstdint> // int{16,32}_t
+#include <cstring> // memcpy
+
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+#	include <immintrin.h>
+#endif
+
+#include "algorithm.hpp"
 #include "Color.hpp"
 #include "Matrix.hpp"
 #include "Vector.hpp"
@@ -33,53 +43,367 @@ namespace page { namespace math
 {
 	namespace
 	{
-		const Matrix<3, 3, int> rgbToYcbcrColorMatrix(
-			RgbToYcbcrColorMatrix() *
-			ScaleMatrix(Vector<3>(YcbcrScaleColor())) *
-			(1u << 24));
-	}
+		/**
+		 * The number of fractional bits in the fixed-point coefficients.
+		 */
+		const unsigned fixedBits = 15;
 
-	void RgbToYcbcr420(
-		const unsigned char *rgb,
-		unsigned char *y, unsigned char *cb, unsigned char *cr,
-		const Vector<2, unsigned> &size,
-		unsigned rgbStride, unsigned ycbcrStride)
-	{
-		// FIXME: provide SIMD implementation
-		for (unsigned i = 0; i < size.y; ++i)
+		/**
+		 * The rows of the RGB to Y'CbCr matrix, scaled to the nominal range
+		 * of each component, in fixed point.  Each row is padded to four
+		 * elements and repeated, so that it can be loaded directly into a
+		 * vector register and multiplied with two pixels.
+		 */
+		struct Coefficients
+		{
+			Coefficients()
+			{
+				const Matrix<3, 3> matrix(RgbToYcbcrColorMatrix());
+				const Vector<3> scale(YcbcrScaleColor());
+				for (unsigned i = 0; i < 3; ++i)
+					for (unsigned j = 0; j < 8; ++j)
+						rows[i][j] = j % 4 < 3 ?
+							std::lround(matrix[i][j % 4] * scale[i] * (1 << fixedBits)) : 0;
+			}
+
+			alignas(16) std::int16_t rows[3][8];
+		};
+
+		const Coefficients &GetCoefficients()
+		{
+			static const Coefficients coefficients;
+			return coefficients;
+		}
+
+		// rounded offsets for luma from one pixel, and chroma from the sum
+		// of four pixels
+		const std::int32_t
+			lumaOffset   = (16  << fixedBits)       + (1 << (fixedBits - 1)),
+			chromaOffset = (128 << (fixedBits + 2)) + (1 << (fixedBits + 1));
+
+		/**
+		 * The size of a pixel, and the offsets of its color components.
+		 */
+		struct Layout
+		{
+			unsigned size, r, g, b;
+		};
+
+		Layout GetLayout(RgbLayout layout)
+		{
+			switch (layout)
+			{
+				case RgbLayout::rgb:  return {3, 0, 1, 2};
+				case RgbLayout::rgba: return {4, 0, 1, 2};
+				case RgbLayout::bgra: return {4, 2, 1, 0};
+			}
+			return {3, 0, 1, 2};
+		}
+
+		/**
+		 * Converts a pair of rows, or a single row if @a y1 is null, in
+		 * which case @a row1 is the same as @a row0.
+		 */
+		typedef void (*RowPairKernel)(
+			const unsigned char *row0, const unsigned char *row1,
+			unsigned char *y0, unsigned char *y1,
+			unsigned char *cb, unsigned char *cr,
+			unsigned width, const Layout &);
+
+		/*--------------+
+		| scalar kernel |
+		+--------------*/
+
+		inline std::int32_t Dot(const std::int16_t *row, std::int32_t r, std::int32_t g, std::int32_t b)
 		{
-			const unsigned char *rgbRow = rgb;
-			unsigned char *yRow = y;
-			if (!(i % 2))
+			return row[0] * r + row[1] * g + row[2] * b;
+		}
+
+		/**
+		 * Converts the pixels of a row pair starting at @a x, which must be
+		 * even.  The SIMD kernels use this for the pixels that are left over
+		 * at the end of the rows.
+		 */
+		void ConvertRowPair(
+			const unsigned char *row0, const unsigned char *row1,
+			unsigned char *y0, unsigned char *y1,
+			unsigned char *cb, unsigned char *cr,
+			unsigned x, unsigned width, const Layout &layout)
+		{
+			const auto &c(GetCoefficients());
+			for (; x < width; x += 2)
 			{
-				unsigned char
-					*cbRow = cb,
-					*crRow = cr;
-				for (unsigned i = 0; i < size.x; ++i)
+				// NOTE: the last column is repeated when the width is odd
+				unsigned x1 = x + 1 < width ? x + 1 : x;
+				const unsigned char *pixels[4] =
+				{
+					row0 + x  * layout.size, row0 + x1 * layout.size,
+					row1 + x  * layout.size, row1 + x1 * layout.size
+				};
+				std::int32_t r = 0, g = 0, b = 0;
+				for (unsigned i = 0; i < 4; ++i)
+				{
+					r += pixels[i][layout.r];
+					g += pixels[i][layout.g];
+					b += pixels[i][layout.b];
+				}
+				y0[x] = (Dot(c.rows[0], pixels[0][layout.r], pixels[0][layout.g], pixels[0][layout.b]) + lumaOffset) >> fixedBits;
+				if (x1 != x)
+					y0[x1] = (Dot(c.rows[0], pixels[1][layout.r], pixels[1][layout.g], pixels[1][layout.b]) + lumaOffset) >> fixedBits;
+				if (y1)
 				{
-					Vector<3, int> color(rgb[0], rgb[1], rgb[2]);
-					*y++ = unsigned(Dot(Vector<3, int>(rgbToYcbcrColorMatrix.Row(0)), color) + (16u << 24)) >> 24;
-					if (!(i % 2))
-					{
-						*cb++ = unsigned(Dot(Vector<3, int>(rgbToYcbcrColorMatrix.Row(1)), color) + (128u << 24)) >> 24;
-						*cr++ = unsigned(Dot(Vector<3, int>(rgbToYcbcrColorMatrix.Row(2)), color) + (128u << 24)) >> 24;
-					}
-					rgb += 3;
+					y1[x] = (Dot(c.rows[0], pixels[2][layout.r], pixels[2][layout.g], pixels[2][layout.b]) + lumaOffset) >> fixedBits;
+					if (x1 != x)
+						y1[x1] = (Dot(c.rows[0], pixels[3][layout.r], pixels[3][layout.g], pixels[3][layout.b]) + lumaOffset) >> fixedBits;
 				}
-				cb = cbRow + ycbcrStride / 2;
-				cr = crRow + ycbcrStride / 2;
+				cb[x / 2] = (Dot(c.rows[1], r, g, b) + chromaOffset) >> (fixedBits + 2);
+				cr[x / 2] = (Dot(c.rows[2], r, g, b) + chromaOffset) >> (fixedBits + 2);
 			}
-			else
+		}
+
+		void ConvertRowPairScalar(
+			const unsigned char *row0, const unsigned char *row1,
+			unsigned char *y0, unsigned char *y1,
+			unsigned char *cb, unsigned char *cr,
+			unsigned width, const Layout &layout)
+		{
+			ConvertRowPair(row0, row1, y0, y1, cb, cr, 0, width, layout);
+		}
+
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+		/*-------------+
+		| SIMD kernels |
+		+-------------*/
+
+		/**
+		 * Builds the byte shuffles that spread two of the four pixels in a
+		 * 16-byte load into 16-bit lanes, as r, g, b, 0, r, g, b, 0.
+		 */
+		void GetShuffles(const Layout &layout, unsigned char (&lo)[16], unsigned char (&hi)[16])
+		{
+			const unsigned offsets[3] = {layout.r, layout.g, layout.b};
+			for (unsigned i = 0; i < 16; ++i)
+			{
+				unsigned pixel = i / 8, component = i / 2 % 4;
+				bool zero = i % 2 || component == 3;
+				lo[i] = zero ? 0x80 : pixel       * layout.size + offsets[component];
+				hi[i] = zero ? 0x80 : (pixel + 2) * layout.size + offsets[component];
+			}
+		}
+
+		/**
+		 * Returns the luma of four pixels, which are spread over two
+		 * registers, in the low four bytes.
+		 */
+		__attribute__((target("ssse3")))
+		inline __m128i LumaSsse3(__m128i pixelsLo, __m128i pixelsHi, __m128i coefficients, __m128i offset)
+		{
+			__m128i luma(_mm_hadd_epi32(
+				_mm_madd_epi16(pixelsLo, coefficients),
+				_mm_madd_epi16(pixelsHi, coefficients)));
+			luma = _mm_srai_epi32(_mm_add_epi32(luma, offset), fixedBits);
+			luma = _mm_packs_epi32(luma, luma);
+			return _mm_packus_epi16(luma, luma);
+		}
+
+		__attribute__((target("ssse3")))
+		void ConvertRowPairSsse3(
+			const unsigned char *row0, const unsigned char *row1,
+			unsigned char *y0, unsigned char *y1,
+			unsigned char *cb, unsigned char *cr,
+			unsigned width, const Layout &layout)
+		{
+			const auto &c(GetCoefficients());
+			unsigned char shuffleLo[16], shuffleHi[16];
+			GetShuffles(layout, shuffleLo, shuffleHi);
+			const __m128i
+				lo      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffleLo)),
+				hi      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffleHi)),
+				cy      = _mm_load_si128(reinterpret_cast<const __m128i *>(c.rows[0])),
+				ccb     = _mm_load_si128(reinterpret_cast<const __m128i *>(c.rows[1])),
+				ccr     = _mm_load_si128(reinterpret_cast<const __m128i *>(c.rows[2])),
+				yOffset = _mm_set1_epi32(lumaOffset),
+				cOffset = _mm_set1_epi32(chromaOffset);
+
+			// NOTE: each step loads 16 bytes, of which only four pixels are
+			// used, so stop before reading past the end of the row
+			unsigned x = 0;
+			for (; (x + 4) * layout.size + (16 - 4 * layout.size) <= width * layout.size; x += 4)
 			{
-				for (unsigned i = 0; i < size.x; ++i)
+				__m128i
+					pixels0   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * layout.size)),
+					pixels1   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * layout.size)),
+					pixels0Lo = _mm_shuffle_epi8(pixels0, lo),
+					pixels0Hi = _mm_shuffle_epi8(pixels0, hi),
+					pixels1Lo = _mm_shuffle_epi8(pixels1, lo),
+					pixels1Hi = _mm_shuffle_epi8(pixels1, hi);
+
+				std::int32_t luma = _mm_cvtsi128_si32(LumaSsse3(pixels0Lo, pixels0Hi, cy, yOffset));
+				std::memcpy(y0 + x, &luma, 4);
+				if (y1)
 				{
-					Vector<3, int> color(rgb[0], rgb[1], rgb[2]);
-					*y++ = unsigned(Dot(Vector<3, int>(rgbToYcbcrColorMatrix.Row(0)), color) + (16u << 24)) >> 24;
-					rgb += 3;
+					luma = _mm_cvtsi128_si32(LumaSsse3(pixels1Lo, pixels1Hi, cy, yOffset));
+					std::memcpy(y1 + x, &luma, 4);
 				}
+
+				// sum the columns, and then the pairs of columns, of each
+				// 2x2 block
+				__m128i
+					sumLo = _mm_add_epi16(pixels0Lo, pixels1Lo),
+					sumHi = _mm_add_epi16(pixels0Hi, pixels1Hi),
+					chroma = _mm_hadd_epi32(
+						_mm_hadd_epi32(_mm_madd_epi16(sumLo, ccb), _mm_madd_epi16(sumHi, ccb)),
+						_mm_hadd_epi32(_mm_madd_epi16(sumLo, ccr), _mm_madd_epi16(sumHi, ccr)));
+				chroma = _mm_srai_epi32(_mm_add_epi32(chroma, cOffset), fixedBits + 2);
+				chroma = _mm_packs_epi32(chroma, chroma);
+				chroma = _mm_packus_epi16(chroma, chroma);
+				std::int32_t chromas = _mm_cvtsi128_si32(chroma);
+				std::memcpy(cb + x / 2, &chromas,                                    2);
+				std::memcpy(cr + x / 2, reinterpret_cast<unsigned char *>(&chromas) + 2, 2);
+			}
+			ConvertRowPair(row0, row1, y0, y1, cb, cr, x, width, layout);
+		}
+
+		/**
+		 * Loads four pixels into each 128-bit lane.
+		 */
+		__attribute__((target("avx2")))
+		inline __m256i LoadAvx2(const unsigned char *row, const Layout &layout)
+		{
+			return _mm256_inserti128_si256(
+				_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row))),
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(row + 4 * layout.size)), 1);
+		}
+
+		/**
+		 * Packs eight 32-bit values, four in each 128-bit lane, into the low
+		 * eight bytes.
+		 */
+		__attribute__((target("avx2")))
+		inline __m128i PackAvx2(__m256i v, __m256i gather)
+		{
+			v = _mm256_packs_epi32(v, v);
+			v = _mm256_packus_epi16(v, v);
+			return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(v, gather));
+		}
+
+		/**
+		 * Returns the luma of eight pixels, which are spread over two
+		 * registers, in the low eight bytes.
+		 */
+		__attribute__((target("avx2")))
+		inline __m128i LumaAvx2(__m256i pixelsLo, __m256i pixelsHi, __m256i coefficients, __m256i offset, __m256i gather)
+		{
+			__m256i luma(_mm256_hadd_epi32(
+				_mm256_madd_epi16(pixelsLo, coefficients),
+				_mm256_madd_epi16(pixelsHi, coefficients)));
+			return PackAvx2(_mm256_srai_epi32(_mm256_add_epi32(luma, offset), fixedBits), gather);
+		}
+
+		__attribute__((target("avx2")))
+		void ConvertRowPairAvx2(
+			const unsigned char *row0, const unsigned char *row1,
+			unsigned char *y0, unsigned char *y1,
+			unsigned char *cb, unsigned char *cr,
+			unsigned width, const Layout &layout)
+		{
+			const auto &c(GetCoefficients());
+			unsigned char shuffleLo[16], shuffleHi[16];
+			GetShuffles(layout, shuffleLo, shuffleHi);
+			const __m256i
+				lo      = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffleLo))),
+				hi      = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffleHi))),
+				cy      = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(c.rows[0]))),
+				ccb     = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(c.rows[1]))),
+				ccr     = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(c.rows[2]))),
+				yOffset = _mm256_set1_epi32(lumaOffset),
+				cOffset = _mm256_set1_epi32(chromaOffset),
+				// gathers the first four bytes of each 128-bit lane
+				gather  = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+			// moves the chroma of four blocks from cb, cb, cr, cr, cb, cb,
+			// cr, cr to four cb followed by four cr
+			const __m128i planar = _mm_setr_epi8(0, 1, 4, 5, 2, 3, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0);
+
+			unsigned x = 0;
+			for (; (x + 8) * layout.size + (16 - 4 * layout.size) <= width * layout.size; x += 8)
+			{
+				__m256i
+					pixels0   = LoadAvx2(row0 + x * layout.size, layout),
+					pixels1   = LoadAvx2(row1 + x * layout.size, layout),
+					pixels0Lo = _mm256_shuffle_epi8(pixels0, lo),
+					pixels0Hi = _mm256_shuffle_epi8(pixels0, hi),
+					pixels1Lo = _mm256_shuffle_epi8(pixels1, lo),
+					pixels1Hi = _mm256_shuffle_epi8(pixels1, hi);
+
+				_mm_storel_epi64(reinterpret_cast<__m128i *>(y0 + x), LumaAvx2(pixels0Lo, pixels0Hi, cy, yOffset, gather));
+				if (y1)
+					_mm_storel_epi64(reinterpret_cast<__m128i *>(y1 + x), LumaAvx2(pixels1Lo, pixels1Hi, cy, yOffset, gather));
+
+				__m256i
+					sumLo = _mm256_add_epi16(pixels0Lo, pixels1Lo),
+					sumHi = _mm256_add_epi16(pixels0Hi, pixels1Hi),
+					chroma = _mm256_hadd_epi32(
+						_mm256_hadd_epi32(_mm256_madd_epi16(sumLo, ccb), _mm256_madd_epi16(sumHi, ccb)),
+						_mm256_hadd_epi32(_mm256_madd_epi16(sumLo, ccr), _mm256_madd_epi16(sumHi, ccr)));
+				__m128i chromas(_mm_shuffle_epi8(
+					PackAvx2(_mm256_srai_epi32(_mm256_add_epi32(chroma, cOffset), fixedBits + 2), gather),
+					planar));
+				std::int32_t cbs = _mm_cvtsi128_si32(chromas), crs = _mm_extract_epi32(chromas, 1);
+				std::memcpy(cb + x / 2, &cbs, 4);
+				std::memcpy(cr + x / 2, &crs, 4);
 			}
-			rgb = rgbRow + rgbStride;
-			y   = yRow   + ycbcrStride;
+			ConvertRowPair(row0, row1, y0, y1, cb, cr, x, width, layout);
+		}
+#endif
+
+		RowPairKernel GetKernel(SimdLevel maxLevel)
+		{
+			SimdLevel level = std::min(GetSimdLevel(), maxLevel);
+			switch (level)
+			{
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+				case SimdLevel::avx2:  return ConvertRowPairAvx2;
+				case SimdLevel::ssse3: return ConvertRowPairSsse3;
+#endif
+				default: return ConvertRowPairScalar;
+			}
+		}
+	}
+
+	SimdLevel GetSimdLevel()
+	{
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+		static const SimdLevel level =
+			__builtin_cpu_supports("avx2")  ? SimdLevel::avx2  :
+			__builtin_cpu_supports("ssse3") ? SimdLevel::ssse3 :
+			SimdLevel::none;
+		return level;
+#else
+		return SimdLevel::none;
+#endif
+	}
+
+	void RgbToYcbcr420(
+		const unsigned char *rgb,
+		unsigned char *y, unsigned char *cb, unsigned char *cr,
+		const Vector<2, unsigned> &size,
+		unsigned rgbStride, unsigned ycbcrStride,
+		RgbLayout rgbLayout, SimdLevel maxLevel)
+	{
+		const Layout layout(GetLayout(rgbLayout));
+		const RowPairKernel kernel = GetKernel(maxLevel);
+		for (unsigned i = 0; i < size.y; i += 2)
+		{
+			// NOTE: the last row is repeated when the height is odd
+			bool pair = i + 1 < size.y;
+			kernel(
+				rgb, pair ? rgb + rgbStride : rgb,
+				y,   pair ? y + ycbcrStride : nullptr,
+				cb, cr, size.x, layout);
+			rgb += rgbStride   * 2;
+			y   += ycbcrStride * 2;
+			cb  += ycbcrStride / 2;
+			cr  += ycbcrStride / 2;
 		}
 	}
 }}
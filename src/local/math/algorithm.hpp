@@ -32,11 +32,50 @@
 
 namespace page { namespace math
 {
+	/**
+	 * The order of the components of the pixels passed to RgbToYcbcr420().
+	 */
+	enum class RgbLayout
+	{
+		rgb,
+		rgba,
+		bgra
+	};
+
+	/**
+	 * The vector instruction sets that the pixel kernels can use, such as
+	 * RgbToYcbcr420(), from the slowest to the fastest.
+	 */
+	enum class SimdLevel
+	{
+		none,
+		ssse3,
+		avx2
+	};
+
+	/**
+	 * Returns the fastest instruction set that the pixel kernels can use on
+	 * this processor.
+	 */
+	SimdLevel GetSimdLevel();
+
+	/**
+	 * Converts 8-bit RGB pixels to planar Y'CbCr 4:2:0.  Each chroma sample
+	 * is the average of the 2x2 block of pixels that it covers.  The fastest
+	 * kernel that is supported by the processor is chosen at run time,
+	 * unless it is limited by @a maxLevel, and every kernel produces the
+	 * same output.
+	 *
+	 * @note An image can be converted in bands of rows, on separate threads
+	 *       if desired, as long as each band starts on an even row.
+	 */
 	void RgbToYcbcr420(
 		const unsigned char *rgb,
 		unsigned char *y, unsigned char *cb, unsigned char *cr,
 		const Vector<2, unsigned> &size,
-		unsigned rgbStride, unsigned ycbcrStride);
+		unsigned rgbStride, unsigned ycbcrStride,
+		RgbLayout = RgbLayout::rgb,
+		SimdLevel maxLevel = SimdLevel::avx2);
 }}
 
 #endif
@@ -30,7 +30,7 @@
 
 #	include <utility> // pair
 
-#	include "fwd.hpp" // Plane
+#	include "fwd.hpp" // Aabb, Frustum, Plane
 #	include "Vector.hpp"
 
 namespace page { namespace math
@@ -59,6 +59,12 @@ namespace page { namespace math
 			const Plane<n, T> &, // plane
 			const Vector<n, T> &); // point
 
+	// closest point on aabb
+	template <unsigned n, typename T> Vector<n, T>
+		ClosestPointOnAabb(
+			const Aabb<n, T> &, // aabb
+			const Vector<n, T> &); // point
+
 	// closest point between lines
 	template <unsigned n, typename T> std::pair<T, T>
 		ClosestPointSegmentWeight(
@@ -79,6 +85,12 @@ namespace page { namespace math
 			const Vector<n, T> &, // point
 			const Vector<n, T> &, const Vector<n, T> &); // line
 
+	// point/aabb distance
+	template <unsigned n, typename T> T
+		PointAabbSqrDist(
+			const Vector<n, T> &, // point
+			const Aabb<n, T> &); // aabb
+
 	// line/line distance
 	template <unsigned n, typename T> T
 		SegmentSqrDist(
@@ -99,6 +111,25 @@ namespace page { namespace math
 			const Vector<2, T> &, // point
 			const Vector<2, T> &, const Vector<2, T> &, const Vector<2, T> &); // triangle
 
+	// aabb/frustum intersection
+	// NOTE: conservative; boxes outside of the frustum but straddling two of
+	// its planes near a corner will be reported as intersecting
+	template <typename T> bool
+		AabbFrustumIntersect(
+			const Aabb<3, T> &, // aabb
+			const Frustum<T> &); // frustum
+	template <typename T> bool
+		AabbInFrustum(
+			const Aabb<3, T> &, // aabb
+			const Frustum<T> &); // frustum
+
+	// sphere/frustum intersection
+	// NOTE: conservative, in the same way as AabbFrustumIntersect
+	template <typename T> bool
+		SphereFrustumIntersect(
+			const Vector<3, T> &, T radius, // sphere
+			const Frustum<T> &); // frustum
+
 	// line/line intersection
 	// NOTE: lines are represented by two end-points
 	template <typename T> T
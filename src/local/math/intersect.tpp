@@ -28,7 +28,9 @@
 #include <algorithm> // max, min
 #include <cmath> // copysign, sqrt
 
+#include "Aabb.hpp"
 #include "float.hpp" // Inf
+#include "Frustum.hpp"
 #include "interp.hpp" // Lerp
 #include "Plane.hpp"
 
@@ -65,6 +67,12 @@ namespace page { namespace math
 		return q - ClosestPointOnPlaneWeight(p, q) * p.no;
 	}
 
+	// closest point on aabb
+	template <unsigned n, typename T> Vector<n, T> ClosestPointOnAabb(const Aabb<n, T> &a, const Vector<n, T> &p)
+	{
+		return Min(Max(p, a.min), a.max);
+	}
+
 	// closest point between lines
 	template <unsigned n, typename T> std::pair<T, T> ClosestPointSegmentWeight(const Vector<n, T> &a, const Vector<n, T> &b, const Vector<n, T> &c, const Vector<n, T> &d)
 	{
@@ -121,6 +129,13 @@ namespace page { namespace math
 		return std::sqrt(PointSegmentSqrDist(p, a, b));
 	}
 
+	// point/aabb distance
+	template <unsigned n, typename T> T PointAabbSqrDist(const Vector<n, T> &p, const Aabb<n, T> &a)
+	{
+		Vector<n, T> v(ClosestPointOnAabb(a, p) - p);
+		return Dot(v, v);
+	}
+
 	// line/line distance
 	template <unsigned n, typename T> T SegmentSqrDist(const Vector<n, T> &a, const Vector<n, T> &b, const Vector<n, T> &c, const Vector<n, T> &d)
 	{
@@ -149,6 +164,42 @@ namespace page { namespace math
 			PerpDot(p - c, a - c) <= 0);
 	}
 
+	// aabb/frustum intersection
+	template <typename T> bool AabbFrustumIntersect(const Aabb<3, T> &a, const Frustum<T> &f)
+	{
+		// Real-Time Collision Detection, Christer Ericson, 2005
+		// test the corner furthest along each plane's normal
+		for (const auto &plane : f)
+		{
+			Vector<3, T> v;
+			for (unsigned i = 0; i < 3; ++i)
+				v[i] = plane.no[i] >= 0 ? a.max[i] : a.min[i];
+			if (Dot(plane.no, v) < plane.d) return false;
+		}
+		return true;
+	}
+	template <typename T> bool AabbInFrustum(const Aabb<3, T> &a, const Frustum<T> &f)
+	{
+		// test the corner furthest against each plane's normal
+		for (const auto &plane : f)
+		{
+			Vector<3, T> v;
+			for (unsigned i = 0; i < 3; ++i)
+				v[i] = plane.no[i] >= 0 ? a.min[i] : a.max[i];
+			if (Dot(plane.no, v) < plane.d) return false;
+		}
+		return true;
+	}
+
+	// sphere/frustum intersection
+	template <typename T> bool SphereFrustumIntersect(const Vector<3, T> &c, T r, const Frustum<T> &f)
+	{
+		for (const auto &plane : f)
+			if (Dot(plane.no, c) - plane.d < -r)
+				return false;
+		return true;
+	}
+
 	// line/line intersection
 	template <typename T> T LineIntersectFirstWeight(const Vector<2, T> &a, const Vector<2, T> &b, const Vector<2, T> &c, const Vector<2, T> &d)
 	{
@@ -0,0 +1,236 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+
+#include <algorithm> // copy_n
+#include <utility> // move
+
+#include "../math/interp.hpp" // LinearInterp
+#include "BoneFrame.hpp"
+
+namespace page { namespace phys
+{
+	namespace
+	{
+		/**
+		 * A bitmask word with every bone set.
+		 */
+		const BoneFrame::Word fullWord = ~BoneFrame::Word(0);
+
+		/*-------------------------+
+		| layout-independent paths |
+		+-------------------------*/
+
+		/**
+		 * Returns a copy of the bone frame indexed by a different layout,
+		 * leaving out any bones that the layout doesn't have.  This is the
+		 * slow path for combining frames from different skeletons.
+		 */
+		BoneFrame Rebind(const BoneFrame &src, const std::shared_ptr<const BoneLayout> &layout)
+		{
+			BoneFrame dest;
+			dest.Bind(layout);
+			for (std::size_t i = 0; i < src.layout->names.size(); ++i)
+			{
+				int j = layout->Find(src.layout->names[i]);
+				if (j == -1) continue;
+				if (src.position.Has(i))    dest.position.Set   (j, src.position.values[i]);
+				if (src.orientation.Has(i)) dest.orientation.Set(j, src.orientation.values[i]);
+				if (src.scale.Has(i))       dest.scale.Set      (j, src.scale.values[i]);
+			}
+			return dest;
+		}
+
+		/*---------------------+
+		| Merge implementation |
+		+---------------------*/
+
+		template <typename T>
+			void Merge(BoneFrame::Channel<T> &dest, const BoneFrame::Channel<T> &src)
+		{
+			for (std::size_t w = 0; w < src.valid.size(); ++w)
+			{
+				BoneFrame::Word bits = src.valid[w];
+				std::size_t first = w * BoneFrame::wordBits;
+				if (bits == fullWord)
+					std::copy_n(&src.values[first], BoneFrame::wordBits, &dest.values[first]);
+				else
+					for (std::size_t i = first; bits; ++i, bits >>= 1)
+						if (bits & 1) dest.values[i] = src.values[i];
+				dest.valid[w] |= src.valid[w];
+			}
+		}
+
+		/*---------------------+
+		| Blend implementation |
+		+---------------------*/
+
+		/**
+		 * Blends a run of vectors that are set in both frames.  The vectors
+		 * are treated as a flat array of components, which the compiler can
+		 * vectorize.
+		 */
+		void BlendRun(math::Vec3 *dest, const math::Vec3 *src, std::size_t size, float alpha)
+		{
+			static_assert(sizeof(math::Vec3) == 3 * sizeof(math::DefaultType), "vector must be packed");
+			auto d(&dest->x);
+			auto s(&src->x);
+			for (std::size_t i = 0; i < size * 3; ++i)
+				d[i] += (s[i] - d[i]) * alpha;
+		}
+
+		/**
+		 * Blends a run of orientations that are set in both frames.
+		 */
+		void BlendRun(math::Quat<> *dest, const math::Quat<> *src, std::size_t size, float alpha)
+		{
+			for (std::size_t i = 0; i < size; ++i)
+				dest[i] = math::LinearInterp(dest[i], src[i], alpha);
+		}
+
+		template <typename T>
+			void Blend(BoneFrame::Channel<T> &dest, const BoneFrame::Channel<T> &src, float alpha)
+		{
+			for (std::size_t w = 0; w < src.valid.size(); ++w)
+			{
+				BoneFrame::Word
+					both = dest.valid[w] &  src.valid[w],
+					only = src.valid[w]  & ~dest.valid[w];
+				std::size_t first = w * BoneFrame::wordBits;
+				if (both == fullWord)
+					BlendRun(&dest.values[first], &src.values[first], BoneFrame::wordBits, alpha);
+				else
+					for (std::size_t i = first; both | only; ++i, both >>= 1, only >>= 1)
+					{
+						if (both & 1) BlendRun(&dest.values[i], &src.values[i], 1, alpha);
+						else if (only & 1) dest.values[i] = src.values[i];
+					}
+				dest.valid[w] |= src.valid[w];
+			}
+		}
+
+		/*--------------------+
+		| Mask implementation |
+		+--------------------*/
+
+		template <typename T>
+			void Mask(BoneFrame::Channel<T> &dest, const BoneFrame::Channel<T> &mask)
+		{
+			for (std::size_t w = 0; w < dest.valid.size(); ++w)
+				dest.valid[w] &= mask.valid[w];
+		}
+	}
+
+	/*-------------+
+	| constructors |
+	+-------------*/
+
+	BoneLayout::BoneLayout(std::vector<std::string> names) :
+		names(std::move(names))
+	{
+		indices.reserve(this->names.size());
+		for (unsigned i = 0; i < this->names.size(); ++i)
+			indices.insert(std::make_pair(this->names[i], i));
+	}
+
+	/*----------+
+	| observers |
+	+----------*/
+
+	int BoneLayout::Find(const std::string &name) const
+	{
+		auto iter(indices.find(name));
+		return iter != indices.end() ? iter->second : -1;
+	}
+
+	/*--------+
+	| binding |
+	+--------*/
+
+	void BoneFrame::Bind(const std::shared_ptr<const BoneLayout> &layout)
+	{
+		std::size_t size = layout ? layout->names.size() : 0;
+		position.Reset(size);
+		orientation.Reset(size);
+		scale.Reset(size);
+		this->layout = layout;
+	}
+
+	/*-----------+
+	| operations |
+	+-----------*/
+
+	BoneFrame &operator +=(BoneFrame &a, const BoneFrame &b)
+	{
+		if (!b.layout) return a;
+		if (!a.layout) return a = b;
+		if (b.layout != a.layout) return a += Rebind(b, a.layout);
+
+		Merge(a.position,    b.position);
+		Merge(a.orientation, b.orientation);
+		Merge(a.scale,       b.scale);
+		return a;
+	}
+
+	void Blend(BoneFrame &dest, const BoneFrame &src, float alpha)
+	{
+		if (!src.layout) return;
+		if (!dest.layout)
+		{
+			dest = src;
+			return;
+		}
+		if (src.layout != dest.layout)
+		{
+			Blend(dest, Rebind(src, dest.layout), alpha);
+			return;
+		}
+
+		Blend(dest.position,    src.position,    alpha);
+		Blend(dest.orientation, src.orientation, alpha);
+		Blend(dest.scale,       src.scale,       alpha);
+	}
+
+	void Mask(BoneFrame &dest, const BoneFrame &mask)
+	{
+		if (!dest.layout) return;
+		if (!mask.layout)
+		{
+			dest.Bind(std::shared_ptr<const BoneLayout>(dest.layout));
+			return;
+		}
+		if (mask.layout != dest.layout)
+		{
+			Mask(dest, Rebind(mask, dest.layout));
+			return;
+		}
+
+		Mask(dest.position,    mask.position);
+		Mask(dest.orientation, mask.orientation);
+		Mask(dest.scale,       mask.scale);
+	}
+}}
@@ -0,0 +1,169 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+
+#ifndef    page_local_phys_BoneFrame_hpp
+#   define page_local_phys_BoneFrame_hpp
+
+#	include <cstddef> // size_t
+#	include <cstdint> // uint32_t
+#	include <memory> // shared_ptr
+#	include <string>
+#	include <unordered_map>
+#	include <vector>
+
+#	include "../math/Quat.hpp"
+#	include "../math/Vector.hpp"
+
+namespace page { namespace phys
+{
+	/**
+	 * The names of a pose's bones in index order.
+	 *
+	 * A layout is immutable once it has been built, so it can be shared
+	 * between copies of a pose, and its address can be used to find out
+	 * whether a binding that was compiled against it is still valid.
+	 */
+	struct BoneLayout
+	{
+		// construct
+		explicit BoneLayout(std::vector<std::string> names);
+
+		/**
+		 * Returns the index of the bone with the specified name, or -1 if
+		 * no bone has that name.
+		 */
+		int Find(const std::string &) const;
+
+		/**
+		 * The names of the bones, by index.
+		 */
+		std::vector<std::string> names;
+
+		/**
+		 * An associative array mapping the name of a bone to its index.
+		 */
+		std::unordered_map<std::string, unsigned> indices;
+	};
+
+	/**
+	 * The bone channels of a frame, indexed by a bone layout.
+	 *
+	 * The channels are stored as structure-of-arrays, with a bitmask per
+	 * channel marking which of the bones have been set, so blending and
+	 * masking are tight loops over dense arrays rather than lookups by name.
+	 */
+	struct BoneFrame
+	{
+		/**
+		 * The word type of the validity bitmasks.
+		 */
+		typedef std::uint32_t Word;
+
+		/**
+		 * The number of bones covered by each word of a bitmask.
+		 */
+		static const unsigned wordBits = 32;
+
+		/**
+		 * A dense array of values for one channel of every bone, along with
+		 * a bitmask marking the values that have been set.
+		 */
+		template <typename T> struct Channel
+		{
+			/**
+			 * Returns @c true if the value for the specified bone has been
+			 * set.
+			 */
+			bool Has(std::size_t index) const
+			{
+				return valid[index / wordBits] >> index % wordBits & 1;
+			}
+
+			/**
+			 * Sets the value for the specified bone.
+			 */
+			void Set(std::size_t index, const T &value)
+			{
+				values[index] = value;
+				valid[index / wordBits] |= Word(1) << index % wordBits;
+			}
+
+			/**
+			 * Resizes the channel for the specified number of bones, and
+			 * marks all of them as unset.
+			 */
+			void Reset(std::size_t size)
+			{
+				values.resize(size);
+				valid.assign((size + wordBits - 1) / wordBits, 0);
+			}
+
+			std::vector<T> values;
+			std::vector<Word> valid;
+		};
+
+		/**
+		 * Sizes the channels for the specified layout, and marks all of the
+		 * bones as unset.  If @a layout is @c nullptr, the frame is emptied.
+		 */
+		void Bind(const std::shared_ptr<const BoneLayout> &layout);
+
+		/**
+		 * The layout that the channels are indexed by, or @c nullptr if the
+		 * frame is empty.
+		 */
+		std::shared_ptr<const BoneLayout> layout;
+
+		Channel<math::Vec3>   position;
+		Channel<math::Quat<>> orientation;
+		Channel<math::Vec3>   scale;
+	};
+
+	/*-----------+
+	| operations |
+	+-----------*/
+
+	/**
+	 * Merges two bone frames, with the second frame overriding any bones in
+	 * the first frame that have been set.
+	 */
+	BoneFrame &operator +=(BoneFrame &, const BoneFrame &);
+
+	/**
+	 * Blends two bone frames by an alpha value.
+	 */
+	void Blend(BoneFrame &dest, const BoneFrame &src, float alpha);
+
+	/**
+	 * Applies a mask to a bone frame.  If a bone is not set in the masking
+	 * frame, that bone will not be set in the destination frame either.
+	 */
+	void Mask(BoneFrame &dest, const BoneFrame &mask);
+}}
+
+#endif
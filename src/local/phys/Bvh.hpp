@@ -0,0 +1,175 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_phys_Bvh_hpp
+#   define page_local_phys_Bvh_hpp
+
+#	include <unordered_map>
+#	include <vector>
+
+#	include "../math/Aabb.hpp"
+#	include "../math/fwd.hpp" // Frustum, Vector
+
+namespace page { namespace phys
+{
+	/**
+	 * A dynamic bounding-volume hierarchy, which indexes a set of objects by
+	 * their axis-aligned bounding-boxes for spatial queries.
+	 *
+	 * The tree is built incrementally, choosing insertion points with the
+	 * surface-area heuristic and rebalancing with tree rotations.  Leaf boxes
+	 * are enlarged by a margin so that small movements don't require the
+	 * tree to be modified.
+	 *
+	 * Objects with an empty or unbounded box are kept outside of the tree,
+	 * and are reported by every query.
+	 *
+	 * @note Based on the dynamic AABB tree in Box2D, by Erin Catto.
+	 */
+	template <typename T> class Bvh
+	{
+		/*-------------+
+		| constructors |
+		+-------------*/
+
+		public:
+		Bvh() = default;
+
+		/*----------+
+		| modifiers |
+		+----------*/
+
+		/**
+		 * Adds an object to the tree with the specified bounding-box.
+		 */
+		void Insert(T *, const math::Aabb<3> &);
+
+		/**
+		 * Removes an object from the tree.
+		 */
+		void Remove(T *);
+
+		/**
+		 * Updates the bounding-box of an object in the tree.
+		 *
+		 * @return @c true if the tree was modified, or @c false if the new
+		 *         box still fits within the margin of the old box.
+		 */
+		bool Update(T *, const math::Aabb<3> &);
+
+		void Clear();
+
+		/*----------+
+		| observers |
+		+----------*/
+
+		bool Contains(T *) const;
+		bool IsEmpty() const;
+
+		/*--------+
+		| queries |
+		+--------*/
+
+		/**
+		 * Calls @a f for each object whose box intersects the frustum.
+		 */
+		template <typename Function>
+			void Query(const math::Frustum<> &, Function f) const;
+
+		/**
+		 * Calls @a f for each object whose box intersects the specified box.
+		 */
+		template <typename Function>
+			void Query(const math::Aabb<3> &, Function f) const;
+
+		/**
+		 * Returns up to @a n objects ordered by the distance of their box from
+		 * the specified position, nearest first.
+		 */
+		std::vector<T *> QueryNearest(const math::Vec3 &, unsigned n) const;
+
+		/*----------------+
+		| node management |
+		+----------------*/
+
+		private:
+		struct Node
+		{
+			bool IsLeaf() const;
+
+			/**
+			 * The box of the node, which encloses its children.  For a leaf,
+			 * this is the object's box enlarged by the margin.
+			 */
+			math::Aabb<3> aabb;
+
+			/**
+			 * The object's actual box, for leaves only.
+			 */
+			math::Aabb<3> tightAabb;
+
+			T *value;
+			int parent, children[2];
+
+			/**
+			 * The height of the subtree, where leaves are zero and free nodes
+			 * are negative.
+			 */
+			int height;
+		};
+
+		int AllocateNode();
+		void FreeNode(int);
+
+		/*--------------+
+		| tree building |
+		+--------------*/
+
+		void InsertLeaf(int);
+		void RemoveLeaf(int);
+		void Refit(int);
+		int Balance(int);
+
+		/*-------------+
+		| data members |
+		+-------------*/
+
+		std::vector<Node> nodes;
+		int root = -1, freeList = -1;
+
+		/**
+		 * The leaf node of each object in the tree, or -1 for objects that
+		 * are stored in @c unbounded.
+		 */
+		std::unordered_map<T *, int> leaves;
+
+		std::vector<T *> unbounded;
+	};
+}}
+
+#	include "Bvh.tpp"
+#endif
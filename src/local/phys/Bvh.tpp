@@ -0,0 +1,432 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // find, max, remove
+#include <cassert>
+#include <cmath> // isfinite
+#include <functional> // greater
+#include <queue> // priority_queue
+#include <tuple>
+
+#include "../math/Frustum.hpp"
+#include "../math/intersect.hpp" // AabbFrustumIntersect, AabbInFrustum, PointAabbSqrDist
+#include "../math/Vector.hpp"
+
+namespace page { namespace phys
+{
+	namespace detail
+	{
+		/**
+		 * The fraction of its largest dimension that a leaf box is enlarged
+		 * by when it is inserted into the tree.
+		 */
+		const float bvhMargin = .125f;
+
+		/**
+		 * The minimum amount that a leaf box is enlarged by, so that point
+		 * objects get a margin too.
+		 */
+		const float bvhMinMargin = .25f;
+
+		inline bool IsBounded(const math::Aabb<3> &aabb)
+		{
+			return
+				std::isfinite(Sum(aabb.min) + Sum(aabb.max)) &&
+				All(aabb.min <= aabb.max);
+		}
+
+		inline float SurfaceArea(const math::Aabb<3> &aabb)
+		{
+			math::Vec3 size(Size(aabb));
+			return 2 * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		inline bool Overlaps(const math::Aabb<3> &a, const math::Aabb<3> &b)
+		{
+			return All(a.min <= b.max) && All(b.min <= a.max);
+		}
+	}
+
+	/*----------+
+	| modifiers |
+	+----------*/
+
+	template <typename T> void Bvh<T>::Insert(T *value, const math::Aabb<3> &aabb)
+	{
+		assert(value);
+		assert(!Contains(value));
+		if (!detail::IsBounded(aabb))
+		{
+			unbounded.push_back(value);
+			leaves.insert(std::make_pair(value, -1));
+			return;
+		}
+		int leaf = AllocateNode();
+		nodes[leaf].tightAabb = aabb;
+		nodes[leaf].aabb = Grow(aabb, std::max(
+			Max(Size(aabb)) * detail::bvhMargin, detail::bvhMinMargin));
+		nodes[leaf].value = value;
+		nodes[leaf].height = 0;
+		InsertLeaf(leaf);
+		leaves.insert(std::make_pair(value, leaf));
+	}
+
+	template <typename T> void Bvh<T>::Remove(T *value)
+	{
+		auto iter(leaves.find(value));
+		assert(iter != leaves.end());
+		if (iter->second == -1)
+			unbounded.erase(std::remove(unbounded.begin(), unbounded.end(), value), unbounded.end());
+		else
+		{
+			RemoveLeaf(iter->second);
+			FreeNode(iter->second);
+		}
+		leaves.erase(iter);
+	}
+
+	template <typename T> bool Bvh<T>::Update(T *value, const math::Aabb<3> &aabb)
+	{
+		auto iter(leaves.find(value));
+		assert(iter != leaves.end());
+		int leaf = iter->second;
+		if (leaf != -1 && detail::IsBounded(aabb))
+		{
+			nodes[leaf].tightAabb = aabb;
+			if (math::Contains(nodes[leaf].aabb, aabb)) return false;
+		}
+		Remove(value);
+		Insert(value, aabb);
+		return true;
+	}
+
+	template <typename T> void Bvh<T>::Clear()
+	{
+		nodes.clear();
+		root = freeList = -1;
+		leaves.clear();
+		unbounded.clear();
+	}
+
+	/*----------+
+	| observers |
+	+----------*/
+
+	template <typename T> bool Bvh<T>::Contains(T *value) const
+	{
+		return leaves.find(value) != leaves.end();
+	}
+
+	template <typename T> bool Bvh<T>::IsEmpty() const
+	{
+		return leaves.empty();
+	}
+
+	/*--------+
+	| queries |
+	+--------*/
+
+	template <typename T> template <typename Function>
+		void Bvh<T>::Query(const math::Frustum<> &frustum, Function f) const
+	{
+		for (T *value : unbounded) f(*value);
+		if (root == -1) return;
+		// the second element is true if the node is entirely within the
+		// frustum, so that its descendents don't need to be tested
+		std::vector<std::pair<int, bool>> stack(1, std::make_pair(root, false));
+		while (!stack.empty())
+		{
+			int index;
+			bool inside;
+			std::tie(index, inside) = stack.back();
+			stack.pop_back();
+			const Node &node(nodes[index]);
+			if (!inside)
+			{
+				if (!AabbFrustumIntersect(node.aabb, frustum)) continue;
+				inside = AabbInFrustum(node.aabb, frustum);
+			}
+			if (node.IsLeaf())
+			{
+				if (inside || AabbFrustumIntersect(node.tightAabb, frustum))
+					f(*node.value);
+			}
+			else
+			{
+				stack.push_back(std::make_pair(node.children[0], inside));
+				stack.push_back(std::make_pair(node.children[1], inside));
+			}
+		}
+	}
+
+	template <typename T> template <typename Function>
+		void Bvh<T>::Query(const math::Aabb<3> &aabb, Function f) const
+	{
+		for (T *value : unbounded) f(*value);
+		if (root == -1) return;
+		std::vector<int> stack(1, root);
+		while (!stack.empty())
+		{
+			const Node &node(nodes[stack.back()]);
+			stack.pop_back();
+			if (!detail::Overlaps(node.aabb, aabb)) continue;
+			if (node.IsLeaf())
+			{
+				if (detail::Overlaps(node.tightAabb, aabb))
+					f(*node.value);
+			}
+			else
+			{
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+	}
+
+	template <typename T> std::vector<T *> Bvh<T>::QueryNearest(const math::Vec3 &co, unsigned n) const
+	{
+		std::vector<T *> result;
+		result.reserve(n);
+		for (T *value : unbounded)
+		{
+			if (result.size() == n) return result;
+			result.push_back(value);
+		}
+		if (root == -1) return result;
+		// best-first search, where a leaf is queued with the distance to its
+		// actual box, which is never closer than any of its ancestors, so
+		// leaves are dequeued in order of distance
+		typedef std::pair<float, int> Entry;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+		auto push = [&](int index)
+		{
+			const Node &node(nodes[index]);
+			queue.push(Entry(PointAabbSqrDist(co,
+				node.IsLeaf() ? node.tightAabb : node.aabb), index));
+		};
+		push(root);
+		while (!queue.empty() && result.size() < n)
+		{
+			const Node &node(nodes[queue.top().second]);
+			queue.pop();
+			if (node.IsLeaf()) result.push_back(node.value);
+			else
+			{
+				push(node.children[0]);
+				push(node.children[1]);
+			}
+		}
+		return result;
+	}
+
+	/*----------------+
+	| node management |
+	+----------------*/
+
+	template <typename T> bool Bvh<T>::Node::IsLeaf() const
+	{
+		return children[0] == -1;
+	}
+
+	template <typename T> int Bvh<T>::AllocateNode()
+	{
+		int index;
+		if (freeList != -1)
+		{
+			index = freeList;
+			freeList = nodes[index].parent;
+		}
+		else
+		{
+			index = nodes.size();
+			nodes.emplace_back();
+		}
+		Node &node(nodes[index]);
+		node.value = nullptr;
+		node.parent = node.children[0] = node.children[1] = -1;
+		node.height = 0;
+		return index;
+	}
+
+	template <typename T> void Bvh<T>::FreeNode(int index)
+	{
+		// free nodes are linked through their parent index
+		nodes[index].parent = freeList;
+		nodes[index].height = -1;
+		freeList = index;
+	}
+
+	/*--------------+
+	| tree building |
+	+--------------*/
+
+	template <typename T> void Bvh<T>::InsertLeaf(int leaf)
+	{
+		if (root == -1)
+		{
+			root = leaf;
+			nodes[leaf].parent = -1;
+			return;
+		}
+
+		// find the best sibling using the surface-area heuristic
+		math::Aabb<3> leafAabb(nodes[leaf].aabb);
+		int index = root;
+		while (!nodes[index].IsLeaf())
+		{
+			const Node &node(nodes[index]);
+			float
+				area = detail::SurfaceArea(node.aabb),
+				combinedArea = detail::SurfaceArea(Max(node.aabb, leafAabb)),
+				// cost of creating a new parent for this node and the leaf
+				cost = 2 * combinedArea,
+				// minimum cost of pushing the leaf further down the tree
+				inheritanceCost = 2 * (combinedArea - area),
+				childCosts[2];
+			for (unsigned i = 0; i < 2; ++i)
+			{
+				const Node &child(nodes[node.children[i]]);
+				float newArea = detail::SurfaceArea(Max(child.aabb, leafAabb));
+				childCosts[i] = (child.IsLeaf() ? newArea :
+					newArea - detail::SurfaceArea(child.aabb)) + inheritanceCost;
+			}
+			if (cost < childCosts[0] && cost < childCosts[1]) break;
+			index = node.children[childCosts[0] < childCosts[1] ? 0 : 1];
+		}
+		int sibling = index;
+
+		// create a new parent for the sibling and the leaf
+		int oldParent = nodes[sibling].parent;
+		int newParent = AllocateNode();
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].aabb = Max(leafAabb, nodes[sibling].aabb);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].children[0] = sibling;
+		nodes[newParent].children[1] = leaf;
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+		if (oldParent != -1)
+		{
+			int *children = nodes[oldParent].children;
+			children[children[0] == sibling ? 0 : 1] = newParent;
+		}
+		else root = newParent;
+
+		Refit(nodes[leaf].parent);
+	}
+
+	template <typename T> void Bvh<T>::RemoveLeaf(int leaf)
+	{
+		if (leaf == root)
+		{
+			root = -1;
+			return;
+		}
+
+		// replace the parent with the sibling
+		int parent = nodes[leaf].parent;
+		int grandParent = nodes[parent].parent;
+		int sibling = nodes[parent].children[nodes[parent].children[0] == leaf ? 1 : 0];
+		nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+		if (grandParent != -1)
+		{
+			int *children = nodes[grandParent].children;
+			children[children[0] == parent ? 0 : 1] = sibling;
+			Refit(grandParent);
+		}
+		else root = sibling;
+	}
+
+	/**
+	 * Rebalances and recalculates the boxes of a node and its ancestors.
+	 */
+	template <typename T> void Bvh<T>::Refit(int index)
+	{
+		while (index != -1)
+		{
+			index = Balance(index);
+			Node &node(nodes[index]);
+			const Node
+				&child0(nodes[node.children[0]]),
+				&child1(nodes[node.children[1]]);
+			node.height = 1 + std::max(child0.height, child1.height);
+			node.aabb = Max(child0.aabb, child1.aabb);
+			index = node.parent;
+		}
+	}
+
+	/**
+	 * Performs a left or right rotation if the node is unbalanced.
+	 *
+	 * @return The index of the node which has replaced it in the tree.
+	 */
+	template <typename T> int Bvh<T>::Balance(int a)
+	{
+		Node &nodeA(nodes[a]);
+		if (nodeA.IsLeaf() || nodeA.height < 2) return a;
+
+		int
+			b = nodeA.children[0],
+			c = nodeA.children[1],
+			balance = nodes[c].height - nodes[b].height;
+		if (balance >= -1 && balance <= 1) return a;
+
+		// rotate the taller child (up) into the position of the node, and
+		// move the node (a) down in its place
+		int up = balance > 1 ? c : b, other = balance > 1 ? b : c;
+		Node &nodeUp(nodes[up]);
+		int
+			upChild0 = nodeUp.children[0],
+			upChild1 = nodeUp.children[1];
+
+		nodeUp.children[0] = a;
+		nodeUp.parent = nodeA.parent;
+		nodeA.parent = up;
+		if (nodeUp.parent != -1)
+		{
+			int *children = nodes[nodeUp.parent].children;
+			children[children[0] == a ? 0 : 1] = up;
+		}
+		else root = up;
+
+		// the taller grandchild stays under the rotated node and the shorter
+		// one moves under the old node
+		int keep = upChild0, move = upChild1;
+		if (nodes[upChild0].height < nodes[upChild1].height)
+			std::swap(keep, move);
+		nodeUp.children[1] = keep;
+		nodeA.children[up == c ? 1 : 0] = move;
+		nodes[move].parent = a;
+
+		nodeA.aabb = Max(nodes[other].aabb, nodes[move].aabb);
+		nodeA.height = 1 + std::max(nodes[other].height, nodes[move].height);
+		nodeUp.aabb = Max(nodeA.aabb, nodes[keep].aabb);
+		nodeUp.height = 1 + std::max(nodeA.height, nodes[keep].height);
+		return up;
+	}
+}}
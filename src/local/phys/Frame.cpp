@@ -25,6 +25,8 @@
  * of this software.
  */
 
+#include <cstddef> // size_t
+
 #include "../math/interp.hpp" // LinearInterp
 #include "Frame.hpp"
 
@@ -65,6 +67,56 @@ namespace page { namespace phys
 		{
 			if (!mask) dest.reset();
 		}
+
+		/*----------------------+
+		| named-bone resolution |
+		+----------------------*/
+
+		/**
+		 * Returns the index of a named bone in the layout of the frame's
+		 * indexed bones, or -1 if the frame has no layout or the layout
+		 * doesn't have the bone.
+		 */
+		inline int FindIndexedBone(const Frame &frame, const std::string &name)
+		{
+			return frame.indexedBones.layout ?
+				frame.indexedBones.layout->Find(name) : -1;
+		}
+
+		template <typename T>
+			inline void Merge(BoneFrame::Channel<T> &dest, std::size_t index, const Frame::Channel<T> &src)
+		{
+			if (src) dest.Set(index, *src);
+		}
+
+		template <typename T>
+			inline void Blend(BoneFrame::Channel<T> &dest, std::size_t index, const Frame::Channel<T> &src, float alpha)
+		{
+			if (src)
+				dest.Set(index, dest.Has(index) ?
+					math::LinearInterp(dest.values[index], *src, alpha) :
+					*src);
+		}
+
+		/**
+		 * Returns the bone channels of a frame indexed by the specified
+		 * layout, including its named bones.
+		 */
+		BoneFrame ResolveBones(const Frame &frame, const std::shared_ptr<const BoneLayout> &layout)
+		{
+			BoneFrame bones;
+			bones.Bind(layout);
+			bones += frame.indexedBones;
+			for (const auto &kv : frame.bones)
+			{
+				int index = layout->Find(kv.first);
+				if (index == -1) continue;
+				Merge(bones.position,    index, kv.second.position);
+				Merge(bones.orientation, index, kv.second.orientation);
+				Merge(bones.scale,       index, kv.second.scale);
+			}
+			return bones;
+		}
 	}
 
 	/*-----------+
@@ -109,8 +161,18 @@ namespace page { namespace phys
 		if (b.volume)        a.volume        = b.volume;
 
 		// bones
+		a.indexedBones += b.indexedBones;
 		for (const auto &kv : b.bones)
 		{
+			int index = FindIndexedBone(a, kv.first);
+			if (index != -1)
+			{
+				Merge(a.indexedBones.position,    index, kv.second.position);
+				Merge(a.indexedBones.orientation, index, kv.second.orientation);
+				Merge(a.indexedBones.scale,       index, kv.second.scale);
+				continue;
+			}
+
 			auto iter(a.bones.find(kv.first));
 			if (iter != a.bones.end())
 			{
@@ -191,8 +253,18 @@ namespace page { namespace phys
 		Blend(dest.volume,        src.volume,        alpha);
 
 		// bones
+		Blend(dest.indexedBones, src.indexedBones, alpha);
 		for (const auto &kv : src.bones)
 		{
+			int index = FindIndexedBone(dest, kv.first);
+			if (index != -1)
+			{
+				Blend(dest.indexedBones.position,    index, kv.second.position,    alpha);
+				Blend(dest.indexedBones.orientation, index, kv.second.orientation, alpha);
+				Blend(dest.indexedBones.scale,       index, kv.second.scale,       alpha);
+				continue;
+			}
+
 			auto iter(dest.bones.find(kv.first));
 			if (iter != dest.bones.end())
 			{
@@ -271,20 +343,35 @@ namespace page { namespace phys
 		Mask(dest.volume,        mask.volume);
 
 		// bones
+		if (dest.indexedBones.layout)
+			Mask(dest.indexedBones, mask.bones.empty() ?
+				mask.indexedBones :
+				ResolveBones(mask, dest.indexedBones.layout));
 		for (auto destIter(dest.bones.begin()); destIter != dest.bones.end();)
 		{
+			auto &destBone(destIter->second);
 			auto maskIter(mask.bones.find(destIter->first));
 			if (maskIter == mask.bones.end())
 			{
-				destIter = dest.bones.erase(destIter);
-				continue;
+				int index = FindIndexedBone(mask, destIter->first);
+				if (index == -1)
+				{
+					destIter = dest.bones.erase(destIter);
+					continue;
+				}
+
+				const auto &maskBones(mask.indexedBones);
+				if (!maskBones.position.Has(index))    destBone.position.reset();
+				if (!maskBones.orientation.Has(index)) destBone.orientation.reset();
+				if (!maskBones.scale.Has(index))       destBone.scale.reset();
+			}
+			else
+			{
+				const auto &maskBone(maskIter->second);
+				Mask(destBone.position,    maskBone.position);
+				Mask(destBone.orientation, maskBone.orientation);
+				Mask(destBone.scale,       maskBone.scale);
 			}
-
-			auto &destBone(destIter->second);
-			const auto &maskBone(maskIter->second);
-			Mask(destBone.position,    maskBone.position);
-			Mask(destBone.orientation, maskBone.orientation);
-			Mask(destBone.scale,       maskBone.scale);
 
 			++destIter;
 		}
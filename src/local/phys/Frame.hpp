@@ -36,6 +36,7 @@
 #	include "../math/Color.hpp" // RgbColor
 #	include "../math/Quat.hpp"
 #	include "../math/Vector.hpp"
+#	include "BoneFrame.hpp"
 
 namespace page { namespace phys
 {
@@ -98,6 +99,18 @@ namespace page { namespace phys
 		| bone channels |
 		+--------------*/
 
+		/**
+		 * The bone channels, indexed by the layout of the controlled pose.
+		 * This is how poses and animations exchange bones.
+		 */
+		BoneFrame indexedBones;
+
+		/**
+		 * Bone channels referred to by name, for controllers that only touch
+		 * a few bones and don't bind to the pose.  When a frame with named
+		 * bones is merged into or blended with a frame that has a bone
+		 * layout, they are resolved into the indexed channels.
+		 */
 		struct Bone
 		{
 			Channel<math::Vec3>   position;
@@ -0,0 +1,237 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // max, min
+#include <cassert>
+#include <cmath> // lround
+
+#if defined(__SSE__)
+#	include <xmmintrin.h>
+#endif
+
+#include "ParticlePool.hpp"
+
+namespace page { namespace phys
+{
+	namespace
+	{
+		/**
+		 * Moves the last element of @a v into the slot at @a index.
+		 */
+		inline void SwapRemove(std::vector<float> &v, std::size_t index)
+		{
+			v[index] = v.back();
+			v.pop_back();
+		}
+
+		/**
+		 * Quantizes a colour component to eight bits.
+		 */
+		inline std::uint8_t Quantize(float x)
+		{
+			return std::lround(std::min(std::max(x, 0.f), 1.f) * 255);
+		}
+
+		/**
+		 * Integrates the particles in the range [@a first, @a last).
+		 */
+		void Integrate(ParticlePool &pool, std::size_t first, std::size_t last,
+			float deltaTime, const math::Vec3 &acceleration, float damping)
+		{
+			float
+				*__restrict__ x  = pool.co.x.data(),
+				*__restrict__ y  = pool.co.y.data(),
+				*__restrict__ z  = pool.co.z.data(),
+				*__restrict__ vx = pool.velocity.x.data(),
+				*__restrict__ vy = pool.velocity.y.data(),
+				*__restrict__ vz = pool.velocity.z.data(),
+				*__restrict__ age = pool.age.data();
+			math::Vec3 dv(acceleration * deltaTime);
+			for (std::size_t i = first; i < last; ++i)
+			{
+				vx[i] = vx[i] * damping + dv.x;
+				vy[i] = vy[i] * damping + dv.y;
+				vz[i] = vz[i] * damping + dv.z;
+				x[i] += vx[i] * deltaTime;
+				y[i] += vy[i] * deltaTime;
+				z[i] += vz[i] * deltaTime;
+				age[i] += deltaTime;
+			}
+		}
+
+#if defined(__SSE__)
+		/**
+		 * Integrates four particles at a time, leaving any remainder for the
+		 * scalar loop.  Returns the number of particles integrated.
+		 */
+		std::size_t IntegrateSse(ParticlePool &pool,
+			float deltaTime, const math::Vec3 &acceleration, float damping)
+		{
+			float
+				*x  = pool.co.x.data(),
+				*y  = pool.co.y.data(),
+				*z  = pool.co.z.data(),
+				*vx = pool.velocity.x.data(),
+				*vy = pool.velocity.y.data(),
+				*vz = pool.velocity.z.data(),
+				*age = pool.age.data();
+			const __m128
+				dt   = _mm_set1_ps(deltaTime),
+				damp = _mm_set1_ps(damping),
+				dvx  = _mm_set1_ps(acceleration.x * deltaTime),
+				dvy  = _mm_set1_ps(acceleration.y * deltaTime),
+				dvz  = _mm_set1_ps(acceleration.z * deltaTime);
+			std::size_t size = pool.GetSize() & ~std::size_t(3);
+			for (std::size_t i = 0; i < size; i += 4)
+			{
+				__m128
+					vx4 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vx + i), damp), dvx),
+					vy4 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), damp), dvy),
+					vz4 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vz + i), damp), dvz);
+				_mm_storeu_ps(vx + i, vx4);
+				_mm_storeu_ps(vy + i, vy4);
+				_mm_storeu_ps(vz + i, vz4);
+				_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(vx4, dt)));
+				_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(vy4, dt)));
+				_mm_storeu_ps(z + i, _mm_add_ps(_mm_loadu_ps(z + i), _mm_mul_ps(vz4, dt)));
+				_mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), dt));
+			}
+			return size;
+		}
+#endif
+	}
+
+	/*-------------+
+	| ParticlePool |
+	+-------------*/
+
+	std::size_t ParticlePool::GetSize() const
+	{
+		return age.size();
+	}
+
+	void ParticlePool::Reserve(std::size_t size)
+	{
+		for (auto stream : {
+			&co.x, &co.y, &co.z,
+			&velocity.x, &velocity.y, &velocity.z,
+			&age, &lifetime, &this->size,
+			&color.r, &color.g, &color.b, &color.a})
+			stream->reserve(size);
+	}
+
+	void ParticlePool::Push(
+		const math::Vec3 &co,
+		const math::Vec3 &velocity,
+		float lifetime,
+		float size,
+		const math::RgbaColor<> &color)
+	{
+		this->co.x.push_back(co.x);
+		this->co.y.push_back(co.y);
+		this->co.z.push_back(co.z);
+		this->velocity.x.push_back(velocity.x);
+		this->velocity.y.push_back(velocity.y);
+		this->velocity.z.push_back(velocity.z);
+		this->age.push_back(0);
+		this->lifetime.push_back(lifetime);
+		this->size.push_back(size);
+		this->color.r.push_back(color.r);
+		this->color.g.push_back(color.g);
+		this->color.b.push_back(color.b);
+		this->color.a.push_back(color.a);
+	}
+
+	void ParticlePool::Remove(std::size_t index)
+	{
+		assert(index < GetSize());
+		for (auto stream : {
+			&co.x, &co.y, &co.z,
+			&velocity.x, &velocity.y, &velocity.z,
+			&age, &lifetime, &size,
+			&color.r, &color.g, &color.b, &color.a})
+			SwapRemove(*stream, index);
+	}
+
+	void ParticlePool::Clear()
+	{
+		for (auto stream : {
+			&co.x, &co.y, &co.z,
+			&velocity.x, &velocity.y, &velocity.z,
+			&age, &lifetime, &size,
+			&color.r, &color.g, &color.b, &color.a})
+			stream->clear();
+	}
+
+	/*-------+
+	| update |
+	+-------*/
+
+	void Update(ParticlePool &pool, float deltaTime, const math::Vec3 &acceleration, float drag)
+	{
+		float damping = std::max(1 - drag * deltaTime, 0.f);
+
+		// integrate
+		std::size_t first = 0;
+#if defined(__SSE__)
+		first = IntegrateSse(pool, deltaTime, acceleration, damping);
+#endif
+		Integrate(pool, first, pool.GetSize(), deltaTime, acceleration, damping);
+
+		// remove dead particles
+		// NOTE: the particle that is moved into the slot of a dead particle
+		// has to be tested before moving on
+		for (std::size_t i = 0; i < pool.GetSize();)
+		{
+			if (pool.age[i] >= pool.lifetime[i]) pool.Remove(i);
+			else ++i;
+		}
+	}
+
+	/*----------------+
+	| instance stream |
+	+----------------*/
+
+	void GetInstances(const ParticlePool &pool, std::vector<ParticleInstance> &instances)
+	{
+		std::size_t first = instances.size();
+		instances.resize(first + pool.GetSize());
+		ParticleInstance *instance = instances.data() + first;
+		for (std::size_t i = 0; i < pool.GetSize(); ++i, ++instance)
+		{
+			instance->co[0] = pool.co.x[i];
+			instance->co[1] = pool.co.y[i];
+			instance->co[2] = pool.co.z[i];
+			instance->size  = pool.size[i];
+			instance->color[0] = Quantize(pool.color.r[i]);
+			instance->color[1] = Quantize(pool.color.g[i]);
+			instance->color[2] = Quantize(pool.color.b[i]);
+			instance->color[3] = Quantize(pool.color.a[i] *
+				(1 - pool.age[i] / pool.lifetime[i]));
+		}
+	}
+}}
@@ -0,0 +1,138 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_phys_ParticlePool_hpp
+#   define page_local_phys_ParticlePool_hpp
+
+#	include <cstddef> // size_t
+#	include <cstdint> // uint8_t
+#	include <vector>
+
+#	include "../math/Color.hpp" // RgbaColor
+#	include "../math/Vector.hpp"
+
+namespace page { namespace phys
+{
+	/**
+	 * The live particles of an emitter, stored as structure-of-arrays
+	 * streams so that they can be integrated without touching any state
+	 * that the integration doesn't need.
+	 *
+	 * The particles are kept packed at the front of the streams.  A dead
+	 * particle is removed by moving the last particle into its slot, so the
+	 * order of the particles is not preserved.
+	 */
+	struct ParticlePool
+	{
+		/**
+		 * Returns the number of live particles.
+		 */
+		std::size_t GetSize() const;
+
+		/**
+		 * Reserves space for @a size particles, so that spawning doesn't
+		 * reallocate the streams until the pool grows beyond it.
+		 */
+		void Reserve(std::size_t size);
+
+		/**
+		 * Adds a particle to the end of the pool.
+		 */
+		void Push(
+			const math::Vec3 &co,
+			const math::Vec3 &velocity,
+			float lifetime,
+			float size,
+			const math::RgbaColor<> &);
+
+		/**
+		 * Removes the particle at @a index by moving the last particle into
+		 * its slot.
+		 */
+		void Remove(std::size_t index);
+
+		/**
+		 * Removes all of the particles.
+		 */
+		void Clear();
+
+		/**
+		 * A structure-of-arrays stream of vectors.
+		 */
+		struct Stream
+		{
+			std::vector<float> x, y, z;
+		};
+		Stream co, velocity;
+
+		/**
+		 * The time that each particle has been alive, and the time at which
+		 * it dies, measured in seconds.
+		 */
+		std::vector<float> age, lifetime;
+
+		/**
+		 * The size of each particle.
+		 */
+		std::vector<float> size;
+
+		/**
+		 * A structure-of-arrays stream of colours.
+		 */
+		struct ColorStream
+		{
+			std::vector<float> r, g, b, a;
+		};
+		ColorStream color;
+	};
+
+	/**
+	 * A particle packed for the renderer, which draws it as a point sprite.
+	 */
+	struct ParticleInstance
+	{
+		float co[3];
+		float size;
+		std::uint8_t color[4];
+	};
+
+	/**
+	 * Integrates the particles over @a deltaTime seconds under a constant
+	 * @a acceleration, with linear @a drag, and removes the particles that
+	 * have outlived their lifetime.
+	 */
+	void Update(ParticlePool &, float deltaTime,
+		const math::Vec3 &acceleration = 0, float drag = 0);
+
+	/**
+	 * Appends the particles to a packed instance stream.  The opacity of
+	 * each particle falls off linearly over its lifetime.
+	 */
+	void GetInstances(const ParticlePool &, std::vector<ParticleInstance> &);
+}}
+
+#endif
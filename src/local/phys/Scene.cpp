@@ -25,14 +25,18 @@
  * of this software.
  */
 
-#include <algorithm> // remove
+#include <algorithm> // remove{,_if}
 #include <cassert>
+#include <chrono> // steady_clock
 
 #include <boost/iterator/indirect_iterator.hpp>
 #include <boost/range/adaptor/indirected.hpp>
 
+#include "../math/Aabb.hpp"
 #include "../math/Euler.hpp"
 #include "../math/float.hpp" // DegToRad
+#include "../math/Frustum.hpp"
+#include "../math/intersect.hpp" // SphereFrustumIntersect
 #include "../math/Plane.hpp"
 #include "../math/Quat.hpp"
 #include "../math/Vector.hpp"
@@ -44,6 +48,7 @@
 #include "controller/FollowController.hpp"
 #include "controller/HeroCamController.hpp"
 #include "mixin/Controllable.hpp" // UpdateControllables
+#include "mixin/Transformable.hpp" // Transformable::{BakeAllTransforms,GetTransformVersion}
 #include "mixin/Trackable.hpp" // Trackable::{GetTrackFaceIndex,HasTrackFace}
 #include "mixin/update/Collidable.hpp" // UpdateCollidables
 #include "mixin/update/Trackable.hpp" // UpdateTrackables
@@ -66,6 +71,28 @@ namespace page { namespace phys
 		{
 			controllable.ApplyControllers(0);
 		}
+
+		// add a node to a view if it has the right type
+		template <typename T> void Categorize(std::vector<T *> &view, Node &node)
+		{
+			if (auto value = dynamic_cast<T *>(&node))
+				view.push_back(value);
+		}
+
+		// remove a node from a view if it has the right type
+		template <typename T> void Uncategorize(std::vector<T *> &view, Node &node)
+		{
+			if (auto value = dynamic_cast<T *>(&node))
+				view.erase(std::remove(view.begin(), view.end(), value), view.end());
+		}
+
+		// insert or refit a value in a spatial index
+		template <typename T> void Index(Bvh<T> &index, T &value, const math::Aabb<3> &aabb)
+		{
+			if (index.Contains(&value))
+				index.Update(&value, aabb);
+			else index.Insert(&value, aabb);
+		}
 	}
 
 	/*-------------+
@@ -85,20 +112,82 @@ namespace page { namespace phys
 	void Scene::Insert(const std::shared_ptr<Node> &node)
 	{
 		assert(node);
-		// FIXME: implement
-		if (auto trackable = dynamic_cast<Trackable *>(node.get()))
-			trackables.push_back(trackable);
+		nodes.push_back(node);
+
+		// views
+		Categorize(bodies,         *node);
+		Categorize(cameras,        *node);
+		Categorize(collidables,    *node);
+		Categorize(controllables,  *node);
+		Categorize(emitters,       *node);
+		Categorize(forms,          *node);
+		Categorize(lights,         *node);
+		Categorize(particles,      *node);
+		Categorize(sounds,         *node);
+		Categorize(trackables,     *node);
+		Categorize(transformables, *node);
+
+		// the node may have been positioned after it was constructed, so
+		// it shouldn't be interpolated from where it started
 		if (auto transformable = dynamic_cast<Transformable *>(node.get()))
-			transformables.push_back(transformable);
+			transformable->BakeAllTransforms();
+
+		// spatial index
+		IndexedNode indexedNode =
+		{
+			node.get(),
+			dynamic_cast<const Transformable *>(node.get()),
+			dynamic_cast<const Form *>(node.get())
+		};
+		if (indexedNode.transformable)
+			indexedNode.transformVersion = indexedNode.transformable->GetTransformVersion();
+		if (indexedNode.form)
+		{
+			indexedNode.poseVersion = indexedNode.form->GetPoseVersion();
+			if (indexedNode.form->GetModel())
+				formAabbs.insert(std::make_pair(indexedNode.form, cache::AabbProxy(*indexedNode.form)));
+		}
+		indexedNodes.push_back(indexedNode);
+		UpdateSpatialIndex(*node);
 	}
 
 	void Scene::Remove(const std::shared_ptr<Node> &node)
 	{
 		assert(node);
-		// FIXME: implement
-		/*transformables.erase(
-			std::remove(transformables.begin(), transformables.end(), transformable),
-			transformables.end());*/
+
+		// spatial index
+		indexedNodes.erase(
+			std::remove_if(indexedNodes.begin(), indexedNodes.end(),
+				[&node](const IndexedNode &indexedNode) { return indexedNode.node == node.get(); }),
+			indexedNodes.end());
+		if (auto collidable = dynamic_cast<Collidable *>(node.get()))
+			collidableIndex.Remove(collidable);
+		if (auto form = dynamic_cast<Form *>(node.get()))
+		{
+			formIndex.Remove(form);
+			formAabbs.erase(form);
+		}
+		if (auto light = dynamic_cast<Light *>(node.get()))
+			lightIndex.Remove(light);
+		if (auto particle = dynamic_cast<Particle *>(node.get()))
+			particleIndex.Remove(particle);
+		if (auto sound = dynamic_cast<Sound *>(node.get()))
+			soundIndex.Remove(sound);
+
+		// views
+		Uncategorize(transformables, *node);
+		Uncategorize(trackables,     *node);
+		Uncategorize(sounds,         *node);
+		Uncategorize(particles,      *node);
+		Uncategorize(lights,         *node);
+		Uncategorize(forms,          *node);
+		Uncategorize(emitters,       *node);
+		Uncategorize(controllables,  *node);
+		Uncategorize(collidables,    *node);
+		Uncategorize(cameras,        *node);
+		Uncategorize(bodies,         *node);
+
+		nodes.erase(std::remove(nodes.begin(), nodes.end(), node), nodes.end());
 	}
 
 	void Scene::Clear()
@@ -109,6 +198,15 @@ namespace page { namespace phys
 		cameraSet.reset();
 		track.reset();
 
+		// spatial index
+		indexedNodes.clear();
+		formAabbs.clear();
+		soundIndex.Clear();
+		particleIndex.Clear();
+		lightIndex.Clear();
+		formIndex.Clear();
+		collidableIndex.Clear();
+
 		// objects
 		transformables.clear();
 		trackables.clear();
@@ -121,12 +219,17 @@ namespace page { namespace phys
 		collidables.clear();
 		cameras.clear();
 		bodies.clear();
+		nodes.clear();
 	}
 
 	void Scene::Reset(const res::Scene &scene)
 	{
 		Clear();
 
+		// interpolation
+		// NOTE: the new nodes have no previous tick to blend from
+		tickInterpolation = 1;
+
 		// forms
 		for (const auto &form : scene.forms)
 			Insert(std::shared_ptr<Form>(new Form(form)));
@@ -162,10 +265,11 @@ namespace page { namespace phys
 	util::reference_vector<Body> Scene::GetVisibleBodies(const math::ViewFrustum<> &frustum) const
 	{
 		util::reference_vector<Body> view;
-		view.reserve(bodies.size());
-		// FIXME: should only copy visible bodies
-		for (auto &body : boost::adaptors::indirect(bodies))
-			view.push_back(body);
+		formIndex.Query(GetFrustum(frustum), [&view](Form &form)
+		{
+			if (auto body = dynamic_cast<Body *>(&form))
+				view.push_back(*body);
+		});
 		return view;
 	}
 
@@ -190,10 +294,10 @@ namespace page { namespace phys
 	util::reference_vector<Collidable> Scene::GetVisibleCollidableNodes(const math::ViewFrustum<> &frustum) const
 	{
 		util::reference_vector<Collidable> view;
-		view.reserve(collidables.size());
-		// FIXME: should only copy visible collidables
-		for (auto &collidable : boost::adaptors::indirect(collidables))
+		collidableIndex.Query(GetFrustum(frustum), [&view](Collidable &collidable)
+		{
 			view.push_back(collidable);
+		});
 		return view;
 	}
 
@@ -209,17 +313,21 @@ namespace page { namespace phys
 	util::reference_vector<Form> Scene::GetVisibleForms(const math::ViewFrustum<> &frustum) const
 	{
 		util::reference_vector<Form> view;
-		view.reserve(forms.size());
-		// FIXME: should only copy visible forms
-		for (auto &form : boost::adaptors::indirect(forms))
+		formIndex.Query(GetFrustum(frustum), [&view](Form &form)
+		{
 			view.push_back(form);
+		});
 		return view;
 	}
 
 	Scene::FormsByMaterialView Scene::GetVisibleFormsByMaterial(const math::ViewFrustum<> &frustum) const
 	{
 		FormsByMaterialView view;
-		// FIXME: implement
+		formIndex.Query(GetFrustum(frustum), [&view](const Form &form)
+		{
+			for (const auto &part : form.GetParts())
+				view.insert(std::make_pair(part.GetMaterial(), &part));
+		});
 		return view;
 	}
 
@@ -235,10 +343,13 @@ namespace page { namespace phys
 	util::reference_vector<Light> Scene::GetInfluentialLights(const math::ViewFrustum<> &frustum) const
 	{
 		util::reference_vector<Light> view;
-		view.reserve(lights.size());
-		// FIXME: should only copy influential lights
-		for (auto &light : boost::adaptors::indirect(lights))
-			view.push_back(light);
+		math::Frustum<> planes(GetFrustum(frustum));
+		lightIndex.Query(planes, [&view, &planes](Light &light)
+		{
+			// the box is only an approximation of the sphere of influence
+			if (SphereFrustumIntersect(light.GetPosition(), light.GetMaxRange(), planes))
+				view.push_back(light);
+		});
 		return view;
 	}
 
@@ -254,10 +365,10 @@ namespace page { namespace phys
 	util::reference_vector<Particle> Scene::GetVisibleParticles(const math::ViewFrustum<> &frustum) const
 	{
 		util::reference_vector<Particle> view;
-		view.reserve(particles.size());
-		// FIXME: should only copy visible particles
-		for (auto &particle : boost::adaptors::indirect(particles))
+		particleIndex.Query(GetFrustum(frustum), [&view](Particle &particle)
+		{
 			view.push_back(particle);
+		});
 		return view;
 	}
 
@@ -274,7 +385,8 @@ namespace page { namespace phys
 	{
 		util::reference_vector<Sound> view;
 		view.reserve(n);
-		// FIXME: find n closest sounds
+		for (auto sound : soundIndex.QueryNearest(co, n))
+			view.push_back(*sound);
 		return view;
 	}
 
@@ -367,28 +479,77 @@ namespace page { namespace phys
 		return *track;
 	}
 
+	/*--------------+
+	| interpolation |
+	+--------------*/
+
+	float Scene::GetTickInterpolation() const
+	{
+		return tickInterpolation;
+	}
+
+	void Scene::SetTickInterpolation(float tickInterpolation)
+	{
+		this->tickInterpolation = tickInterpolation;
+	}
+
 	/*-------+
 	| update |
 	+-------*/
 
-	void Scene::Update(float deltaTime)
+	void Scene::Update(float deltaTime, UpdateTimes *times)
 	{
+		// adds the time since the end of the last phase to the given phase
+		typedef std::chrono::steady_clock Clock;
+		Clock::time_point lap;
+		if (times) lap = Clock::now();
+		auto Lap([&](double UpdateTimes::*phase)
+		{
+			if (times)
+			{
+				auto now(Clock::now());
+				times->*phase += std::chrono::duration<double>(now - lap).count();
+				lap = now;
+			}
+		});
+
+		UpdateTickTransforms();
+		Lap(&UpdateTimes::deltas);
 		UpdateControllables(AnimationLayer::preCollision, deltaTime);
+		Lap(&UpdateTimes::controllables);
 		UpdateForces();
+		Lap(&UpdateTimes::forces);
 		UpdateCollidables(
 			boost::make_indirect_iterator(collidables.begin()),
 			boost::make_indirect_iterator(collidables.end()));
+		Lap(&UpdateTimes::collision);
 		UpdateTrackables(
 			boost::make_indirect_iterator(trackables.begin()),
 			boost::make_indirect_iterator(trackables.end()));
+		Lap(&UpdateTimes::trackables);
 		UpdateDeltas();
+		Lap(&UpdateTimes::deltas);
 		UpdateControllables(AnimationLayer::postCollision, deltaTime);
 		// FIXME: update constraints
 		UpdateControllables(AnimationLayer::postConstraint, deltaTime);
+		Lap(&UpdateTimes::controllables);
 		UpdateCameraTracking();
+		Lap(&UpdateTimes::cameraTracking);
 		UpdateObjects(deltaTime);
+		Lap(&UpdateTimes::objects);
+		UpdateSpatialIndex();
 		// update focus
 		if (focus.target) focus.position = focus.target->GetPosition();
+		Lap(&UpdateTimes::spatialIndex);
+	}
+
+	void Scene::UpdateTickTransforms()
+	{
+		for (Transformables::iterator iter(transformables.begin()); iter != transformables.end(); ++iter)
+		{
+			Transformable &transformable(**iter);
+			transformable.BakeTickTransform();
+		}
 	}
 
 	void Scene::UpdateControllables(AnimationLayer layer, float deltaTime)
@@ -516,5 +677,52 @@ namespace page { namespace phys
 			Sound &sound(**iter);
 			sound.Update(deltaTime);
 		}
+		// update emitters
+		for (auto &emitter : boost::adaptors::indirect(emitters))
+			emitter.Update(deltaTime);
+	}
+
+	/*--------------+
+	| spatial index |
+	+--------------*/
+
+	void Scene::UpdateSpatialIndex()
+	{
+		for (auto &indexedNode : indexedNodes)
+		{
+			unsigned
+				transformVersion = indexedNode.transformable ? indexedNode.transformable->GetTransformVersion() : 0,
+				poseVersion      = indexedNode.form          ? indexedNode.form->GetPoseVersion()               : 0;
+			if (transformVersion != indexedNode.transformVersion ||
+				poseVersion      != indexedNode.poseVersion)
+			{
+				indexedNode.transformVersion = transformVersion;
+				indexedNode.poseVersion      = poseVersion;
+				UpdateSpatialIndex(*indexedNode.node);
+			}
+		}
+	}
+
+	void Scene::UpdateSpatialIndex(Node &node)
+	{
+		if (auto collidable = dynamic_cast<Collidable *>(&node))
+			Index(collidableIndex, *collidable,
+				Grow(math::Aabb<3>(collidable->GetPosition()), collidable->GetRadius()));
+		if (auto form = dynamic_cast<Form *>(&node))
+		{
+			// forms without a model have no bounds, so the index will treat
+			// them as always visible
+			auto aabb(formAabbs.find(form));
+			Index(formIndex, *form, aabb != formAabbs.end() ?
+				*aabb->second : math::InverseInfiniteAabb<3>());
+		}
+		if (auto light = dynamic_cast<Light *>(&node))
+			Index(lightIndex, *light,
+				Grow(math::Aabb<3>(light->GetPosition()), light->GetMaxRange()));
+		if (auto particle = dynamic_cast<Particle *>(&node))
+			Index(particleIndex, *particle,
+				Grow(math::Aabb<3>(particle->GetPosition()), particle->GetSize()));
+		if (auto sound = dynamic_cast<Sound *>(&node))
+			Index(soundIndex, *sound, math::Aabb<3>(sound->GetPosition()));
 	}
 }}
@@ -30,13 +30,15 @@
 
 #	include <functional> // unary_function
 #	include <memory> // shared_ptr
-#	include <unordered_map> // unordered_multimap
+#	include <unordered_map> // unordered_{,multi}map
 #	include <vector>
 
+#	include "../cache/proxy/AabbProxy.hpp"
 #	include "../cache/proxy/Proxy.hpp"
 #	include "../math/fwd.hpp" // Vector, ViewFrustum
 #	include "../res/type/CameraSet.hpp" // CameraSet::Cameras
 #	include "../util/container/reference_vector.hpp"
+#	include "Bvh.hpp"
 #	include "node/Form.hpp" // Form::Part
 
 namespace page
@@ -244,20 +246,70 @@ namespace page { namespace phys
 		bool HasTrack() const;
 		const res::Track &GetTrack() const;
 
+		/*--------------+
+		| interpolation |
+		+--------------*/
+
+		/**
+		 * Returns the fraction of a simulation tick that has passed since
+		 * the last update, which is used to blend the transformations from
+		 * the last two ticks when rendering.
+		 */
+		float GetTickInterpolation() const;
+		void SetTickInterpolation(float);
+
 		/*-------+
 		| update |
 		+-------*/
 
 		public:
-		void Update(float deltaTime);
+		/**
+		 * The time spent in each phase of an update, in seconds, which can
+		 * be accumulated over many updates for profiling.
+		 */
+		struct UpdateTimes
+		{
+			double controllables  = 0;
+			double forces         = 0;
+			double collision      = 0;
+			double trackables     = 0;
+			double deltas         = 0;
+			double cameraTracking = 0;
+			double objects        = 0;
+			double spatialIndex   = 0;
+		};
+
+		/**
+		 * Advances the simulation by one tick.
+		 *
+		 * @param[in,out] times If not null, the time spent in each phase of
+		 *                the update is added to it.
+		 */
+		void Update(float deltaTime, UpdateTimes *times = nullptr);
 
 		private:
+		void UpdateTickTransforms();
 		void UpdateControllables(AnimationLayer, float deltaTime);
 		void UpdateForces();
 		void UpdateDeltas();
 		void UpdateCameraTracking();
 		void UpdateObjects(float deltaTime);
 
+		/*--------------+
+		| spatial index |
+		+--------------*/
+
+		/**
+		 * Refits the nodes that have moved since the last update, which are
+		 * found by polling the versions of their transformations and poses.
+		 */
+		void UpdateSpatialIndex();
+
+		/**
+		 * Inserts or refits a node in the spatial indices for its types.
+		 */
+		void UpdateSpatialIndex(Node &);
+
 		/*-------------+
 		| data members |
 		+-------------*/
@@ -276,6 +328,28 @@ namespace page { namespace phys
 		std::vector<Trackable *> trackables;
 		std::vector<Transformable *> transformables;
 
+		// spatial indices
+		Bvh<Collidable> collidableIndex;
+		Bvh<Form> formIndex;
+		Bvh<Light> lightIndex;
+		Bvh<Particle> particleIndex;
+		Bvh<Sound> soundIndex;
+		std::unordered_map<const Form *, cache::AabbProxy> formAabbs;
+
+		/**
+		 * A node in the spatial indices, with the versions of its
+		 * transformation and pose from when it was last indexed.
+		 */
+		struct IndexedNode
+		{
+			Node *node;
+			const Transformable *transformable;
+			const Form *form;
+			unsigned transformVersion;
+			unsigned poseVersion;
+		};
+		std::vector<IndexedNode> indexedNodes;
+
 		// attributes
 		std::shared_ptr<const res::Track> track;
 		std::shared_ptr<const res::CameraSet> cameraSet;
@@ -293,6 +367,9 @@ namespace page { namespace phys
 
 		// atmospherics
 		math::Vec3 sunDirection;
+
+		// interpolation
+		float tickInterpolation = 1;
 	};
 }}
 
@@ -25,57 +25,381 @@
  * of this software.
  */
 
+#include <algorithm> // copy, min, partial_sort
+#include <cassert>
+#include <cmath> // abs, lround
+
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+#	include <immintrin.h>
+#elif defined(__SSE__)
+#	include <xmmintrin.h>
+#endif
+
+#include "../cfg/vars.hpp"
 #include "../res/type/Mesh.hpp"
+#include "../util/thread/WorkerPool.hpp"
 #include "Skin.hpp"
 
 namespace page { namespace phys
 {
-	// construct
-	Skin::Skin(const res::Mesh &mesh, const attrib::Pose &pose)
+	namespace
 	{
-		// copy vertices
-		vertices.reserve(mesh.vertices.size());
-		for (res::Mesh::Vertices::const_iterator meshVertex(mesh.vertices.begin()); meshVertex != mesh.vertices.end(); ++meshVertex)
+		/**
+		 * The number of vertices that each skinning job handles when a mesh
+		 * is split between threads.
+		 */
+		const std::size_t verticesPerJob = 2048;
+
+		/**
+		 * The amount by which the sum of a vertex's weights can differ from
+		 * one before they are renormalized, which is less than the smallest
+		 * quantized weight.
+		 */
+		const float weightTolerance = .5f / Skin::weightScale;
+
+		/**
+		 * The threads for skinning large meshes, which are created the first
+		 * time that they are needed.
+		 */
+		util::WorkerPool &GetWorkerPool()
+		{
+			static util::WorkerPool workers(*CVAR(skinThreads));
+			return workers;
+		}
+
+		/**
+		 * An entry in the matrix palette, holding the columns of a skinning
+		 * matrix followed by the columns of its normalized counterpart.  The
+		 * columns are padded to four components so that they can be blended
+		 * with vector instructions.
+		 */
+		struct PaletteEntry
+		{
+			float columns[7][4];
+		};
+
+		void BuildPalette(const Skin &skin, std::vector<PaletteEntry> &palette)
 		{
-			Vertex vertex =
+			palette.resize(skin.bones.size());
+			for (std::size_t i = 0; i < skin.bones.size(); ++i)
 			{
-				meshVertex->co,
-				meshVertex->no
-			};
-			// copy influences
-			vertex.influences.reserve(meshVertex->influences.size());
-			for (res::Mesh::Vertex::Influences::const_iterator meshInfluence(meshVertex->influences.begin()); meshInfluence != meshVertex->influences.end(); ++meshInfluence)
+				PaletteEntry &entry(palette[i]);
+				std::fill(&entry.columns[0][0], &entry.columns[0][0] + 7 * 4, 0.f);
+				if (const attrib::Pose::Bone *bone = skin.bones[i])
+				{
+					const math::Mat34 &matrix(bone->GetSkinMatrix());
+					const math::Mat3 &normMatrix(bone->GetNormSkinMatrix());
+					for (unsigned column = 0; column < 4; ++column)
+						for (unsigned row = 0; row < 3; ++row)
+							entry.columns[column][row] = matrix[row][column];
+					for (unsigned column = 0; column < 3; ++column)
+						for (unsigned row = 0; row < 3; ++row)
+							entry.columns[4 + column][row] = normMatrix[row][column];
+				}
+				else
+				{
+					// identity
+					for (unsigned i = 0; i < 3; ++i)
+						entry.columns[i][i] = entry.columns[4 + i][i] = 1;
+				}
+			}
+		}
+
+		/**
+		 * Returns a pointer to the output for a vertex.
+		 */
+		inline float *Advance(float *base, std::size_t index, std::size_t stride)
+		{
+			return reinterpret_cast<float *>(reinterpret_cast<char *>(base) + index * stride);
+		}
+
+#if defined(__SSE__)
+		inline void Store3(float *out, __m128 v)
+		{
+			alignas(16) float t[4];
+			_mm_store_ps(t, v);
+			std::copy(t, t + 3, out);
+		}
+
+		/**
+		 * Skins a single vertex by blending the palette entries of its
+		 * influences and transforming the vertex by the result.
+		 */
+		inline void SkinVertex(const Skin &skin, const PaletteEntry *palette, std::size_t i, float *co, float *no)
+		{
+			const float scale = 1.f / Skin::weightScale;
+			const std::uint16_t
+				*indices = &skin.boneIndices[i * Skin::maxInfluences],
+				*weights = &skin.weights[i * Skin::maxInfluences];
+			__m128 columns[7];
+			for (unsigned k = 0; k < Skin::maxInfluences; ++k)
 			{
-				const attrib::Pose::Bone *bone(pose.GetBone(*meshInfluence->bone));
-				if (bone)
+				const PaletteEntry &entry(palette[indices[k]]);
+				__m128 weight = _mm_set1_ps(weights[k] * scale);
+				for (unsigned j = 0; j < 7; ++j)
 				{
-					Vertex::Influence influence =
-					{
-						bone,
-						meshInfluence->weight
-					};
-					vertex.influences.push_back(influence);
+					__m128 column = _mm_mul_ps(weight, _mm_loadu_ps(entry.columns[j]));
+					columns[j] = k ? _mm_add_ps(columns[j], column) : column;
 				}
 			}
-			vertices.push_back(vertex);
+			Store3(co,
+				_mm_add_ps(
+					_mm_add_ps(
+						_mm_mul_ps(columns[0], _mm_set1_ps(skin.co.x[i])),
+						_mm_mul_ps(columns[1], _mm_set1_ps(skin.co.y[i]))),
+					_mm_add_ps(
+						_mm_mul_ps(columns[2], _mm_set1_ps(skin.co.z[i])),
+						columns[3])));
+			Store3(no,
+				_mm_add_ps(
+					_mm_add_ps(
+						_mm_mul_ps(columns[4], _mm_set1_ps(skin.no.x[i])),
+						_mm_mul_ps(columns[5], _mm_set1_ps(skin.no.y[i]))),
+					_mm_mul_ps(columns[6], _mm_set1_ps(skin.no.z[i]))));
+		}
+#else
+		inline void SkinVertex(const Skin &skin, const PaletteEntry *palette, std::size_t i, float *co, float *no)
+		{
+			const float scale = 1.f / Skin::weightScale;
+			const std::uint16_t
+				*indices = &skin.boneIndices[i * Skin::maxInfluences],
+				*weights = &skin.weights[i * Skin::maxInfluences];
+			float columns[7][4] = {};
+			for (unsigned k = 0; k < Skin::maxInfluences; ++k)
+			{
+				const PaletteEntry &entry(palette[indices[k]]);
+				float weight = weights[k] * scale;
+				for (unsigned j = 0; j < 7; ++j)
+					for (unsigned r = 0; r < 4; ++r)
+						columns[j][r] += entry.columns[j][r] * weight;
+			}
+			for (unsigned r = 0; r < 3; ++r)
+			{
+				co[r] =
+					columns[0][r] * skin.co.x[i] +
+					columns[1][r] * skin.co.y[i] +
+					columns[2][r] * skin.co.z[i] +
+					columns[3][r];
+				no[r] =
+					columns[4][r] * skin.no.x[i] +
+					columns[5][r] * skin.no.y[i] +
+					columns[6][r] * skin.no.z[i];
+			}
+		}
+#endif
+
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+		__attribute__((target("avx")))
+		inline __m256 Combine(__m128 a, __m128 b)
+		{
+			return _mm256_insertf128_ps(_mm256_castps128_ps256(a), b, 1);
+		}
+
+		/**
+		 * Returns a register holding a component of a pair of vertices, with
+		 * one vertex in each half.
+		 */
+		__attribute__((target("avx")))
+		inline __m256 Broadcast(const std::vector<float> &stream, std::size_t i)
+		{
+			return Combine(_mm_set1_ps(stream[i]), _mm_set1_ps(stream[i + 1]));
+		}
+
+		/**
+		 * Skins a pair of vertices, with one vertex in each half of the
+		 * registers.
+		 */
+		__attribute__((target("avx")))
+		inline void SkinVertexPair(const Skin &skin, const PaletteEntry *palette, std::size_t i, float *co0, float *no0, float *co1, float *no1)
+		{
+			const float scale = 1.f / Skin::weightScale;
+			const std::uint16_t
+				*indices = &skin.boneIndices[i * Skin::maxInfluences],
+				*weights = &skin.weights[i * Skin::maxInfluences];
+			__m256 columns[7];
+			for (unsigned k = 0; k < Skin::maxInfluences; ++k)
+			{
+				const PaletteEntry
+					&entry0(palette[indices[k]]),
+					&entry1(palette[indices[k + Skin::maxInfluences]]);
+				__m256 weight = Combine(
+					_mm_set1_ps(weights[k] * scale),
+					_mm_set1_ps(weights[k + Skin::maxInfluences] * scale));
+				for (unsigned j = 0; j < 7; ++j)
+				{
+					__m256 column = _mm256_mul_ps(weight, Combine(
+						_mm_loadu_ps(entry0.columns[j]),
+						_mm_loadu_ps(entry1.columns[j])));
+					columns[j] = k ? _mm256_add_ps(columns[j], column) : column;
+				}
+			}
+			alignas(32) float t[8];
+			_mm256_store_ps(t,
+				_mm256_add_ps(
+					_mm256_add_ps(
+						_mm256_mul_ps(columns[0], Broadcast(skin.co.x, i)),
+						_mm256_mul_ps(columns[1], Broadcast(skin.co.y, i))),
+					_mm256_add_ps(
+						_mm256_mul_ps(columns[2], Broadcast(skin.co.z, i)),
+						columns[3])));
+			std::copy(t,     t + 3, co0);
+			std::copy(t + 4, t + 7, co1);
+			_mm256_store_ps(t,
+				_mm256_add_ps(
+					_mm256_add_ps(
+						_mm256_mul_ps(columns[4], Broadcast(skin.no.x, i)),
+						_mm256_mul_ps(columns[5], Broadcast(skin.no.y, i))),
+					_mm256_mul_ps(columns[6], Broadcast(skin.no.z, i))));
+			std::copy(t,     t + 3, no0);
+			std::copy(t + 4, t + 7, no1);
+		}
+
+		/**
+		 * Skins the vertices in [first, last) in pairs with AVX.
+		 */
+		__attribute__((target("avx")))
+		void SkinRangeAvx(const Skin &skin, const PaletteEntry *palette, std::size_t first, std::size_t last, float *co, float *no, std::size_t stride)
+		{
+			std::size_t i = first;
+			for (; i + 1 < last; i += 2)
+				SkinVertexPair(skin, palette, i,
+					Advance(co, i,     stride), Advance(no, i,     stride),
+					Advance(co, i + 1, stride), Advance(no, i + 1, stride));
+			for (; i < last; ++i)
+				SkinVertex(skin, palette, i,
+					Advance(co, i, stride),
+					Advance(no, i, stride));
+		}
+#endif
+
+		/**
+		 * Skins the vertices in [first, last), using AVX when the processor
+		 * supports it.
+		 */
+		void SkinRange(const Skin &skin, const PaletteEntry *palette, std::size_t first, std::size_t last, float *co, float *no, std::size_t stride)
+		{
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+			static const bool haveAvx = __builtin_cpu_supports("avx");
+			if (haveAvx)
+				return SkinRangeAvx(skin, palette, first, last, co, no, stride);
+#endif
+			for (std::size_t i = first; i < last; ++i)
+				SkinVertex(skin, palette, i,
+					Advance(co, i, stride),
+					Advance(no, i, stride));
 		}
 	}
 
-	// transform vertex
-	void Update(const Skin::Vertex &vertex, math::Vec3 &co, math::Vec3 &no)
+	// construct
+	Skin::Skin(const res::Mesh &mesh, const attrib::Pose &pose) :
+		bones(1, nullptr)
 	{
-		co = no = 0;
-		float weight = 1.f;
-		for (Skin::Vertex::Influences::const_iterator influence(vertex.influences.begin()); influence != vertex.influences.end(); ++influence)
+		// map the mesh's bones to palette indices
+		std::vector<int> paletteIndices;
+		paletteIndices.reserve(mesh.bones.size());
+		for (const auto &name : mesh.bones)
 		{
-			co += influence->bone->GetSkinMatrix() * vertex.co * influence->weight;
-			no += influence->bone->GetNormSkinMatrix() * vertex.no * influence->weight;
-			weight -= influence->weight;
+			const attrib::Pose::Bone *bone(pose.GetBone(name));
+			paletteIndices.push_back(bone ? bones.size() : -1);
+			if (bone) bones.push_back(bone);
 		}
-		if (weight > 0.f)
+
+		// copy vertices
+		std::size_t size = mesh.vertices.size();
+		for (Stream *stream : {&co, &no})
 		{
-			co += vertex.co * weight;
-			no += vertex.no * weight;
+			stream->x.reserve(size);
+			stream->y.reserve(size);
+			stream->z.reserve(size);
+		}
+		boneIndices.reserve(size * maxInfluences);
+		weights.reserve(size * maxInfluences);
+		struct Influence
+		{
+			unsigned index;
+			float weight;
+		};
+		std::vector<Influence> influences;
+		for (const auto &meshVertex : mesh.vertices)
+		{
+			co.x.push_back(meshVertex.co.x);
+			co.y.push_back(meshVertex.co.y);
+			co.z.push_back(meshVertex.co.z);
+			no.x.push_back(meshVertex.no.x);
+			no.y.push_back(meshVertex.no.y);
+			no.z.push_back(meshVertex.no.z);
+
+			// gather influences, giving any unassigned weight to the
+			// identity matrix
+			influences.clear();
+			float total = 0;
+			for (const auto &meshInfluence : meshVertex.influences)
+			{
+				int index = paletteIndices[meshInfluence.bone - mesh.bones.begin()];
+				if (index == -1 || meshInfluence.weight <= 0) continue;
+				influences.push_back({static_cast<unsigned>(index), meshInfluence.weight});
+				total += meshInfluence.weight;
+			}
+			if (total < 1) influences.push_back({0, 1 - total});
+
+			// keep the strongest influences
+			if (influences.size() > maxInfluences)
+			{
+				std::partial_sort(influences.begin(), influences.begin() + maxInfluences, influences.end(),
+					[](const Influence &a, const Influence &b) { return a.weight > b.weight; });
+				influences.resize(maxInfluences);
+			}
+
+			// quantize the weights, renormalizing them if they don't add up
+			// to one, which happens when weak influences were dropped or
+			// when the mesh's weights add up to more than one; the last
+			// weight takes up the rounding error, so that the quantized
+			// weights always add up to exactly one
+			float sum = 0;
+			for (const auto &influence : influences)
+				sum += influence.weight;
+			float scale = weightScale;
+			if (std::abs(sum - 1) > weightTolerance) scale /= sum;
+			unsigned remaining = weightScale;
+			for (unsigned i = 0; i < maxInfluences; ++i)
+			{
+				if (i < influences.size())
+				{
+					unsigned weight = i + 1 == influences.size() ? remaining :
+						std::min<unsigned>(remaining, std::lround(influences[i].weight * scale));
+					boneIndices.push_back(influences[i].index);
+					weights.push_back(weight);
+					remaining -= weight;
+				}
+				else
+				{
+					boneIndices.push_back(0);
+					weights.push_back(0);
+				}
+			}
 		}
+		assert(bones.size() <= 0x10000);
+	}
+
+	std::size_t Skin::GetSize() const
+	{
+		return co.x.size();
+	}
+
+	// update
+	void Update(const Skin &skin, float *co, float *no, std::size_t stride)
+	{
+		// NOTE: the palette is built on the calling thread, since the bones
+		// calculate their matrices lazily and aren't safe to share
+		std::vector<PaletteEntry> palette;
+		BuildPalette(skin, palette);
+
+		auto job([&](std::size_t first, std::size_t last)
+		{
+			SkinRange(skin, palette.data(), first, last, co, no, stride);
+		});
+		if (*CVAR(skinThreads) && skin.GetSize() > verticesPerJob)
+			GetWorkerPool().ParallelFor(skin.GetSize(), verticesPerJob, job);
+		else job(0, skin.GetSize());
 	}
 }}
@@ -28,9 +28,10 @@
 #ifndef    page_local_phys_Skin_hpp
 #   define page_local_phys_Skin_hpp
 
+#	include <cstddef> // size_t
+#	include <cstdint> // uint16_t
 #	include <vector>
 
-#	include "../math/Vector.hpp"
 #	include "attrib/Pose.hpp" // Pose::Bone
 
 namespace page { namespace res { class Mesh; }}
@@ -38,30 +39,66 @@ namespace page { namespace res { class Mesh; }}
 namespace page { namespace phys
 {
 	/**
-	 * The binding between a mesh and a pose.
+	 * The binding between a mesh and a pose, packed for fast skinning.
+	 *
+	 * The bind-pose vertices are stored as structure-of-arrays streams, and
+	 * each vertex has a fixed number of influence slots with quantized
+	 * weights.  The influences refer to bones by their index in a palette,
+	 * so the skinning matrices only need to be fetched once per bone for
+	 * each update, rather than once per influence.
 	 */
 	struct Skin
 	{
 		// construct
 		Skin(const res::Mesh &mesh, const attrib::Pose &);
 
-		struct Vertex
+		/**
+		 * The number of influence slots for each vertex.  If a vertex has
+		 * more influences than this, the weakest ones are dropped and the
+		 * remaining weights are renormalized.
+		 */
+		static const unsigned maxInfluences = 4;
+
+		/**
+		 * The scale of the quantized weights, which is the value of a weight
+		 * of one.
+		 */
+		static const unsigned weightScale = 0xffff;
+
+		/**
+		 * Returns the number of vertices.
+		 */
+		std::size_t GetSize() const;
+
+		/**
+		 * The bones that make up the matrix palette.  The first entry is
+		 * always null, and stands for the identity matrix, so that any weight
+		 * that isn't assigned to a bone leaves the vertex in its bind pose.
+		 */
+		std::vector<const attrib::Pose::Bone *> bones;
+
+		/**
+		 * A structure-of-arrays stream of vectors.
+		 */
+		struct Stream
 		{
-			math::Vec3 co, no;
-			struct Influence
-			{
-				const attrib::Pose::Bone *bone;
-				float weight;
-			};
-			typedef std::vector<Influence> Influences;
-			Influences influences;
+			std::vector<float> x, y, z;
 		};
-		typedef std::vector<Vertex> Vertices;
-		Vertices vertices;
+		Stream co, no;
+
+		/**
+		 * The palette index and quantized weight of each influence slot,
+		 * with @c maxInfluences consecutive slots for each vertex.
+		 */
+		std::vector<std::uint16_t> boneIndices, weights;
 	};
 
-	// transform vertex
-	void Update(const Skin::Vertex &, math::Vec3 &co, math::Vec3 &no);
+	/**
+	 * Skins the vertices using the current pose, writing the positions and
+	 * normals to the output arrays, which have @a stride bytes between the
+	 * start of each vertex.  Large meshes are split between worker threads.
+	 */
+	void Update(const Skin &, float *co, float *no, std::size_t stride);
 }}
 
 #endif
@@ -27,6 +27,7 @@
 
 #include <cassert>
 
+#include "../../math/interp.hpp" // Lerp
 #include "Normal.hpp"
 
 namespace page { namespace phys { namespace attrib
@@ -61,7 +62,7 @@ namespace page { namespace phys { namespace attrib
 		{
 			// HACK: normalize to correct floating-point drift
 			this->value = Norm(value);
-			dirtyTransformSig();
+			MarkTransformDirty();
 		}
 	}
 
@@ -86,6 +87,11 @@ namespace page { namespace phys { namespace attrib
 		return Tpos(GetMatrix());
 	}
 
+	math::Mat3 Normal::GetInterpolatedMatrix(float alpha) const
+	{
+		return RotationMatrix(math::NormVector<3>(), Norm(math::Lerp(tickValue, value, alpha)));
+	}
+
 	void Normal::SetMatrix(const math::Mat3 &matrix)
 	{
 		SetNormal(GetRotation(matrix) * math::NormVector<3>());
@@ -146,4 +152,9 @@ namespace page { namespace phys { namespace attrib
 	{
 		spin = math::Quat<>(lastValue, value);
 	}
+
+	void Normal::BakeTickTransform()
+	{
+		tickValue = value;
+	}
 }}}
@@ -26,6 +26,7 @@
  */
 
 #include <cassert>
+#include "../../math/interp.hpp" // Lerp
 #include "Orientation.hpp"
 
 namespace page { namespace phys { namespace attrib
@@ -60,7 +61,7 @@ namespace page { namespace phys { namespace attrib
 		{
 			// HACK: normalize to correct floating-point drift
 			this->value = Norm(value);
-			dirtyTransformSig();
+			MarkTransformDirty();
 		}
 	}
 
@@ -85,6 +86,11 @@ namespace page { namespace phys { namespace attrib
 		return RotationMatrix(Inv(value));
 	}
 
+	math::Mat3 Orientation::GetInterpolatedMatrix(float alpha) const
+	{
+		return RotationMatrix(math::Lerp(tickValue, value, alpha));
+	}
+
 	void Orientation::SetMatrix(const math::Mat3 &matrix)
 	{
 		SetOrientation(math::GetOrientation(matrix));
@@ -145,4 +151,9 @@ namespace page { namespace phys { namespace attrib
 	{
 		spin = value / lastValue;
 	}
+
+	void Orientation::BakeTickTransform()
+	{
+		tickValue = value;
+	}
 }}}
@@ -25,6 +25,9 @@
  * of this software.
  */
 
+#include <cassert>
+#include <cstddef> // size_t
+#include <memory> // make_shared
 #include <utility> // move, swap
 
 #include <boost/range/algorithm/find.hpp> // find
@@ -41,10 +44,7 @@ namespace page { namespace phys { namespace attrib
 	+-------------*/
 
 	Pose::Bone::Bone(Pose &pose, const std::string &name) :
-		pose(&pose), name(name)
-	{
-		Init();
-	}
+		pose(&pose), name(name) {}
 
 	Pose::Bone::Bone(Pose &pose, const res::Skeleton::Bone &skelBone, Bone *parent) :
 		PositionOrientationScale(skelBone.position, skelBone.orientation, skelBone.scale),
@@ -52,8 +52,6 @@ namespace page { namespace phys { namespace attrib
 	{
 		if (parent != nullptr)
 			SetParent(*parent);
-
-		Init();
 	}
 
 	Pose::Bone::Bone(const Bone &other) :
@@ -75,10 +73,7 @@ namespace page { namespace phys { namespace attrib
 		invPoseMatrix           (other.invPoseMatrix),
 		normInvPoseMatrix       (other.normInvPoseMatrix),
 		skinMatrix              (other.skinMatrix),
-		normSkinMatrix          (other.normSkinMatrix)
-	{
-		Init();
-	}
+		normSkinMatrix          (other.normSkinMatrix) {}
 
 	Pose::Bone::Bone(Bone &&other) :
 		PositionOrientationScale(std::move(other)),
@@ -99,10 +94,7 @@ namespace page { namespace phys { namespace attrib
 		invPoseMatrix           (std::move(other.invPoseMatrix)),
 		normInvPoseMatrix       (std::move(other.normInvPoseMatrix)),
 		skinMatrix              (std::move(other.skinMatrix)),
-		normSkinMatrix          (std::move(other.normSkinMatrix))
-	{
-		Init();
-	}
+		normSkinMatrix          (std::move(other.normSkinMatrix)) {}
 
 	Pose::Bone &Pose::Bone::operator =(Bone other)
 	{
@@ -110,21 +102,6 @@ namespace page { namespace phys { namespace attrib
 		return *this;
 	}
 
-	void Pose::Bone::Init()
-	{
-		dirtyTransformSig.connect([this]
-		{
-			MarkDirty();
-
-			/**
-			 * @todo This signal gets called every time a bone is transformed,
-			 * which could result in a lot of unnecessary function calls.  A
-			 * polling approach would make more sense.
-			 */
-			pose->dirtyPoseSig();
-		});
-	}
-
 	/*----------+
 	| observers |
 	+----------*/
@@ -338,6 +315,17 @@ namespace page { namespace phys { namespace attrib
 		}
 	}
 
+	/*-----------------------------+
+	| Transformable implementation |
+	+-----------------------------*/
+
+	void Pose::Bone::MarkTransformDirty()
+	{
+		Transformable::MarkTransformDirty();
+		MarkDirty();
+		++pose->poseVersion;
+	}
+
 ////////// Pose ////////////////////////////////////////////////////////////////
 
 	/*-------------+
@@ -347,8 +335,14 @@ namespace page { namespace phys { namespace attrib
 	Pose::Pose(const res::Skeleton &skeleton)
 	{
 		// create the bones as orphans
+		std::vector<std::string> names;
+		names.reserve(skeleton.bones.size());
 		for (const auto &skelBone : skeleton.bones)
+		{
+			names.push_back(skelBone.name);
 			bones.emplace_back(*this, skelBone);
+		}
+		boneLayout = std::make_shared<const BoneLayout>(std::move(names));
 
 		// attach child bones to parents
 		for (auto bone : util::zip(bones, skeleton.bones))
@@ -367,6 +361,11 @@ namespace page { namespace phys { namespace attrib
 		return !bones.empty();
 	}
 
+	unsigned Pose::GetPoseVersion() const noexcept
+	{
+		return poseVersion;
+	}
+
 	/*----------+
 	| modifiers |
 	+----------*/
@@ -390,13 +389,16 @@ namespace page { namespace phys { namespace attrib
 
 	Pose::Bone &Pose::CopyTreePath(const res::Skeleton::Bone &skelBone)
 	{
-		auto boneIter(bonesByName.find(skelBone.name));
-		if (boneIter == bonesByName.end())
+		int index = boneLayout ? boneLayout->Find(skelBone.name) : -1;
+		if (index == -1)
 		{
 			bones.emplace_back(*this, skelBone, skelBone.parent ? &CopyTreePath(*skelBone.parent) : nullptr);
-			boneIter = bonesByName.insert(std::make_pair(skelBone.name, bones.size() - 1)).first;
+			auto names(boneLayout ? boneLayout->names : std::vector<std::string>());
+			names.push_back(skelBone.name);
+			boneLayout = std::make_shared<const BoneLayout>(std::move(names));
+			index = bones.size() - 1;
 		}
-		return bones[boneIter->second];
+		return bones[index];
 	}
 
 	/*------+
@@ -410,14 +412,19 @@ namespace page { namespace phys { namespace attrib
 
 	Pose::Bone *Pose::GetBone(const std::string &name)
 	{
-		auto iter(bonesByName.find(name));
-		return iter != bonesByName.end() ? &bones[iter->second] : nullptr;
+		int index = boneLayout ? boneLayout->Find(name) : -1;
+		return index != -1 ? &bones[index] : nullptr;
 	}
 
 	const Pose::Bone *Pose::GetBone(const std::string &name) const
 	{
-		auto iter(bonesByName.find(name));
-		return iter != bonesByName.end() ? &bones[iter->second] : nullptr;
+		int index = boneLayout ? boneLayout->Find(name) : -1;
+		return index != -1 ? &bones[index] : nullptr;
+	}
+
+	const std::shared_ptr<const BoneLayout> &Pose::GetBoneLayout() const
+	{
+		return boneLayout;
 	}
 
 	/*--------------------+
@@ -429,15 +436,14 @@ namespace page { namespace phys { namespace attrib
 		Frame frame(PositionOrientationScale::GetFrame());
 
 		// bones
-		for (const auto &bone : bones)
+		auto &boneFrame(frame.indexedBones);
+		boneFrame.Bind(boneLayout);
+		for (std::size_t i = 0; i < bones.size(); ++i)
 		{
-			Frame::Bone boneFrame
-			{
-				bone.GetPosition(),
-				bone.GetOrientation(),
-				bone.GetScale()
-			};
-			frame.bones.insert(std::make_pair(bone.GetName(), boneFrame));
+			const auto &bone(bones[i]);
+			boneFrame.position.Set   (i, bone.GetPosition());
+			boneFrame.orientation.Set(i, bone.GetOrientation());
+			boneFrame.scale.Set      (i, bone.GetScale());
 		}
 
 		return frame;
@@ -447,7 +453,23 @@ namespace page { namespace phys { namespace attrib
 	{
 		PositionOrientationScale::SetFrame(frame);
 
-		// bones
+		// indexed bones
+		if (frame.indexedBones.layout && boneLayout)
+		{
+			if (frame.indexedBones.layout == boneLayout)
+				SetBoneFrame(frame.indexedBones);
+			else
+			{
+				// the frame was built for another skeleton, so its bones
+				// have to be matched by name
+				BoneFrame boneFrame;
+				boneFrame.Bind(boneLayout);
+				boneFrame += frame.indexedBones;
+				SetBoneFrame(boneFrame);
+			}
+		}
+
+		// named bones
 		for (const auto &kv : frame.bones)
 			if (Bone *bone = GetBone(kv.first))
 			{
@@ -457,4 +479,16 @@ namespace page { namespace phys { namespace attrib
 				if (boneFrame.scale)       bone->SetScale      (*boneFrame.scale);
 			}
 	}
+
+	void Pose::SetBoneFrame(const BoneFrame &boneFrame)
+	{
+		assert(boneFrame.layout == boneLayout);
+		for (std::size_t i = 0; i < bones.size(); ++i)
+		{
+			auto &bone(bones[i]);
+			if (boneFrame.position.Has(i))    bone.SetPosition   (boneFrame.position.values[i]);
+			if (boneFrame.orientation.Has(i)) bone.SetOrientation(boneFrame.orientation.values[i]);
+			if (boneFrame.scale.Has(i))       bone.SetScale      (boneFrame.scale.values[i]);
+		}
+	}
 }}}
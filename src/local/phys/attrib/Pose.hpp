@@ -28,16 +28,16 @@
 #ifndef    page_local_phys_attrib_Pose_hpp
 #   define page_local_phys_attrib_Pose_hpp
 
+#	include <memory> // shared_ptr
 #	include <string>
-#	include <unordered_map>
 #	include <vector>
 
 #	include <boost/optional.hpp>
 
 #	include "../../math/Matrix.hpp"
 #	include "../../res/type/Skeleton.hpp" // Skeleton::Bone
-#	include "../../util/copyable_signal.hpp"
 #	include "../../util/Identifiable.hpp"
+#	include "../BoneFrame.hpp" // BoneLayout
 #	include "PositionOrientationScale.hpp"
 
 namespace page { namespace phys { namespace attrib
@@ -103,9 +103,6 @@ namespace page { namespace phys { namespace attrib
 			 */
 			Bone &operator =(Bone);
 
-			private:
-			void Init();
-
 			/*----------+
 			| observers |
 			+----------*/
@@ -254,6 +251,16 @@ namespace page { namespace phys { namespace attrib
 			 */
 			void MarkDirty() const;
 
+			/*-----------------------------+
+			| Transformable implementation |
+			+-----------------------------*/
+
+			/**
+			 * Marks the bone and its children as dirty, and increments the
+			 * version of the pose.
+			 */
+			void MarkTransformDirty() override;
+
 			/*-------------+
 			| data members |
 			+-------------*/
@@ -369,6 +376,17 @@ namespace page { namespace phys { namespace attrib
 		 */
 		bool IsPosed() const;
 
+		/**
+		 * Returns a number that is incremented every time one of the bones
+		 * is transformed.  Any cached data that is based on the pose can
+		 * record the version it was built from, and compare it with the
+		 * current version to find out whether it needs to be updated.
+		 *
+		 * @note The version doesn't account for the transformation of the
+		 *       pose itself, which has its own version.
+		 */
+		unsigned GetPoseVersion() const noexcept;
+
 		/*----------+
 		| modifiers |
 		+----------*/
@@ -421,11 +439,12 @@ namespace page { namespace phys { namespace attrib
 		 */
 		const Bone *GetBone(const std::string &) const;
 
-		/*--------+
-		| signals |
-		+--------*/
-
-		util::copyable_signal<void ()> dirtyPoseSig;
+		/**
+		 * Returns the names of the bones in index order, which is the layout
+		 * of the indexed bone channels in a frame, or @c nullptr if the pose
+		 * doesn't have any bones.
+		 */
+		const std::shared_ptr<const BoneLayout> &GetBoneLayout() const;
 
 		/*--------------------+
 		| frame serialization |
@@ -435,6 +454,13 @@ namespace page { namespace phys { namespace attrib
 		Frame GetFrame() const;
 		void SetFrame(const Frame &);
 
+		private:
+		/**
+		 * Applies the indexed bone channels of a frame, which must be bound
+		 * to the pose's bone layout.
+		 */
+		void SetBoneFrame(const BoneFrame &);
+
 		/*-------------+
 		| data members |
 		+-------------*/
@@ -447,9 +473,17 @@ namespace page { namespace phys { namespace attrib
 		std::vector<Bone> bones;
 
 		/**
-		 * An associative array mapping the name of a bone to its index.
+		 * The names of the bones in index order, including an associative
+		 * array mapping the name of a bone to its index.  It is replaced
+		 * rather than modified when bones are added, since it is shared with
+		 * copies of the pose and with the frames and bindings built from it.
+		 */
+		std::shared_ptr<const BoneLayout> boneLayout;
+
+		/**
+		 * The number of times that any of the bones has been transformed.
 		 */
-		std::unordered_map<std::string, unsigned> bonesByName;
+		unsigned poseVersion = 0;
 	};
 }}}
 
@@ -25,6 +25,7 @@
  * of this software.
  */
 
+#include "../../math/interp.hpp" // Lerp
 #include "Position.hpp"
 
 namespace page { namespace phys { namespace attrib
@@ -54,7 +55,7 @@ namespace page { namespace phys { namespace attrib
 		if (Any(value != this->value))
 		{
 			this->value = value;
-			dirtyTransformSig();
+			MarkTransformDirty();
 		}
 	}
 
@@ -68,6 +69,11 @@ namespace page { namespace phys { namespace attrib
 		return TranslationMatrix(-value);
 	}
 
+	math::Mat34 Position::GetInterpolatedMatrix(float alpha) const
+	{
+		return TranslationMatrix(math::Lerp(tickValue, value, alpha));
+	}
+
 	void Position::SetMatrix(const math::Mat34 &matrix)
 	{
 		SetPosition(GetTranslation(matrix));
@@ -123,4 +129,9 @@ namespace page { namespace phys { namespace attrib
 	{
 		velocity = value - lastValue;
 	}
+
+	void Position::BakeTickTransform()
+	{
+		tickValue = value;
+	}
 }}}
@@ -58,6 +58,7 @@ namespace page { namespace phys { namespace attrib
 		// matrix view
 		math::Mat34 GetMatrix() const;
 		math::Mat34 GetInvMatrix() const;
+		math::Mat34 GetInterpolatedMatrix(float alpha) const;
 		void SetMatrix(const math::Mat34 &);
 
 		// transformation observers
@@ -81,13 +82,14 @@ namespace page { namespace phys { namespace attrib
 		void BakeTransform() override;
 		void UpdateForce() override;
 		void UpdateDelta() override;
+		void BakeTickTransform() override;
 
 		/*-------------+
 		| data members |
 		+-------------*/
 
 		private:
-		math::Vec3 value, lastValue = value;
+		math::Vec3 value, lastValue = value, tickValue = value;
 		math::Vec3 force, velocity;
 	};
 }}}
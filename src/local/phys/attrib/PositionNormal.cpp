@@ -56,6 +56,11 @@ namespace page { namespace phys { namespace attrib
 		return math::Mat34(Normal::GetInvMatrix()) * Position::GetInvMatrix();
 	}
 
+	math::Mat34 PositionNormal::GetInterpolatedMatrix(float alpha) const
+	{
+		return Position::GetInterpolatedMatrix(alpha) * math::Mat34(Normal::GetInterpolatedMatrix(alpha));
+	}
+
 	void PositionNormal::SetMatrix(const math::Mat34 &matrix)
 	{
 		Position::SetMatrix(matrix);
@@ -100,4 +105,10 @@ namespace page { namespace phys { namespace attrib
 		Position::UpdateDelta();
 		Normal  ::UpdateDelta();
 	}
+
+	void PositionNormal::BakeTickTransform()
+	{
+		Position::BakeTickTransform();
+		Normal  ::BakeTickTransform();
+	}
 }}}
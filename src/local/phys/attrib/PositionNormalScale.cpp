@@ -56,6 +56,11 @@ namespace page { namespace phys { namespace attrib
 		return math::Mat34(Scale::GetInvMatrix()) * PositionNormal::GetInvMatrix();
 	}
 
+	math::Mat34 PositionNormalScale::GetInterpolatedMatrix(float alpha) const
+	{
+		return PositionNormal::GetInterpolatedMatrix(alpha) * math::Mat34(Scale::GetInterpolatedMatrix(alpha));
+	}
+
 	void PositionNormalScale::SetMatrix(const math::Mat34 &matrix)
 	{
 		PositionNormal::SetMatrix(matrix);
@@ -103,4 +108,10 @@ namespace page { namespace phys { namespace attrib
 		PositionNormal::UpdateDelta();
 		Scale         ::UpdateDelta();
 	}
+
+	void PositionNormalScale::BakeTickTransform()
+	{
+		PositionNormal::BakeTickTransform();
+		Scale         ::BakeTickTransform();
+	}
 }}}
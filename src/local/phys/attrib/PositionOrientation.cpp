@@ -56,6 +56,11 @@ namespace page { namespace phys { namespace attrib
 		return math::Mat34(Orientation::GetInvMatrix()) * Position::GetInvMatrix();
 	}
 
+	math::Mat34 PositionOrientation::GetInterpolatedMatrix(float alpha) const
+	{
+		return Position::GetInterpolatedMatrix(alpha) * math::Mat34(Orientation::GetInterpolatedMatrix(alpha));
+	}
+
 	void PositionOrientation::SetMatrix(const math::Mat34 &matrix)
 	{
 		Position   ::SetMatrix(matrix);
@@ -100,4 +105,10 @@ namespace page { namespace phys { namespace attrib
 		Position   ::UpdateDelta();
 		Orientation::UpdateDelta();
 	}
+
+	void PositionOrientation::BakeTickTransform()
+	{
+		Position   ::BakeTickTransform();
+		Orientation::BakeTickTransform();
+	}
 }}}
@@ -56,6 +56,7 @@ namespace page { namespace phys { namespace attrib
 
 		math::Mat34 GetMatrix() const;
 		math::Mat34 GetInvMatrix() const;
+		math::Mat34 GetInterpolatedMatrix(float alpha) const;
 		void SetMatrix(const math::Mat34 &);
 
 		/*--------------------+
@@ -74,6 +75,7 @@ namespace page { namespace phys { namespace attrib
 		void BakeTransform() override;
 		void UpdateForce() override;
 		void UpdateDelta() override;
+		void BakeTickTransform() override;
 	};
 }}}
 
@@ -56,6 +56,11 @@ namespace page { namespace phys { namespace attrib
 		return math::Mat34(Scale::GetInvMatrix()) * PositionOrientation::GetInvMatrix();
 	}
 
+	math::Mat34 PositionOrientationScale::GetInterpolatedMatrix(float alpha) const
+	{
+		return PositionOrientation::GetInterpolatedMatrix(alpha) * math::Mat34(Scale::GetInterpolatedMatrix(alpha));
+	}
+
 	void PositionOrientationScale::SetMatrix(const math::Mat34 &matrix)
 	{
 		PositionOrientation::SetMatrix(matrix);
@@ -106,4 +111,10 @@ namespace page { namespace phys { namespace attrib
 		PositionOrientation::UpdateDelta();
 		Scale              ::UpdateDelta();
 	}
+
+	void PositionOrientationScale::BakeTickTransform()
+	{
+		PositionOrientation::BakeTickTransform();
+		Scale              ::BakeTickTransform();
+	}
 }}}
@@ -58,6 +58,7 @@ namespace page { namespace phys { namespace attrib
 
 		math::Mat34 GetMatrix() const;
 		math::Mat34 GetInvMatrix() const;
+		math::Mat34 GetInterpolatedMatrix(float alpha) const;
 		void SetMatrix(const math::Mat34 &);
 		void SetMatrix(const math::Mat3 &);
 
@@ -77,6 +78,7 @@ namespace page { namespace phys { namespace attrib
 		void BakeTransform() override;
 		void UpdateForce() override;
 		void UpdateDelta() override;
+		void BakeTickTransform() override;
 	};
 }}}
 
@@ -25,6 +25,7 @@
  * of this software.
  */
 
+#include "../../math/interp.hpp" // Lerp
 #include "Scale.hpp"
 
 namespace page { namespace phys { namespace attrib
@@ -54,7 +55,7 @@ namespace page { namespace phys { namespace attrib
 		if (Any(value != this->value))
 		{
 			this->value = value;
-			dirtyTransformSig();
+			MarkTransformDirty();
 		}
 	}
 
@@ -68,6 +69,11 @@ namespace page { namespace phys { namespace attrib
 		return ScaleMatrix(1 / value);
 	}
 
+	math::Mat3 Scale::GetInterpolatedMatrix(float alpha) const
+	{
+		return ScaleMatrix(math::Lerp(tickValue, value, alpha));
+	}
+
 	void Scale::SetMatrix(const math::Mat3 &matrix)
 	{
 		SetScale(math::GetScale(matrix));
@@ -123,4 +129,9 @@ namespace page { namespace phys { namespace attrib
 	{
 		delta = value / lastValue;
 	}
+
+	void Scale::BakeTickTransform()
+	{
+		tickValue = value;
+	}
 }}}
@@ -56,6 +56,7 @@ namespace page { namespace phys { namespace attrib
 		// matrix view
 		math::Mat3 GetMatrix() const;
 		math::Mat3 GetInvMatrix() const;
+		math::Mat3 GetInterpolatedMatrix(float alpha) const;
 		void SetMatrix(const math::Mat3 &);
 
 		// transformation observers
@@ -79,13 +80,14 @@ namespace page { namespace phys { namespace attrib
 		void BakeTransform() override;
 		void UpdateForce() override;
 		void UpdateDelta() override;
+		void BakeTickTransform() override;
 
 		/*-------------+
 		| data members |
 		+-------------*/
 
 		private:
-		math::Vec3 value, lastValue = value;
+		math::Vec3 value, lastValue = value, tickValue = value;
 		math::Vec3 force = 1, delta = 1;
 	};
 }}}
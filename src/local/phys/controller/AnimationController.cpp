@@ -25,44 +25,61 @@
  * of this software.
  */
 
-#include <algorithm> // copy
 #include <cmath> // fmod
-#include <iterator> // back_inserter
+#include <cstddef> // size_t
+#include <memory> // shared_ptr
 
 #include "AnimationController.hpp"
 
 namespace page { namespace phys
 {
+	namespace
+	{
+		/**
+		 * Returns a pointer to one of the animation's channels that shares
+		 * ownership of the animation.
+		 */
+		template <typename T>
+			std::shared_ptr<const res::Animation::Channel<T>> Share(
+				const std::shared_ptr<const res::Animation> &anim,
+				const res::Animation::Channel<T> &channel)
+		{
+			return std::shared_ptr<const res::Animation::Channel<T>>(anim, &channel);
+		}
+	}
+
 	/*-------------+
 	| constructors |
 	+-------------*/
 
-	AnimationController::AnimationController(const res::Animation &anim, float timeScale) :
+	AnimationController::AnimationController(const std::shared_ptr<const res::Animation> &anim, float timeScale) :
 		Controller(AnimationLayer::preCollision),
-		time(0), timeScale(timeScale), duration(anim.duration),
-		position(anim.position),
-		orientation(anim.orientation),
-		normal(anim.normal),
-		scale(anim.scale),
-		texCoord(anim.texCoord),
-		ambient(anim.ambient),
-		diffuse(anim.diffuse),
-		specular(anim.specular),
-		attenuation(anim.attenuation),
-		cutoff(anim.cutoff),
-		depth(anim.depth),
-		exposure(anim.exposure),
-		falloff(anim.falloff),
-		fov(anim.fov),
-		opacity(anim.opacity),
-		range(anim.range),
-		size(anim.size),
-		volume(anim.volume)
+		time(0), timeScale(timeScale), duration(anim->duration),
+		position(Share(anim, anim->position)),
+		orientation(Share(anim, anim->orientation)),
+		normal(Share(anim, anim->normal)),
+		scale(Share(anim, anim->scale)),
+		texCoord(Share(anim, anim->texCoord)),
+		ambient(Share(anim, anim->ambient)),
+		diffuse(Share(anim, anim->diffuse)),
+		specular(Share(anim, anim->specular)),
+		attenuation(Share(anim, anim->attenuation)),
+		cutoff(Share(anim, anim->cutoff)),
+		depth(Share(anim, anim->depth)),
+		exposure(Share(anim, anim->exposure)),
+		falloff(Share(anim, anim->falloff)),
+		fov(Share(anim, anim->fov)),
+		opacity(Share(anim, anim->opacity)),
+		range(Share(anim, anim->range)),
+		size(Share(anim, anim->size)),
+		volume(Share(anim, anim->volume))
 	{
-		bones.reserve(anim.bones.size());
-		std::copy(anim.bones.begin(), anim.bones.end(), std::back_inserter(bones));
-		vertices.reserve(anim.vertices.size());
-		std::copy(anim.vertices.begin(), anim.vertices.end(), std::back_inserter(vertices));
+		bones.reserve(anim->bones.size());
+		for (const auto &bone : anim->bones)
+			bones.emplace_back(anim, bone);
+		vertices.reserve(anim->vertices.size());
+		for (const auto &vertex : anim->vertices)
+			vertices.emplace_back(anim, vertex);
 	}
 
 	/*----------+
@@ -74,6 +91,20 @@ namespace page { namespace phys
 		time = std::fmod(std::fmod(playPosition, duration) + duration, duration);
 	}
 
+	/*-------------+
+	| bone binding |
+	+-------------*/
+
+	void AnimationController::BindBones(const std::shared_ptr<const BoneLayout> &layout) const
+	{
+		if (layout == boneLayout) return;
+		boneIndices.clear();
+		boneIndices.reserve(bones.size());
+		for (const auto &bone : bones)
+			boneIndices.push_back(layout->Find(bone.name));
+		boneLayout = layout;
+	}
+
 	/*--------------------------+
 	| Controller implementation |
 	+--------------------------*/
@@ -84,7 +115,7 @@ namespace page { namespace phys
 		SetPlayPosition(time + deltaTime * timeScale);
 	}
 
-	Frame AnimationController::DoGetFrame(const Frame &, const Frame &) const
+	Frame AnimationController::DoGetFrame(const Frame &base, const Frame &) const
 	{
 		Frame frame;
 		if (position)    frame.position    = position.Get(time);
@@ -105,7 +136,22 @@ namespace page { namespace phys
 		if (range)       frame.range       = range.Get(time);
 		if (size)        frame.size        = size.Get(time);
 		if (volume)      frame.volume      = volume.Get(time);
-		for (Bones::const_iterator bone(bones.begin()); bone != bones.end(); ++bone)
+		if (const auto &layout = base.indexedBones.layout)
+		{
+			BindBones(layout);
+			auto &boneFrame(frame.indexedBones);
+			boneFrame.Bind(layout);
+			for (std::size_t i = 0; i < bones.size(); ++i)
+			{
+				int index = boneIndices[i];
+				if (index == -1) continue;
+				const auto &bone(bones[i]);
+				if (bone.position)    boneFrame.position.Set   (index, bone.position.Get(time));
+				if (bone.orientation) boneFrame.orientation.Set(index, bone.orientation.Get(time));
+				if (bone.scale)       boneFrame.scale.Set      (index, bone.scale.Get(time));
+			}
+		}
+		else for (Bones::const_iterator bone(bones.begin()); bone != bones.end(); ++bone)
 		{
 			Frame::Bone &frameBone(frame.bones[bone->name]);
 			if (bone->position)    frameBone.position    = bone->position.Get(time);
@@ -128,11 +174,11 @@ namespace page { namespace phys
 	| constructors |
 	+-------------*/
 
-	AnimationController::Bone::Bone(res::Animation::Bones::const_iterator::reference pair) :
+	AnimationController::Bone::Bone(const std::shared_ptr<const res::Animation> &anim, res::Animation::Bones::const_iterator::reference pair) :
 		name(pair.first),
-		position(pair.second.position),
-		orientation(pair.second.orientation),
-		scale(pair.second.scale) {}
+		position(Share(anim, pair.second.position)),
+		orientation(Share(anim, pair.second.orientation)),
+		scale(Share(anim, pair.second.scale)) {}
 
 ////////// AnimationController::Vertex /////////////////////////////////////////
 
@@ -140,9 +186,9 @@ namespace page { namespace phys
 	| constructors |
 	+-------------*/
 
-	AnimationController::Vertex::Vertex(res::Animation::Vertices::const_iterator::reference pair) :
+	AnimationController::Vertex::Vertex(const std::shared_ptr<const res::Animation> &anim, res::Animation::Vertices::const_iterator::reference pair) :
 		index(pair.first),
-		position(pair.second.position),
-		normal(pair.second.normal),
-		texCoord(pair.second.texCoord) {}
+		position(Share(anim, pair.second.position)),
+		normal(Share(anim, pair.second.normal)),
+		texCoord(Share(anim, pair.second.texCoord)) {}
 }}
@@ -28,6 +28,7 @@
 #ifndef    page_local_phys_controller_AnimationController_hpp
 #   define page_local_phys_controller_AnimationController_hpp
 
+#	include <memory> // shared_ptr
 #	include <string>
 #	include <vector>
 
@@ -46,7 +47,11 @@ namespace page { namespace phys
 		+-------------*/
 
 		public:
-		explicit AnimationController(const res::Animation &, float timeScale = 1);
+		/**
+		 * Creates a controller that plays the specified animation.  The
+		 * controller shares the animation's frames, keeping it alive.
+		 */
+		explicit AnimationController(const std::shared_ptr<const res::Animation> &, float timeScale = 1);
 
 		/*----------+
 		| modifiers |
@@ -54,6 +59,17 @@ namespace page { namespace phys
 
 		void SetPlayPosition(float);
 
+		/*-------------+
+		| bone binding |
+		+-------------*/
+
+		private:
+		/**
+		 * Maps the animated bones to their indices in the specified layout,
+		 * unless they have already been mapped to it.
+		 */
+		void BindBones(const std::shared_ptr<const BoneLayout> &) const;
+
 		/*--------------------------+
 		| Controller implementation |
 		+--------------------------*/
@@ -77,7 +93,7 @@ namespace page { namespace phys
 		struct Bone
 		{
 			// construct
-			Bone(res::Animation::Bones::const_iterator::reference);
+			Bone(const std::shared_ptr<const res::Animation> &, res::Animation::Bones::const_iterator::reference);
 
 			std::string name;
 			Interpolator<math::Vec3> position;
@@ -87,10 +103,21 @@ namespace page { namespace phys
 		typedef std::vector<Bone> Bones;
 		Bones bones;
 
+		/**
+		 * The layout that the bones were last bound to.
+		 */
+		mutable std::shared_ptr<const BoneLayout> boneLayout;
+
+		/**
+		 * The index of each of the bones in the bound layout, or -1 if the
+		 * layout doesn't have the bone.
+		 */
+		mutable std::vector<int> boneIndices;
+
 		struct Vertex
 		{
 			// construct
-			Vertex(res::Animation::Vertices::const_iterator::reference);
+			Vertex(const std::shared_ptr<const res::Animation> &, res::Animation::Vertices::const_iterator::reference);
 
 			unsigned index;
 			Interpolator<math::Vec3> position, normal;
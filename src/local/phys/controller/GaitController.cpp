@@ -67,7 +67,7 @@ namespace page { namespace phys
 	{
 		if (state.animation)
 		{
-			SetTarget(AnimationController(*state.animation));
+			SetTarget(AnimationController(state.animation.lock()));
 			stride = state.stride * state.animation->duration;
 		}
 		else
@@ -57,13 +57,26 @@ namespace page { namespace phys
 
 	void PathfindingController::Goto(const res::Track::Face &targetTrackFace, const math::Vec2 &targetPosition)
 	{
-		path = FindPath(controlled.GetTrackFace(), targetTrackFace, controlled.GetRadius());
+		const res::Track &track(controlled.GetTrack());
+		const res::Track::Face &sourceTrackFace(controlled.GetTrackFace());
+		float radius = controlled.GetRadius();
+		res::TrackPath path(FindPath(track, sourceTrackFace, targetTrackFace, radius));
+		if (path.empty() && &sourceTrackFace != &targetTrackFace)
+		{
+			// target is unreachable
+			Stop();
+			return;
+		}
+		SetTarget();
+		waypoints = SmoothPath(track, sourceTrackFace, controlled.GetPosition(), path,
+			math::Vec3(targetPosition.x, GetHeight(targetTrackFace, targetPosition), targetPosition.y),
+			radius);
 	}
 
 	void PathfindingController::Stop()
 	{
 		SetTarget();
-		while (!path.empty()) path.pop();
+		while (!waypoints.empty()) waypoints.pop();
 	}
 
 	/*-------------+
@@ -72,11 +85,11 @@ namespace page { namespace phys
 
 	void PathfindingController::UpdateLocomotion()
 	{
-		if (!path.empty() && !HasTarget())
+		if (!waypoints.empty() && !HasTarget())
 		{
-			// FIXME: set orientation toward next path node
-			SetTarget(GetCenter(*path.front()));
-			path.pop();
+			// FIXME: set orientation toward next waypoint
+			SetTarget(waypoints.front());
+			waypoints.pop();
 		}
 	}
 }}
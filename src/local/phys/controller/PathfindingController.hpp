@@ -28,7 +28,7 @@
 #ifndef    page_local_phys_controller_PathfindingController_hpp
 #   define page_local_phys_controller_PathfindingController_hpp
 
-#	include "../../res/type/Track.hpp" // Track::Face, TrackPath
+#	include "../../res/type/Track.hpp" // Track::Face, TrackWaypoints
 #	include "LocomotionController.hpp"
 
 namespace page { namespace phys
@@ -73,7 +73,7 @@ namespace page { namespace phys
 		+-------------*/
 
 		const Collidable &controlled;
-		res::TrackPath path;
+		res::TrackWaypoints waypoints;
 	};
 }}
 
@@ -28,6 +28,9 @@
 #ifndef    page_local_phys_controller_animation_Interpolator_hpp
 #   define page_local_phys_controller_animation_Interpolator_hpp
 
+#	include <cstddef> // size_t
+#	include <memory> // shared_ptr
+
 #	include "../../../res/type/Animation.hpp" // Animation::Channel
 
 namespace page
@@ -37,6 +40,11 @@ namespace page
 		/**
 		 * Key frame interpolator.
 		 *
+		 * The frames are shared with the animation resource rather than
+		 * copied, and each interpolator keeps a cursor on the frame that it
+		 * found last, so finding the frame for a time that has only moved a
+		 * little since the last call takes constant time.
+		 *
 		 * @note Inspired by CatMother's anim::Interpolator.
 		 */
 		template <typename T> struct Interpolator
@@ -50,7 +58,7 @@ namespace page
 
 			// constructor
 			// TEST: cubic interpolation should be the default
-			Interpolator(const res::Animation::Channel<T> &, InterpolationType = linearInterpolation);
+			Interpolator(const std::shared_ptr<const res::Animation::Channel<T>> &, InterpolationType = linearInterpolation);
 
 			// interpolated access
 			T Get(float time) const;
@@ -59,29 +67,21 @@ namespace page
 			explicit operator bool() const;
 
 			private:
-			// frame
-			struct Frame
-			{
-				// construct
-				explicit Frame(float time, const T & = T());
-				Frame(const typename res::Animation::Channel<T>::Frame &);
-
-				float time;
-				T value;
-			};
-			typedef std::vector<Frame> Frames;
+			// interpolated access
+			template <typename Frames, typename Unpack> T Get(const Frames &, float time, Unpack) const;
 
 			// bounded frame search
-			typename Frames::const_iterator FindFloorFrame(float time) const;
+			template <typename Frames> std::size_t FindFloorFrame(const Frames &, float time) const;
 
 			// bounded frame iteration
-			typename Frames::const_iterator Advance(const typename Frames::const_iterator &, int) const;
+			std::size_t Advance(std::size_t, int) const;
 
-			// frame comparison
-			static bool CompareFrameTime(const Frame &, const Frame &);
-
-			Frames frames;
+			std::shared_ptr<const res::Animation::Channel<T>> channel;
 			InterpolationType type;
+
+			// the frame found by the last search, where the next search
+			// starts
+			mutable std::size_t cursor = 0;
 		};
 	}
 }
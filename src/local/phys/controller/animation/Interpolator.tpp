@@ -25,9 +25,9 @@
  * of this software.
  */
 
-#include <algorithm> // copy, lower_bound, max, min
+#include <algorithm> // max, min
 #include <cassert>
-#include <iterator> // back_inserter
+#include <cstddef> // ptrdiff_t
 
 #include "../../../math/interp.hpp" // {Cubic,Linear}Interp
 
@@ -36,41 +36,51 @@ namespace page
 	namespace phys
 	{
 		// constructor
-		template <typename T> Interpolator<T>::Interpolator(const res::Animation::Channel<T> &channel, InterpolationType type) :
-			type(type)
+		template <typename T> Interpolator<T>::Interpolator(const std::shared_ptr<const res::Animation::Channel<T>> &channel, InterpolationType type) :
+			channel(channel), type(type)
 		{
 			// NOTE: animation frames expected to be sorted by increasing time
-			frames.reserve(channel.frames.size());
-			std::copy(channel.frames.begin(), channel.frames.end(), std::back_inserter(frames));
+			assert(channel);
 		}
 
 		// interpolated access
 		template <typename T> T Interpolator<T>::Get(float time) const
 		{
-			typename Frames::const_iterator frame(FindFloorFrame(time));
-			assert(frame != frames.end());
-			if (frame == frames.end() - 1) return frame->value;
+			// check whether the channel is packed once, rather than for
+			// every frame that is accessed
+			return channel->packedFrames.empty() ?
+				Get(channel->frames, time,
+					[](const T &value) -> const T & { return value; }) :
+				Get(channel->packedFrames, time,
+					[this](const typename res::Quantization<T>::Value &value)
+					{ return channel->quantization.Unpack(value); });
+		}
+		template <typename T> template <typename Frames, typename Unpack> T Interpolator<T>::Get(const Frames &frames, float time, Unpack unpack) const
+		{
+			std::size_t frame = FindFloorFrame(frames, time);
+			if (frame == frames.size() - 1) return unpack(frames[frame].value);
 			switch (type)
 			{
-				case stepInterpolation: return frame->value;
+				case stepInterpolation: return unpack(frames[frame].value);
 				case linearInterpolation:
 				{
-					const Frame
-						&frame1(*frame),
-						&frame2(*Advance(frame, 1));
+					const auto
+						&frame1(frames[frame]),
+						&frame2(frames[frame + 1]);
 					return math::LinearInterp(
-						frame1.value, frame2.value,
+						T(unpack(frame1.value)), T(unpack(frame2.value)),
 						(time - frame1.time) / (frame2.time - frame1.time));
 				}
 				case cubicInterpolation:
 				{
-					const Frame
-						&frame1(*Advance(frame, -1)),
-						&frame2(*frame),
-						&frame3(*Advance(frame, 1)),
-						&frame4(*Advance(frame, 2));
+					const auto
+						&frame1(frames[Advance(frame, -1)]),
+						&frame2(frames[frame]),
+						&frame3(frames[frame + 1]),
+						&frame4(frames[Advance(frame, 2)]);
 					return math::CubicInterp(
-						frame1.value, frame2.value, frame3.value, frame4.value,
+						T(unpack(frame1.value)), T(unpack(frame2.value)),
+						T(unpack(frame3.value)), T(unpack(frame4.value)),
 						(time - frame2.time) / (frame3.time - frame2.time));
 				}
 				default: assert(!"invalid interpolation type");
@@ -80,42 +90,50 @@ namespace page
 		// validity
 		template <typename T> Interpolator<T>::operator bool() const
 		{
-			return !frames.empty();
+			return channel->GetSize();
 		}
 
-		// frame
-		// construct
-		template <typename T> Interpolator<T>::Frame::Frame(float time, const T &value) :
-			time(time), value(value) {}
-		template <typename T> Interpolator<T>::Frame::Frame(const typename res::Animation::Channel<T>::Frame &frame) :
-			time(frame.time), value(frame.value) {}
-
-		// interpolator
 		// bounded frame search
-		template <typename T> typename Interpolator<T>::Frames::const_iterator Interpolator<T>::FindFloorFrame(float time) const
+		// finds the last frame before the time, or the first frame if there
+		// isn't one
+		template <typename T> template <typename Frames> std::size_t Interpolator<T>::FindFloorFrame(const Frames &frames, float time) const
 		{
-			assert(!frames.empty());
-			typename Frames::const_iterator frame(std::lower_bound(
-				frames.begin(), frames.end(), Frame(time), CompareFrameTime));
-			if (frame != frames.begin()) --frame;
-			return frame;
+			std::size_t size = frames.size();
+			assert(size);
+
+			// the time usually moves by less than a frame between calls, so
+			// step from the last frame that was found
+			const unsigned maxSteps = 4;
+			std::size_t frame = std::min(cursor, size - 1);
+			for (unsigned step = 0; step < maxSteps; ++step)
+			{
+				if (frame + 1 < size && frames[frame + 1].time < time) ++frame;
+				else if (frame && !(frames[frame].time < time)) --frame;
+				else return cursor = frame;
+			}
+
+			// the time has jumped, as when the animation loops, so search
+			// for the first frame at or after the time
+			std::size_t first = 0;
+			for (std::size_t count = size; count;)
+			{
+				std::size_t half = count / 2;
+				if (frames[first + half].time < time)
+				{
+					first += half + 1;
+					count -= half + 1;
+				}
+				else count = half;
+			}
+			return cursor = first ? first - 1 : 0;
 		}
 
 		// bounded frame iteration
-		template <typename T> typename Interpolator<T>::Frames::const_iterator Interpolator<T>::Advance(const typename Interpolator<T>::Frames::const_iterator &iter, int n) const
+		template <typename T> std::size_t Interpolator<T>::Advance(std::size_t frame, int n) const
 		{
-			assert(!frames.empty());
 			// FIXME: for wrapping iterator during looping; must wrap time too
-			/*int i = iter - frames.begin(), max = frames.size();
-			n = ((i + n) % max + max) % max;*/
-			n = std::min(std::max(n, frames.begin() - iter), (frames.end() - 1) - iter);
-			return iter + n;
-		}
-
-		// frame comparison
-		template <typename T> bool Interpolator<T>::CompareFrameTime(const Frame &a, const Frame &b)
-		{
-			return a.time < b.time;
+			std::ptrdiff_t last = channel->GetSize() - 1;
+			return std::min(std::max(std::ptrdiff_t(frame) + n, std::ptrdiff_t(0)), last);
 		}
 	}
 }
@@ -44,8 +44,10 @@ namespace page { namespace phys
 		auto &controllers(layers[layerIndex]);
 		if (controllers.empty()) return;
 
-		// execute controllers
+		// execute controllers, accumulating the bones in the base frame's
+		// layout so that any named bones are resolved as they are blended
 		Frame baseFrame(GetFrame()), accumFrame;
+		accumFrame.indexedBones.Bind(baseFrame.indexedBones.layout);
 		for (Controllers::iterator iter(controllers.begin()); iter != controllers.end();)
 		{
 			Controller &controller(**iter);
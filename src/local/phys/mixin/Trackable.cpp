@@ -94,7 +94,11 @@ namespace page { namespace phys
 		{
 			trackFace = 0;
 			if ((this->track = track) && BindTrackFace())
+			{
+				// snapping to the track is a teleport
 				SetPosition(Swizzle(GetPosition(), 0, 2));
+				BakeAllTransforms();
+			}
 		}
 	}
 
@@ -167,7 +171,7 @@ namespace page { namespace phys
 		if (track && BindTrackFace())
 		{
 			SetPosition(Swizzle(GetPosition(), 0, 2));
-			BakeTransform();
+			BakeAllTransforms();
 		}
 	}
 }}
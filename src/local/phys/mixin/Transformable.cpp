@@ -29,5 +29,19 @@
 
 namespace page { namespace phys
 {
-	Transformable::Transformable(const Transformable &) {}
+	unsigned Transformable::GetTransformVersion() const noexcept
+	{
+		return transformVersion;
+	}
+
+	void Transformable::BakeAllTransforms()
+	{
+		BakeTransform();
+		BakeTickTransform();
+	}
+
+	void Transformable::MarkTransformDirty()
+	{
+		++transformVersion;
+	}
 }}
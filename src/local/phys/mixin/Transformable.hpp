@@ -29,7 +29,6 @@
 #   define page_local_phys_mixin_Transformable_hpp
 
 #	include "../../util/class/special_member_functions.hpp" // Polymorphic
-#	include "../../util/copyable_signal.hpp"
 
 namespace page { namespace phys
 {
@@ -40,9 +39,6 @@ namespace page { namespace phys
 	class Transformable : public util::Polymorphic<Transformable>
 	{
 		public:
-		Transformable() = default;
-		Transformable(const Transformable &);
-
 		/**
 		 * Resets the transformation from the last frame to match the current
 		 * transformation, thereby zeroing out any calculated force/delta.
@@ -62,11 +58,42 @@ namespace page { namespace phys
 		virtual void UpdateDelta() = 0;
 
 		/**
-		 * A signal that will be called when the transformation changes.  It is
-		 * typically used to invalidate any cached data that is based on the
-		 * transformation.
+		 * Saves the current transformation as the transformation from the
+		 * last simulation tick, which is blended with the current
+		 * transformation when rendering between ticks.
+		 */
+		virtual void BakeTickTransform() = 0;
+
+		/**
+		 * Resets the transformations from the last frame and the last tick
+		 * to match the current transformation.  This should be called after
+		 * a node is placed or teleported, rather than moved by the
+		 * simulation, so that it doesn't pick up a force from the jump, and
+		 * isn't interpolated through the space in between.
+		 */
+		void BakeAllTransforms();
+
+		/**
+		 * Returns a number that is incremented every time the transformation
+		 * changes.  Any cached data that is based on the transformation can
+		 * record the version it was built from, and compare it with the
+		 * current version to find out whether it needs to be updated.
+		 */
+		unsigned GetTransformVersion() const noexcept;
+
+		protected:
+		/**
+		 * Marks the transformation as changed, incrementing its version.
+		 * Derived classes can override it to mark their own derived state as
+		 * dirty.
+		 */
+		virtual void MarkTransformDirty();
+
+		private:
+		/**
+		 * The number of times that the transformation has changed.
 		 */
-		util::copyable_signal<void ()> dirtyTransformSig;
+		unsigned transformVersion = 0;
 	};
 }}
 
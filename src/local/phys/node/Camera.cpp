@@ -146,6 +146,14 @@ namespace page { namespace phys
 			camera.GetPosition(), camera.GetOrientation());
 	}
 
+	math::ViewFrustum<> GetViewFrustum(const Camera &camera, float interpolation)
+	{
+		math::Mat34 matrix(camera.GetInterpolatedMatrix(interpolation));
+		return math::ViewFrustum<>(near, far,
+			math::DegToRad(camera.GetFov()), camera.GetAspect(),
+			GetTranslation(matrix), math::Quat<>(math::Mat3(matrix)));
+	}
+
 	math::Frustum<> GetFrustum(const Camera &camera)
 	{
 		return math::GetFrustum(GetViewFrustum(camera));
@@ -115,6 +115,7 @@ namespace page { namespace phys
 	+-------------------------*/
 
 	math::ViewFrustum<> GetViewFrustum(const Camera &);
+	math::ViewFrustum<> GetViewFrustum(const Camera &, float interpolation);
 	math::Frustum<> GetFrustum(const Camera &);
 	math::Mat4 GetMatrix(const Camera &);
 	math::Mat4 GetProjMatrix(const Camera &);
@@ -25,17 +25,116 @@
  * of this software.
  */
 
+#include <algorithm> // max
+#include <cmath> // cos, floor, sin, sqrt
+
+#include "../../math/float.hpp" // DegToRad, Pi
+#include "../../math/Matrix.hpp"
 #include "Emitter.hpp"
 
 namespace page { namespace phys
 {
+	namespace
+	{
+		/**
+		 * The shortest lifetime of a particle, which keeps the fraction of
+		 * its life that has passed finite even if it is drawn before it is
+		 * updated.
+		 */
+		const float minLifetime = .001f;
+	}
+
+	/*----------+
+	| accessors |
+	+----------*/
+
+	float Emitter::GetRate() const
+	{
+		return rate;
+	}
+
+	void Emitter::SetRate(float rate)
+	{
+		this->rate = rate;
+	}
+
+	const math::Vec3 &Emitter::GetAcceleration() const
+	{
+		return acceleration;
+	}
+
+	void Emitter::SetAcceleration(const math::Vec3 &acceleration)
+	{
+		this->acceleration = acceleration;
+	}
+
+	float Emitter::GetDrag() const
+	{
+		return drag;
+	}
+
+	void Emitter::SetDrag(float drag)
+	{
+		this->drag = drag;
+	}
+
+	const ParticlePool &Emitter::GetParticles() const
+	{
+		return particles;
+	}
+
 	/*-------+
 	| update |
 	+-------*/
 
-	void Emitter::Update()
+	void Emitter::Update(float deltaTime)
+	{
+		phys::Update(particles, deltaTime, acceleration, drag);
+
+		// spawn new particles
+		// NOTE: spawning after integration means that new particles start
+		// exactly at the emitter
+		float count = rate * deltaTime + spawnRemainder;
+		float whole = std::floor(count);
+		spawnRemainder = count - whole;
+		Spawn(whole);
+	}
+
+	void Emitter::Spawn(std::size_t count)
 	{
-		// FIXME: create particles
+		if (!count || GetMaxLifetime() <= 0) return;
+
+		math::Vec3 co(GetPosition());
+		math::Mat3 orientation(attrib::Orientation::GetMatrix());
+		float minCos = std::cos(math::DegToRad(GetCutoff()));
+		std::uniform_real_distribution<float>
+			unit(0, 1),
+			angle(0, 2 * math::Pi<float>()),
+			cosine(minCos, 1),
+			lifetime(GetMinLifetime(), GetMaxLifetime()),
+			opacity(GetMinOpacity(), GetMaxOpacity()),
+			size(GetMinSize(), GetMaxSize()),
+			speed(GetMinSpeed(), GetMaxSpeed());
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			// pick a direction within the cone
+			float
+				z = cosine(random),
+				r = std::sqrt(std::max(1 - z * z, 0.f)),
+				a = angle(random);
+			math::Vec3 direction(orientation *
+				math::Vec3(r * std::cos(a), r * std::sin(a), z));
+
+			math::RgbColor<> diffuse(
+				GetMinDiffuse() +
+				(GetMaxDiffuse() - GetMinDiffuse()) * unit(random));
+
+			particles.Push(co,
+				direction * speed(random),
+				std::max(lifetime(random), minLifetime),
+				size(random),
+				math::RgbaColor<>(diffuse, opacity(random)));
+		}
 	}
 
 	/*--------------------+
@@ -28,6 +28,8 @@
 #ifndef    page_local_phys_node_Emitter_hpp
 #   define page_local_phys_node_Emitter_hpp
 
+#	include <cstddef> // size_t
+#	include <random> // mt19937
 #	include <string>
 
 #	include "../attrib/AmbientRange.hpp"
@@ -41,13 +43,21 @@
 #	include "../attrib/SizeRange.hpp"
 #	include "../attrib/SpecularRange.hpp"
 #	include "../attrib/SpeedRange.hpp"
+#	include "../../math/Vector.hpp"
 #	include "../mixin/Controllable.hpp"
+#	include "../ParticlePool.hpp"
 #	include "Node.hpp"
 
 namespace page { namespace phys
 {
 	/**
 	 * A particle emitter.
+	 *
+	 * Particles are spawned at the position of the emitter and travel
+	 * within a cone around its Z axis, whose half-angle is the cutoff angle
+	 * in degrees.  Each particle takes its lifetime, speed, size, colour and
+	 * opacity from the ranges of the emitter.  The particles are owned by
+	 * the emitter rather than being nodes in the scene.
 	 */
 	class Emitter :
 		public Node,
@@ -66,12 +76,53 @@ namespace page { namespace phys
 	{
 		IMPLEMENT_CLONEABLE(Emitter, Node)
 
+		/*----------+
+		| accessors |
+		+----------*/
+
+		public:
+		/**
+		 * Returns the number of particles spawned per second.
+		 */
+		float GetRate() const;
+
+		void SetRate(float);
+
+		/**
+		 * Returns the constant acceleration of the particles, such as
+		 * gravity or wind.
+		 */
+		const math::Vec3 &GetAcceleration() const;
+
+		void SetAcceleration(const math::Vec3 &);
+
+		/**
+		 * Returns the fraction of its velocity that a particle loses per
+		 * second.
+		 */
+		float GetDrag() const;
+
+		void SetDrag(float);
+
+		/**
+		 * Returns the live particles.
+		 */
+		const ParticlePool &GetParticles() const;
+
 		/*-------+
 		| update |
 		+-------*/
 
-		public:
-		void Update();
+		/**
+		 * Spawns new particles, integrates the live ones, and removes the
+		 * ones that have outlived their lifetime.
+		 */
+		void Update(float deltaTime);
+
+		/**
+		 * Spawns @a count particles immediately.
+		 */
+		void Spawn(std::size_t count);
 
 		/*--------------------+
 		| frame serialization |
@@ -80,6 +131,24 @@ namespace page { namespace phys
 		protected:
 		Frame GetFrame() const override;
 		void SetFrame(const Frame &) override;
+
+		/*-------------+
+		| data members |
+		+-------------*/
+
+		private:
+		ParticlePool particles;
+		float rate = 0;
+		math::Vec3 acceleration = 0;
+		float drag = 0;
+
+		/**
+		 * The fraction of a particle that was due to be spawned in the
+		 * previous update, which is carried over to the next update.
+		 */
+		float spawnRemainder = 0;
+
+		std::mt19937 random;
 	};
 }}
 
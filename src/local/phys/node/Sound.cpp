@@ -63,6 +63,16 @@ namespace page { namespace phys
 		return playPosition;
 	}
 
+	int Sound::GetPriority() const
+	{
+		return priority;
+	}
+
+	void Sound::SetPriority(int priority)
+	{
+		this->priority = priority;
+	}
+
 	/*-------+
 	| update |
 	+-------*/
@@ -80,6 +80,16 @@ namespace page { namespace phys
 		 */
 		float GetPlayPosition() const;
 
+		/**
+		 * Returns the priority of the sound when competing for audio
+		 * channels.  Sounds with a higher priority are given channels before
+		 * any sound with a lower priority, regardless of how audible they
+		 * are.
+		 */
+		int GetPriority() const;
+
+		void SetPriority(int);
+
 		/*-------+
 		| update |
 		+-------*/
@@ -124,6 +134,11 @@ namespace page { namespace phys
 		 * The amount of the sound that has been played, measured in seconds.
 		 */
 		float playPosition = 0;
+
+		/**
+		 * The priority of the sound when competing for audio channels.
+		 */
+		int priority = 0;
 	};
 }}
 
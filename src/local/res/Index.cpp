@@ -25,7 +25,10 @@
  * of this software.
  */
 
-#include <memory> // unique_ptr
+#include <atomic>
+#include <chrono> // milliseconds
+#include <future> // {packaged,shared}_future, promise
+#include <memory> // {make_shared,unique_ptr}
 #include <iostream> // cout
 
 #include "../cfg/vars.hpp"
@@ -33,23 +36,79 @@
 #include "../err/report.hpp" // ReportError, std::exception
 #include "../log/Indenter.hpp"
 #include "../opt.hpp" // resourceSources
+#include "../util/raii/ScopeGuard.hpp"
 #include "Index.hpp"
 #include "node/path.hpp" // NormPath
 #include "pipe/Stream.hpp" // Stream::GetText
-#include "source/Source.hpp" // Source::{~Source,Open,Refresh}
+#include "source/IndexCache.hpp"
+#include "source/Source.hpp" // Source::{~Source,Contains,GetLoaded,IsThreadSafe,Load,Open,Poll,Refresh}
 #include "source/SourceRegistry.hpp"
 #include "type/TypeRegistry.hpp"
 
 namespace page { namespace res
 {
+	/*---------+
+	| requests |
+	+---------*/
+
+	/**
+	 * A resource that is being loaded in the background, which can be run
+	 * by whichever thread gets to it first.
+	 */
+	struct Index::Request
+	{
+		explicit Request(const std::function<std::shared_ptr<const void> ()> &load) :
+			task(load), future(task.get_future().share()) {}
+
+		/**
+		 * Loads the resource unless another thread has already started
+		 * loading it.
+		 *
+		 * @note Doesn't block on other threads, so the caller can go on to
+		 *       wait on @c future through @c Index::Wait, which keeps
+		 *       servicing the deferred loads that the running request may
+		 *       depend on.
+		 */
+		void TryRun()
+		{
+			if (!started.exchange(true)) task();
+		}
+
+		std::packaged_task<std::shared_ptr<const void> ()> task;
+		LoadFuture<void>::Future future;
+		std::atomic<bool> started{false};
+	};
+
+	auto Index::MakeRequest(const std::type_info &type, const std::string &normPath) const -> std::shared_ptr<Request>
+	{
+		// NOTE: the mutex must be held by the caller
+		PendingKey key(normPath, type.name());
+		auto iter(pending.find(key));
+		if (iter != pending.end()) return iter->second;
+		auto request(std::make_shared<Request>([this, &type, normPath, key]
+		{
+			util::ScopeGuard eraseGuard([this, &key]
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				pending.erase(key);
+			});
+			return LoadFromSources(type, normPath);
+		}));
+		pending.insert(std::make_pair(key, request));
+		return request;
+	}
+
 	/*-------------+
 	| constructors |
 	+-------------*/
 
-	Index::Index()
+	Index::Index() :
+		mainThread(std::this_thread::get_id()),
+		workers(*CVAR(resourceLoadThreads))
 	{
 		for (const auto &source : *CVAR(resourceSources)) AddSource(source);
 		for (const auto &source :  opt::resourceSources) AddSource(source);
+		GLOBAL(IndexCache).Save();
 	}
 
 	/*----------+
@@ -64,13 +123,32 @@ namespace page { namespace res
 		// executes, which is where all the indexing happens.
 		std::cout << "indexing source: " << path << std::endl;
 		log::Indenter indenter;
-		sources.push_front(GLOBAL(SourceRegistry).Make(path));
+		std::shared_ptr<Source> source(GLOBAL(SourceRegistry).Make(path));
+		std::lock_guard<std::mutex> lock(mutex);
+		sources.push_front(source);
 	}
 
 	void Index::Refresh()
 	{
-		for (const auto &source : sources)
+		for (const auto &source : GetSources())
 			source->Refresh();
+		GLOBAL(IndexCache).Save();
+	}
+
+	void Index::Poll()
+	{
+		for (const auto &source : GetSources())
+			source->Poll();
+	}
+
+	void Index::Update() const
+	{
+		decltype(deferred) jobs;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.swap(deferred);
+		}
+		for (const auto &job : jobs) job();
 	}
 
 	/*----------------+
@@ -80,7 +158,7 @@ namespace page { namespace res
 	Stream *Index::Open(const std::string &path) const
 	{
 		std::string normPath(NormPath(path));
-		for (const auto &source : sources)
+		for (const auto &source : GetSources())
 		{
 			Stream *stream = source->Open(normPath);
 			if (stream) return stream;
@@ -95,12 +173,35 @@ namespace page { namespace res
 		log::Indenter indenter;
 		try
 		{
-			for (const auto &source : sources)
+			bool mainThread = std::this_thread::get_id() == this->mainThread;
+
+			// share the request if it is already being loaded
+			std::shared_ptr<Request> request;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto iter(pending.find(PendingKey(normPath, type.name())));
+				if (iter != pending.end()) request = iter->second;
+			}
+			if (request)
+			{
+				// NOTE: if no worker has started the request yet, we run it
+				// ourselves rather than waiting in line behind it
+				if (mainThread || IsThreadSafe(type, normPath)) request->TryRun();
+				return Wait(request->future);
+			}
+
+			// defer to the main thread if the loader isn't thread-safe
+			if (!mainThread && !IsThreadSafe(type, normPath))
 			{
-				std::shared_ptr<const void> resource(source->Load(type, normPath));
-				if (resource) return resource;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					request = MakeRequest(type, normPath);
+					deferred.push_back([request] { request->TryRun(); });
+				}
+				return Wait(request->future);
 			}
-			THROW((err::Exception<err::ResModuleTag, err::NotFoundTag>("resource not found")))
+
+			return LoadFromSources(type, normPath);
 		}
 		catch (const std::exception &e)
 		{
@@ -109,9 +210,104 @@ namespace page { namespace res
 		}
 	}
 
+	LoadFuture<void>::Future Index::LoadAsync(const std::type_info &type, const std::string &path) const
+	{
+		std::string normPath(NormPath(path));
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// share the request if it is already being loaded
+		auto iter(pending.find(PendingKey(normPath, type.name())));
+		if (iter != pending.end()) return iter->second->future;
+
+		// skip the workers if the resource is already loaded
+		for (const auto &source : sources)
+		{
+			if (!source->Contains(normPath)) continue;
+			if (auto resource = source->GetLoaded(type, normPath))
+			{
+				std::promise<std::shared_ptr<const void>> promise;
+				promise.set_value(resource);
+				return promise.get_future().share();
+			}
+			break;
+		}
+
+		std::cout << "loading " << GLOBAL(TypeRegistry).Query(type).name << " from " << normPath << " in the background" << std::endl;
+		auto request(MakeRequest(type, normPath));
+		workers.Post([this, &type, normPath, request]
+		{
+			bool threadSafe;
+			try
+			{
+				threadSafe = IsThreadSafe(type, normPath);
+			}
+			catch (...)
+			{
+				// NOTE: let the request fail on its own
+				threadSafe = true;
+			}
+			if (threadSafe) request->TryRun();
+			else
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				deferred.push_back([request] { request->TryRun(); });
+			}
+		});
+		return request->future;
+	}
+
 	std::string Index::LoadString(const std::string &path) const
 	{
 		const std::unique_ptr<Stream> stream(Open(path));
 		return stream->GetText();
 	}
+
+	/*----------------+
+	| synchronization |
+	+----------------*/
+
+	std::shared_ptr<const void> Index::Wait(const LoadFuture<void>::Future &future) const
+	{
+		// NOTE: the resource may be waiting for us to load it
+		if (std::this_thread::get_id() == mainThread)
+			while (future.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+				Update();
+		return future.get();
+	}
+
+	namespace detail
+	{
+		std::shared_ptr<const void> WaitForLoad(const LoadFuture<void>::Future &future)
+		{
+			return GLOBAL(Index).Wait(future);
+		}
+	}
+
+	/*---------------+
+	| implementation |
+	+---------------*/
+
+	std::shared_ptr<const void> Index::LoadFromSources(const std::type_info &type, const std::string &normPath) const
+	{
+		for (const auto &source : GetSources())
+		{
+			std::shared_ptr<const void> resource(source->Load(type, normPath));
+			if (resource) return resource;
+		}
+		THROW((err::Exception<err::ResModuleTag, err::NotFoundTag>("resource not found")))
+	}
+
+	bool Index::IsThreadSafe(const std::type_info &type, const std::string &normPath) const
+	{
+		for (const auto &source : GetSources())
+			if (source->Contains(normPath))
+				return source->IsThreadSafe(type, normPath);
+		return true;
+	}
+
+	auto Index::GetSources() const -> Sources
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return sources;
+	}
 }}
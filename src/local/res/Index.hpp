@@ -30,12 +30,18 @@
 
 #	include <array>
 #	include <deque>
-#	include <functional> // reference_wrapper
+#	include <functional> // function, reference_wrapper
+#	include <map>
 #	include <memory> // shared_ptr
+#	include <mutex>
 #	include <string>
+#	include <thread> // thread::id
 #	include <typeinfo> // type_info
+#	include <utility> // pair
 
 #	include "../util/class/Monostate.hpp"
+#	include "../util/thread/WorkerPool.hpp"
+#	include "LoadFuture.hpp"
 
 namespace page { namespace res
 {
@@ -45,6 +51,10 @@ namespace page { namespace res
 	/**
 	 * Provides access to resources through an ordered list of sources.
 	 *
+	 * Resources can be loaded in the background with LoadAsync.  Loaders that
+	 * are not marked as thread-safe in @c LoaderRegistry are deferred to the
+	 * main thread, where they are run by Update.
+	 *
 	 * @sa Source
 	 */
 	class Index : public util::Monostate<Index>
@@ -77,6 +87,19 @@ namespace page { namespace res
 		 */
 		void Refresh();
 
+		/**
+		 * Applies the changes that the sources have been notified of, such
+		 * as by a directory watcher.  Unlike @c Refresh, this is cheap enough
+		 * to call on every frame.
+		 */
+		void Poll();
+
+		/**
+		 * Runs any background loads that were deferred to the main thread.
+		 * This should be called regularly from the main thread.
+		 */
+		void Update() const;
+
 		/*----------------+
 		| resource access |
 		+----------------*/
@@ -97,18 +120,82 @@ namespace page { namespace res
 		template <typename T>
 			std::shared_ptr<const T> Load(const std::string &path) const;
 
+		/**
+		 * Starts loading a resource of the specified type at the given path
+		 * in the background.
+		 *
+		 * @note If the resource is already being loaded, the existing request
+		 *       is shared.
+		 */
+		LoadFuture<void>::Future LoadAsync(const std::type_info &, const std::string &path) const;
+
+		/**
+		 * Starts loading a resource of the specified type at the given path
+		 * in the background.
+		 */
+		template <typename T>
+			LoadFuture<T> LoadAsync(const std::string &path) const;
+
 		/**
 		 * Returns the raw content of a resource as a string.
 		 */
 		std::string LoadString(const std::string &path) const;
 
+		/*----------------+
+		| synchronization |
+		+----------------*/
+
+		private:
+		friend std::shared_ptr<const void> detail::WaitForLoad(const LoadFuture<void>::Future &);
+
+		/**
+		 * Waits for a background load to finish, running any deferred loads
+		 * in the meantime if called from the main thread.
+		 */
+		std::shared_ptr<const void> Wait(const LoadFuture<void>::Future &) const;
+
+		/*---------------+
+		| implementation |
+		+---------------*/
+
+		struct Request;
+		typedef std::deque<std::shared_ptr<Source>> Sources;
+
+		std::shared_ptr<Request> MakeRequest(const std::type_info &, const std::string &normPath) const;
+		std::shared_ptr<const void> LoadFromSources(const std::type_info &, const std::string &normPath) const;
+		bool IsThreadSafe(const std::type_info &, const std::string &normPath) const;
+		Sources GetSources() const;
+
 		/*-------------+
 		| data members |
 		+-------------*/
 
-		private:
-		typedef std::deque<std::shared_ptr<Source>> Sources;
 		Sources sources;
+
+		/**
+		 * The background loads that have not finished yet, keyed by path and
+		 * type name, like @c Source::paths.
+		 */
+		typedef std::pair<std::string, std::string> PendingKey;
+		mutable std::map<PendingKey, std::shared_ptr<Request>> pending;
+
+		/**
+		 * The background loads that must be run on the main thread.
+		 */
+		mutable std::deque<std::function<void ()>> deferred;
+
+		/**
+		 * Guards @c sources, @c pending, and @c deferred.
+		 */
+		mutable std::mutex mutex;
+
+		std::thread::id mainThread;
+
+		/**
+		 * @note Must be declared last so that its threads are joined before
+		 *       anything they use is destroyed.
+		 */
+		mutable util::WorkerPool workers;
 	};
 }}
 
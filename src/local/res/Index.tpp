@@ -37,4 +37,9 @@ namespace page { namespace res
 	{
 		return std::static_pointer_cast<const T>(Load(util::GetIncompleteTypeInfo<T>(), path));
 	}
+
+	template <typename T> LoadFuture<T> Index::LoadAsync(const std::string &path) const
+	{
+		return LoadFuture<T>(LoadAsync(util::GetIncompleteTypeInfo<T>(), path));
+	}
 }}
@@ -0,0 +1,107 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_res_LoadFuture_hpp
+#   define page_local_res_LoadFuture_hpp
+
+#	include <future> // shared_future
+#	include <memory> // shared_ptr
+
+namespace page { namespace res
+{
+	namespace detail
+	{
+		/**
+		 * Waits for a resource that is being loaded in the background.
+		 *
+		 * @note On the main thread, any loads that are waiting to be run on
+		 *       the main thread are run while waiting.
+		 */
+		std::shared_ptr<const void> WaitForLoad(const std::shared_future<std::shared_ptr<const void>> &);
+	}
+
+	/**
+	 * A handle to a resource that is being loaded in the background.
+	 *
+	 * @sa Index::LoadAsync
+	 */
+	template <typename T>
+		class LoadFuture
+	{
+		/*-------+
+		| traits |
+		+-------*/
+
+		public:
+		/**
+		 * The type-erased future that is shared by all requests for the
+		 * resource.
+		 */
+		using Future = std::shared_future<std::shared_ptr<const void>>;
+
+		/*-------------+
+		| constructors |
+		+-------------*/
+
+		LoadFuture() = default;
+		explicit LoadFuture(const Future &);
+
+		/*----------+
+		| observers |
+		+----------*/
+
+		/**
+		 * @return @c true if the resource has finished loading, or if it
+		 *         failed to load, in which case Get() will throw.
+		 */
+		bool IsReady() const;
+
+		/**
+		 * Waits for the resource to finish loading.
+		 *
+		 * @sa detail::WaitForLoad
+		 *
+		 * @throw Any exception that was thrown while loading the resource.
+		 */
+		std::shared_ptr<const T> Get() const;
+
+		/**
+		 * @return @c true if the handle refers to a resource.
+		 */
+		explicit operator bool() const noexcept;
+
+		/*-------------+
+		| data members |
+		+-------------*/
+
+		private:
+		Future future;
+	};
+}}
+
+#	include "LoadFuture.tpp"
+#endif
@@ -67,7 +67,7 @@ namespace page
 				Init();
 			}
 			OpenArgs::OpenArgs(std::unique_ptr<Stream> &stream) :
-				stream(std::move(stream)), off(stream->Tell())
+				stream(std::move(stream)), off(this->stream->Tell())
 			{
 				Init();
 			}
@@ -82,6 +82,15 @@ namespace page
 
 			void OpenArgs::Init()
 			{
+				// let FreeType read mapped streams in place
+				if (const char *data = stream->GetData())
+				{
+					args.flags = FT_OPEN_MEMORY;
+					args.memory_base = reinterpret_cast<const FT_Byte *>(data) + off;
+					args.memory_size = stream->Size() - off;
+					args.stream = 0;
+					return;
+				}
 				args.flags = FT_OPEN_STREAM;
 				args.stream = new FT_StreamRec;
 				args.stream->base = 0;
@@ -25,14 +25,137 @@
  * of this software.
  */
 
+#include <cstdint> // uint{16,32}_t
+
 #include <zip.h>
 
-#include "../../err/Exception.hpp
+#include "../../err/Exception.hpp"
+#include "zip.hpp"
 
 namespace page
 {
 	namespace res
 	{
+		namespace
+		{
+			const unsigned
+				localHeaderSize     = 30,
+				centralHeaderSize   = 46,
+				endOfCentralDirSize = 22,
+				maxCommentSize      = 0xffff;
+
+			const std::uint32_t
+				localHeaderSig     = 0x04034b50,
+				centralHeaderSig   = 0x02014b50,
+				endOfCentralDirSig = 0x06054b50;
+
+			const std::uint16_t
+				storedMethod   = 0,
+				deflatedMethod = 8,
+				encryptedFlag  = 0x1;
+
+			inline std::uint16_t Read16(const char *s)
+			{
+				const unsigned char *u = reinterpret_cast<const unsigned char *>(s);
+				return u[0] | u[1] << 8;
+			}
+			inline std::uint32_t Read32(const char *s)
+			{
+				return Read16(s) | std::uint32_t(Read16(s + 2)) << 16;
+			}
+		}
+
+		// archive
+		ZipArchive::ZipArchive(const std::string &path)
+		{
+			int ze = 0;
+			if (!(handle = zip_open(path.c_str(), 0, &ze))) ZipError(ze);
+#if defined USE_POSIX || defined USE_WIN32
+			// NOTE: if the archive can't be mapped, all of its entries will
+			// be read through libzip
+			try
+			{
+				mapping = sys::MapFile(path);
+			}
+			catch (const std::exception &) {}
+			IndexEntries();
+#endif
+		}
+		ZipArchive::~ZipArchive()
+		{
+			// NOTE: nothing has been written, so there is nothing to report
+			zip_discard(handle);
+		}
+
+		const ZipArchive::Entry *ZipArchive::GetEntry(int index) const
+		{
+			return
+				index >= 0 && static_cast<unsigned>(index) < entries.size() && entries[index].size != -1u ?
+				&entries[index] : nullptr;
+		}
+
+		void ZipArchive::IndexEntries()
+		{
+			const char *data = mapping.data.get();
+			if (!data || mapping.size < endOfCentralDirSize) return;
+
+			// find end of central directory, which is followed by a comment
+			const char *end = data + mapping.size;
+			const char *eocd = end - endOfCentralDirSize;
+			for (;; --eocd)
+			{
+				if (Read32(eocd) == endOfCentralDirSig &&
+					eocd + endOfCentralDirSize + Read16(eocd + 20) == end) break;
+				if (eocd == data || end - eocd >= endOfCentralDirSize + maxCommentSize) return;
+			}
+			unsigned count  = Read16(eocd + 10);
+			unsigned offset = Read32(eocd + 16);
+			if (offset > mapping.size) return;
+
+			// NOTE: libzip indexes entries in the order of the central
+			// directory; any entry that we can't read directly (including
+			// ZIP64 and encrypted entries) is marked by a size of -1
+			Entry unreadable = {false, 0, 0, -1u};
+			entries.assign(count, unreadable);
+			const char *header = data + offset;
+			for (unsigned i = 0; i < count; ++i)
+			{
+				if (end - header < centralHeaderSize ||
+					Read32(header) != centralHeaderSig) break;
+				std::uint16_t
+					flags  = Read16(header + 8),
+					method = Read16(header + 10),
+					nameSize    = Read16(header + 28),
+					extraSize   = Read16(header + 30),
+					commentSize = Read16(header + 32);
+				std::uint32_t
+					compressedSize = Read32(header + 20),
+					size           = Read32(header + 24),
+					localOffset    = Read32(header + 42);
+				header += centralHeaderSize + nameSize + extraSize + commentSize;
+
+				if (flags & encryptedFlag ||
+					(method != storedMethod && method != deflatedMethod) ||
+					compressedSize == 0xffffffff || size == 0xffffffff ||
+					localOffset >= mapping.size ||
+					mapping.size - localOffset < localHeaderSize) continue;
+				const char *local = data + localOffset;
+				if (Read32(local) != localHeaderSig) continue;
+				std::uint32_t dataOffset = localOffset + localHeaderSize +
+					Read16(local + 26) + Read16(local + 28);
+				if (dataOffset > mapping.size ||
+					mapping.size - dataOffset < compressedSize ||
+					(method == storedMethod && compressedSize != size)) continue;
+
+				Entry &entry(entries[i]);
+				entry.deflated       = method == deflatedMethod;
+				entry.offset         = dataOffset;
+				entry.compressedSize = compressedSize;
+				entry.size           = size;
+			}
+		}
+
+		// error handling
 		void ZipError(int ze, int se)
 		{
 			switch (ze)
@@ -44,7 +167,7 @@ namespace page
 			}
 			std::string s(zip_error_to_str(0, 0, ze, se), '\0');
 			zip_error_to_str(&*s.begin(), s.size(), ze, se);
-			THROW((err::Exception<err::ResModuleTag, err::ZipPlatformTag>(s))))
+			THROW((err::Exception<err::ResModuleTag, err::ZipPlatformTag>(s)))
 		}
 		void ZipError(zip *archive)
 		{
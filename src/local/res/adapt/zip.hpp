@@ -29,13 +29,64 @@
 #   define page_local_res_adapt_zip_hpp
 
 #	include <cerrno>
+#	include <mutex>
+#	include <string>
+#	include <vector>
 
 #	include <zip.h> // zip, zip_file
 
+#	include "../../sys/mapping.hpp" // FileMapping
+#	include "../../util/class/special_member_functions.hpp" // DEFINE_COPY
+
 namespace page
 {
 	namespace res
 	{
+		/**
+		 * An open ZIP archive, which is shared by the pipes of a source so
+		 * that their streams don't have to reopen it.
+		 *
+		 * @note libzip handles are not thread-safe, so any use of the handle,
+		 *       or of a file that was opened from it, must be serialized with
+		 *       @c mutex.
+		 */
+		struct ZipArchive
+		{
+			explicit ZipArchive(const std::string &path);
+			~ZipArchive();
+
+			DEFINE_COPY(ZipArchive, delete)
+
+			/**
+			 * The location of an entry's data within the mapped archive.
+			 */
+			struct Entry
+			{
+				bool deflated;
+				unsigned offset, compressedSize, size;
+			};
+
+			/**
+			 * @return The entry, if its data can be read directly from the
+			 *         mapped archive, or @c nullptr if it must be read
+			 *         through libzip.
+			 */
+			const Entry *GetEntry(int index) const;
+
+			zip *handle;
+			std::mutex mutex;
+
+			/**
+			 * The contents of the archive, if it could be mapped into memory.
+			 */
+			sys::FileMapping mapping;
+
+			private:
+			void IndexEntries();
+
+			std::vector<Entry> entries;
+		};
+
 		void ZipError(int ze, int se = errno);
 		void ZipError(zip *);
 		void ZipError(zip_file *);
@@ -25,18 +25,30 @@
  * of this software.
  */
 
+#include <algorithm> // max
 #include <cassert>
 #include <functional> // bind
 #include <iostream> // cout
 
 #include "../../cfg/vars.hpp"
 #include "../../err/Exception.hpp"
+#include "../../err/report.hpp" // ReportError, std::exception
+#include "../../log/Indenter.hpp"
 #include "../type/Image.hpp"
 #include "Encoder.hpp"
 #include "Stream.hpp"
 
 namespace page { namespace res { namespace clip
 {
+	namespace
+	{
+		/**
+		 * The number of encoded chunks that can be waiting to be written to
+		 * the file.
+		 */
+		const unsigned outputQueueDepth = 16;
+	}
+
 	/*-------------+
 	| constructors |
 	+-------------*/
@@ -46,8 +58,12 @@ namespace page { namespace res { namespace clip
 		const std::string &format,
 		const math::Vec2u &size,
 		float frameRate,
-		float quality) :
-			size(size)
+		float quality,
+		unsigned queueDepth,
+		bool dropFrames) :
+			size(size), dropFrames(dropFrames),
+			frames(std::max(queueDepth, 1u)),
+			output(outputQueueDepth)
 	{
 		// select the closest-matching encoder
 		std::string encoderPath(path);
@@ -74,14 +90,68 @@ namespace page { namespace res { namespace clip
 			remove(encoderPath);
 			throw;
 		}
+
+		// NOTE: the headers that the encoder wrote when it was created are
+		// flushed by the encoder thread
+		try
+		{
+			encoderThread = std::thread(&Stream::RunEncoder, this);
+			outputThread  = std::thread(&Stream::RunOutput,  this);
+		}
+		catch (...)
+		{
+			// stop the encoder thread if it was started, since destroying
+			// a thread that is still joinable terminates the program
+			if (encoderThread.joinable())
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					done = true;
+				}
+				changed.notify_all();
+				encoderThread.join();
+			}
+			fs.close();
+			remove(encoderPath);
+			throw;
+		}
 	}
 
 	Stream::~Stream()
 	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			done = true;
+		}
+		changed.notify_all();
+		encoderThread.join();
+		outputThread.join();
+
+		// the destructor can't throw, so report any error that happened
+		// while the remaining frames were being encoded and written
+		if (error)
+		{
+			try
+			{
+				std::rethrow_exception(error);
+			}
+			catch (const std::exception &e)
+			{
+				err::ReportError(e);
+			}
+			catch (...) {}
+		}
+
 		// print statistics
 		if (*CVAR(logVerbose))
 		{
-			// FIXME: implement
+			std::cout << "clip stream statistics" << std::endl;
+			log::Indenter indenter;
+			std::cout << "encoded frames: "  << GetEncodedFrameCount() << std::endl;
+			std::cout << "dropped frames: "  << GetDroppedFrameCount() << std::endl;
+			std::cout << "max queue depth: " << GetMaxQueueDepth()     << std::endl;
+			std::cout << "encode latency: "  << GetAverageEncodeLatency() * 1000 << "ms average, " <<
+				GetMaxEncodeLatency() * 1000 << "ms max" << std::endl;
 		}
 	}
 
@@ -94,15 +164,79 @@ namespace page { namespace res { namespace clip
 		return size;
 	}
 
+	/*-----------+
+	| statistics |
+	+-----------*/
+
+	unsigned Stream::GetQueueDepth() const
+	{
+		return frames.GetSize();
+	}
+
+	unsigned Stream::GetMaxQueueDepth() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return maxQueueDepth;
+	}
+
+	unsigned Stream::GetEncodedFrameCount() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return encodedFrames;
+	}
+
+	unsigned Stream::GetDroppedFrameCount() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return droppedFrames;
+	}
+
+	float Stream::GetAverageEncodeLatency() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return encodedFrames ? totalEncodeLatency / encodedFrames : 0;
+	}
+
+	float Stream::GetMaxEncodeLatency() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return maxEncodeLatency;
+	}
+
 	/*------------------+
 	| audio/video input |
 	+------------------*/
 
 	void Stream::Write(const res::Image &img)
 	{
+		CheckError();
+		Frame *frame;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (!(frame = frames.GetWriteSlot()))
+			{
+				if (dropFrames)
+				{
+					++droppedFrames;
+					return;
+				}
+				changed.wait(lock, [this, &frame] { return error || (frame = frames.GetWriteSlot()); });
+				if (error) std::rethrow_exception(error);
+			}
+		}
+
 		// FIXME: crop to size
 		// FIXME: convert to packed RGB8 format
-		encoder->Write(&*img.data.begin(), img.data.size());
+		// NOTE: the slot keeps its buffer, so this only allocates for the
+		// first few frames
+		frame->data.assign(img.data.begin(), img.data.end());
+		frame->writeTime = Clock::now();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			frames.Push();
+			maxQueueDepth = std::max<unsigned>(maxQueueDepth, frames.GetSize());
+		}
+		changed.notify_all();
 	}
 
 	/*---------------+
@@ -111,7 +245,109 @@ namespace page { namespace res { namespace clip
 
 	void Stream::WriteEncoded(const void *s, unsigned n)
 	{
-		if (!fs.write(static_cast<const char *>(s), n))
-			THROW((err::Exception<err::ClipModuleTag, err::FileWriteTag>()))
+		encoded.insert(encoded.end(),
+			static_cast<const char *>(s),
+			static_cast<const char *>(s) + n);
+	}
+
+	void Stream::FlushEncoded()
+	{
+		if (encoded.empty()) return;
+		std::vector<char> *chunk;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [this, &chunk] { return error || (chunk = output.GetWriteSlot()); });
+			if (error)
+			{
+				// the output can't be written, so there's no point keeping it
+				encoded.clear();
+				return;
+			}
+		}
+		// NOTE: swapping hands the slot's old buffer back to the encoder
+		chunk->swap(encoded);
+		encoded.clear();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			output.Push();
+		}
+		changed.notify_all();
+	}
+
+	/*--------+
+	| threads |
+	+--------*/
+
+	void Stream::RunEncoder()
+	{
+		try
+		{
+			for (;;)
+			{
+				FlushEncoded();
+				Frame *frame;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					changed.wait(lock, [this, &frame] { return (frame = frames.GetReadSlot()) || done; });
+					if (!frame) break;
+				}
+				encoder->Write(&*frame->data.begin(), frame->data.size());
+				double latency = std::chrono::duration<double>(Clock::now() - frame->writeTime).count();
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					frames.Pop();
+					++encodedFrames;
+					totalEncodeLatency += latency;
+					maxEncodeLatency = std::max(maxEncodeLatency, latency);
+				}
+				changed.notify_all();
+			}
+
+			// destroy the encoder here, since it may write the last frame
+			encoder.reset();
+			FlushEncoded();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error) error = std::current_exception();
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			encoderDone = true;
+		}
+		changed.notify_all();
+	}
+
+	void Stream::RunOutput()
+	{
+		for (;;)
+		{
+			std::vector<char> *chunk;
+			bool failed;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				changed.wait(lock, [this, &chunk] { return (chunk = output.GetReadSlot()) || encoderDone; });
+				if (!chunk) return;
+				failed = bool(error);
+			}
+			if (!failed && !fs.write(&*chunk->begin(), chunk->size()))
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!error)
+					error = std::make_exception_ptr(err::Exception<err::ClipModuleTag, err::FileWriteTag>());
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				output.Pop();
+			}
+			changed.notify_all();
+		}
+	}
+
+	void Stream::CheckError()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (error) std::rethrow_exception(error);
 	}
 }}}
@@ -28,13 +28,19 @@
 #ifndef    page_local_res_clip_Stream_hpp
 #   define page_local_res_clip_Stream_hpp
 
+#	include <chrono> // steady_clock
+#	include <condition_variable>
+#	include <exception> // exception_ptr
 #	include <fstream> // ofstream
 #	include <memory> // unique_ptr
+#	include <mutex>
 #	include <string>
+#	include <thread>
 #	include <vector>
 
 #	include "../../math/Vector.hpp"
 #	include "../../util/class/special_member_functions.hpp" // Uncopyable
+#	include "../../util/container/SpscRing.hpp"
 
 namespace page { namespace res { class Image; }}
 
@@ -45,6 +51,11 @@ namespace page { namespace res { namespace clip
 	/**
 	 * An output stream for encoding and writing a clip to a file.
 	 *
+	 * Frames are copied into a bounded queue of recycled buffers, and then
+	 * converted and encoded on a background thread, while the encoded output
+	 * is written to the file on another thread, so that recording doesn't
+	 * stall the thread that renders the frames.
+	 *
 	 * @fixme This class could be made copyable by storing the encoder in a @c
 	 *        std::shared_ptr, which would only make sense if the encoder didn't
 	 *        maintain any output state.
@@ -56,13 +67,25 @@ namespace page { namespace res { namespace clip
 		+-------------*/
 
 		public:
+		/**
+		 * @param queueDepth The number of frames that can be waiting to be
+		 *        encoded.
+		 * @param dropFrames If @c true, frames that are written while the
+		 *        queue is full are dropped.  Otherwise, Write() waits for the
+		 *        encoder to catch up.
+		 */
 		Stream(
 			const std::string &path,
 			const std::string &format,
 			const math::Vec2u &size,
 			float frameRate,
-			float quality);
+			float quality,
+			unsigned queueDepth = 8,
+			bool dropFrames = false);
 
+		/**
+		 * Encodes and writes any queued frames before closing the file.
+		 */
 		~Stream();
 
 		/*-----------+
@@ -72,11 +95,56 @@ namespace page { namespace res { namespace clip
 		public:
 		const math::Vec2u &GetSize() const;
 
+		/*-----------+
+		| statistics |
+		+-----------*/
+
+		public:
+		/**
+		 * Returns the number of frames that are waiting to be encoded.
+		 */
+		unsigned GetQueueDepth() const;
+
+		/**
+		 * Returns the largest number of frames that have been waiting to be
+		 * encoded at one time.
+		 */
+		unsigned GetMaxQueueDepth() const;
+
+		/**
+		 * Returns the number of frames that have been encoded.
+		 */
+		unsigned GetEncodedFrameCount() const;
+
+		/**
+		 * Returns the number of frames that have been dropped because the
+		 * queue was full.
+		 */
+		unsigned GetDroppedFrameCount() const;
+
+		/**
+		 * Returns the average time, in seconds, from when a frame is written
+		 * to when it has been encoded.
+		 */
+		float GetAverageEncodeLatency() const;
+
+		/**
+		 * Returns the longest time, in seconds, from when a frame was written
+		 * to when it had been encoded.
+		 */
+		float GetMaxEncodeLatency() const;
+
 		/*------------------+
 		| audio/video input |
 		+------------------*/
 
 		public:
+		/**
+		 * Queues a frame to be encoded.
+		 *
+		 * @throw err::Exception<err::ClipModuleTag, err::FileWriteTag> if
+		 *        the encoded output of an earlier frame couldn't be written.
+		 */
 		void Write(const res::Image &);
 
 		/*---------------+
@@ -84,16 +152,88 @@ namespace page { namespace res { namespace clip
 		+---------------*/
 
 		private:
+		/**
+		 * Collects the output of the encoder, which is handed to the output
+		 * thread after each frame.
+		 */
 		void WriteEncoded(const void *, unsigned);
 
+		/**
+		 * Hands the collected output of the encoder to the output thread.
+		 */
+		void FlushEncoded();
+
+		/*--------+
+		| threads |
+		+--------*/
+
+		private:
+		/**
+		 * Converts and encodes the queued frames.
+		 */
+		void RunEncoder();
+
+		/**
+		 * Writes the encoded output to the file.
+		 */
+		void RunOutput();
+
+		/**
+		 * Rethrows the first error that occurred on one of the threads.
+		 */
+		void CheckError();
+
 		/*-------------+
 		| data members |
 		+-------------*/
 
 		private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Frame
+		{
+			std::vector<unsigned char> data;
+			Clock::time_point writeTime;
+		};
+
 		math::Vec2u size;
 		std::ofstream fs;
 		std::unique_ptr<Encoder> encoder;
+		bool dropFrames;
+
+		/**
+		 * The frames waiting to be encoded, whose buffers are reused.
+		 */
+		util::SpscRing<Frame> frames;
+
+		/**
+		 * The encoded output waiting to be written, whose buffers are
+		 * reused.
+		 */
+		util::SpscRing<std::vector<char>> output;
+
+		/**
+		 * The output of the encoder for the current frame, which is only
+		 * accessed by the encoder thread.
+		 */
+		std::vector<char> encoded;
+
+		// statistics
+		unsigned maxQueueDepth = 0;
+		unsigned encodedFrames = 0;
+		unsigned droppedFrames = 0;
+		double totalEncodeLatency = 0;
+		double maxEncodeLatency = 0;
+
+		// synchronization
+		mutable std::mutex mutex;
+		std::condition_variable changed;
+		std::exception_ptr error;
+		bool done = false, encoderDone = false;
+
+		// NOTE: started at the end of the constructor, once the encoder
+		// has been created
+		std::thread encoderThread, outputThread;
 	};
 }}}
 
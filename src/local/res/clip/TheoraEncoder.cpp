@@ -25,9 +25,11 @@
  * of this software.
  */
 
+#include <algorithm> // min
 #include <cstdlib> // {,s}rand
 #include <ctime> // time
 
+#include "../../cfg/vars.hpp"
 #include "../../err/Exception.hpp"
 #include "../../math/algorithm.hpp" // RgbToYcbcr420
 #include "../../util/cpp.hpp" // STRINGIZE
@@ -36,6 +38,15 @@
 
 namespace page { namespace res { namespace clip
 {
+	namespace
+	{
+		/**
+		 * The number of pairs of rows to convert in each job when the
+		 * conversion is split between threads.
+		 */
+		const std::size_t rowPairsPerJob = 32;
+	}
+
 	/*-------------+
 	| constructors |
 	+-------------*/
@@ -44,6 +55,9 @@ namespace page { namespace res { namespace clip
 		Encoder(cb, Content(size) * 3),
 		size(size), size16((size + 15) & ~0xfu), offset((size16 - size) / 2)
 	{
+		if (*CVAR(clipThreads))
+			workers.reset(new util::WorkerPool(*CVAR(clipThreads)));
+
 		// initialize ogg stream
 		std::srand(std::time(0));
 		if (ogg_stream_init(&os, std::rand()))
@@ -168,12 +182,29 @@ namespace page { namespace res { namespace clip
 		math::Vec2u
 			halfSize16(size16 / 2),
 			halfOffset(offset / 2);
-		math::RgbToYcbcr420(
-			static_cast<const unsigned char *>(s),
-			tb.y + offset.y * size16.x + offset.x,
-			tb.u + halfOffset.y * halfSize16.x + halfOffset.x,
-			tb.v + halfOffset.y * halfSize16.x + halfOffset.x,
-			size, size.x * 3, size16.x);
+		const unsigned char *rgb = static_cast<const unsigned char *>(s);
+		unsigned char
+			*y  = tb.y + offset.y * size16.x + offset.x,
+			*cb = tb.u + halfOffset.y * halfSize16.x + halfOffset.x,
+			*cr = tb.v + halfOffset.y * halfSize16.x + halfOffset.x;
+		auto job([&](std::size_t first, std::size_t last)
+		{
+			// NOTE: the image is split into bands of whole pairs of rows,
+			// so that the chroma of each band is independent
+			unsigned
+				row    = first * 2,
+				endRow = std::min<std::size_t>(last * 2, size.y);
+			math::RgbToYcbcr420(
+				rgb + row * size.x * 3,
+				y  + row * size16.x,
+				cb + row / 2 * halfSize16.x,
+				cr + row / 2 * halfSize16.x,
+				math::Vec2u(size.x, endRow - row), size.x * 3, size16.x);
+		});
+		std::size_t rowPairs = (size.y + 1) / 2;
+		if (workers && rowPairs > rowPairsPerJob)
+			workers->ParallelFor(rowPairs, rowPairsPerJob, job);
+		else job(0, rowPairs);
 	}
 
 	void TheoraEncoder::EncodeBuffer(bool lastFrame)
@@ -28,11 +28,13 @@
 #ifndef    page_local_res_clip_TheoraEncoder_hpp
 #   define page_local_res_clip_TheoraEncoder_hpp
 
+#	include <memory> // unique_ptr
 #	include <vector>
 
 #	include <theora/theora.h>
 
 #	include "../../math/Vector.hpp"
+#	include "../../util/thread/WorkerPool.hpp"
 #	include "Encoder.hpp"
 
 namespace page { namespace res { namespace clip
@@ -77,6 +79,12 @@ namespace page { namespace res { namespace clip
 		yuv_buffer tb;
 		std::vector<unsigned char> tbData;
 		math::Vec2u size, size16, offset;
+
+		/**
+		 * The threads for converting frames to Y'CbCr, which are only
+		 * created if @c clip.threads is not zero.
+		 */
+		std::unique_ptr<util::WorkerPool> workers;
 	};
 }}}
 
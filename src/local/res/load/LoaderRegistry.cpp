@@ -28,6 +28,7 @@
 #include <algorithm> // lower_bound
 #include <cassert>
 #include <functional> // bind, greater
+#include <unordered_set>
 
 #include <boost/range/adaptor/indirected.hpp>
 
@@ -50,14 +51,16 @@ namespace page { namespace res
 		std::vector<std::string> const& mimeTypes,
 		std::vector<std::string> const& extensions,
 		bool                            inspect,
-		int                             priority) :
+		int                             priority,
+		bool                            threadSafe) :
 			name(name),
 			loader(loader),
 			compatibleFunction(compatibleFunction),
 			mimeTypes(mimeTypes),
 			extensions(extensions),
 			inspect(inspect),
-			priority(priority)
+			priority(priority),
+			threadSafe(threadSafe)
 	{
 		assert(loader             != nullptr);
 		assert(compatibleFunction != nullptr);
@@ -128,15 +131,26 @@ namespace page { namespace res
 	}
 
 	const Loader &LoaderRegistry::GetLoader(const std::type_info &type, const Node &node) const
+	{
+		static const Loader none;
+		auto record(GetRecord(type, node));
+		return record ? record->loader : none;
+	}
+
+	auto LoaderRegistry::GetRecord(const std::type_info &type, const Node &node) const -> const Record *
 	{
 		auto iter(types.find(type));
 		if (iter != types.end())
 		{
 			const auto &typeRecord(iter->second);
 
-			// reset tried flag
-			for (const auto &record : typeRecord.records)
-				record.tried = false;
+			// the loaders that have already been tried
+			// NOTE: kept per call, since this can run on the loader workers
+			std::unordered_set<const Record *> tried;
+			auto Try([&tried](const Record &record)
+			{
+				return tried.insert(&record).second;
+			});
 
 			// try loaders with matching mime type and extension
 			auto extension(util::ToLower(util::GetExtension(node.path)));
@@ -153,10 +167,9 @@ namespace page { namespace res
 				{
 					auto records(boost::adaptors::indirect(iter->second));
 					for (const auto &record : records)
-						if (!record.tried &&
-							(record.tried = true) &&
+						if (Try(record) &&
 							record.compatibleFunction(*node.pipe))
-								return record.loader;
+								return &record;
 
 					THROW((err::Exception<err::ResModuleTag, err::NotFoundTag>("mismatched mime type") <<
 						boost::errinfo_file_name(node.path) <<
@@ -172,10 +185,9 @@ namespace page { namespace res
 				{
 					auto records(boost::adaptors::indirect(iter->second));
 					for (const auto &record : records)
-						if (!record.tried &&
-							(record.tried = true) &&
+						if (Try(record) &&
 							record.compatibleFunction(*node.pipe))
-								return record.loader;
+								return &record;
 
 					THROW((err::Exception<err::ResModuleTag, err::NotFoundTag>("mismatched extension") <<
 						boost::errinfo_file_name(node.path) <<
@@ -187,10 +199,9 @@ namespace page { namespace res
 			if (node.inspect)
 				for (const auto &record : typeRecord.records)
 					if (record.inspect &&
-						!record.tried &&
-						(record.tried = true) &&
+						Try(record) &&
 						record.compatibleFunction(*node.pipe))
-							return record.loader;
+							return &record;
 		}
 
 		return nullptr;
@@ -62,11 +62,6 @@ namespace page { namespace res
 	 */
 	struct LoaderRegistryRecord
 	{
-		/**
-		 * Permits @c LoaderRegistry to access @c tried.
-		 */
-		friend class LoaderRegistry;
-
 		LoaderRegistryRecord(
 			std::string              const& name,
 			Loader                   const& loader,
@@ -74,7 +69,8 @@ namespace page { namespace res
 			std::vector<std::string> const& mimeTypes  = {},
 			std::vector<std::string> const& extensions = {},
 			bool                            inspect    = true,
-			int                             priority   = 0);
+			int                             priority   = 0,
+			bool                            threadSafe = false);
 
 		/**
 		 * The name of the loader.
@@ -113,15 +109,12 @@ namespace page { namespace res
 		 */
 		int priority;
 
-		private:
 		/**
-		 * A marker used when searching for a compatible loader, which will be
-		 * @c true if this loader has already been tried.
-		 *
-		 * @note This member has no definite value outside
-		 *       @c LoaderRegistry::GetLoader.
+		 * @c true if this loader can be run on a background thread, which
+		 * means that it must not depend on any thread-specific state, such
+		 * as a video driver context.
 		 */
-		bool mutable tried;
+		bool threadSafe;
 	};
 
 ////////// LoaderRegistry //////////////////////////////////////////////////////
@@ -165,6 +158,14 @@ namespace page { namespace res
 		 */
 		const Loader &GetLoader(const std::type_info &, const Node &) const;
 
+		/**
+		 * Searches for a loader that is compatible with the given node.
+		 *
+		 * @return The record of a compatible loader, or @c nullptr if none
+		 *         was found.
+		 */
+		const Record *GetRecord(const std::type_info &, const Node &) const;
+
 		private:
 		struct TypeRecord
 		{
@@ -117,5 +117,8 @@ namespace page { namespace res
 		LoadNativeAnimation,
 		CheckNativeAnimation,
 		{"application/x-page-animation"},
-		{"anim", "pageanim"})
+		{"anim", "pageanim"},
+		true, // inspect
+		0,    // priority
+		true) // thread-safe
 }}
@@ -124,5 +124,8 @@ namespace page { namespace res
 		LoadNativeCameraSet,
 		CheckNativeCameraSet,
 		{"application/x-page-camera-set"},
-		{"cam", "pagecam"})
+		{"cam", "pagecam"},
+		true, // inspect
+		0,    // priority
+		true) // thread-safe
 }}
@@ -130,5 +130,8 @@ namespace page { namespace res
 		LoadNativeCharacter,
 		CheckNativeCharacter,
 		{"application/x-page-character"},
-		{"char", "character", "pagechar", "pagecharacter"})
+		{"char", "character", "pagechar", "pagecharacter"},
+		true, // inspect
+		0,    // priority
+		true) // thread-safe
 }}
@@ -51,14 +51,12 @@ namespace page { namespace res
 			try
 			{
 				// map existing characters to glyphs
-				typedef std::unordered_map<char, unsigned> CharGlyphs;
+				typedef std::unordered_map<char32_t, unsigned> CharGlyphs;
 				CharGlyphs charGlyphs;
 				charGlyphs.insert(std::make_pair(0, 0));
-				for (unsigned char code = 32; code < 127; ++code) // ASCII
-				{
-					FT_UInt glyph = FT_Get_Char_Index(face, code);
-					if (glyph) charGlyphs.insert(std::make_pair(code, glyph));
-				}
+				FT_UInt glyphIndex;
+				for (FT_ULong code = FT_Get_First_Char(face, &glyphIndex); glyphIndex; code = FT_Get_Next_Char(face, code, &glyphIndex))
+					if (code >= 32) charGlyphs.insert(std::make_pair(code, glyphIndex));
 				// load glyphs
 				for (CharGlyphs::const_iterator iter(charGlyphs.begin()); iter != charGlyphs.end(); ++iter)
 				{
@@ -144,9 +142,12 @@ namespace page { namespace res
 				// load kernings
 				if (FT_HAS_KERNING(face))
 				{
+					// NOTE: only pairs within ASCII are probed, because
+					// probing every pair in a large character map is quadratic
 					for (CharGlyphs::const_iterator left(charGlyphs.begin()); left != charGlyphs.end(); ++left)
 						for (CharGlyphs::const_iterator right(charGlyphs.begin()); right != charGlyphs.end(); ++right)
 						{
+							if (left->first >= 128 || right->first >= 128) continue;
 							FT_Vector vector;
 							if (FT_Get_Kerning(face, left->second, right->second, FT_KERNING_UNSCALED, &vector))
 								THROW((err::Exception<err::ResModuleTag, err::FreetypePlatformTag>("failed to load kerning")))
@@ -84,9 +84,14 @@ namespace page
 			assert(pipe);
 			const std::unique_ptr<Stream> stream(pipe->Open());
 			// FIXME: check format, perhaps the DTD
-			while (!stream->Eof())
-				XML_ParseBuffer(GetParser(), stream->ReadSome(XML_GetBuffer(GetParser(), bufferSize), bufferSize), false);
-			XML_ParseBuffer(GetParser(), 0, true);
+			if (const char *data = stream->GetData())
+				XML_Parse(GetParser(), data + stream->Tell(), stream->Size() - stream->Tell(), true);
+			else
+			{
+				while (!stream->Eof())
+					XML_ParseBuffer(GetParser(), stream->ReadSome(XML_GetBuffer(GetParser(), bufferSize), bufferSize), false);
+				XML_ParseBuffer(GetParser(), 0, true);
+			}
 			const std::unique_ptr<Model> model(new Model);
 			return model.release();
 		}
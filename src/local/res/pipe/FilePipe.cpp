@@ -25,6 +25,8 @@
  * of this software.
  */
 
+#include <algorithm> // min
+#include <cstring> // memcpy
 #include <fstream>
 
 #include "../../err/Exception.hpp"
@@ -75,7 +77,7 @@ namespace page
 				if (!fs) fs.clear();
 				if (!fs.read(static_cast<char *>(s), n))
 					if (fs.eof())
-						THROW((err::Exception<err::ResModuleTag, err::EndOfFileTag>()))
+						THROW((err::Exception<err::ResModuleTag, err::EndOfStreamTag>()))
 					else
 						THROW((err::Exception<err::ResModuleTag, err::FileReadTag>()))
 			}
@@ -104,13 +106,83 @@ namespace page
 				if (!fs || fs.eof()) fs.clear();
 				if (!fs.seekg(n))
 					if (fs.eof())
-						THROW((err::Exception<err::ResModuleTag, err::EndOfFileTag, err::Tag>()))
+						THROW((err::Exception<err::ResModuleTag, err::EndOfStreamTag, err::Tag>()))
 					else
 						THROW((err::Exception<err::ResModuleTag, err::FileSeekTag, err::Tag>()))
 			}
 		}
 
-		FilePipe::FilePipe(const std::string &path) : path(path) {}
+#if defined USE_POSIX || defined USE_WIN32
+		namespace
+		{
+			/**
+			 * A stream for reading a file that has been mapped into memory.
+			 */
+			struct MappedFileStream : Stream
+			{
+				explicit MappedFileStream(const sys::FileMapping &);
+
+				protected:
+				void DoRead(void *, unsigned);
+				unsigned DoReadSome(void *, unsigned);
+
+				unsigned DoTell() const;
+				unsigned DoSize() const;
+				void DoSeek(unsigned);
+
+				const char *DoGetData() const;
+
+				private:
+				sys::FileMapping mapping;
+				unsigned pos;
+			};
+
+			MappedFileStream::MappedFileStream(const sys::FileMapping &mapping) :
+				mapping(mapping), pos(0) {}
+
+			void MappedFileStream::DoRead(void *s, unsigned n)
+			{
+				unsigned n2 = std::min(mapping.size - pos, n);
+				std::memcpy(s, mapping.data.get() + pos, n2);
+				pos += n2;
+				if (n > n2)
+					THROW((err::Exception<err::ResModuleTag, err::EndOfStreamTag>()))
+			}
+			unsigned MappedFileStream::DoReadSome(void *s, unsigned n)
+			{
+				n = std::min(mapping.size - pos, n);
+				std::memcpy(s, mapping.data.get() + pos, n);
+				pos += n;
+				return n;
+			}
+
+			unsigned MappedFileStream::DoTell() const
+			{
+				return pos;
+			}
+			unsigned MappedFileStream::DoSize() const
+			{
+				return mapping.size;
+			}
+			void MappedFileStream::DoSeek(unsigned n)
+			{
+				if (n > mapping.size)
+				{
+					pos = mapping.size;
+					THROW((err::Exception<err::ResModuleTag, err::EndOfStreamTag>()))
+				}
+				pos = n;
+			}
+
+			const char *MappedFileStream::DoGetData() const
+			{
+				return mapping.data ? mapping.data.get() : "";
+			}
+		}
+#endif
+
+		FilePipe::FilePipe(const std::string &path, bool map) :
+			path(path), map(map) {}
 
 		unsigned FilePipe::Size() const
 		{
@@ -118,6 +190,50 @@ namespace page
 		}
 
 		Stream *FilePipe::MakeStream() const
-			{ return new FileStream(path); }
+		{
+#if defined USE_POSIX || defined USE_WIN32
+			if (lockMapping.data)
+				return new MappedFileStream(lockMapping);
+			if (map)
+			{
+				// NOTE: if the file cannot be mapped, we fall back to reading
+				// it normally, which will report any errors
+				try
+				{
+					return new MappedFileStream(sys::MapFile(path));
+				}
+				catch (const std::exception &) {}
+			}
+#endif
+			return new FileStream(path);
+		}
+
+		bool FilePipe::DoLock(unsigned size)
+		{
+#if defined USE_POSIX || defined USE_WIN32
+			if (map)
+			{
+				if (!lockMapping.data)
+				{
+					try
+					{
+						lockMapping = sys::MapFile(path);
+					}
+					catch (const std::exception &)
+					{
+						return false;
+					}
+				}
+				// NOTE: an empty file has no data to map, so we use the lock
+				// buffer, which will also be empty
+				return lockMapping.data != nullptr;
+			}
+#endif
+			return false;
+		}
+		void FilePipe::DoUnlock()
+		{
+			lockMapping = {};
+		}
 	}
 }
@@ -30,15 +30,28 @@
 
 #	include <string>
 
+#	include "../../sys/mapping.hpp" // FileMapping
 #	include "Pipe.hpp"
 
 namespace page
 {
 	namespace res
 	{
+		/**
+		 * A pipe for streaming a file.
+		 *
+		 * By default, the file is mapped into memory, so that its streams are
+		 * contiguous (see Stream::GetData), and reading and seeking do not
+		 * involve any system calls.  While the pipe is locked, the mapping is
+		 * shared by all of its streams.
+		 */
 		struct FilePipe : Pipe
 		{
-			explicit FilePipe(const std::string &);
+			/**
+			 * @param[in] map Whether to map the file into memory.  If the file
+			 *            cannot be mapped, it will be read normally.
+			 */
+			explicit FilePipe(const std::string &, bool map = true);
 
 			unsigned Size() const;
 
@@ -46,7 +59,16 @@ namespace page
 			Stream *MakeStream() const;
 
 			private:
+			bool DoLock(unsigned size);
+			void DoUnlock();
+
 			std::string path;
+			bool map;
+
+			/**
+			 * The mapping that is kept while the pipe is locked.
+			 */
+			sys::FileMapping lockMapping;
 		};
 	}
 }
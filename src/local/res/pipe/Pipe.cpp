@@ -157,6 +157,11 @@ namespace page
 		// preloading
 		void Pipe::Lock(unsigned size)
 		{
+			if (DoLock(size))
+			{
+				LockBuffer().swap(lockBuffer);
+				return;
+			}
 			LockBuffer::size_type prevLockSize(lockBuffer.size());
 			if (size > prevLockSize)
 			{
@@ -169,8 +174,14 @@ namespace page
 		}
 		void Pipe::Unlock()
 		{
+			DoUnlock();
 			LockBuffer().swap(lockBuffer);
 		}
+		bool Pipe::DoLock(unsigned size)
+		{
+			return false;
+		}
+		void Pipe::DoUnlock() {}
 
 		// pipe locker
 		// constructors
@@ -92,6 +92,14 @@ namespace page
 			protected:
 			virtual Stream *MakeStream() const = 0;
 
+			/**
+			 * Lock the pipe without using the lock buffer, such as by keeping
+			 * the data mapped in memory, or return false to use the lock
+			 * buffer.
+			 */
+			virtual bool DoLock(unsigned size);
+			virtual void DoUnlock();
+
 			private:
 			typedef std::vector<char> LockBuffer;
 			LockBuffer lockBuffer;
@@ -25,7 +25,7 @@
  * of this software.
  */
 
-#include <algorithm> // min
+#include <algorithm> // find_if, min
 #include <cassert>
 #include <cstring> // memcpy
 
@@ -94,6 +94,35 @@ namespace page
 		}
 		std::string Stream::GetLine(char delim)
 		{
+			// parse in place when the stream is contiguous
+			if (delim == '\n' && bufferPos == buffer.size())
+				if (const char *data = DoGetData())
+				{
+					if (eof) return std::string();
+					const char
+						*first = data + DoTell(),
+						*last  = data + DoSize();
+					// skip the rest of a newline sequence
+					if (first != last && (
+						(endl == '\r' && *first == '\n') ||
+						(endl == '\n' && *first == '\r'))) ++first;
+					endl = '\0';
+					const char *end = std::find_if(first, last,
+						[](char c) { return c == '\n' || c == '\r'; });
+					std::string s(first, end);
+					if (end != last)
+					{
+						endl = *end;
+						DoSeek(end + 1 - data);
+					}
+					else
+					{
+						DoSeek(last - data);
+						eof = true;
+					}
+					return s;
+				}
+
 			std::string s;
 			for (char c; (c = GetChar()) != delim && (c || !eof);)
 				s.push_back(c);
@@ -107,6 +136,13 @@ namespace page
 			return s;*/
 			// HACK: although the above implementation is more correct, the
 			// following should be faster in most situations
+			if (bufferPos == buffer.size())
+				if (const char *data = DoGetData())
+				{
+					unsigned pos = DoTell(), size = DoSize();
+					DoSeek(size);
+					return util::NormEndl(std::string(data + pos, data + size));
+				}
 			Buffer buffer(Size());
 			Read(&*buffer.begin(), buffer.size());
 			return util::NormEndl(std::string(buffer.begin(), buffer.end()));
@@ -219,5 +255,15 @@ namespace page
 		{
 			return eof;
 		}
+
+		// contiguous access
+		const char *Stream::GetData() const
+		{
+			return DoGetData();
+		}
+		const char *Stream::DoGetData() const
+		{
+			return nullptr;
+		}
 	}
 }
@@ -72,6 +72,16 @@ namespace page
 			// input state
 			bool Eof() const;
 
+			// contiguous access
+			/**
+			 * Return a pointer to the entire contents of the stream if they
+			 * are held in contiguous memory, so that they can be parsed in
+			 * place without being copied, or nullptr otherwise.
+			 *
+			 * @note The pointer remains valid for the lifetime of the stream.
+			 */
+			const char *GetData() const;
+
 			protected:
 			// input
 			virtual void DoRead(void *, unsigned) = 0;
@@ -82,6 +92,9 @@ namespace page
 			virtual unsigned DoSize() const = 0;
 			virtual void DoSeek(unsigned) = 0;
 
+			// contiguous access
+			virtual const char *DoGetData() const;
+
 			private:
 			typedef std::vector<char> Buffer;
 			Buffer buffer; // for formatted input
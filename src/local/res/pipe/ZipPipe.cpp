@@ -26,13 +26,18 @@
  */
 
 #include <algorithm> // min
+#include <cstring> // memcpy
+#include <mutex> // lock_guard
+#include <vector>
 
 #include <zip.h>
+#ifdef USE_ZLIB
+#	include <zlib.h>
+#endif
 
 #include "../../err/Exception.hpp"
-#include "../../sys/file.hpp" // FileSize
 #include "../../util/container/ScratchBuffer.hpp"
-#include "../adapt/zip.hpp" // ZipError
+#include "../adapt/zip.hpp" // ZipArchive, ZipError
 #include "Stream.hpp"
 #include "ZipPipe.hpp"
 
@@ -40,11 +45,265 @@ namespace page
 {
 	namespace res
 	{
+		namespace detail
+		{
+			/**
+			 * A cache of inflate states at regular intervals through the
+			 * uncompressed data of an entry, which is shared by the streams of
+			 * a pipe.
+			 */
+			struct InflateIndex
+			{
+				explicit InflateIndex(unsigned size);
+
+				unsigned interval;
+#ifdef USE_ZLIB
+				std::mutex mutex;
+				// checkpoints[i] is the state at (i + 1) * interval
+				std::vector<std::shared_ptr<z_stream>> checkpoints;
+#endif
+			};
+
+			InflateIndex::InflateIndex(unsigned size)
+			{
+				// NOTE: each checkpoint costs about 40 KiB (mostly the 32 KiB
+				// window), so we limit how many there can be
+				const unsigned minInterval = 256 * 1024, maxCheckpoints = 32;
+				interval = std::max(minInterval, (size + maxCheckpoints - 1) / maxCheckpoints);
+#ifdef USE_ZLIB
+				checkpoints.resize(size / interval);
+#endif
+			}
+		}
+
 		namespace
 		{
+			/**
+			 * A stream for reading a stored entry directly from the mapped
+			 * archive.
+			 */
+			struct StoredZipStream : Stream
+			{
+				StoredZipStream(const std::shared_ptr<ZipArchive> &, const ZipArchive::Entry &);
+
+				protected:
+				void DoRead(void *, unsigned);
+				unsigned DoReadSome(void *, unsigned);
+
+				unsigned DoTell() const;
+				unsigned DoSize() const;
+				void DoSeek(unsigned);
+
+				const char *DoGetData() const;
+
+				private:
+				std::shared_ptr<ZipArchive> archive;
+				const char *data;
+				unsigned pos, size;
+			};
+
+			StoredZipStream::StoredZipStream(const std::shared_ptr<ZipArchive> &archive, const ZipArchive::Entry &entry) :
+				archive(archive), data(archive->mapping.data.get() + entry.offset),
+				pos(0), size(entry.size) {}
+
+			void StoredZipStream::DoRead(void *s, unsigned n)
+			{
+				unsigned n2 = std::min(size - pos, n);
+				std::memcpy(s, data + pos, n2);
+				pos += n2;
+				if (n > n2)
+					THROW((err::Exception<err::ResModuleTag, err::ZipPlatformTag, err::EndOfStreamTag>()))
+			}
+			unsigned StoredZipStream::DoReadSome(void *s, unsigned n)
+			{
+				n = std::min(size - pos, n);
+				std::memcpy(s, data + pos, n);
+				pos += n;
+				return n;
+			}
+
+			unsigned StoredZipStream::DoTell() const
+			{
+				return pos;
+			}
+			unsigned StoredZipStream::DoSize() const
+			{
+				return size;
+			}
+			void StoredZipStream::DoSeek(unsigned n)
+			{
+				if (n > size)
+				{
+					pos = size;
+					THROW((err::Exception<err::ResModuleTag, err::ZipPlatformTag, err::EndOfStreamTag>()))
+				}
+				pos = n;
+			}
+
+			const char *StoredZipStream::DoGetData() const
+			{
+				return data;
+			}
+
+#ifdef USE_ZLIB
+			/**
+			 * A stream for inflating a deflated entry directly from the mapped
+			 * archive.
+			 */
+			struct DeflatedZipStream : Stream
+			{
+				DeflatedZipStream(const std::shared_ptr<ZipArchive> &, const ZipArchive::Entry &, const std::shared_ptr<detail::InflateIndex> &);
+				~DeflatedZipStream();
+
+				protected:
+				void DoRead(void *, unsigned);
+				unsigned DoReadSome(void *, unsigned);
+
+				unsigned DoTell() const;
+				unsigned DoSize() const;
+				void DoSeek(unsigned);
+
+				private:
+				unsigned Inflate(void *, unsigned);
+				void Checkpoint();
+				void Reset();
+
+				std::shared_ptr<ZipArchive> archive;
+				ZipArchive::Entry entry;
+				std::shared_ptr<detail::InflateIndex> index;
+				z_stream zs;
+				unsigned pos;
+			};
+
+			DeflatedZipStream::DeflatedZipStream(const std::shared_ptr<ZipArchive> &archive, const ZipArchive::Entry &entry, const std::shared_ptr<detail::InflateIndex> &index) :
+				archive(archive), entry(entry), index(index), zs(), pos(0)
+			{
+				// NOTE: ZIP entries are raw deflate streams without headers
+				if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+					THROW((err::Exception<err::ResModuleTag, err::ZlibPlatformTag>()))
+				Reset();
+			}
+			DeflatedZipStream::~DeflatedZipStream()
+			{
+				inflateEnd(&zs);
+			}
+
+			void DeflatedZipStream::DoRead(void *s, unsigned n)
+			{
+				if (Inflate(s, n) < n)
+					THROW((err::Exception<err::ResModuleTag, err::ZlibPlatformTag, err::EndOfStreamTag>()))
+			}
+			unsigned DeflatedZipStream::DoReadSome(void *s, unsigned n)
+			{
+				return Inflate(s, n);
+			}
+
+			unsigned DeflatedZipStream::DoTell() const
+			{
+				return pos;
+			}
+			unsigned DeflatedZipStream::DoSize() const
+			{
+				return entry.size;
+			}
+			void DeflatedZipStream::DoSeek(unsigned n)
+			{
+				unsigned target = std::min(n, entry.size);
+
+				// resume from the nearest checkpoint if it is closer than
+				// where we are now, or if we need to go backwards
+				{
+					std::lock_guard<std::mutex> lock(index->mutex);
+					unsigned i = std::min<unsigned>(target / index->interval, index->checkpoints.size());
+					while (i && !index->checkpoints[i - 1]) --i;
+					unsigned checkpointPos = i * index->interval;
+					if (target < pos || checkpointPos > pos)
+					{
+						if (i)
+						{
+							inflateEnd(&zs);
+							if (inflateCopy(&zs, index->checkpoints[i - 1].get()) != Z_OK)
+							{
+								zs = z_stream();
+								THROW((err::Exception<err::ResModuleTag, err::ZlibPlatformTag>()))
+							}
+							pos = checkpointPos;
+						}
+						else
+						{
+							if (inflateReset(&zs) != Z_OK)
+								THROW((err::Exception<err::ResModuleTag, err::ZlibPlatformTag>()))
+							Reset();
+						}
+					}
+				}
+
+				// inflate the rest of the way
+				// NOTE: zlib reads back-references out of the output buffer,
+				// so the discarded data can't go in a buffer that is shared
+				// with other threads
+				thread_local char discard[16 * 1024];
+				while (pos < target)
+				{
+					unsigned n2 = std::min<unsigned>(target - pos, sizeof discard);
+					if (Inflate(discard, n2) < n2) break;
+				}
+				if (pos < n)
+					THROW((err::Exception<err::ResModuleTag, err::ZlibPlatformTag, err::EndOfStreamTag>()))
+			}
+
+			unsigned DeflatedZipStream::Inflate(void *s, unsigned n)
+			{
+				unsigned total = 0;
+				while (n && pos < entry.size)
+				{
+					// stop at the next checkpoint so that we can record it
+					unsigned next = (pos / index->interval + 1) * index->interval;
+					unsigned n2 = std::min(n, next - pos);
+					zs.next_out  = static_cast<Bytef *>(s);
+					zs.avail_out = n2;
+					int result = inflate(&zs, Z_NO_FLUSH);
+					unsigned inflated = n2 - zs.avail_out;
+					pos   += inflated;
+					total += inflated;
+					s = static_cast<char *>(s) + inflated;
+					n -= inflated;
+					if (result == Z_STREAM_END) break;
+					if (result != Z_OK)
+						THROW((err::Exception<err::ResModuleTag, err::ZlibPlatformTag, err::StreamReadTag>()))
+					if (pos == next) Checkpoint();
+				}
+				return total;
+			}
+
+			void DeflatedZipStream::Checkpoint()
+			{
+				std::lock_guard<std::mutex> lock(index->mutex);
+				unsigned i = pos / index->interval - 1;
+				if (i >= index->checkpoints.size() || index->checkpoints[i]) return;
+				std::shared_ptr<z_stream> checkpoint(new z_stream(),
+					[](z_stream *zs) { inflateEnd(zs); delete zs; });
+				// NOTE: failing to record a checkpoint only costs us speed
+				if (inflateCopy(checkpoint.get(), &zs) == Z_OK)
+					index->checkpoints[i] = checkpoint;
+			}
+
+			void DeflatedZipStream::Reset()
+			{
+				zs.next_in  = reinterpret_cast<Bytef *>(const_cast<char *>(archive->mapping.data.get() + entry.offset));
+				zs.avail_in = entry.compressedSize;
+				pos = 0;
+			}
+#endif
+
+			/**
+			 * A stream for reading an entry through libzip, which is used
+			 * when the archive couldn't be mapped, or when the entry is in a
+			 * format that we don't read directly.
+			 */
 			struct ZipStream : Stream
 			{
-				ZipStream(const std::string &path, int index);
+				ZipStream(const std::shared_ptr<ZipArchive> &, int index);
 				~ZipStream();
 
 				protected:
@@ -58,31 +317,31 @@ namespace page
 				private:
 				void Reset();
 
-				zip *archive;
+				std::shared_ptr<ZipArchive> archive;
 				zip_file *file;
 				int index; // for resetting
 				unsigned pos, size;
 			};
 
-			ZipStream::ZipStream(const std::string &path, int index) :
-				index(index), pos(0)
+			ZipStream::ZipStream(const std::shared_ptr<ZipArchive> &archive, int index) :
+				archive(archive), index(index), pos(0)
 			{
-				int ze = 0;
-				if (!(archive = zip_open(path.c_str(), 0, &ze))) ZipError(ze);
+				std::lock_guard<std::mutex> lock(archive->mutex);
 				struct zip_stat stat;
-				if (zip_stat_index(archive, index, 0, &stat) == -1) ZipError(archive);
+				if (zip_stat_index(archive->handle, index, 0, &stat) == -1) ZipError(archive->handle);
 				size = stat.size;
-				if (!(file = zip_fopen_index(archive, index, 0))) ZipError(archive);
+				if (!(file = zip_fopen_index(archive->handle, index, 0))) ZipError(archive->handle);
 			}
 			ZipStream::~ZipStream()
 			{
+				std::lock_guard<std::mutex> lock(archive->mutex);
 				int ze = zip_fclose(file);
 				if (ze) ZipError(ze);
-				if (zip_close(archive) == -1) ZipError(archive);
 			}
 
 			void ZipStream::DoRead(void *s, unsigned n)
 			{
+				std::lock_guard<std::mutex> lock(archive->mutex);
 				int result = zip_fread(file, s, n);
 				if (result == -1)
 					THROW((err::Exception<err::ResModuleTag, err::ZipPlatformTag, err::StreamReadTag>()))
@@ -92,6 +351,7 @@ namespace page
 			}
 			unsigned ZipStream::DoReadSome(void *s, unsigned n)
 			{
+				std::lock_guard<std::mutex> lock(archive->mutex);
 				int result = zip_fread(file, s, n);
 				if (result == -1)
 					THROW((err::Exception<err::ResModuleTag, err::ZipPlatformTag, err::StreamReadTag>()))
@@ -109,6 +369,7 @@ namespace page
 			}
 			void ZipStream::DoSeek(unsigned n)
 			{
+				std::lock_guard<std::mutex> lock(archive->mutex);
 				if (n < pos) Reset();
 				else n -= pos;
 				while (n)
@@ -128,15 +389,30 @@ namespace page
 			{
 				int ze = zip_fclose(file);
 				if (ze) ZipError(ze);
-				if (!(file = zip_fopen_index(archive, index, 0))) ZipError(archive);
+				if (!(file = zip_fopen_index(archive->handle, index, 0))) ZipError(archive->handle);
 				pos = 0;
 			}
 		}
 
-		ZipPipe::ZipPipe(const std::string &path, int index) :
-			path(path), index(index) {}
+		ZipPipe::ZipPipe(const std::shared_ptr<ZipArchive> &archive, int index) :
+			archive(archive), index(index)
+		{
+			if (const ZipArchive::Entry *entry = archive->GetEntry(index))
+				if (entry->deflated)
+					inflateIndex = std::make_shared<detail::InflateIndex>(entry->size);
+		}
 
 		Stream *ZipPipe::MakeStream() const
-			{ return new ZipStream(path, index); }
+		{
+			if (const ZipArchive::Entry *entry = archive->GetEntry(index))
+			{
+				if (!entry->deflated)
+					return new StoredZipStream(archive, *entry);
+#ifdef USE_ZLIB
+				return new DeflatedZipStream(archive, *entry, inflateIndex);
+#endif
+			}
+			return new ZipStream(archive, index);
+		}
 	}
 }
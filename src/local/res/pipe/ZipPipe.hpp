@@ -28,7 +28,7 @@
 #ifndef    page_local_res_pipe_ZipPipe_hpp
 #   define page_local_res_pipe_ZipPipe_hpp
 
-#	include <string>
+#	include <memory> // shared_ptr
 
 #	include "Pipe.hpp"
 
@@ -36,16 +36,33 @@ namespace page
 {
 	namespace res
 	{
+		struct ZipArchive;
+
+		namespace detail
+		{
+			struct InflateIndex;
+		}
+
+		/**
+		 * A pipe for streaming an entry of a ZIP archive.
+		 *
+		 * If the archive has been mapped into memory, stored entries are read
+		 * directly from the mapping, and deflated entries are inflated from
+		 * it, using checkpoints that are shared by all of the pipe's streams
+		 * so that seeking doesn't have to start over from the beginning.
+		 * Otherwise, the entry is read through libzip.
+		 */
 		struct ZipPipe : Pipe
 		{
-			ZipPipe(const std::string &, int index);
+			ZipPipe(const std::shared_ptr<ZipArchive> &, int index);
 
 			protected:
 			Stream *MakeStream() const;
 
 			private:
-			std::string path;
+			std::shared_ptr<ZipArchive> archive;
 			int index;
+			std::shared_ptr<detail::InflateIndex> inflateIndex;
 		};
 	}
 }
@@ -27,7 +27,7 @@
 
 #include <algorithm> // lower_bound
 #include <cassert>
-#include <functional> // bind, greater
+#include <functional> // bind, greater, hash
 
 #include <boost/range/adaptor/indirected.hpp>
 
@@ -135,6 +135,14 @@ namespace page { namespace res
 		}
 	}
 
+	std::size_t ScannerRegistry::GetHash() const
+	{
+		std::string names;
+		for (const auto &record : records)
+			names.append(record.name).push_back('\0');
+		return std::hash<std::string>()(names);
+	}
+
 	bool ScannerRegistry::Scan(const Node &node, const ScanCallback &callback) const
 	{
 		/* Lock the pipe for efficiency, since we're going to be repeatedly
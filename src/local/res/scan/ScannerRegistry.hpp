@@ -139,6 +139,13 @@ namespace page { namespace res
 		template <typename... RecordArgs>
 			void Register(RecordArgs &&...);
 
+		/**
+		 * @return A hash of the names of the registered scanners, which
+		 *         changes when the set of scanners changes, such as when
+		 *         building with a different set of libraries.
+		 */
+		std::size_t GetHash() const;
+
 		private:
 		/**
 		 * @copydoc Register
@@ -26,10 +26,12 @@
  */
 
 #include <functional> // bind
-#include <regex>
+#include <unordered_set>
+#include <vector>
 
 #include "../../err/Exception.hpp"
-#include "../../sys/file.hpp" // {Abs,Cat,Norm}Path, IsDir, ModTime, WalkDir
+#include "../../sys/file.hpp" // {Abs,Cat,Norm}Path, FileSize, Is{Dir,File}, ModTime, WalkDir
+#include "../../sys/watch.hpp" // DirectoryChange, WatchDirectory
 #include "../node/path.hpp" // NormPath
 #include "../pipe/FilePipe.hpp" // FilePipe::{,~}FilePipe
 #include "DirectorySource.hpp"
@@ -40,6 +42,9 @@ namespace page { namespace res
 	// construct
 	DirectorySource::DirectorySource(const std::string &path) : path(path)
 	{
+		// NOTE: the watcher is started first so that changes made while
+		// the tree is being indexed aren't missed
+		watcher = sys::WatchDirectory(path);
 		sys::WalkDir(path, std::bind(&DirectorySource::IndexFile, this, std::placeholders::_1));
 	}
 
@@ -52,6 +57,11 @@ namespace page { namespace res
 	// modifiers
 	void DirectorySource::Refresh()
 	{
+		if (watcher)
+		{
+			Poll();
+			return;
+		}
 		for (Files::iterator fileIter(files.begin()); fileIter != files.end();)
 		{
 			const std::string &path(fileIter->first);
@@ -74,16 +84,79 @@ namespace page { namespace res
 		}
 	}
 
+	void DirectorySource::Poll()
+	{
+		if (!watcher) return;
+		std::vector<sys::DirectoryChange> changes;
+		if (!watcher->Poll(changes))
+		{
+			// some changes were lost, so check the whole tree
+			changes.clear();
+			changes.push_back(sys::DirectoryChange{"", true});
+		}
+		if (changes.empty()) return;
+
+		// gather the affected files
+		std::unordered_set<std::string> dirty;
+		for (const auto &change : changes)
+		{
+			std::string resPath(NormPath(change.path));
+			if (change.directory)
+			{
+				// files that were in the directory
+				std::string prefix(resPath.empty() ? resPath : resPath + '/');
+				for (const auto &file : files)
+					if (!file.first.compare(0, prefix.size(), prefix))
+						dirty.insert(file.first);
+				// files that are in the directory now
+				std::string absPath(sys::CatPath(this->path, change.path));
+				if (sys::IsDir(absPath))
+					sys::WalkDir(absPath, [&](const std::string &path)
+					{
+						dirty.insert(NormPath(sys::CatPath(change.path, path)));
+					});
+			}
+			else dirty.insert(resPath);
+		}
+
+		// update the affected files
+		for (const auto &path : dirty)
+			UpdateFile(path);
+	}
+
 	// indexing
 	void DirectorySource::IndexFile(const std::string &path)
 	{
 		std::string resPath(NormPath(path));
 		std::string absPath(sys::CatPath(this->path, path));
-		Index(Node(std::shared_ptr<Pipe>(new FilePipe(absPath)), resPath));
 		// store file information
 		File file = {absPath, sys::ModTime(absPath)};
+		IndexCache::Stamp stamp = {file.mtime, sys::FileSize(absPath), 0};
+		Index(Node(std::shared_ptr<Pipe>(new FilePipe(absPath)), resPath), absPath, stamp);
 		files.insert(std::make_pair(resPath, File())).first->second = file;
 	}
 
+	void DirectorySource::UpdateFile(const std::string &path)
+	{
+		Files::iterator fileIter(files.find(path));
+		std::string absPath(sys::CatPath(this->path, path));
+		try
+		{
+			if (sys::IsFile(absPath))
+			{
+				if (fileIter != files.end()) Clear(path);
+				IndexFile(path);
+				return;
+			}
+		}
+		catch (const err::Exception<err::FileTag>::Permutation &) {}
+		// the file no longer exists
+		if (fileIter != files.end())
+		{
+			Clear(path);
+			files.erase(fileIter);
+		}
+	}
+
 	REGISTER_SOURCE(DirectorySource)
 }}
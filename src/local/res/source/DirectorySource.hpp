@@ -28,8 +28,10 @@
 #ifndef    page_local_res_source_DirectorySource_hpp
 #   define page_local_res_source_DirectorySource_hpp
 
+#	include <memory> // unique_ptr
 #	include <unordered_map>
 
+#	include "../../sys/watch.hpp" // DirectoryWatcher
 #	include "Source.hpp"
 
 namespace page { namespace res
@@ -43,11 +45,18 @@ namespace page { namespace res
 
 		// modifiers
 		void Refresh();
+		void Poll();
 
 		private:
 		// indexing
 		void IndexFile(const std::string &path);
 
+		/**
+		 * Re-indexes a file that was created or modified, or removes it
+		 * from the index if it no longer exists.
+		 */
+		void UpdateFile(const std::string &path);
+
 		std::string path;
 		struct File
 		{
@@ -56,6 +65,13 @@ namespace page { namespace res
 		};
 		typedef std::unordered_map<std::string, File> Files;
 		Files files;
+
+		/**
+		 * The subscription to changes in the directory tree, or @c nullptr
+		 * if the platform doesn't support it, in which case the files are
+		 * checked on each refresh.
+		 */
+		std::unique_ptr<sys::DirectoryWatcher> watcher;
 	};
 }}
 
@@ -25,7 +25,7 @@
  * of this software.
  */
 
-#include "../../sys/file.hpp" // {Abs,Norm}Path, IsFile, ModTime
+#include "../../sys/file.hpp" // {Abs,Norm}Path, FileSize, IsFile, ModTime
 #include "../pipe/FilePipe.hpp" // FilePipe::{{,~}FilePipe}
 #include "FileSource.hpp"
 #include "register.hpp" // REGISTER_SOURCE
@@ -54,8 +54,9 @@ namespace page { namespace res
 
 	void FileSource::Index()
 	{
-		Source::Index(Node(std::shared_ptr<Pipe>(new FilePipe(path))));
 		mtime = sys::ModTime(path);
+		IndexCache::Stamp stamp = {mtime, sys::FileSize(path), 0};
+		Source::Index(Node(std::shared_ptr<Pipe>(new FilePipe(path))), path, stamp);
 	}
 
 	REGISTER_SOURCE(FileSource)
@@ -0,0 +1,232 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // all_of, count_if
+#include <cstdio> // rename
+#include <cstring> // memcmp
+#include <fstream> // [io]fstream
+#include <functional> // hash
+#include <iostream> // cout
+
+#include "../../cfg/vars.hpp"
+#include "../scan/ScannerRegistry.hpp"
+#include "IndexCache.hpp"
+
+namespace page { namespace res
+{
+	namespace
+	{
+		/**
+		 * The signature at the start of the file.
+		 */
+		const char signature[8] = {'P', 'A', 'G', 'E', 'I', 'D', 'X', '\0'};
+
+		/**
+		 * The version of the file, which follows the signature.  It must be
+		 * incremented whenever the layout of the file or the way that nodes
+		 * are classified changes, so that older files are discarded.
+		 */
+		const std::uint32_t version = 2;
+
+		/**
+		 * Returns a hash of the registered scanners, which determines which
+		 * nodes were found inside other nodes when the records were made.
+		 */
+		std::uint64_t GetScannersHash()
+		{
+			return GLOBAL(ScannerRegistry).GetHash();
+		}
+
+		/**
+		 * Returns a hash of @c resource.excludes, which determines which
+		 * nodes were excluded when the records were made.
+		 */
+		std::uint64_t GetExcludesHash()
+		{
+			std::string patterns;
+			for (const auto &filter : *CVAR(resourceExcludes))
+				patterns.append(filter.str()).push_back('\0');
+			return std::hash<std::string>()(patterns);
+		}
+
+		template <typename T>
+			bool Read(std::istream &is, T &value)
+		{
+			return is.read(reinterpret_cast<char *>(&value), sizeof value).good();
+		}
+
+		template <typename T>
+			void Write(std::ostream &os, const T &value)
+		{
+			os.write(reinterpret_cast<const char *>(&value), sizeof value);
+		}
+	}
+
+	/*-------------+
+	| constructors |
+	+-------------*/
+
+	IndexCache::IndexCache()
+	{
+		if (!CVAR(resourceIndexPath)->empty())
+			Load(*CVAR(resourceIndexPath));
+	}
+
+	/*-------+
+	| access |
+	+-------*/
+
+	bool IndexCache::Find(const std::string &key, const Stamp &stamp, Result &result) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto iter(records.find(key));
+		if (iter == records.end()) return false;
+		const Record &record(iter->second);
+		if (record.stamp.mtime != stamp.mtime ||
+			record.stamp.size  != stamp.size  ||
+			record.stamp.crc   != stamp.crc) return false;
+		record.live = true;
+		result = record.result;
+		return true;
+	}
+
+	void IndexCache::Store(const std::string &key, const Stamp &stamp, Result result)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		records[key] = Record{stamp, result, true};
+		dirty = true;
+	}
+
+	void IndexCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		records.clear();
+		dirty = false;
+	}
+
+	/*--------------+
+	| serialization |
+	+--------------*/
+
+	void IndexCache::Load(const std::string &path)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		records.clear();
+		dirty = false;
+
+		std::ifstream fs(path, std::ios_base::binary);
+		if (!fs) return;
+
+		// check header
+		char sig[sizeof signature];
+		std::uint32_t fileVersion;
+		std::uint64_t scannersHash, excludesHash, size;
+		if (!fs.read(sig, sizeof sig) ||
+			std::memcmp(sig, signature, sizeof sig) ||
+			!Read(fs, fileVersion)  || fileVersion  != version ||
+			!Read(fs, scannersHash) || scannersHash != GetScannersHash() ||
+			!Read(fs, excludesHash) || excludesHash != GetExcludesHash() ||
+			!Read(fs, size)) return;
+
+		// read records
+		records.reserve(size);
+		for (std::uint64_t i = 0; i < size; ++i)
+		{
+			std::uint32_t keySize;
+			if (!Read(fs, keySize)) break;
+			std::string key(keySize, '\0');
+			Record record;
+			if (!fs.read(&*key.begin(), keySize) ||
+				!Read(fs, record.stamp.mtime) ||
+				!Read(fs, record.stamp.size) ||
+				!Read(fs, record.stamp.crc) ||
+				!Read(fs, record.result) ||
+				record.result > Result::composite)
+			{
+				// discard a truncated or corrupt file
+				records.clear();
+				break;
+			}
+			record.live = false;
+			records.insert(std::make_pair(key, record));
+		}
+	}
+
+	void IndexCache::Save()
+	{
+		if (CVAR(resourceIndexPath)->empty()) return;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!dirty && std::all_of(records.begin(), records.end(),
+				[](const decltype(records)::value_type &kv) { return kv.second.live; }))
+					return;
+		}
+		Save(*CVAR(resourceIndexPath));
+	}
+
+	void IndexCache::Save(const std::string &path)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// NOTE: the records are written to a temporary file, which replaces
+		// the old file once it is complete, so that an interrupted save
+		// leaves the old file intact
+		std::string tempPath(path + ".tmp");
+		{
+			std::ofstream fs(tempPath, std::ios_base::binary | std::ios_base::trunc);
+			if (!fs)
+			{
+				std::cout << "failed to write resource index: " << path << std::endl;
+				return;
+			}
+			fs.write(signature, sizeof signature);
+			Write(fs, version);
+			Write<std::uint64_t>(fs, GetScannersHash());
+			Write<std::uint64_t>(fs, GetExcludesHash());
+			Write<std::uint64_t>(fs, std::count_if(records.begin(), records.end(),
+				[](const decltype(records)::value_type &kv) { return kv.second.live; }));
+			for (const auto &kv : records)
+			{
+				const Record &record(kv.second);
+				if (!record.live) continue;
+				Write<std::uint32_t>(fs, kv.first.size());
+				fs.write(kv.first.data(), kv.first.size());
+				Write(fs, record.stamp.mtime);
+				Write(fs, record.stamp.size);
+				Write(fs, record.stamp.crc);
+				Write(fs, record.result);
+			}
+			if (!fs)
+			{
+				std::cout << "failed to write resource index: " << path << std::endl;
+				return;
+			}
+		}
+		std::rename(tempPath.c_str(), path.c_str());
+		dirty = false;
+	}
+}}
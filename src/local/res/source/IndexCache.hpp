@@ -0,0 +1,172 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_res_source_IndexCache_hpp
+#   define page_local_res_source_IndexCache_hpp
+
+#	include <cstdint> // uint{32,64}_t
+#	include <mutex>
+#	include <string>
+#	include <unordered_map>
+
+#	include "../../util/class/Monostate.hpp"
+
+namespace page { namespace res
+{
+	/**
+	 * A persistent record of what was found when scanning the nodes of each
+	 * source, which lets a source skip the scanners for any node that hasn't
+	 * changed since it was last indexed.
+	 *
+	 * Each record is keyed by a string that identifies the node, such as its
+	 * absolute path, and is only used if the stamp of the node still matches
+	 * the stamp that was recorded with it.  The records are validated lazily,
+	 * as each node is indexed.
+	 *
+	 * @note Only the result of the scan is recorded, not the nodes that were
+	 *       found, because their pipes can't be serialized.  A node that
+	 *       contains other nodes, such as an archive, is scanned again.
+	 */
+	class IndexCache : public util::Monostate<IndexCache>
+	{
+		/*-------------+
+		| constructors |
+		+-------------*/
+
+		public:
+		/**
+		 * Loads the records from @c resource.index.path, if it is set.
+		 */
+		IndexCache();
+
+		/*-------+
+		| record |
+		+-------*/
+
+		/**
+		 * The identity of a version of a node.
+		 */
+		struct Stamp
+		{
+			std::uint64_t mtime;
+			std::uint64_t size;
+			std::uint32_t crc;
+		};
+
+		/**
+		 * What was found when scanning a node.
+		 */
+		enum class Result : std::uint8_t
+		{
+			/**
+			 * The node was filtered out by @c resource.excludes.
+			 */
+			excluded,
+			/**
+			 * The node was indexed and contains no other nodes.
+			 */
+			leaf,
+			/**
+			 * The node contains other nodes.
+			 */
+			composite
+		};
+
+		/*-------+
+		| access |
+		+-------*/
+
+		/**
+		 * @return @c true if there is a record for the node with a matching
+		 *         stamp, in which case @a result is set to its result.
+		 */
+		bool Find(const std::string &key, const Stamp &, Result &result) const;
+
+		/**
+		 * Records the result of scanning a node.
+		 */
+		void Store(const std::string &key, const Stamp &, Result);
+
+		/**
+		 * Removes all of the records.
+		 */
+		void Clear();
+
+		/*--------------+
+		| serialization |
+		+--------------*/
+
+		/**
+		 * Replaces the records with those in the file.  If the file is
+		 * missing, is from an incompatible version, or was written with a
+		 * different set of scanners or @c resource.excludes, no records are
+		 * loaded.
+		 */
+		void Load(const std::string &path);
+
+		/**
+		 * Writes the records that were used or stored since they were
+		 * loaded to @c resource.index.path, if it is set and any of them
+		 * have changed.
+		 */
+		void Save();
+
+		/**
+		 * Writes the records that were used or stored since they were
+		 * loaded to the file.
+		 */
+		void Save(const std::string &path);
+
+		/*-------------+
+		| data members |
+		+-------------*/
+
+		private:
+		struct Record
+		{
+			Stamp stamp;
+			Result result;
+
+			/**
+			 * @c true if the record was used or stored since it was loaded.
+			 * Records that weren't used belong to nodes that no longer
+			 * exist, and aren't saved.
+			 */
+			mutable bool live;
+		};
+		std::unordered_map<std::string, Record> records;
+
+		/**
+		 * @c true if any of the records were stored since they were loaded.
+		 */
+		bool dirty = false;
+
+		mutable std::mutex mutex;
+	};
+}}
+
+#endif
@@ -25,14 +25,15 @@
  * of this software.
  */
 
-#include <functional> // bind
 #include <iostream> // cout
-#include <regex>
+#include <memory> // shared_ptr
+#include <mutex> // {lock_guard,unique_lock}
 
 #include <boost/optional.hpp>
+#include <boost/regex.hpp> // regex_search
 
-#include "../../cache.hpp" // PurgeResource
-#include "../../cfg/vars.hpp"
+#include "../../cache/Cache.hpp" // Cache::PurgeResource
+#include "../../cfg/Snapshot.hpp"
 #include "../../err/Exception.hpp"
 #include "../../err/report.hpp" // ReportWarning, std::exception
 #include "../../log/Indenter.hpp"
@@ -41,6 +42,7 @@
 #include "../pipe/Pipe.hpp" // Pipe::Open
 #include "../scan/ScannerRegistry.hpp"
 #include "../type/TypeRegistry.hpp"
+#include "IndexCache.hpp"
 #include "Source.hpp"
 
 namespace page { namespace res
@@ -63,12 +65,41 @@ namespace page { namespace res
 
 	void Source::Refresh() {}
 
+	void Source::Poll() {}
+
 	void Source::Index(const Node &node)
 	{
+		std::lock_guard<std::mutex> lock(mutex);
 		ScanToBuildIndex(node, groups.insert(std::make_pair(node.path, Group())).first->second);
 	}
+	void Source::Index(const Node &node, const std::string &key, const IndexCache::Stamp &stamp)
+	{
+		IndexCache &cache(GLOBAL(IndexCache));
+		IndexCache::Result result;
+		bool found = cache.Find(key, stamp, result);
+		if (found && result == IndexCache::Result::excluded) return;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		Group &group(groups.insert(std::make_pair(node.path, Group())).first->second);
+		if (found && result == IndexCache::Result::leaf)
+		{
+			// add node to index without scanning it
+			std::pair<Paths::iterator, bool> inserted(paths.insert(std::make_pair(node.path, Path())));
+			if (inserted.second) group.paths.push_back(inserted.first);
+			inserted.first->second.node = node;
+			return;
+		}
+
+		// scan node and record what was found
+		unsigned count = ScanToBuildIndex(node, group);
+		cache.Store(key, stamp,
+			!count     ? IndexCache::Result::excluded :
+			count == 1 ? IndexCache::Result::leaf :
+			IndexCache::Result::composite);
+	}
 	void Source::Clear(const std::string &group)
 	{
+		std::lock_guard<std::mutex> lock(mutex);
 		// HACK: GCC produces scope warnings if both iterators have the same
 		// name, even when the -ffor-scope flag is given (bug #33260)
 		Groups::iterator groupIter(groups.find(group));
@@ -80,7 +111,7 @@ namespace page { namespace res
 				// FIXME: we should only clear the cache if we are the
 				// top-level source for the given path
 				// FIXME: we should not be purging the cache here anyway!
-				cache::PurgeResource((*iter)->first);
+				GLOBAL(cache::Cache).PurgeResource((*iter)->first);
 				paths.erase(*iter);
 			}
 			groups.erase(groupIter);
@@ -90,109 +121,87 @@ namespace page { namespace res
 	// resource access
 	Stream *Source::Open(const std::string &path) const
 	{
+		std::unique_lock<std::mutex> lock(mutex);
 		Paths::const_iterator iter(paths.find(path));
-		return iter != paths.end() ? iter->second.node.pipe->Open() : 0;
+		if (iter == paths.end()) return 0;
+		std::shared_ptr<Pipe> pipe(iter->second.node.pipe);
+		lock.unlock();
+		return pipe->Open();
 	}
 	std::shared_ptr<const void> Source::Load(const std::type_info &id, const std::string &path) const
 	{
+		std::unique_lock<std::mutex> lock(mutex);
 		// check if path is known
 		Paths::iterator pathIter(paths.find(path));
-		if (pathIter == paths.end())
-		{
-			std::shared_ptr<const void> resource(LoadFromDisk(id, path), GLOBAL(TypeRegistry).Query(id).deleter);
-			if (resource)
-			{
-				Path::Types &types(paths.insert(std::make_pair(path, Path())).first->second.types);
-				Path::Type::Data &data(types.insert(std::make_pair(id.name(), Path::Type())).first->second.data);
-				data = resource;
-			}
-			return resource;
-		}
-		// check if type is known
-		Path::Types &types(pathIter->second.types);
-		Path::Types::iterator typeIter(types.find(id.name()));
-		if (typeIter == types.end())
-		{
-			std::shared_ptr<const void> resource(LoadFromDisk(id, path), GLOBAL(TypeRegistry).Query(id).deleter);
-			if (resource)
-			{
-				Path::Type::Data &data(types.insert(std::make_pair(id.name(), Path::Type())).first->second.data);
-				data = resource;
-			}
-			return resource;
-		}
+		if (pathIter == paths.end()) return nullptr;
 		// check if resource is loaded
-		Path::Type::Data &data(typeIter->second.data);
-		std::shared_ptr<const void> resource(data.lock());
-		if (!resource)
+		const Path::Type &type(GetType(id, pathIter->second));
+		std::shared_ptr<const void> resource(type.data.lock());
+		if (resource) return resource;
+		// NOTE: the mutex is released while the loader runs, so that other
+		// threads can use the source, and so that the loader can load its
+		// own dependencies from it
+		Node node(pathIter->second.node);
+		Loader loader(type.loader);
+		lock.unlock();
+		resource.reset(LoadFromDisk(id, node, loader), GLOBAL(TypeRegistry).Query(id).deleter);
+		lock.lock();
+		// remember resource, unless the path was removed while loading
+		pathIter = paths.find(path);
+		if (pathIter != paths.end())
 		{
-			try
-			{
-				resource.reset(LoadFromDisk(id, path), GLOBAL(TypeRegistry).Query(id).deleter);
-			}
-			catch (...)
-			{
-				types.erase(typeIter);
-				if (types.empty()) paths.erase(pathIter);
-				throw;
-			}
-			if (!resource)
-			{
-				types.erase(typeIter);
-				if (types.empty()) paths.erase(pathIter);
-			}
-			data = resource;
+			Path::Types::iterator typeIter(pathIter->second.types.find(id.name()));
+			if (typeIter != pathIter->second.types.end())
+				typeIter->second.data = resource;
 		}
 		return resource;
 	}
+	std::shared_ptr<const void> Source::GetLoaded(const std::type_info &id, const std::string &path) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		Paths::const_iterator pathIter(paths.find(path));
+		if (pathIter == paths.end()) return nullptr;
+		const Path::Types &types(pathIter->second.types);
+		Path::Types::const_iterator typeIter(types.find(id.name()));
+		return typeIter != types.end() ? typeIter->second.data.lock() : nullptr;
+	}
+	bool Source::Contains(const std::string &path) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return paths.find(path) != paths.end();
+	}
+	bool Source::IsThreadSafe(const std::type_info &id, const std::string &path) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		Paths::iterator pathIter(paths.find(path));
+		return pathIter == paths.end() || GetType(id, pathIter->second).threadSafe;
+	}
 
 	// parsing
-	const void *Source::LoadFromDisk(const std::type_info &id, const std::string &path) const
+	const void *Source::LoadFromDisk(const std::type_info &id, const Node &node, const Loader &loader) const
 	{
-		Paths::iterator iter(paths.find(path));
-		if (iter != paths.end())
-		{
-			Path &path(iter->second);
-			Path::Types::const_iterator iter(path.types.find(id.name()));
-			if (iter == path.types.end())
-			{
-				LoadFunction loader(GLOBAL(load::Registry).GetLoader(id, path.node));
-				if (!loader)
-					THROW((err::Exception<err::ResModuleTag, err::NotFoundTag>("resource type mismatch") <<
-						boost::errinfo_file_name(path.node.path) <<
-						err::errinfo_subject(id.name)))
-				Path::Type pathType = {loader};
-				iter = path.types.insert(std::make_pair(id.name(), pathType)).first;
-			}
-			const Path::Type &type(iter->second);
-			void *data = type.loader(path.node.pipe);
-			if (!data)
-				THROW((err::Exception<err::ResModuleTag, err::NotFoundTag>("resource type mismatch") <<
-					boost::errinfo_file_name(path.node.path) <<
-					err::errinfo_subject(id.name)))
-			auto postLoader(GLOBAL(TypeRegistry).Query(id).postLoader);
-			if (postLoader) postLoader(data);
-			return data;
-		}
-		return 0;
+		void *data = loader(node.pipe).release();
+		if (!data)
+			THROW((err::Exception<err::ResModuleTag, err::NotFoundTag>("resource type mismatch") <<
+				boost::errinfo_file_name(node.path) <<
+				err::errinfo_subject(id.name)))
+		auto postLoader(GLOBAL(TypeRegistry).Query(id).postLoader);
+		if (postLoader) postLoader(data);
+		return data;
 	}
-	void Source::ScanToBuildIndex(const Node &node, Group &group, const std::string &rootPath)
+	unsigned Source::ScanToBuildIndex(const Node &node, Group &group, const std::string &rootPath)
 	{
 		std::string path(CatPath(rootPath, node.path));
 		// filter path
-		for (const auto &filter : *CVAR(resourceExcludes))
-		{
-			/**
-			 * @todo GCC does not implement @c regex_search yet, so we
-			 *       emulate it via @c regex_match and leading/trailing
-			 *       wildcards.
-			 */
-			if (std::regex_match(path, std::regex(".*" + filter + ".*")))
-				return;
-		}
+		// NOTE: the patterns are compiled once, when the variable is set;
+		// the snapshot is held so that it outlives the loop
+		std::shared_ptr<const cfg::Snapshot> snapshot(cfg::GetSnapshot());
+		for (const auto &filter : snapshot->resourceExcludes)
+			if (boost::regex_search(path, filter))
+				return 0;
 		// print path
 		boost::optional<log::Indenter> indenter;
-		if (*CVAR(logVerbose))
+		if (CSNAP(logVerbose))
 		{
 			std::cout << (!node.path.empty() ? path : std::string(".")) << std::endl;
 			indenter = boost::in_place();
@@ -202,13 +211,35 @@ namespace page { namespace res
 		if (result.second) group.paths.push_back(result.first);
 		result.first->second.node = node;
 		// recurse into node
+		unsigned count = 1;
 		try
 		{
-			GLOBAL(scan::Registry).Scan(node, std::bind(&Source::ScanToBuildIndex, this, std::placeholders::_1, group, path));
+			GLOBAL(scan::Registry).Scan(node, [&](const Node &child)
+			{
+				count += ScanToBuildIndex(child, group, path);
+			});
 		}
 		catch (const std::exception &e)
 		{
 			err::ReportWarning(e);
 		}
+		return count;
+	}
+
+	// index
+	auto Source::GetType(const std::type_info &id, Path &path) const -> Path::Type &
+	{
+		Path::Types::iterator iter(path.types.find(id.name()));
+		if (iter == path.types.end())
+		{
+			const LoaderRegistryRecord *record(GLOBAL(LoaderRegistry).GetRecord(id, path.node));
+			if (!record)
+				THROW((err::Exception<err::ResModuleTag, err::NotFoundTag>("resource type mismatch") <<
+					boost::errinfo_file_name(path.node.path) <<
+					err::errinfo_subject(id.name)))
+			Path::Type type = {record->loader, record->threadSafe};
+			iter = path.types.insert(std::make_pair(id.name(), type)).first;
+		}
+		return iter->second;
 	}
 }}
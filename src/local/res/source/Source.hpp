@@ -29,13 +29,15 @@
 #   define page_local_res_source_Source_hpp
 
 #	include <memory> // {weak,shared}_ptr
+#	include <mutex>
 #	include <string>
 #	include <typeinfo> // type_info
 #	include <unordered_map>
 #	include <vector>
 
-#	include "../load/function.hpp" // LoadFunction
+#	include "../load/LoaderRegistry.hpp" // Loader
 #	include "../node/Node.hpp"
+#	include "IndexCache.hpp" // IndexCache::Stamp
 
 namespace page { namespace res
 {
@@ -43,6 +45,9 @@ namespace page { namespace res
 
 	/**
 	 * An abstract representation of a collection of resources.
+	 *
+	 * @note Resources may be loaded from any thread.  The index is guarded by
+	 *       a mutex, which is not held while a loader is running.
 	 */
 	class Source
 	{
@@ -70,8 +75,25 @@ namespace page { namespace res
 		 */
 		virtual void Refresh();
 
+		/**
+		 * Updates the internal index to match any changes that the source
+		 * has been notified of, without checking for other changes.  This
+		 * function is cheap enough to call on every frame.
+		 */
+		virtual void Poll();
+
 		protected:
 		void Index(const Node &);
+
+		/**
+		 * Indexes the node, skipping the scanners if the persistent index
+		 * has a record of the node with the same stamp, which shows that it
+		 * doesn't contain any other nodes.
+		 *
+		 * @param key A string that identifies the node across runs.
+		 */
+		void Index(const Node &, const std::string &key, const IndexCache::Stamp &);
+
 		void Clear(const std::string &group = "");
 
 		public:
@@ -79,12 +101,37 @@ namespace page { namespace res
 		Stream *Open(const std::string &path) const;
 		std::shared_ptr<const void> Load(const std::type_info &, const std::string &path) const;
 
+		/**
+		 * @return The resource if it has already been loaded and is still
+		 *         in use, or @c nullptr otherwise.
+		 */
+		std::shared_ptr<const void> GetLoaded(const std::type_info &, const std::string &path) const;
+
+		/**
+		 * @return @c true if the source has a resource at the path.
+		 */
+		bool Contains(const std::string &path) const;
+
+		/**
+		 * @return @c true if the resource can be loaded on a background
+		 *         thread, or if the source doesn't have it.
+		 */
+		bool IsThreadSafe(const std::type_info &, const std::string &path) const;
+
 		private:
 		class Group;
 
 		// parsing
-		const void *LoadFromDisk(const std::type_info &, const std::string &path) const;
-		void ScanToBuildIndex(const Node &, Group &, const std::string &rootPath = "");
+		const void *LoadFromDisk(const std::type_info &, const Node &, const Loader &) const;
+
+		/**
+		 * Adds the node and any nodes that it contains to the index.
+		 *
+		 * @return The number of nodes that were indexed, including the node
+		 *         itself and any that were already in the index, or zero if
+		 *         the node was excluded.
+		 */
+		unsigned ScanToBuildIndex(const Node &, Group &, const std::string &rootPath = "");
 
 		// index
 		struct Path
@@ -92,7 +139,8 @@ namespace page { namespace res
 			Node node;
 			struct Type
 			{
-				LoadFunction loader;
+				Loader loader;
+				bool threadSafe;
 				typedef std::weak_ptr<const void> Data;
 				Data data;
 			};
@@ -114,6 +162,18 @@ namespace page { namespace res
 		};
 		typedef std::unordered_map<std::string, Group> Groups;
 		Groups groups;
+
+		/**
+		 * Finds a loader for the resource, if it hasn't been found already.
+		 *
+		 * @note The mutex must be held by the caller.
+		 */
+		Path::Type &GetType(const std::type_info &, Path &) const;
+
+		/**
+		 * Guards @c paths and @c groups.
+		 */
+		mutable std::mutex mutex;
 	};
 }}
 
@@ -25,12 +25,14 @@
  * of this software.
  */
 
+#include <cstdint> // uint{32,64}_t
 #include <fstream>
+#include <memory> // make_shared
 
 #include <zip.h>
 
 #include "../../sys/file.hpp"
-#include "../adapt/zip.hpp" // ZipError
+#include "../adapt/zip.hpp" // ZipArchive
 #include "../fmt/zip.hpp" // sig
 #include "../node/path.hpp" // NormPath
 #include "../pipe/ZipPipe.hpp"
@@ -69,19 +71,30 @@ namespace page { namespace res
 	// indexing
 	void ZipSource::Index()
 	{
-		int ze = 0;
-		zip *archive = zip_open(path.c_str(), 0, &ze);
-		if (!archive) ZipError(ze);
-		for (int i = 0; i < zip_get_num_files(archive); ++i)
-			IndexFile(zip_get_name(archive, i, 0), i);
-		if (zip_close(archive) == -1) ZipError(archive);
+		// NOTE: pipes from a previous index keep the old archive open for
+		// as long as they are in use
+		archive = std::make_shared<ZipArchive>(path);
+		for (int i = 0; i < zip_get_num_files(archive->handle); ++i)
+			IndexFile(zip_get_name(archive->handle, i, 0), i);
 		mtime = sys::ModTime(path);
 	}
 
 	void ZipSource::IndexFile(const std::string &path, int i)
 	{
 		const std::string resPath(NormPath(path));
-		Source::Index(Node(std::shared_ptr<Pipe>(new ZipPipe(this->path, i)), resPath));
+		Node node(std::shared_ptr<Pipe>(new ZipPipe(archive, i)), resPath);
+		// identify the entry by its central directory record
+		struct zip_stat stat;
+		if (zip_stat_index(archive->handle, i, 0, &stat) == -1)
+		{
+			Source::Index(node);
+			return;
+		}
+		IndexCache::Stamp stamp = {
+			static_cast<std::uint64_t>(stat.mtime),
+			static_cast<std::uint64_t>(stat.size),
+			static_cast<std::uint32_t>(stat.crc)};
+		Source::Index(node, this->path + '/' + path, stamp);
 	}
 
 	REGISTER_SOURCE(ZipSource, 50)
@@ -28,10 +28,14 @@
 #ifndef    page_local_res_source_ZipSource_hpp
 #   define page_local_res_source_ZipSource_hpp
 
+#	include <memory> // shared_ptr
+
 #	include "Source.hpp"
 
 namespace page { namespace res
 {
+	struct ZipArchive;
+
 	struct ZipSource : Source
 	{
 		// construct
@@ -49,6 +53,11 @@ namespace page { namespace res
 
 		std::string path;
 		unsigned mtime;
+
+		/**
+		 * The open archive, which is shared by all of the source's pipes.
+		 */
+		std::shared_ptr<ZipArchive> archive;
 	};
 }}
 
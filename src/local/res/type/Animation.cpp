@@ -25,8 +25,12 @@
  * of this software.
  */
 
-#include <algorithm> // sort
+#include <algorithm> // max, min, sort
+#include <cmath> // abs, asin
+#include <cstddef> // size_t
 
+#include "../../cfg/vars.hpp"
+#include "../../math/interp.hpp" // LinearInterp
 #include "Animation.hpp"
 #include "Registry.hpp" // REGISTER_TYPE
 
@@ -63,6 +67,90 @@ namespace page
 			{
 				if (!IsSorted(channel)) Sort(channel);
 			}
+
+			// interpolation error
+			inline float GetError(float a, float b)
+			{
+				return std::abs(a - b);
+			}
+			template <unsigned n> inline float GetError(const math::Vector<n> &a, const math::Vector<n> &b)
+			{
+				return Len(a - b);
+			}
+			inline float GetError(const math::Quat<> &a, const math::Quat<> &b)
+			{
+				// the rotation angle from the chord between the quaternions,
+				// which stays accurate for small angles where acos doesn't
+				float chord = Len(Dot(a, b) < 0 ? a + b : a - b);
+				return 4 * std::asin(std::min(chord / 2, 1.f));
+			}
+			inline float GetError(const math::RgbColor<> &a, const math::RgbColor<> &b)
+			{
+				math::RgbColor<> d(a - b);
+				return std::max(Max(d), -Min(d));
+			}
+
+			// channel compression
+			// NOTE: the error is measured against linear interpolation, which
+			// is what the animation controller uses
+			template <typename T> bool IsRedundant(
+				const typename Animation::Channel<T>::Frames &frames,
+				std::size_t first, std::size_t last, float tolerance)
+			{
+				const auto
+					&a(frames[first]),
+					&b(frames[last]);
+				for (std::size_t i = first + 1; i < last; ++i)
+					if (GetError(frames[i].value, math::LinearInterp(a.value, b.value,
+						(frames[i].time - a.time) / (b.time - a.time))) > tolerance)
+						return false;
+				return true;
+			}
+			template <typename T> void Reduce(Animation::Channel<T> &channel, float tolerance)
+			{
+				auto &frames(channel.frames);
+				if (frames.size() < 2) return;
+
+				// a constant channel only needs one frame
+				bool constant = true;
+				for (const auto &frame : frames)
+					if (GetError(frame.value, frames.front().value) > tolerance)
+					{
+						constant = false;
+						break;
+					}
+				if (constant)
+				{
+					frames.resize(1, frames.front());
+					return;
+				}
+
+				// extend each segment for as long as the frames in between
+				// are redundant, keeping the frame that ends it
+				typename Animation::Channel<T>::Frames reduced(1, frames.front());
+				for (std::size_t first = 0, last = 1; last < frames.size(); ++last)
+					if (last + 1 == frames.size() || !IsRedundant<T>(frames, first, last + 1, tolerance))
+					{
+						reduced.push_back(frames[last]);
+						first = last;
+					}
+				frames.swap(reduced);
+			}
+			template <typename T> void Quantize(Animation::Channel<T> &channel)
+			{
+				channel.quantization.Fit(channel.frames);
+				channel.packedFrames.clear();
+				channel.packedFrames.reserve(channel.frames.size());
+				for (const auto &frame : channel.frames)
+					channel.packedFrames.push_back({frame.time, channel.quantization.Pack(frame.value)});
+				typename Animation::Channel<T>::Frames().swap(channel.frames);
+			}
+			template <typename T> inline void Compress(Animation::Channel<T> &channel, float tolerance)
+			{
+				if (channel.frames.empty()) return;
+				Reduce(channel, tolerance);
+				Quantize(channel);
+			}
 		}
 
 		// sorting
@@ -139,9 +227,49 @@ namespace page
 			}
 		}
 
+		// compression
+		void Compress(Animation &anim, float tolerance)
+		{
+			Compress(anim.ambient,     tolerance);
+			Compress(anim.aspect,      tolerance);
+			Compress(anim.attenuation, tolerance);
+			Compress(anim.cutoff,      tolerance);
+			Compress(anim.depth,       tolerance);
+			Compress(anim.diffuse,     tolerance);
+			Compress(anim.exposure,    tolerance);
+			Compress(anim.falloff,     tolerance);
+			Compress(anim.fov,         tolerance);
+			Compress(anim.normal,      tolerance);
+			Compress(anim.opacity,     tolerance);
+			Compress(anim.orientation, tolerance);
+			Compress(anim.position,    tolerance);
+			Compress(anim.range,       tolerance);
+			Compress(anim.scale,       tolerance);
+			Compress(anim.size,        tolerance);
+			Compress(anim.specular,    tolerance);
+			Compress(anim.texCoord,    tolerance);
+			Compress(anim.volume,      tolerance);
+			for (Animation::Bones::iterator iter(anim.bones.begin()); iter != anim.bones.end(); ++iter)
+			{
+				Animation::Bone &bone(iter->second);
+				Compress(bone.position,    tolerance);
+				Compress(bone.orientation, tolerance);
+				Compress(bone.scale,       tolerance);
+			}
+			for (Animation::Vertices::iterator iter(anim.vertices.begin()); iter != anim.vertices.end(); ++iter)
+			{
+				Animation::Vertex &vertex(iter->second);
+				Compress(vertex.position, tolerance);
+				Compress(vertex.normal,   tolerance);
+				Compress(vertex.texCoord, tolerance);
+			}
+		}
+
 		void PostLoadAnimation(Animation &anim)
 		{
 			EnsureSorted(anim);
+			if (*CVAR(animationCompress))
+				Compress(anim, *CVAR(animationTolerance));
 		}
 
 		REGISTER_TYPE(Animation, "animation", PostLoadAnimation)
@@ -28,6 +28,9 @@
 #ifndef    page_local_res_type_Animation_hpp
 #   define page_local_res_type_Animation_hpp
 
+#	include <array>
+#	include <cstddef> // size_t
+#	include <cstdint> // {,u}int16_t
 #	include <string>
 #	include <unordered_map>
 #	include <vector>
@@ -40,6 +43,38 @@ namespace page
 {
 	namespace res
 	{
+		// quantized channel values, which are stored unchanged by default
+		template <typename T> struct Quantization
+		{
+			typedef T Value;
+
+			template <typename Frames> void Fit(const Frames &) {}
+			const Value &Pack(const T &value) const { return value; }
+			const T &Unpack(const Value &value) const { return value; }
+		};
+
+		// quaternions, as normalized 16-bit components
+		template <> struct Quantization<math::Quat<>>
+		{
+			typedef std::array<std::int16_t, 4> Value;
+
+			template <typename Frames> void Fit(const Frames &) {}
+			Value Pack(const math::Quat<> &) const;
+			math::Quat<> Unpack(const Value &) const;
+		};
+
+		// vectors, as 16-bit fractions of the channel's bounds
+		template <> struct Quantization<math::Vec3>
+		{
+			typedef std::array<std::uint16_t, 3> Value;
+
+			template <typename Frames> void Fit(const Frames &);
+			Value Pack(const math::Vec3 &) const;
+			math::Vec3 Unpack(const Value &) const;
+
+			math::Vec3 min, step;
+		};
+
 		struct Animation
 		{
 			float duration;
@@ -57,6 +92,21 @@ namespace page
 				};
 				typedef std::vector<Frame> Frames;
 				Frames frames;
+
+				// compressed frames, which replace the frames above
+				struct PackedFrame
+				{
+					float time;
+					typename Quantization<T>::Value value;
+				};
+				typedef std::vector<PackedFrame> PackedFrames;
+				PackedFrames packedFrames;
+				Quantization<T> quantization;
+
+				// access to either form of the frames
+				std::size_t GetSize() const;
+				float GetTime(std::size_t) const;
+				T GetValue(std::size_t) const;
 			};
 
 			// channels
@@ -102,7 +152,14 @@ namespace page
 		// sorting
 		void Sort(Animation &);
 		void EnsureSorted(Animation &);
+
+		// compression
+		// removes the frames that linear interpolation reproduces within the
+		// tolerance, in the units of each channel, or in radians for
+		// orientations, and quantizes the quaternions and vectors
+		void Compress(Animation &, float tolerance);
 	}
 }
 
+#	include "Animation.tpp"
 #endif
@@ -0,0 +1,94 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+
+#include <algorithm> // max, min
+#include <cmath> // lround
+
+namespace page
+{
+	namespace res
+	{
+		// quaternion quantization
+		inline Quantization<math::Quat<>>::Value Quantization<math::Quat<>>::Pack(const math::Quat<> &q) const
+		{
+			Value value;
+			for (unsigned i = 0; i < 4; ++i)
+				value[i] = std::lround(std::min(std::max(q[i], -1.f), 1.f) * 32767);
+			return value;
+		}
+		inline math::Quat<> Quantization<math::Quat<>>::Unpack(const Value &value) const
+		{
+			math::Quat<> q;
+			for (unsigned i = 0; i < 4; ++i)
+				q[i] = value[i] / 32767.f;
+			return Norm(q);
+		}
+
+		// vector quantization
+		template <typename Frames> void Quantization<math::Vec3>::Fit(const Frames &frames)
+		{
+			if (frames.empty()) return;
+			math::Vec3 max(frames.front().value);
+			min = max;
+			for (const auto &frame : frames)
+			{
+				min = Min(min, frame.value);
+				max = Max(max, frame.value);
+			}
+			step = (max - min) / 65535;
+		}
+		inline Quantization<math::Vec3>::Value Quantization<math::Vec3>::Pack(const math::Vec3 &v) const
+		{
+			Value value;
+			for (unsigned i = 0; i < 3; ++i)
+				value[i] = step[i] ? std::lround(std::min(std::max((v[i] - min[i]) / step[i], 0.f), 65535.f)) : 0;
+			return value;
+		}
+		inline math::Vec3 Quantization<math::Vec3>::Unpack(const Value &value) const
+		{
+			return math::Vec3(
+				min.x + value[0] * step.x,
+				min.y + value[1] * step.y,
+				min.z + value[2] * step.z);
+		}
+
+		// channel access
+		template <typename T> std::size_t Animation::Channel<T>::GetSize() const
+		{
+			return packedFrames.empty() ? frames.size() : packedFrames.size();
+		}
+		template <typename T> float Animation::Channel<T>::GetTime(std::size_t i) const
+		{
+			return packedFrames.empty() ? frames[i].time : packedFrames[i].time;
+		}
+		template <typename T> T Animation::Channel<T>::GetValue(std::size_t i) const
+		{
+			return packedFrames.empty() ? frames[i].value : quantization.Unpack(packedFrames[i].value);
+		}
+	}
+}
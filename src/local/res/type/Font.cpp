@@ -43,23 +43,33 @@ namespace page
 	{
 		namespace detail
 		{
-			std::size_t KerningHash::operator ()(const std::pair<char, char> &pair) const
+			std::size_t KerningHash::operator ()(const std::pair<char32_t, char32_t> &pair) const
 			{
-				return std::hash<std::size_t>()(pair.first + pair.second * UCHAR_MAX);
+				return std::hash<std::size_t>()(pair.first + pair.second * 0x110000);
+			}
+		}
+
+		namespace
+		{
+			// the C library only classifies characters in the range of
+			// unsigned char, so anything beyond it is not whitespace
+			bool IsSpace(char32_t c)
+			{
+				return c <= UCHAR_MAX && std::isspace(c);
 			}
 		}
 
 		// glyph access
-		const Font::Glyph *GetGlyph(const Font &font, char c)
+		const Font::Glyph *GetGlyph(const Font &font, char32_t c)
 		{
 			Font::Glyphs::const_iterator iter(font.glyphs.find(c));
-			if (iter == font.glyphs.end() && (std::isspace(c) ||
+			if (iter == font.glyphs.end() && (IsSpace(c) ||
 				(iter = font.glyphs.find('\0')) == font.glyphs.end())) return 0;
 			return &iter->second;
 		}
 
 		// glyph images
-		Image GetCharImage(const Font &font, char c, float fontSize)
+		Image GetCharImage(const Font &font, char32_t c, float fontSize)
 		{
 			assert(fontSize);
 			if (const Font::Glyph *glyph = GetGlyph(font, c))
@@ -94,12 +104,12 @@ namespace page
 #endif
 
 		// advance
-		float GetAdvance(const Font &font, char c)
+		float GetAdvance(const Font &font, char32_t c)
 		{
 			const Font::Glyph *glyph = GetGlyph(font, c);
 			return glyph ? glyph->advance : 1;
 		}
-		float GetAdvance(const Font &font, char first, char second)
+		float GetAdvance(const Font &font, char32_t first, char32_t second)
 		{
 			Font::Kernings::const_iterator kerning(
 				font.kernings.find(std::make_pair(first, second)));
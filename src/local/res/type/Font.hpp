@@ -41,12 +41,15 @@ namespace page
 	{
 		namespace detail
 		{
-			struct KerningHash : std::unary_function<std::pair<char, char>, std::size_t>
+			struct KerningHash : std::unary_function<std::pair<char32_t, char32_t>, std::size_t>
 			{
-				std::size_t operator ()(const std::pair<char, char> &) const;
+				std::size_t operator ()(const std::pair<char32_t, char32_t> &) const;
 			};
 		}
 
+		/**
+		 * A font, with its glyphs and kernings keyed by Unicode code point.
+		 */
 		struct Font
 		{
 			struct Glyph
@@ -76,9 +79,9 @@ namespace page
 				math::Vec2 size, bearing;
 				float advance;
 			};
-			typedef std::unordered_map<char, Glyph> Glyphs;
+			typedef std::unordered_map<char32_t, Glyph> Glyphs;
 			Glyphs glyphs;
-			typedef std::unordered_map<std::pair<char, char>, float, detail::KerningHash> Kernings;
+			typedef std::unordered_map<std::pair<char32_t, char32_t>, float, detail::KerningHash> Kernings;
 			Kernings kernings;
 			math::Vec2 maxSize, maxBearing;
 			float maxAdvance, lineHeight;
@@ -94,15 +97,15 @@ namespace page
 		};
 
 		// glyph access
-		const Font::Glyph *GetGlyph(const Font &, char);
+		const Font::Glyph *GetGlyph(const Font &, char32_t);
 
 		// glyph images
-		Image GetCharImage(const Font &, char, float fontSize);
+		Image GetCharImage(const Font &, char32_t, float fontSize);
 		Image RenderOutline(const Font::Glyph &, float fontSize);
 
 		// advance
-		float GetAdvance(const Font &, char);
-		float GetAdvance(const Font &, char, char);
+		float GetAdvance(const Font &, char32_t);
+		float GetAdvance(const Font &, char32_t, char32_t);
 
 		// line wrapping
 		std::string Wrap(const Font &, std::string, float width);
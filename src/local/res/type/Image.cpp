@@ -30,9 +30,15 @@
 #include <climits> // CHAR_BIT, UCHAR_MAX
 #include <cmath> // fmod
 #include <cstdlib> // abs
+#include <cstring> // memcpy
 #include <vector>
 
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+#	include <immintrin.h>
+#endif
+
 #include "../../math/Aabb.hpp"
+#include "../../math/algorithm.hpp" // GetSimdLevel, SimdLevel
 #include "../../util/bit.hpp" // BitCopy
 #include "Image.hpp"
 #include "Registry.hpp" // REGISTER_TYPE
@@ -118,33 +124,6 @@ namespace page
 				}
 				return data;
 			}
-			Image::Data SwizzleBytes(const Image &img, const Image::Channels &channels, const Steps &steps, unsigned alignment)
-			{
-				unsigned
-					srcDepth  = GetDepth(img.channels),
-					destDepth = GetDepth(channels);
-				Image::Data data(GetDataSize(img.size, destDepth, alignment));
-				Image::Data::const_iterator src(img.data.begin());
-				Image::Data::iterator dest(data.begin());
-				unsigned
-					srcPadding  = GetPadding(img.size.x, srcDepth,  img.alignment),
-					destPadding = GetPadding(img.size.x, destDepth, alignment);
-				srcDepth  /= CHAR_BIT;
-				destDepth /= CHAR_BIT;
-				for (unsigned i = 0; i < img.size.y; ++i)
-				{
-					for (unsigned i = 0; i < img.size.x; ++i)
-					{
-						for (Steps::const_iterator step(steps.begin()); step != steps.end(); ++step)
-							dest[step->targets[0].offset / CHAR_BIT] = src[step->sources[0].offset / CHAR_BIT];
-						src  += srcDepth;
-						dest += destDepth;
-					}
-					src  += srcPadding;
-					dest += destPadding;
-				}
-				return data;
-			}
 			Image::Data ConvertBytes(const Image &img, const Image::Channels &channels, const Steps &steps, unsigned alignment)
 			{
 				unsigned
@@ -184,6 +163,251 @@ namespace page
 				return data;
 			}
 
+			// byte mapping
+			// NOTE: covers conversions between 8-bit formats of up to four
+			// channels where each destination byte is either copied from a
+			// source byte or constant, such as swizzles, adding or removing
+			// alpha, and gray expansion
+			struct ByteMap
+			{
+				unsigned srcSize, destSize;
+				int sources[4]; // -1 for constant
+				unsigned char constants[4];
+				// SIMD shuffle for as many pixels as fit in 16 bytes
+				unsigned pixelsPerShuffle;
+				alignas(16) unsigned char shuffle[16], fill[16];
+			};
+			bool GetByteMap(const Image::Channels &srcChannels, const Image::Channels &destChannels, const Steps &steps, ByteMap &map)
+			{
+				map.srcSize  = srcChannels.size();
+				map.destSize = destChannels.size();
+				if (map.srcSize > 4 || map.destSize > 4) return false;
+				for (Steps::const_iterator step(steps.begin()); step != steps.end(); ++step)
+				{
+					if (step->sources.size() > 1) return false;
+					for (Step::Components::const_iterator target(step->targets.begin()); target != step->targets.end(); ++target)
+					{
+						unsigned i = target->offset / CHAR_BIT;
+						map.sources[i] = step->sources.empty() ? -1 : step->sources[0].offset / CHAR_BIT;
+						map.constants[i] = step->alpha * UCHAR_MAX;
+					}
+				}
+				map.pixelsPerShuffle = 16 / std::max(map.srcSize, map.destSize);
+				for (unsigned i = 0; i < 16; ++i)
+				{
+					unsigned pixel = i / map.destSize, j = i % map.destSize;
+					bool used = pixel < map.pixelsPerShuffle && map.sources[j] >= 0;
+					map.shuffle[i] = used ? pixel * map.srcSize + map.sources[j] : 0x80;
+					map.fill[i] = pixel < map.pixelsPerShuffle && !used ? map.constants[j] : 0;
+				}
+				return true;
+			}
+
+			// byte mapping kernels
+			// NOTE: each kernel converts the pixels [first, last) of a row
+			typedef void (*MapRowKernel)(const unsigned char *src, unsigned char *dest, unsigned first, unsigned last, const ByteMap &);
+			template <unsigned srcSize, unsigned destSize>
+				void MapRow(const unsigned char *src, unsigned char *dest, unsigned first, unsigned last, const ByteMap &map)
+			{
+				src  += first * srcSize;
+				dest += first * destSize;
+				for (unsigned i = first; i < last; ++i, src += srcSize, dest += destSize)
+					for (unsigned j = 0; j < destSize; ++j)
+						dest[j] = map.sources[j] < 0 ? map.constants[j] : src[map.sources[j]];
+			}
+			template <unsigned srcSize>
+				MapRowKernel GetMapRowKernel(unsigned destSize)
+			{
+				switch (destSize)
+				{
+					case 1:  return MapRow<srcSize, 1>;
+					case 2:  return MapRow<srcSize, 2>;
+					case 3:  return MapRow<srcSize, 3>;
+					default: return MapRow<srcSize, 4>;
+				}
+			}
+			MapRowKernel GetMapRowKernel(const ByteMap &map)
+			{
+				switch (map.srcSize)
+				{
+					case 1:  return GetMapRowKernel<1>(map.destSize);
+					case 2:  return GetMapRowKernel<2>(map.destSize);
+					case 3:  return GetMapRowKernel<3>(map.destSize);
+					default: return GetMapRowKernel<4>(map.destSize);
+				}
+			}
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+			// returns the number of pixels converted, leaving the rest of
+			// the row for the scalar kernel
+			// NOTE: each step reads and writes 16 bytes, of which only the
+			// leading pixels are used, so it stops before running past the
+			// end of either row
+			__attribute__((target("ssse3")))
+				unsigned MapRowSsse3(const unsigned char *src, unsigned char *dest, unsigned width, const ByteMap &map)
+			{
+				const __m128i
+					shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(map.shuffle)),
+					fill    = _mm_load_si128(reinterpret_cast<const __m128i *>(map.fill));
+				unsigned i = 0;
+				for (; i * map.srcSize + 16 <= width * map.srcSize && i * map.destSize + 16 <= width * map.destSize; i += map.pixelsPerShuffle)
+				{
+					__m128i pixels(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * map.srcSize)));
+					pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), fill);
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i * map.destSize), pixels);
+				}
+				return i;
+			}
+#endif
+			Image::Data MapBytes(const Image &img, const ByteMap &map, unsigned alignment)
+			{
+				unsigned
+					srcPitch  = GetBitPitch(img.size.x, map.srcSize  * CHAR_BIT, img.alignment) / CHAR_BIT,
+					destPitch = GetBitPitch(img.size.x, map.destSize * CHAR_BIT, alignment)     / CHAR_BIT;
+				Image::Data data(GetDataSize(img.size, map.destSize * CHAR_BIT, alignment));
+				const MapRowKernel kernel = GetMapRowKernel(map);
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+				bool simd = math::GetSimdLevel() >= math::SimdLevel::ssse3;
+#endif
+				for (unsigned i = 0; i < img.size.y; ++i)
+				{
+					const unsigned char *src = img.data.data() + i * srcPitch;
+					unsigned char *dest = data.data() + i * destPitch;
+					unsigned first = 0;
+#if defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+					if (simd) first = MapRowSsse3(src, dest, img.size.x, map);
+#endif
+					kernel(src, dest, first, img.size.x, map);
+				}
+				return data;
+			}
+
+			// row reversal kernels
+			typedef void (*ReverseRowKernel)(const unsigned char *src, unsigned char *dest, unsigned width, unsigned size);
+			template <unsigned size>
+				void ReverseRow(const unsigned char *src, unsigned char *dest, unsigned width, unsigned)
+			{
+				dest += width * size;
+				for (unsigned i = 0; i < width; ++i, src += size)
+					std::memcpy(dest -= size, src, size);
+			}
+			void ReverseWideRow(const unsigned char *src, unsigned char *dest, unsigned width, unsigned size)
+			{
+				dest += width * size;
+				for (unsigned i = 0; i < width; ++i, src += size)
+					std::memcpy(dest -= size, src, size);
+			}
+			Image::Data FlipBytes(const Image &img, const math::Vector<2, bool> &flip)
+			{
+				unsigned
+					size  = GetDepth(img.channels) / CHAR_BIT,
+					width = img.size.x * size,
+					pitch = GetBitPitch(img.size.x, size * CHAR_BIT, img.alignment) / CHAR_BIT;
+				ReverseRowKernel reverse =
+					size == 1 ? ReverseRow<1> :
+					size == 2 ? ReverseRow<2> :
+					size == 3 ? ReverseRow<3> :
+					size == 4 ? ReverseRow<4> : ReverseWideRow;
+				// NOTE: only the pixels are copied, leaving the padding zeroed
+				// as in the general implementation
+				Image::Data data(img.data.size());
+				for (unsigned i = 0; i < img.size.y; ++i)
+				{
+					const unsigned char *src = img.data.data() + i * pitch;
+					unsigned char *dest = data.data() + (flip.y ? img.size.y - 1 - i : i) * pitch;
+					if (flip.x) reverse(src, dest, img.size.x, size);
+					else std::memcpy(dest, src, width);
+				}
+				return data;
+			}
+
+			// 2x box filter kernels
+			// NOTE: colors are weighted by alpha, as in the general filter,
+			// but the results are rounded rather than truncated
+			typedef void (*HalveRowKernel)(const unsigned char *row0, const unsigned char *row1, unsigned char *dest, unsigned width, int alpha);
+			template <unsigned size>
+				void HalveRow(const unsigned char *row0, const unsigned char *row1, unsigned char *dest, unsigned width, int alpha)
+			{
+				for (unsigned i = 0; i < width; ++i, row0 += size * 2, row1 += size * 2, dest += size)
+				{
+					if (alpha < 0)
+					{
+						for (unsigned j = 0; j < size; ++j)
+							dest[j] = (row0[j] + row0[j + size] + row1[j] + row1[j + size] + 2) / 4;
+						continue;
+					}
+					unsigned
+						a0 = row0[alpha], a1 = row0[alpha + size],
+						a2 = row1[alpha], a3 = row1[alpha + size],
+						totalAlpha = a0 + a1 + a2 + a3;
+					for (unsigned j = 0; j < size; ++j)
+						dest[j] = int(j) == alpha ? (totalAlpha + 2) / 4 : totalAlpha ?
+							(row0[j] * a0 + row0[j + size] * a1 + row1[j] * a2 + row1[j + size] * a3 + totalAlpha / 2) / totalAlpha : 0;
+				}
+			}
+			bool HalveBytes(const Image &img, Image &destImg)
+			{
+				unsigned size = img.channels.size();
+				if (size > 4) return false;
+				int alpha = -1;
+				for (unsigned i = 0; i < size; ++i)
+				{
+					if (img.channels[i].depth != CHAR_BIT) return false;
+					if (img.channels[i].type & Image::Channel::alpha)
+					{
+						if (alpha >= 0) return false;
+						alpha = i;
+					}
+				}
+				HalveRowKernel halve =
+					size == 1 ? HalveRow<1> :
+					size == 2 ? HalveRow<2> :
+					size == 3 ? HalveRow<3> : HalveRow<4>;
+				unsigned
+					srcPitch  = GetBitPitch(img.size.x,     size * CHAR_BIT, img.alignment) / CHAR_BIT,
+					destPitch = GetBitPitch(destImg.size.x, size * CHAR_BIT, img.alignment) / CHAR_BIT;
+				destImg.data.resize(GetDataSize(destImg.size, size * CHAR_BIT, img.alignment));
+				for (unsigned i = 0; i < destImg.size.y; ++i)
+				{
+					const unsigned char *src = img.data.data() + i * 2 * srcPitch;
+					halve(src, src + srcPitch, destImg.data.data() + i * destPitch, destImg.size.x, alpha);
+				}
+				return true;
+			}
+
+			// conversion step construction
+			Steps GetSteps(const Image::Channels &srcChannels, const Image::Channels &destChannels)
+			{
+				// build conversion steps
+				Steps steps;
+				unsigned destOffset = 0;
+				for (Image::Channels::const_iterator destChannel(destChannels.begin()); destChannel != destChannels.end(); ++destChannel)
+				{
+					if (!destChannel->depth) continue;
+					Step step;
+					unsigned srcOffset = 0;
+					for (Image::Channels::const_iterator srcChannel(srcChannels.begin()); srcChannel != srcChannels.end(); ++srcChannel)
+					{
+						if (srcChannel->type & destChannel->type && srcChannel->depth)
+							step.sources.push_back(Step::Component(srcOffset, srcChannel->depth));
+						srcOffset += srcChannel->depth;
+					}
+					step.targets.push_back(Step::Component(destOffset, destChannel->depth));
+					step.alpha = destChannel->type & Image::Channel::alpha;
+					steps.push_back(step);
+					destOffset += destChannel->depth;
+				}
+				// combine similar conversion steps
+				for (Steps::iterator step(steps.begin()); step != steps.end(); ++step)
+					for (Steps::iterator step2(step + 1); step2 != steps.end();)
+						if (step2->sources == step->sources && (!step->sources.empty() || step2->alpha == step->alpha))
+						{
+							step->targets.insert(step->targets.end(), step2->targets.begin(), step2->targets.end());
+							step2 = steps.erase(step2);
+						}
+						else ++step2;
+				return steps;
+			}
+
 			// component extraction/insertion
 			inline float GetComponent(Image::Data::const_iterator iter, unsigned bitOffset, unsigned bitSize)
 			{
@@ -289,6 +513,53 @@ namespace page
 					*iter |= *valuePtr >> CHAR_BIT - n << CHAR_BIT - n - bitOffset;
 				}
 			}
+
+			// general conversion
+			Image::Data ConvertComponents(const Image &img, const Image::Channels &channels, const Steps &steps, unsigned alignment)
+			{
+				unsigned
+					srcDepth  = GetDepth(img.channels),
+					destDepth = GetDepth(channels);
+				Image::Data data(GetDataSize(img.size, destDepth, alignment));
+				Image::Data::const_iterator srcIter(img.data.begin());
+				Image::Data::iterator destIter(data.begin());
+				unsigned srcBit = 0, destBit = 0,
+					srcPadding  = GetPadding(img.size.x, srcDepth,  img.alignment),
+					destPadding = GetPadding(img.size.x, destDepth, alignment);
+				for (unsigned i = 0; i < img.size.y; ++i)
+				{
+					for (unsigned i = 0; i < img.size.x; ++i)
+					{
+						for (Steps::const_iterator step(steps.begin()); step != steps.end(); ++step)
+						{
+							// load average value
+							float value = step->alpha;
+							if (!step->sources.empty())
+							{
+								value = 0;
+								for (Step::Components::const_iterator source(step->sources.begin()); source != step->sources.end(); ++source)
+									value += GetComponent(srcIter, srcBit + source->offset, source->depth);
+								value /= step->sources.size();
+							}
+							// store result
+							if (value)
+								for (Step::Components::const_iterator target(step->targets.begin()); target != step->targets.end(); ++target)
+									SetComponent(destIter, destBit + target->offset, target->depth, value);
+						}
+						// increment source position
+						srcBit += srcDepth;
+						srcIter += srcBit / CHAR_BIT;
+						srcBit %= CHAR_BIT;
+						// increment destination position
+						destBit += destDepth;
+						destIter += destBit / CHAR_BIT;
+						destBit %= CHAR_BIT;
+					}
+					if (srcPadding)  { srcIter  += srcPadding;  srcBit  = 0; }
+					if (destPadding) { destIter += destPadding; destBit = 0; }
+				}
+				return data;
+			}
 		}
 
 		// channel construct
@@ -369,6 +640,37 @@ namespace page
 
 		// transformation
 		Image Flip(const Image &img, const math::Vector<2, bool> &flip)
+		{
+			if (All(!flip)) return img;
+			if (GetDepth(img.channels) % CHAR_BIT) return FlipGeneral(img, flip);
+			Image destImg =
+			{
+				img.size,
+				img.channels,
+				img.alignment
+			};
+			destImg.data = FlipBytes(img, flip);
+			return destImg;
+		}
+		Image Scale(const Image &img, const math::Vec2u &size)
+		{
+			if (All(size == img.size)) return img;
+			// check for 2x downsampling, as used for mipmaps
+			if (All(size * 2u == img.size))
+			{
+				Image destImg =
+				{
+					size,
+					img.channels,
+					img.alignment
+				};
+				if (HalveBytes(img, destImg)) return destImg;
+			}
+			return ScaleGeneral(img, size);
+		}
+
+		// general transformation
+		Image FlipGeneral(const Image &img, const math::Vector<2, bool> &flip)
 		{
 			if (All(!flip)) return img;
 			// create destination image
@@ -416,6 +718,8 @@ namespace page
 						{
 							*destIter |= *srcIter << srcBit >> CHAR_BIT - n << CHAR_BIT - (destBit + n);
 							srcBit += n;
+							srcIter += srcBit / CHAR_BIT;
+							srcBit %= CHAR_BIT;
 						}
 						else
 						{
@@ -515,7 +819,7 @@ namespace page
 			}
 			return destImg;
 		}
-		Image Scale(const Image &img, const math::Vec2u &size)
+		Image ScaleGeneral(const Image &img, const math::Vec2u &size)
 		{
 			if (All(size == img.size)) return img;
 			Image destImg =
@@ -695,89 +999,38 @@ namespace page
 				}
 			}
 			NotSimple:
-			// build conversion steps
-			Steps steps;
-			unsigned destOffset = 0;
-			for (Image::Channels::const_iterator destChannel(channels.begin()); destChannel != channels.end(); ++destChannel)
-			{
-				if (!destChannel->depth) continue;
-				Step step;
-				unsigned srcOffset = 0;
-				for (Image::Channels::const_iterator srcChannel(img.channels.begin()); srcChannel != img.channels.end(); ++srcChannel)
-				{
-					if (srcChannel->type & destChannel->type && srcChannel->depth)
-						step.sources.push_back(Step::Component(srcOffset, srcChannel->depth));
-					srcOffset += srcChannel->depth;
-				}
-				step.targets.push_back(Step::Component(destOffset, destChannel->depth));
-				step.alpha = destChannel->type & Image::Channel::alpha;
-				steps.push_back(step);
-				destOffset += destChannel->depth;
-			}
-			// combine similar conversion steps
-			for (Steps::iterator step(steps.begin()); step != steps.end(); ++step)
-				for (Steps::iterator step2(step + 1); step2 != steps.end();)
-					if (step2->sources == step->sources && (!step->sources.empty() || step2->alpha == step->alpha))
-					{
-						step->targets.insert(step->targets.end(), step2->targets.begin(), step2->targets.end());
-						step2 = steps.erase(step2);
-					}
-					else ++step2;
+			Steps steps(GetSteps(img.channels, channels));
 			// check for pure byte conversions
 			for (Image::Channels::const_iterator channel(img.channels.begin()); channel != img.channels.end(); ++channel)
 				if (channel->depth != CHAR_BIT) goto NotByte;
 			for (Image::Channels::const_iterator channel(channels.begin()); channel != channels.end(); ++channel)
 				if (channel->depth != CHAR_BIT) goto NotByte;
-			for (Steps::const_iterator step(steps.begin()); step != steps.end(); ++step)
-				if (step->sources.size() != 1 || step->targets.size() != 1) goto NotSwizzle;
-			destImg.data = SwizzleBytes(img, channels, steps, alignment);
-			return destImg;
-			NotSwizzle:
-			destImg.data = ConvertBytes(img, channels, steps, alignment);
-			return destImg;
-			NotByte:
-			// perform conversion
-			unsigned
-				srcDepth  = GetDepth(img.channels),
-				destDepth = GetDepth(channels);
-			destImg.data.resize(GetDataSize(img.size, destDepth, alignment));
-			Image::Data::const_iterator srcIter(img.data.begin());
-			Image::Data::iterator destIter(destImg.data.begin());
-			unsigned srcBit = 0, destBit = 0,
-				srcPadding  = GetPadding(img.size.x, srcDepth,  img.alignment),
-				destPadding = GetPadding(img.size.x, destDepth, alignment);
-			for (unsigned i = 0; i < img.size.y; ++i)
 			{
-				for (unsigned i = 0; i < img.size.x; ++i)
+				ByteMap map;
+				if (GetByteMap(img.channels, channels, steps, map))
 				{
-					for (Steps::const_iterator step(steps.begin()); step != steps.end(); ++step)
-					{
-						// load average value
-						float value = step->alpha;
-						if (!step->sources.empty())
-						{
-							value = 0;
-							for (Step::Components::const_iterator source(step->sources.begin()); source != step->sources.end(); ++source)
-								value += GetComponent(srcIter, srcBit + source->offset, source->depth);
-							value /= step->sources.size();
-						}
-						// store result
-						if (value)
-							for (Step::Components::const_iterator target(step->targets.begin()); target != step->targets.end(); ++target)
-								SetComponent(destIter, destBit + target->offset, target->depth, value);
-					}
-					// increment source position
-					srcBit += srcDepth;
-					srcIter += srcBit / CHAR_BIT;
-					srcBit %= CHAR_BIT;
-					// increment destination position
-					destBit += destDepth;
-					destIter += destBit / CHAR_BIT;
-					destBit %= CHAR_BIT;
+					destImg.data = MapBytes(img, map, alignment);
+					return destImg;
 				}
-				if (srcPadding)  { srcIter  += srcPadding;  srcBit  = 0; }
-				if (destPadding) { destIter += destPadding; destBit = 0; }
 			}
+			destImg.data = ConvertBytes(img, channels, steps, alignment);
+			return destImg;
+			NotByte:
+			destImg.data = ConvertComponents(img, channels, steps, alignment);
+			return destImg;
+		}
+
+		// general format conversion
+		Image ConvertGeneral(const Image &img, const Image::Channels &channels, unsigned alignment)
+		{
+			if (channels == img.channels) return img;
+			Image destImg =
+			{
+				img.size,
+				channels,
+				alignment
+			};
+			destImg.data = ConvertComponents(img, channels, GetSteps(img.channels, channels), alignment);
 			return destImg;
 		}
 
@@ -789,13 +1042,36 @@ namespace page
 			if (!alignment || !img.alignment)
 				return
 					!(pitch % CHAR_BIT) &&
-					!(pitch / CHAR_BIT % std::min(alignment, img.alignment));
+					!(pitch / CHAR_BIT % std::max(alignment, img.alignment));
 			pitch = (pitch + CHAR_BIT - 1) / CHAR_BIT;
 			return
-				alignment - pitch % alignment ==
-				img.alignment - pitch % img.alignment;
+				(alignment     - pitch % alignment)     % alignment ==
+				(img.alignment - pitch % img.alignment) % img.alignment;
 		}
 		Image Align(const Image &img, unsigned alignment)
+		{
+			if (IsAligned(img, alignment)) return img;
+			unsigned depth = GetDepth(img.channels);
+			if (img.size.x * depth % CHAR_BIT) return AlignGeneral(img, alignment);
+			// copy whole rows of bytes
+			Image destImg =
+			{
+				img.size,
+				img.channels,
+				alignment
+			};
+			unsigned
+				width     = img.size.x * depth / CHAR_BIT,
+				srcPitch  = GetBitPitch(img.size.x, depth, img.alignment) / CHAR_BIT,
+				destPitch = GetBitPitch(img.size.x, depth, alignment)     / CHAR_BIT;
+			destImg.data.resize(GetDataSize(img.size, depth, alignment));
+			for (unsigned i = 0; i < img.size.y; ++i)
+				std::memcpy(destImg.data.data() + i * destPitch, img.data.data() + i * srcPitch, width);
+			return destImg;
+		}
+
+		// general alignment
+		Image AlignGeneral(const Image &img, unsigned alignment)
 		{
 			if (IsAligned(img, alignment)) return img;
 			Image destImg =
@@ -805,7 +1081,7 @@ namespace page
 				alignment
 			};
 			unsigned depth = GetDepth(img.channels);
-			if (alignment) // packed to aligned
+			if (!img.alignment) // packed to aligned
 			{
 				unsigned
 					srcPitch = img.size.x * depth / CHAR_BIT,
@@ -826,7 +1102,7 @@ namespace page
 					destIter += destPitch;
 				}
 			}
-			else if (img.alignment) // aligned to packed
+			else if (!alignment) // aligned to packed
 			{
 				unsigned
 					srcPitch = GetBytePitch(img.size.x, depth, img.alignment),
@@ -100,6 +100,14 @@ namespace page
 		// alignment
 		bool IsAligned(const Image &, unsigned alignment);
 		Image Align(const Image &, unsigned alignment);
+
+		// general implementations
+		// NOTE: these bypass the specialized kernels for 8-bit formats, for
+		// checking them against the bit-level code that handles any format
+		Image FlipGeneral(const Image &, const math::Vector<2, bool> &);
+		Image ScaleGeneral(const Image &, const math::Vec2u &);
+		Image ConvertGeneral(const Image &, const Image::Channels &, unsigned alignment);
+		Image AlignGeneral(const Image &, unsigned alignment);
 	}
 }
 
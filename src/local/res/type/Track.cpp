@@ -25,19 +25,20 @@
  * of this software.
  */
 
-#include <algorithm> // find, max, pop_heap, push_heap, reverse
+#include <algorithm> // binary_search, max, min, pop_heap, push_heap, sort
 #include <cassert>
+#include <cmath> // floor, sqrt
 #include <deque>
-#include <functional> // bind, less
+#include <functional> // greater
 #include <iostream> // clog
+#include <limits> // numeric_limits
+#include <utility> // pair
 
 #include "../../err/Exception.hpp"
 #include "../../log/manip.hpp" // Warning
 #include "../../math/float.hpp" // Near
-#include "../../math/interp.hpp" // Bilerp
+#include "../../math/interp.hpp" // Bilerp, Lerp
 #include "../../math/intersect.hpp" // ClosestPointOnLine, LineIntersectSecondWeight, PointInTriangle{,Edges}
-#include "../../util/functional/member.hpp" // make_member_of
-#include "../../util/iterator/member_iterator.hpp"
 #include "Registry.hpp" // REGISTER_TYPE
 #include "Track.hpp"
 
@@ -47,83 +48,107 @@ namespace page
 	{
 		namespace
 		{
-			// pathfinding
-			struct PathNode
+			// navigation
+			inline float GetPortalWidth(const Track &track, std::size_t face, unsigned edge)
 			{
-				explicit PathNode(const Track::Face *face, const Track::Face *parent = 0, float cost = 0) :
-					face(face), parent(parent), cost(cost) {}
-
-				const Track::Face *face, *parent;
-				float cost;
-			};
-			typedef std::vector<PathNode> PathNodes;
-
-			// pathfinding identity search
-			inline PathNodes::iterator Find(PathNodes &nodes, const Track::Face &neighbour)
+				if (!track.navigation.portalWidths.empty())
+					return track.navigation.portalWidths[face * 3 + edge];
+				const Track::Face &trackFace(track.faces[face]);
+				return trackFace.neighbours[edge] ? Len(Swizzle(
+					trackFace.vertices[(edge + 1) % 3] -
+					trackFace.vertices[edge], 0, 2)) : 0;
+			}
+			inline bool IsBoundaryVertex(const Track &track, std::size_t face, unsigned vertex)
 			{
-				return std::find(
-					util::make_member_iterator(nodes.begin(), &PathNode::face),
-					util::make_member_iterator(nodes.end(),   &PathNode::face),
-					&neighbour).base();
+				// NOTE: without navigation data, assume the worst
+				return track.navigation.boundaryVertices.empty() ||
+					track.navigation.boundaryVertices[face * 3 + vertex];
 			}
-			inline PathNodes::const_iterator Find(const PathNodes &nodes, const Track::Face &neighbour)
+			inline math::Vec3 GetCenter(const Track &track, std::size_t face)
 			{
-				return std::find(
-					util::make_member_iterator(nodes.begin(), &PathNode::face),
-					util::make_member_iterator(nodes.end(),   &PathNode::face),
-					&neighbour).base();
+				return !track.navigation.centers.empty() ?
+					track.navigation.centers[face] :
+					GetCenter(track.faces[face]);
 			}
 
-			// pathfinding priority queue
-			inline PathNode &Top(PathNodes &nodes)
+			// pathfinding node state
+			struct PathNode
 			{
-				return nodes.front();
-			}
-			inline const PathNode &Top(const PathNodes &nodes)
+				unsigned generation = 0;
+				bool closed;
+				std::size_t parent;
+				float cost;
+			};
+
+			/**
+			 * The per-thread state of the pathfinder, which is reused between
+			 * searches.  Nodes from earlier searches are recognized by their
+			 * generation, so the nodes don't need to be cleared.
+			 */
+			struct PathState
 			{
-				return nodes.front();
-			}
-			inline void Push(PathNodes &nodes, const PathNode &node)
+				std::vector<PathNode> nodes;
+				unsigned generation = 0;
+				typedef std::pair<float, std::size_t> OpenNode;
+				std::vector<OpenNode> open;
+			};
+
+			PathState &BeginPathSearch(std::size_t size)
 			{
-				nodes.push_back(node);
-				using std::bind;
-				using namespace std::placeholders;
-				std::push_heap(nodes.begin(), nodes.end(),
-					bind(std::less<float>(),
-						bind(util::make_member_of(&PathNode::cost), _1),
-						bind(util::make_member_of(&PathNode::cost), _2)));
+				thread_local PathState state;
+				if (state.nodes.size() < size)
+					state.nodes.resize(size);
+				if (!++state.generation)
+				{
+					// generation wrapped around
+					for (auto &node : state.nodes) node.generation = 0;
+					state.generation = 1;
+				}
+				state.open.clear();
+				return state;
 			}
-			inline PathNode Pop(PathNodes &nodes)
+
+			inline PathNode &GetPathNode(PathState &state, std::size_t index)
 			{
-				PathNode node(Top(nodes));
-				using std::bind;
-				using namespace std::placeholders;
-				std::pop_heap(nodes.begin(), nodes.end(),
-					bind(std::less<float>(),
-						bind(util::make_member_of(&PathNode::cost), _1),
-						bind(util::make_member_of(&PathNode::cost), _2)));
-				nodes.pop_back();
+				PathNode &node(state.nodes[index]);
+				if (node.generation != state.generation)
+				{
+					node.generation = state.generation;
+					node.closed = false;
+					node.parent = index;
+					node.cost = std::numeric_limits<float>::infinity();
+				}
 				return node;
 			}
+
+			// path smoothing
+			inline float TriArea2(const math::Vec2 &a, const math::Vec2 &b, const math::Vec2 &c)
+			{
+				return PerpDot(b - a, c - a);
+			}
 		}
 
 		// track construct/copy
 		Track::Track() {}
 		Track::Track(const Track &other) :
-			faces(other.faces)
+			faces(other.faces), navigation(other.navigation)
 		{
 			// remap neighbours
 			for (Faces::iterator face(faces.begin()); face != faces.end(); ++face)
 				for (Face::Neighbours::iterator neighbour(face->neighbours.begin()); neighbour != face->neighbours.end(); ++neighbour)
-					*neighbour = &*faces.begin() + (*neighbour - &*other.faces.begin());
+					if (*neighbour)
+						*neighbour = &*faces.begin() + (*neighbour - &*other.faces.begin());
 		}
 		Track &Track::operator =(const Track &other)
 		{
 			faces = other.faces;
+			navigation = other.navigation;
 			// remap neighbours
 			for (Faces::iterator face(faces.begin()); face != faces.end(); ++face)
 				for (Face::Neighbours::iterator neighbour(face->neighbours.begin()); neighbour != face->neighbours.end(); ++neighbour)
-					*neighbour = &*faces.begin() + (*neighbour - &*other.faces.begin());
+					if (*neighbour)
+						*neighbour = &*faces.begin() + (*neighbour - &*other.faces.begin());
+			return *this;
 		}
 
 		// face functions
@@ -137,6 +162,15 @@ namespace page
 		{
 			return (face.vertices[0] + face.vertices[1] + face.vertices[2]) / 3;
 		}
+		float GetHeight(const Track::Face &face, const math::Vec2 &pos)
+		{
+			math::Vec2 bc(Barycentric(
+				Swizzle(face.vertices[0], 0, 2),
+				Swizzle(face.vertices[1], 0, 2),
+				Swizzle(face.vertices[2], 0, 2),
+				pos));
+			return math::Bilerp(face.vertices[0].y, face.vertices[1].y, face.vertices[2].y, bc.x, bc.y);
+		}
 		int GetNeighbourEdge(const Track::Face &face, unsigned edge)
 		{
 			assert(edge < face.neighbours.size());
@@ -145,33 +179,138 @@ namespace page
 				if (neighbour.neighbours[i] == &face) return i;
 			return -1;
 		}
+		std::size_t GetIndex(const Track &track, const Track::Face &face)
+		{
+			assert(&face >= track.faces.data() && &face < track.faces.data() + track.faces.size());
+			return &face - track.faces.data();
+		}
+
+		// navigation
+		void BuildNavigation(Track &track)
+		{
+			Track::Navigation &navigation(track.navigation);
+			navigation = Track::Navigation();
+			if (track.faces.empty()) return;
+
+			// calculate portal widths, centers, and bounds
+			navigation.portalWidths.reserve(track.faces.size() * 3);
+			navigation.centers.reserve(track.faces.size());
+			math::Vec2
+				min(std::numeric_limits<float>::infinity()),
+				max(-std::numeric_limits<float>::infinity());
+			for (const auto &face : track.faces)
+			{
+				for (unsigned i = 0; i < 3; ++i)
+				{
+					navigation.portalWidths.push_back(face.neighbours[i] ?
+						Len(Swizzle(face.vertices[(i + 1) % 3] - face.vertices[i], 0, 2)) : 0);
+					min = Min(min, Swizzle(face.vertices[i], 0, 2));
+					max = Max(max, Swizzle(face.vertices[i], 0, 2));
+				}
+				navigation.centers.push_back(GetCenter(face));
+			}
+
+			// find the vertices on the boundary, matching them by position
+			// since neighbouring faces don't share vertices
+			auto less([](const math::Vec2 &a, const math::Vec2 &b)
+			{
+				return a.x < b.x || (a.x == b.x && a.y < b.y);
+			});
+			std::vector<math::Vec2> boundary;
+			for (const auto &face : track.faces)
+				for (unsigned i = 0; i < 3; ++i)
+					if (!face.neighbours[i])
+					{
+						boundary.push_back(Swizzle(face.vertices[i], 0, 2));
+						boundary.push_back(Swizzle(face.vertices[(i + 1) % 3], 0, 2));
+					}
+			std::sort(boundary.begin(), boundary.end(), less);
+			navigation.boundaryVertices.reserve(track.faces.size() * 3);
+			for (const auto &face : track.faces)
+				for (const auto &vertex : face.vertices)
+					navigation.boundaryVertices.push_back(std::binary_search(
+						boundary.begin(), boundary.end(), Swizzle(vertex, 0, 2), less));
+
+			// size the grid cells for about one face per cell, without
+			// letting a thin track produce more cells than faces along an
+			// axis
+			math::Vec2 extent(max - min);
+			navigation.gridOrigin = min;
+			navigation.gridCellSize = std::max({
+				std::sqrt(extent.x * extent.y / track.faces.size()),
+				Max(extent) / track.faces.size(),
+				std::numeric_limits<float>::min()});
+			navigation.gridSize = math::Vector<2, unsigned>(Floor(extent / navigation.gridCellSize)) + 1u;
+
+			// bin the faces into the cells they overlap
+			auto getCells([&navigation](const Track::Face &face)
+			{
+				math::Vec2
+					min(Swizzle(face.vertices[0], 0, 2)),
+					max(min);
+				for (unsigned i = 1; i < 3; ++i)
+				{
+					min = Min(min, Swizzle(face.vertices[i], 0, 2));
+					max = Max(max, Swizzle(face.vertices[i], 0, 2));
+				}
+				return std::make_pair(
+					Min(math::Vector<2, unsigned>(Floor((min - navigation.gridOrigin) / navigation.gridCellSize)), navigation.gridSize - 1u),
+					Min(math::Vector<2, unsigned>(Floor((max - navigation.gridOrigin) / navigation.gridCellSize)), navigation.gridSize - 1u));
+			});
+			navigation.cellStarts.resize(navigation.gridSize.x * navigation.gridSize.y + 1);
+			for (const auto &face : track.faces)
+			{
+				auto cells(getCells(face));
+				for (unsigned y = cells.first.y; y <= cells.second.y; ++y)
+					for (unsigned x = cells.first.x; x <= cells.second.x; ++x)
+						++navigation.cellStarts[y * navigation.gridSize.x + x + 1];
+			}
+			for (std::size_t i = 1; i < navigation.cellStarts.size(); ++i)
+				navigation.cellStarts[i] += navigation.cellStarts[i - 1];
+			navigation.cellFaces.resize(navigation.cellStarts.back());
+			std::vector<unsigned> cellEnds(navigation.cellStarts.begin(), navigation.cellStarts.end() - 1);
+			for (std::size_t i = 0; i < track.faces.size(); ++i)
+			{
+				auto cells(getCells(track.faces[i]));
+				for (unsigned y = cells.first.y; y <= cells.second.y; ++y)
+					for (unsigned x = cells.first.x; x <= cells.second.x; ++x)
+						navigation.cellFaces[cellEnds[y * navigation.gridSize.x + x]++] = i;
+			}
+		}
 
 		// binding
 		const Track::Face *GetBestFace(const Track &track, const math::Vec3 &pos)
 		{
+			math::Vec2 pos2(Swizzle(pos, 0, 2));
 			const Track::Face *selFace = 0;
 			float selHeight;
-			for (Track::Faces::const_iterator face(track.faces.begin()); face != track.faces.end(); ++face)
-				if (PointInTriangle(
-					Swizzle(pos, 0, 2),
-					Swizzle(face->vertices[0], 0, 2),
-					Swizzle(face->vertices[1], 0, 2),
-					Swizzle(face->vertices[2], 0, 2)))
-					if (selFace)
-					{
-						math::Vec2 bc(Barycentric(
-							Swizzle(face->vertices[0], 0, 2),
-							Swizzle(face->vertices[1], 0, 2),
-							Swizzle(face->vertices[2], 0, 2),
-							Swizzle(pos, 0, 2)));
-						float height = math::Bilerp(face->vertices[0].y, face->vertices[1].y, face->vertices[2].y, bc.x, bc.y);
-						if (height > selHeight && (height <= pos.y || math::Near(height, pos.y)))
-						{
-							selFace = &*face;
-							selHeight = height;
-						}
-					}
-					else selFace = &*face;
+			auto consider([&](const Track::Face &face)
+			{
+				if (!PointInTriangle(pos2,
+					Swizzle(face.vertices[0], 0, 2),
+					Swizzle(face.vertices[1], 0, 2),
+					Swizzle(face.vertices[2], 0, 2))) return;
+				float height = GetHeight(face, pos2);
+				if (!selFace || (height > selHeight && (height <= pos.y || math::Near(height, pos.y))))
+				{
+					selFace = &face;
+					selHeight = height;
+				}
+			});
+
+			// use the grid if the navigation data has been built
+			const Track::Navigation &navigation(track.navigation);
+			if (navigation.cellStarts.empty())
+			{
+				for (const auto &face : track.faces) consider(face);
+				return selFace;
+			}
+			math::Vec2 cell(Floor((pos2 - navigation.gridOrigin) / navigation.gridCellSize));
+			if (Any(cell < 0) || cell.x >= navigation.gridSize.x || cell.y >= navigation.gridSize.y)
+				return 0;
+			std::size_t cellIndex = unsigned(cell.y) * navigation.gridSize.x + unsigned(cell.x);
+			for (unsigned i = navigation.cellStarts[cellIndex]; i < navigation.cellStarts[cellIndex + 1]; ++i)
+				consider(track.faces[navigation.cellFaces[i]]);
 			return selFace;
 		}
 
@@ -220,43 +359,155 @@ namespace page
 		}
 
 		// pathfinding
-		TrackPath FindPath(const Track::Face &source, const Track::Face &target, float radius)
+		TrackPath FindPath(const Track &track, const Track::Face &source, const Track::Face &target, float radius)
 		{
-			// FIXME: perform collision detection with track faces to ensure
-			// that a collider with the given radius can make it through
-			PathNodes open(1, PathNode(&source)), closed;
-			while (Top(open).face != &target)
+			std::size_t
+				sourceIndex = GetIndex(track, source),
+				targetIndex = GetIndex(track, target);
+			const math::Vec3 goal(GetCenter(track, targetIndex));
+			const float minPortalWidth = radius * 2;
+
+			// A* search with a binary heap as the open set, where nodes that
+			// are improved are pushed again rather than decreased in place,
+			// and the stale entries are skipped when they are popped
+			PathState &state(BeginPathSearch(track.faces.size()));
+			std::greater<PathState::OpenNode> compare;
+			GetPathNode(state, sourceIndex).cost = 0;
+			state.open.push_back({Len(GetCenter(track, sourceIndex) - goal), sourceIndex});
+			while (!state.open.empty())
 			{
-				PathNode node(Pop(open));
-				Push(closed, node);
-				for (Track::Face::Neighbours::const_iterator iter(node.face->neighbours.begin()); iter != node.face->neighbours.end(); ++iter)
+				std::pop_heap(state.open.begin(), state.open.end(), compare);
+				std::size_t index = state.open.back().second;
+				state.open.pop_back();
+				PathNode &node(state.nodes[index]);
+				if (node.closed) continue;
+				if (index == targetIndex)
 				{
-					const Track::Face &neighbour(**iter);
-					float cost = node.cost + Len(GetCenter(neighbour) - GetCenter(*node.face));
-					PathNodes::iterator iter(Find(open, neighbour));
-					if (iter == open.end())
+					// build result by walking back through parents
+					std::deque<const Track::Face *> path;
+					for (; index != sourceIndex; index = state.nodes[index].parent)
+						path.push_front(&track.faces[index]);
+					return TrackPath(path);
+				}
+				node.closed = true;
+
+				const Track::Face &face(track.faces[index]);
+				math::Vec3 center(GetCenter(track, index));
+				for (unsigned i = 0; i < 3; ++i)
+				{
+					if (!face.neighbours[i] || GetPortalWidth(track, index, i) < minPortalWidth)
+						continue;
+					std::size_t neighbourIndex = GetIndex(track, *face.neighbours[i]);
+					PathNode &neighbour(GetPathNode(state, neighbourIndex));
+					if (neighbour.closed) continue;
+					math::Vec3 neighbourCenter(GetCenter(track, neighbourIndex));
+					float cost = node.cost + Len(neighbourCenter - center);
+					if (cost < neighbour.cost)
 					{
-						PathNodes::iterator iter(Find(closed, neighbour));
-						if (iter == closed.end())
-							Push(open, PathNode(&neighbour, node.face, cost));
-						else if (cost < iter->cost)
-							closed.erase(iter);
+						neighbour.cost = cost;
+						neighbour.parent = index;
+						state.open.push_back({cost + Len(neighbourCenter - goal), neighbourIndex});
+						std::push_heap(state.open.begin(), state.open.end(), compare);
 					}
-					else if (cost < iter->cost)
-						open.erase(iter);
 				}
 			}
-			// build result by walking back through parents
-			std::deque<const Track::Face *> path;
-			for (const Track::Face *face = Top(open).face; face != &source;)
+			return TrackPath();
+		}
+
+		// path smoothing
+		TrackWaypoints SmoothPath(const Track &track, const Track::Face &source, const math::Vec3 &origin, TrackPath path, const math::Vec3 &target, float radius)
+		{
+			// gather the edges crossed by the path, oriented so that the left
+			// vertex is on the left when crossing, and pulled in from the
+			// boundary by the radius
+			struct Portal
+			{
+				math::Vec3 left, right;
+			};
+			std::vector<Portal> portals(1, Portal{origin, origin});
+			portals.reserve(path.size() + 2);
+			for (const Track::Face *face = &source; !path.empty(); path.pop())
+			{
+				const Track::Face *next = path.front();
+				unsigned edge = 0;
+				while (edge < 3 && face->neighbours[edge] != next) ++edge;
+				assert(edge < 3);
+				std::size_t faceIndex = GetIndex(track, *face);
+				math::Vec3
+					a(face->vertices[edge]),
+					b(face->vertices[(edge + 1) % 3]);
+				if (float width = Len(Swizzle(b - a, 0, 2)))
+				{
+					float inset = std::min(radius / width, .5f);
+					math::Vec3 insetA(IsBoundaryVertex(track, faceIndex, edge) ? math::Lerp(a, b, inset) : a);
+					if (IsBoundaryVertex(track, faceIndex, (edge + 1) % 3)) b = math::Lerp(b, a, inset);
+					a = insetA;
+				}
+				math::Vec2 center(Swizzle(GetCenter(*face), 0, 2));
+				if (TriArea2(center, Swizzle(a, 0, 2), Swizzle(b, 0, 2)) > 0)
+					portals.push_back({b, a});
+				else
+					portals.push_back({a, b});
+				face = next;
+			}
+			portals.push_back({target, target});
+
+			// run the funnel algorithm
+			TrackWaypoints waypoints;
+			math::Vec2
+				apex (Swizzle(origin, 0, 2)),
+				left (apex),
+				right(apex);
+			std::size_t apexIndex = 0, leftIndex = 0, rightIndex = 0;
+			for (std::size_t i = 1; i < portals.size(); ++i)
 			{
-				path.push_front(face);
-				PathNodes::const_iterator iter(Find(open, *face));
-				assert(iter != open.end());
-				face = iter->parent;
-				assert(face);
+				math::Vec2
+					portalLeft (Swizzle(portals[i].left,  0, 2)),
+					portalRight(Swizzle(portals[i].right, 0, 2));
+
+				// narrow the right side of the funnel
+				if (TriArea2(apex, right, portalRight) >= 0)
+				{
+					if (All(apex == right) || TriArea2(apex, left, portalRight) < 0)
+					{
+						right = portalRight;
+						rightIndex = i;
+					}
+					else
+					{
+						// the right side crossed the left, so the left vertex
+						// is a corner of the path
+						waypoints.push(portals[leftIndex].left);
+						apex = right = left;
+						apexIndex = rightIndex = leftIndex;
+						i = apexIndex;
+						continue;
+					}
+				}
+
+				// narrow the left side of the funnel
+				if (TriArea2(apex, left, portalLeft) <= 0)
+				{
+					if (All(apex == left) || TriArea2(apex, right, portalLeft) > 0)
+					{
+						left = portalLeft;
+						leftIndex = i;
+					}
+					else
+					{
+						// the left side crossed the right, so the right vertex
+						// is a corner of the path
+						waypoints.push(portals[rightIndex].right);
+						apex = left = right;
+						apexIndex = leftIndex = rightIndex;
+						i = apexIndex;
+						continue;
+					}
+				}
 			}
-			return TrackPath(path);
+			if (waypoints.empty() || !All(waypoints.back() == target))
+				waypoints.push(target);
+			return waypoints;
 		}
 
 		// validation
@@ -311,6 +562,7 @@ namespace page
 		{
 			CheckContinuity(track);
 			CheckSlope(track);
+			BuildNavigation(track);
 		}
 
 		REGISTER_TYPE(Track, "track", PostLoadTrack)
@@ -29,6 +29,7 @@
 #   define page_local_res_type_Track_hpp
 
 #	include <array>
+#	include <cstddef> // size_t
 #	include <queue>
 #	include <vector>
 
@@ -57,12 +58,57 @@ namespace page
 			};
 			typedef std::vector<Face> Faces;
 			Faces faces;
+
+			/**
+			 * Navigation data that is derived from the faces by
+			 * BuildNavigation() when the track is loaded.  Faces are referred
+			 * to by their index, so the data stays valid when the track is
+			 * copied.
+			 */
+			struct Navigation
+			{
+				/**
+				 * The horizontal width of each face edge, with three
+				 * consecutive entries for each face.  Edges without a
+				 * neighbouring face have a width of zero.
+				 */
+				std::vector<float> portalWidths;
+
+				/**
+				 * Whether each face vertex is on the boundary of the track,
+				 * with three consecutive entries for each face.  Colliders
+				 * need to keep their distance from these vertices when
+				 * cutting corners.
+				 */
+				std::vector<bool> boundaryVertices;
+
+				/**
+				 * The center of each face.
+				 */
+				std::vector<math::Vec3> centers;
+
+				/**
+				 * A uniform grid over the horizontal extent of the track,
+				 * listing the faces whose bounds overlap each cell.  The faces
+				 * of cell @c i are in <tt>[cellStarts[i], cellStarts[i +
+				 * 1])</tt> of @c cellFaces, in ascending order.
+				 */
+				math::Vec2 gridOrigin;
+				float gridCellSize = 0;
+				math::Vector<2, unsigned> gridSize;
+				std::vector<unsigned> cellStarts, cellFaces;
+			} navigation;
 		};
 
 		// face functions
 		math::Vec3 GetNormal(const Track::Face &);
 		math::Vec3 GetCenter(const Track::Face &);
+		float GetHeight(const Track::Face &, const math::Vec2 &);
 		int GetNeighbourEdge(const Track::Face &, unsigned edge);
+		std::size_t GetIndex(const Track &, const Track::Face &);
+
+		// navigation
+		void BuildNavigation(Track &);
 
 		// binding
 		const Track::Face *GetBestFace(const Track &, const math::Vec3 &);
@@ -74,7 +120,25 @@ namespace page
 
 		// pathfinding
 		typedef std::queue<const Track::Face *> TrackPath;
-		TrackPath FindPath(const Track::Face &source, const Track::Face &target, float radius = 0);
+		/**
+		 * Finds the shortest sequence of faces leading from @a source to
+		 * @a target, not including @a source, through edges that are wide
+		 * enough for a collider with the given radius.  Returns an empty
+		 * path if the target can't be reached.
+		 */
+		TrackPath FindPath(const Track &, const Track::Face &source, const Track::Face &target, float radius = 0);
+
+		// path smoothing
+		typedef std::queue<math::Vec3> TrackWaypoints;
+		/**
+		 * Pulls a path returned by FindPath taut through the edges between its
+		 * faces, using the funnel algorithm, and returns the corners that a
+		 * collider with the given radius must pass through to get from
+		 * @a origin to @a target, ending with @a target.
+		 */
+		TrackWaypoints SmoothPath(const Track &, const Track::Face &source,
+			const math::Vec3 &origin, TrackPath, const math::Vec3 &target,
+			float radius = 0);
 
 		// validation
 		void CheckContinuity(const Track &);
@@ -41,6 +41,7 @@ namespace page
 			+-------------*/
 
 			public:
+			AudioStream() = default;
 			virtual ~AudioStream() = default;
 
 			/*--------------------+
@@ -28,6 +28,7 @@
 #ifndef    page_local_sys_info_hpp
 #   define page_local_sys_info_hpp
 
+#	include <cstddef> // size_t
 #	include <string>
 
 #	include <boost/optional.hpp>
@@ -73,6 +74,12 @@ namespace page
 		 * @return The value of an environment variable.
 		 */
 		boost::optional<std::string> GetEnvVar(const std::string &key);
+
+		/**
+		 * @return The largest amount of physical memory that the process has
+		 *         used since it started, in bytes.
+		 */
+		std::size_t GetPeakMemoryUsage();
 	}
 }
 
@@ -25,12 +25,14 @@
  * of this software.
  */
 
+#include <cstddef> // size_t
 #include <string>
 
 #include <boost/optional.hpp>
 
 #include <pwd.h> // getpwuid
 #include <stdlib.h> // getenv
+#include <sys/resource.h> // getrusage
 #include <sys/utsname.h> // uname
 #include <unistd.h> // get{hostname,login,uid}
 
@@ -95,5 +97,15 @@ namespace page
 			const char *value = getenv(name.c_str());
 			return value ? boost::in_place(value) : boost::none;
 		}
+
+		std::size_t GetPeakMemoryUsage()
+		{
+			struct rusage usage;
+			if (getrusage(RUSAGE_SELF, &usage) == -1)
+				THROW((err::Exception<err::SysModuleTag, err::PosixPlatformTag>("failed to get resource usage") <<
+					boost::errinfo_api_function("getrusage")))
+			// NOTE: ru_maxrss is in kilobytes
+			return std::size_t(usage.ru_maxrss) * 1024;
+		}
 	}
 }
@@ -26,6 +26,7 @@
  */
 
 #include <algorithm> // find
+#include <cstddef> // size_t
 #include <sstream> // ostringstream
 #include <string>
 #include <vector>
@@ -34,6 +35,7 @@
 
 #include <shlobj.h> // SHGetFolderPath
 #include <windows.h>
+#include <psapi.h> // GetProcessMemoryInfo
 
 // HACK: SHGFP_TYPE_CURRENT may not be defined
 #if defined __MINGW32__ && _WIN32_IE < 0x0500
@@ -196,5 +198,14 @@ namespace page
 			}
 			return boost::in_place(util::Convert<char>(&*buffer.begin()));
 		}
+
+		std::size_t GetPeakMemoryUsage()
+		{
+			PROCESS_MEMORY_COUNTERS counters;
+			if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof counters))
+				THROW((err::Exception<err::SysModuleTag, err::Win32PlatformTag>("failed to get process memory information") <<
+					boost::errinfo_api_function("GetProcessMemoryInfo")))
+			return counters.PeakWorkingSetSize;
+		}
 	}
 }
@@ -0,0 +1,59 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_sys_mapping_hpp
+#   define page_local_sys_mapping_hpp
+
+#	include <memory> // shared_ptr
+#	include <string>
+
+namespace page
+{
+	namespace sys
+	{
+		/**
+		 * A read-only view of a file that has been mapped into memory.
+		 *
+		 * @note The file remains mapped for as long as there is a reference
+		 *       to its data.
+		 */
+		struct FileMapping
+		{
+			std::shared_ptr<const char> data;
+			unsigned size = 0;
+		};
+
+		/**
+		 * Maps the entire contents of a file into memory for reading.
+		 *
+		 * @note An empty file produces a mapping with no data.
+		 */
+		FileMapping MapFile(const std::string &path);
+	}
+}
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close
+
+#include "../err/Exception.hpp"
+#include "../util/raii/ScopeGuard.hpp"
+#include "mapping.hpp"
+
+namespace page
+{
+	namespace sys
+	{
+		FileMapping MapFile(const std::string &path)
+		{
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd == -1)
+				THROW((err::Exception<err::SysModuleTag, err::PosixPlatformTag, err::FileOpenTag>("failed to open file") <<
+					boost::errinfo_api_function("open") <<
+					boost::errinfo_file_name(path)))
+			util::ScopeGuard fdGuard([fd] { close(fd); });
+
+			struct stat st;
+			if (fstat(fd, &st) == -1)
+				THROW((err::Exception<err::SysModuleTag, err::PosixPlatformTag>("failed to get file status") <<
+					boost::errinfo_api_function("fstat") <<
+					boost::errinfo_file_name(path)))
+
+			FileMapping mapping;
+			if (!(mapping.size = st.st_size)) return mapping;
+
+			// NOTE: the mapping remains valid after the descriptor is closed
+			void *data = mmap(nullptr, mapping.size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data == MAP_FAILED)
+				THROW((err::Exception<err::SysModuleTag, err::PosixPlatformTag>("failed to map file") <<
+					boost::errinfo_api_function("mmap") <<
+					boost::errinfo_file_name(path)))
+
+			unsigned size = mapping.size;
+			mapping.data.reset(static_cast<const char *>(data),
+				[size](const char *data) { munmap(const_cast<char *>(data), size); });
+			return mapping;
+		}
+	}
+}
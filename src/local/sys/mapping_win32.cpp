@@ -0,0 +1,72 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <windows.h>
+
+#include "../err/Exception.hpp"
+#include "../util/locale/convert.hpp" // Convert
+#include "../util/raii/ScopeGuard.hpp"
+#include "mapping.hpp"
+
+namespace page
+{
+	namespace sys
+	{
+		FileMapping MapFile(const std::string &path)
+		{
+			HANDLE file = CreateFile(util::Convert<TCHAR>(path).c_str(),
+				GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				THROW((err::Exception<err::SysModuleTag, err::Win32PlatformTag, err::FileOpenTag>("failed to open file") <<
+					boost::errinfo_api_function("CreateFile") <<
+					boost::errinfo_file_name(path)))
+			util::ScopeGuard fileGuard([file] { CloseHandle(file); });
+
+			FileMapping mapping;
+			if (!(mapping.size = GetFileSize(file, nullptr))) return mapping;
+
+			// NOTE: the view remains valid after the handles are closed
+			HANDLE fileMapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!fileMapping)
+				THROW((err::Exception<err::SysModuleTag, err::Win32PlatformTag>("failed to create file mapping") <<
+					boost::errinfo_api_function("CreateFileMapping") <<
+					boost::errinfo_file_name(path)))
+			util::ScopeGuard fileMappingGuard([fileMapping] { CloseHandle(fileMapping); });
+
+			void *data = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+			if (!data)
+				THROW((err::Exception<err::SysModuleTag, err::Win32PlatformTag>("failed to map view of file") <<
+					boost::errinfo_api_function("MapViewOfFile") <<
+					boost::errinfo_file_name(path)))
+
+			mapping.data.reset(static_cast<const char *>(data),
+				[](const char *data) { UnmapViewOfFile(data); });
+			return mapping;
+		}
+	}
+}
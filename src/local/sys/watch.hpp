@@ -0,0 +1,86 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_sys_watch_hpp
+#   define page_local_sys_watch_hpp
+
+#	include <memory> // unique_ptr
+#	include <string>
+#	include <vector>
+
+namespace page
+{
+	namespace sys
+	{
+		/**
+		 * A file or directory that was created, modified, or removed.
+		 */
+		struct DirectoryChange
+		{
+			/**
+			 * The path of the file or directory, relative to the root of the
+			 * watched tree.
+			 */
+			std::string path;
+
+			/**
+			 * @c true if the path is a directory, in which case anything
+			 * within it may have changed.
+			 */
+			bool directory;
+		};
+
+		/**
+		 * A subscription to the changes made to a directory tree, which are
+		 * queued by the operating system until they are polled.
+		 */
+		struct DirectoryWatcher
+		{
+			virtual ~DirectoryWatcher() = default;
+
+			/**
+			 * Appends the changes that have been made since the last call,
+			 * without blocking.
+			 *
+			 * @return @c false if some of the changes were lost, such as when
+			 *         the queue overflowed, in which case the whole tree
+			 *         should be considered to have changed.
+			 */
+			virtual bool Poll(std::vector<DirectoryChange> &) = 0;
+		};
+
+		/**
+		 * Starts watching the directory tree.
+		 *
+		 * @return The watcher, or @c nullptr if watching isn't supported on
+		 *         this platform or failed to start.
+		 */
+		std::unique_ptr<DirectoryWatcher> WatchDirectory(const std::string &path);
+	}
+}
+
+#endif
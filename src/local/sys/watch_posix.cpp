@@ -0,0 +1,167 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#if defined __linux__
+#	include <cerrno>
+#	include <climits> // NAME_MAX
+#	include <dirent.h> // {close,open,read}dir
+#	include <sys/inotify.h>
+#	include <unistd.h> // close, read
+#	include <unordered_map>
+#endif
+
+#include "watch.hpp"
+
+namespace page
+{
+	namespace sys
+	{
+#if defined __linux__
+		namespace
+		{
+			/**
+			 * A directory watcher that uses inotify, which needs a watch for
+			 * every directory in the tree.
+			 */
+			class InotifyWatcher : public DirectoryWatcher
+			{
+				public:
+				explicit InotifyWatcher(const std::string &root) :
+					root(root),
+					fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {}
+
+				~InotifyWatcher()
+				{
+					if (fd != -1) close(fd);
+				}
+
+				/**
+				 * @return @c true if the watcher started successfully.
+				 */
+				bool Start()
+				{
+					return fd != -1 && AddWatch("");
+				}
+
+				bool Poll(std::vector<DirectoryChange> &changes) override
+				{
+					bool complete = true;
+					alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+					for (;;)
+					{
+						ssize_t size = read(fd, buffer, sizeof buffer);
+						if (size <= 0) break; // EAGAIN, no more events
+						for (const char *p = buffer; p < buffer + size;)
+						{
+							const inotify_event &event(*reinterpret_cast<const inotify_event *>(p));
+							p += sizeof event + event.len;
+
+							if (event.mask & IN_Q_OVERFLOW)
+							{
+								complete = false;
+								continue;
+							}
+							auto iter(watches.find(event.wd));
+							if (iter == watches.end()) continue;
+							if (event.mask & IN_IGNORED)
+							{
+								watches.erase(iter);
+								continue;
+							}
+							if (!event.len) continue;
+
+							std::string path(iter->second.empty() ?
+								std::string(event.name) :
+								iter->second + '/' + event.name);
+							bool directory = event.mask & IN_ISDIR;
+							// a new directory needs its own watches, which
+							// might be added after files were created in it,
+							// so the whole directory is reported
+							if (directory && event.mask & (IN_CREATE | IN_MOVED_TO))
+								if (!AddWatch(path)) complete = false;
+							changes.push_back(DirectoryChange{path, directory});
+						}
+					}
+					return complete;
+				}
+
+				private:
+				/**
+				 * Watches the directory and all of its subdirectories.
+				 */
+				bool AddWatch(const std::string &path)
+				{
+					std::string absPath(path.empty() ? root : root + '/' + path);
+					// NOTE: files are reported when they are closed after
+					// writing, rather than on each write, so that they aren't
+					// reloaded while they are only partly written
+					int wd = inotify_add_watch(fd, absPath.c_str(),
+						IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+						IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+					// NOTE: the path may have been removed already, or may not
+					// be a directory if its type couldn't be determined
+					if (wd == -1) return errno == ENOENT || errno == ENOTDIR;
+					watches[wd] = path;
+
+					bool complete = true;
+					if (DIR *dir = opendir(absPath.c_str()))
+					{
+						while (const dirent *entry = readdir(dir))
+						{
+							std::string name(entry->d_name);
+							if (name == "." || name == "..") continue;
+							if (entry->d_type == DT_DIR || entry->d_type == DT_UNKNOWN)
+								if (!AddWatch(path.empty() ? name : path + '/' + name))
+									complete = false;
+						}
+						closedir(dir);
+					}
+					return complete;
+				}
+
+				std::string root;
+				int fd;
+
+				/**
+				 * The path of each watched directory, relative to the root,
+				 * by its watch descriptor.
+				 */
+				std::unordered_map<int, std::string> watches;
+			};
+		}
+#endif
+
+		std::unique_ptr<DirectoryWatcher> WatchDirectory(const std::string &path)
+		{
+#if defined __linux__
+			std::unique_ptr<InotifyWatcher> watcher(new InotifyWatcher(path));
+			if (watcher->Start()) return std::move(watcher);
+#endif
+			return nullptr;
+		}
+	}
+}
@@ -90,8 +90,8 @@ namespace page { namespace util
 	 */
 	template <typename Derived>
 		class StateSaver :
-			public Polymorphic<StateSaver>,
-			public Uncopyable<StateSaver>
+			public Polymorphic<StateSaver<Derived>>,
+			public Uncopyable<StateSaver<Derived>>
 	{
 		/*-------------+
 		| constructors |
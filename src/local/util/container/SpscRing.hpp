@@ -0,0 +1,131 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_util_container_SpscRing_hpp
+#   define page_local_util_container_SpscRing_hpp
+
+#	include <atomic>
+#	include <cstddef> // size_t
+#	include <vector>
+
+#	include "../class/special_member_functions.hpp" // Uncopyable
+
+namespace page
+{
+	namespace util
+	{
+		/**
+		 * A fixed-capacity ring of preallocated slots, which is safe to use
+		 * without locking between one producer thread and one consumer thread.
+		 *
+		 * The producer fills the slot returned by GetWriteSlot() in place and
+		 * then publishes it with Push().  The consumer reads the slot returned
+		 * by GetReadSlot() in place and then releases it with Pop().  Slots
+		 * are never destroyed, so any memory that they own is reused.
+		 */
+		template <typename T>
+			class SpscRing : public Uncopyable<SpscRing<T>>
+		{
+			/*-------------+
+			| constructors |
+			+-------------*/
+
+			public:
+			explicit SpscRing(std::size_t capacity, const T & = T());
+
+			/*----------+
+			| observers |
+			+----------*/
+
+			/**
+			 * Returns the number of published slots that haven't been popped.
+			 * The value may already be out of date when it is returned.
+			 */
+			std::size_t GetSize() const;
+
+			std::size_t GetCapacity() const;
+
+			/*--------------------+
+			| producer operations |
+			+--------------------*/
+
+			/**
+			 * Returns the next slot to fill, or @c nullptr if the ring is
+			 * full.
+			 */
+			T *GetWriteSlot();
+
+			/**
+			 * Publishes the slot returned by GetWriteSlot().
+			 */
+			void Push();
+
+			/*--------------------+
+			| consumer operations |
+			+--------------------*/
+
+			/**
+			 * Returns the oldest published slot, or @c nullptr if the ring is
+			 * empty.
+			 */
+			T *GetReadSlot();
+
+			/**
+			 * Releases the slot returned by GetReadSlot() to the producer.
+			 */
+			void Pop();
+
+			/*-------------+
+			| data members |
+			+-------------*/
+
+			private:
+			std::vector<T> slots;
+
+			/**
+			 * The number of slots that have been popped, which is only
+			 * written by the consumer.
+			 */
+			std::atomic<std::size_t> head;
+
+			/**
+			 * Padding to keep the producer and consumer indices on separate
+			 * cache lines.
+			 */
+			char padding[64];
+
+			/**
+			 * The number of slots that have been pushed, which is only
+			 * written by the producer.
+			 */
+			std::atomic<std::size_t> tail;
+		};
+	}
+}
+
+#	include "SpscRing.tpp"
+#endif
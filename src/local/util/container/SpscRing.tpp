@@ -0,0 +1,110 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // min
+#include <cassert>
+
+namespace page
+{
+	namespace util
+	{
+		/*-------------+
+		| constructors |
+		+-------------*/
+
+		template <typename T>
+			SpscRing<T>::SpscRing(std::size_t capacity, const T &value) :
+				slots(capacity, value), head(0), tail(0)
+		{
+			assert(capacity);
+		}
+
+		/*----------+
+		| observers |
+		+----------*/
+
+		template <typename T>
+			std::size_t SpscRing<T>::GetSize() const
+		{
+			// NOTE: the head is loaded first, since the tail never falls
+			// behind it, so the difference can't wrap around below zero;
+			// the head may have moved on by the time that the tail is
+			// loaded, so the size is clamped to the capacity
+			std::size_t first = head.load(std::memory_order_acquire);
+			std::size_t last  = tail.load(std::memory_order_acquire);
+			return std::min(last - first, slots.size());
+		}
+
+		template <typename T>
+			std::size_t SpscRing<T>::GetCapacity() const
+		{
+			return slots.size();
+		}
+
+		/*--------------------+
+		| producer operations |
+		+--------------------*/
+
+		template <typename T>
+			T *SpscRing<T>::GetWriteSlot()
+		{
+			std::size_t index = tail.load(std::memory_order_relaxed);
+			if (index - head.load(std::memory_order_acquire) == slots.size())
+				return nullptr;
+			return &slots[index % slots.size()];
+		}
+
+		template <typename T>
+			void SpscRing<T>::Push()
+		{
+			std::size_t index = tail.load(std::memory_order_relaxed);
+			assert(index - head.load(std::memory_order_acquire) < slots.size());
+			tail.store(index + 1, std::memory_order_release);
+		}
+
+		/*--------------------+
+		| consumer operations |
+		+--------------------*/
+
+		template <typename T>
+			T *SpscRing<T>::GetReadSlot()
+		{
+			std::size_t index = head.load(std::memory_order_relaxed);
+			if (index == tail.load(std::memory_order_acquire))
+				return nullptr;
+			return &slots[index % slots.size()];
+		}
+
+		template <typename T>
+			void SpscRing<T>::Pop()
+		{
+			std::size_t index = head.load(std::memory_order_relaxed);
+			assert(index != tail.load(std::memory_order_acquire));
+			head.store(index + 1, std::memory_order_release);
+		}
+	}
+}
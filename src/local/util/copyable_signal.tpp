@@ -46,7 +46,10 @@ namespace page { namespace util
 
 	template <typename Signature>
 		copyable_signal<Signature> &
-		copyable_signal<Signature>::operator =(const copyable_signal &other) {}
+		copyable_signal<Signature>::operator =(const copyable_signal &other)
+	{
+		return *this;
+	}
 
 	template <typename Signature>
 		copyable_signal<Signature>::copyable_signal(copyable_signal &&other)
@@ -67,5 +70,6 @@ namespace page { namespace util
 		 * @sa http://thread.gmane.org/gmane.comp.lib.boost.user/75108
 		 */
 		this->connect(other);
+		return *this;
 	}
 }}
@@ -0,0 +1,138 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // max, min
+#include <atomic>
+#include <exception> // current_exception, exception_ptr, rethrow_exception
+#include <memory> // make_shared
+
+#include "WorkerPool.hpp"
+
+namespace page
+{
+	namespace util
+	{
+		// constructor/destructor
+		WorkerPool::WorkerPool(unsigned size)
+		{
+			// NOTE: hardware_concurrency may return 0 if it is unknown
+			size = std::max(size, 1u);
+			threads.reserve(size);
+			for (unsigned i = 0; i < size; ++i)
+				threads.emplace_back(&WorkerPool::Work, this);
+		}
+		WorkerPool::~WorkerPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				done = true;
+			}
+			condition.notify_all();
+			for (auto &thread : threads) thread.join();
+		}
+
+		// modifiers
+		std::future<void> WorkerPool::Post(const Job &job)
+		{
+			// NOTE: the task is shared because Job must be copyable
+			auto task(std::make_shared<std::packaged_task<void ()>>(job));
+			auto future(task->get_future());
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				jobs.push_back([task] { (*task)(); });
+			}
+			condition.notify_one();
+			return future;
+		}
+
+		void WorkerPool::ParallelFor(std::size_t size, std::size_t grain,
+			const std::function<void (std::size_t, std::size_t)> &job)
+		{
+			grain = std::max<std::size_t>(grain, 1);
+			struct State
+			{
+				std::atomic<std::size_t> next{0};
+				std::size_t done = 0;
+				std::exception_ptr exception;
+				std::mutex mutex;
+				std::condition_variable condition;
+			};
+			auto state(std::make_shared<State>());
+			const std::size_t chunks = (size + grain - 1) / grain;
+
+			// NOTE: job is only called for chunks that haven't been claimed
+			// yet, and this function doesn't return until every chunk has
+			// finished, so the reference can't dangle
+			auto run([state, chunks, size, grain, &job]
+			{
+				for (std::size_t chunk; (chunk = state->next++) < chunks;)
+				{
+					std::size_t first = chunk * grain, finished = 1;
+					try
+					{
+						job(first, std::min(first + grain, size));
+					}
+					catch (...)
+					{
+						// claim the remaining chunks so that they aren't
+						// started, and count them as finished
+						finished += chunks - std::min(state->next.exchange(chunks), chunks);
+						std::lock_guard<std::mutex> lock(state->mutex);
+						if (!state->exception)
+							state->exception = std::current_exception();
+					}
+					std::lock_guard<std::mutex> lock(state->mutex);
+					if ((state->done += finished) == chunks)
+						state->condition.notify_all();
+				}
+			});
+			std::size_t helpers = std::min<std::size_t>(chunks ? chunks - 1 : 0, threads.size());
+			for (std::size_t i = 0; i < helpers; ++i) Post(run);
+			run();
+
+			std::unique_lock<std::mutex> lock(state->mutex);
+			state->condition.wait(lock, [&] { return state->done == chunks; });
+			if (state->exception) std::rethrow_exception(state->exception);
+		}
+
+		void WorkerPool::Work()
+		{
+			for (;;)
+			{
+				Job job;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					condition.wait(lock, [this] { return done || !jobs.empty(); });
+					if (jobs.empty()) return;
+					job = std::move(jobs.front());
+					jobs.pop_front();
+				}
+				job();
+			}
+		}
+	}
+}
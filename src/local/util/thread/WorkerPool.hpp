@@ -0,0 +1,96 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_util_thread_WorkerPool_hpp
+#   define page_local_util_thread_WorkerPool_hpp
+
+#	include <condition_variable>
+#	include <cstddef> // size_t
+#	include <deque>
+#	include <functional> // function
+#	include <future>
+#	include <mutex>
+#	include <thread>
+#	include <vector>
+
+#	include "../class/special_member_functions.hpp" // Unmovable
+
+namespace page
+{
+	namespace util
+	{
+		/**
+		 * A fixed set of threads for running jobs in the background.
+		 *
+		 * Jobs are run in the order that they are posted, but more than one
+		 * job may be running at a time.  Any jobs that are still queued when
+		 * the pool is destroyed are run to completion first.
+		 *
+		 * An exception that escapes a job is passed back to the caller, through
+		 * the future returned by Post() or by rethrowing it from ParallelFor(),
+		 * rather than terminating the worker.
+		 */
+		struct WorkerPool : Unmovable<WorkerPool>
+		{
+			typedef std::function<void ()> Job;
+
+			// constructor/destructor
+			explicit WorkerPool(unsigned size = std::thread::hardware_concurrency());
+			~WorkerPool();
+
+			// modifiers
+			/**
+			 * Queues a job.
+			 *
+			 * @return A future that becomes ready when the job has finished,
+			 *         and which holds any exception that the job threw.
+			 */
+			std::future<void> Post(const Job &);
+
+			/**
+			 * Splits [0, size) into ranges of at most @a grain elements and
+			 * runs @a job on each of them, using the calling thread as well
+			 * as the workers.  Returns once every range that was started has
+			 * finished.  If a range throws, no more ranges are started, and
+			 * the first exception is rethrown.
+			 */
+			void ParallelFor(std::size_t size, std::size_t grain,
+				const std::function<void (std::size_t first, std::size_t last)> &job);
+
+			private:
+			void Work();
+
+			std::vector<std::thread> threads;
+			std::deque<Job> jobs;
+			std::mutex mutex;
+			std::condition_variable condition;
+			bool done = false;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // max
+#include <cassert>
+#include <limits> // numeric_limits
+
+#include "GlyphAtlas.hpp"
+
+namespace page
+{
+	namespace vid
+	{
+		// construct
+		GlyphAtlas::GlyphAtlas(const math::Vec2u &size, unsigned padding) :
+			size(size), padding(padding)
+		{
+			assert(All(size));
+			Span span = {0, 0, size.x};
+			skyline.push_back(span);
+		}
+
+		// size
+		const math::Vec2u &GlyphAtlas::GetSize() const
+		{
+			return size;
+		}
+
+		// sections
+		const math::Aabb<2> *GlyphAtlas::GetSection(char32_t c) const
+		{
+			Sections::const_iterator iter(sections.find(c));
+			return iter != sections.end() ? &iter->second : nullptr;
+		}
+
+		// insertion
+		bool GlyphAtlas::Insert(char32_t c, const math::Vec2u &glyphSize, math::Vec2u &pos)
+		{
+			math::Vec2u paddedSize(glyphSize + padding);
+			// find the span where the glyph rests lowest, preferring the
+			// narrowest span to break ties, which leaves less wasted space
+			// under the skyline
+			std::vector<Span>::size_type best = skyline.size();
+			unsigned bestY = std::numeric_limits<unsigned>::max(), bestWidth = 0;
+			for (std::vector<Span>::size_type i = 0; i < skyline.size(); ++i)
+			{
+				unsigned y;
+				if (Fit(i, paddedSize, y) &&
+					(y < bestY || (y == bestY && skyline[i].width < bestWidth)))
+				{
+					best = i;
+					bestY = y;
+					bestWidth = skyline[i].width;
+				}
+			}
+			if (best == skyline.size()) return false;
+			pos = math::Vec2u(skyline[best].x, bestY);
+			// raise the skyline over the glyph
+			Span span = {pos.x, bestY + paddedSize.y, paddedSize.x};
+			skyline.insert(skyline.begin() + best, span);
+			for (std::vector<Span>::size_type i = best + 1; i < skyline.size();)
+			{
+				Span &prev(skyline[i - 1]), &next(skyline[i]);
+				if (next.x >= prev.x + prev.width) break;
+				unsigned shrink = prev.x + prev.width - next.x;
+				if (shrink < next.width)
+				{
+					next.x += shrink;
+					next.width -= shrink;
+					break;
+				}
+				skyline.erase(skyline.begin() + i);
+			}
+			// merge neighbouring spans of the same height
+			for (std::vector<Span>::size_type i = 1; i < skyline.size();)
+			{
+				if (skyline[i - 1].y == skyline[i].y)
+				{
+					skyline[i - 1].width += skyline[i].width;
+					skyline.erase(skyline.begin() + i);
+				}
+				else ++i;
+			}
+			// insert section
+			math::Vec2
+				min(math::Vec2(pos) / size),
+				max(min + math::Vec2(glyphSize) / size);
+			sections[c] = math::Aabb<2>(min, max);
+			return true;
+		}
+		void GlyphAtlas::Grow()
+		{
+			math::Vec2u oldSize(size);
+			if (size.x <= size.y)
+			{
+				Span span = {size.x, 0, size.x};
+				skyline.push_back(span);
+				size.x *= 2;
+			}
+			else size.y *= 2;
+			// rescale the texture coordinates of the existing glyphs
+			math::Vec2 scale(math::Vec2(oldSize) / size);
+			for (Sections::iterator iter(sections.begin()); iter != sections.end(); ++iter)
+			{
+				iter->second.min *= scale;
+				iter->second.max *= scale;
+			}
+		}
+
+		bool GlyphAtlas::Fit(std::vector<Span>::size_type i, const math::Vec2u &glyphSize, unsigned &y) const
+		{
+			unsigned x = skyline[i].x;
+			if (x + glyphSize.x > size.x) return false;
+			y = 0;
+			for (unsigned width = 0; width < glyphSize.x; width += skyline[i++].width)
+			{
+				assert(i < skyline.size());
+				y = std::max(y, skyline[i].y);
+				if (y + glyphSize.y > size.y) return false;
+			}
+			return true;
+		}
+	}
+}
@@ -0,0 +1,101 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_vid_GlyphAtlas_hpp
+#   define page_local_vid_GlyphAtlas_hpp
+
+#	include <unordered_map>
+#	include <vector>
+
+#	include "../math/Aabb.hpp"
+#	include "../math/Vector.hpp"
+
+namespace page
+{
+	namespace vid
+	{
+		/**
+		 * The layout of a texture that glyphs are packed into as they are
+		 * needed, using the skyline bottom-left heuristic.
+		 *
+		 * The atlas only tracks where each glyph is placed; it is up to the
+		 * owner to copy the glyph images into the texture.  It doesn't
+		 * depend on any particular rendering platform.
+		 */
+		struct GlyphAtlas
+		{
+			// construct
+			explicit GlyphAtlas(const math::Vec2u &size, unsigned padding = 1);
+
+			// size
+			const math::Vec2u &GetSize() const;
+
+			// sections
+			/**
+			 * @return The texture coordinates of the glyph, or @c nullptr if
+			 *         it hasn't been inserted.
+			 */
+			const math::Aabb<2> *GetSection(char32_t) const;
+
+			// insertion
+			/**
+			 * Finds space for a glyph image of the given size.
+			 *
+			 * @return @c true if the glyph was inserted, in which case @a pos
+			 *         is set to its position in texels, or @c false if there
+			 *         isn't enough space left in the atlas.
+			 */
+			bool Insert(char32_t, const math::Vec2u &size, math::Vec2u &pos);
+
+			/**
+			 * Doubles the size of the atlas along its shorter side.  Glyphs
+			 * that have already been inserted keep their positions in
+			 * texels, but their texture coordinates change.
+			 */
+			void Grow();
+
+			private:
+			// the top edge of the packed region over a range of columns
+			struct Span
+			{
+				unsigned x, y, width;
+			};
+
+			// returns the height at which a rectangle would rest on the
+			// skyline at the given span, or false if it doesn't fit
+			bool Fit(std::vector<Span>::size_type, const math::Vec2u &size, unsigned &y) const;
+
+			math::Vec2u size;
+			unsigned padding;
+			std::vector<Span> skyline;
+			typedef std::unordered_map<char32_t, math::Aabb<2>> Sections;
+			Sections sections;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,335 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#include <algorithm> // find, find_if, find_if_not, none_of
+#include <cctype> // isspace
+#include <climits> // UCHAR_MAX
+#include <cmath> // sqrt
+#include <functional> // hash
+
+#include "../util/hash.hpp" // combine_hash
+#include "GlyphAtlas.hpp"
+#include "TextLayout.hpp"
+
+namespace page
+{
+	namespace vid
+	{
+		namespace
+		{
+			// the maximum number of layouts in the cache
+			const std::size_t layoutCacheSize = 256;
+
+			// the C library only classifies characters in the range of
+			// unsigned char, so anything beyond it is not whitespace
+			bool IsSpace(char32_t c)
+			{
+				return c <= UCHAR_MAX && std::isspace(c);
+			}
+
+			// UTF-8 decoding
+			// NOTE: malformed sequences are decoded as U+FFFD
+			std::u32string DecodeUtf8(const std::string &s)
+			{
+				std::u32string r;
+				r.reserve(s.size());
+				for (std::string::const_iterator iter(s.begin()); iter != s.end();)
+				{
+					unsigned char lead = *iter++;
+					if (lead < 0x80)
+					{
+						r.push_back(lead);
+						continue;
+					}
+					unsigned n;
+					char32_t c;
+					if      ((lead & 0xe0) == 0xc0) { n = 1; c = lead & 0x1f; }
+					else if ((lead & 0xf0) == 0xe0) { n = 2; c = lead & 0x0f; }
+					else if ((lead & 0xf8) == 0xf0) { n = 3; c = lead & 0x07; }
+					else
+					{
+						r.push_back(0xfffd);
+						continue;
+					}
+					for (; n && iter != s.end() && (*iter & 0xc0) == 0x80; --n, ++iter)
+						c = c << 6 | (*iter & 0x3f);
+					r.push_back(n || c > 0x10ffff ? 0xfffd : c);
+				}
+				return r;
+			}
+
+			// metrics
+			float GetAdvance(const res::Font &font,
+				std::u32string::const_iterator c,
+				std::u32string::const_iterator last)
+			{
+				std::u32string::const_iterator next(c + 1);
+				return next != last ?
+					res::GetAdvance(font, *c, *next) :
+					res::GetAdvance(font, *c);
+			}
+			float GetLineWidth(const res::Font &font,
+				std::u32string::const_iterator first,
+				std::u32string::const_iterator last)
+			{
+				float width = 0;
+				for (std::u32string::const_iterator c(first); c != last; ++c)
+					width += GetAdvance(font, c, last);
+				return width;
+			}
+
+			// line wrapping
+			// NOTE: follows res::Wrap, but works on code points
+			std::u32string Wrap(const res::Font &font, std::u32string s, float width)
+			{
+				float offset = 0, hardOffset = 0;
+				std::u32string::iterator space(s.end());
+				char32_t lastChar = 0;
+				for (std::u32string::iterator c(s.begin()); c != s.end(); ++c)
+				{
+					if (*c == '\n')
+					{
+						offset = 0;
+						space = s.end();
+						continue;
+					}
+					if (IsSpace(*c) && !IsSpace(lastChar))
+					{
+						hardOffset = offset;
+						space = c;
+					}
+					offset += GetAdvance(font, c, s.end());
+					if (offset > width && space != s.end())
+					{
+						std::u32string::iterator endSpace(std::find_if_not(space, s.end(), IsSpace));
+						std::u32string::iterator::difference_type index = c - s.begin() - (endSpace - space - 1);
+						s.replace(space, endSpace, 1, '\n');
+						c = s.begin() + index;
+						offset -= hardOffset;
+						space = s.end();
+					}
+					lastChar = *c;
+				}
+				return s;
+			}
+		}
+
+		// layout
+		TextLayout LayoutText(const res::Font &font, const std::string &text,
+			float width, bool wrap, res::TextAlign align)
+		{
+			std::u32string s(DecodeUtf8(text));
+			if (wrap) s = Wrap(font, s, width);
+			TextLayout layout;
+			layout.glyphs.reserve(s.size());
+			math::Vec2 pen(0, font.maxBearing.y);
+			for (std::u32string::const_iterator line(s.cbegin()); line != s.cend();)
+			{
+				std::u32string::const_iterator end(std::find(line, s.cend(), '\n'));
+				// calculate offset for alignment and whitespace coefficient
+				// for justified alignment, which spreads the letters of a
+				// line without whitespace instead, and falls back to
+				// centering when the line can't be stretched to fit
+				float offset = 0, space = 1, letterSpace = 0;
+				switch (align)
+				{
+					case res::justifyTextAlign:
+					{
+						float
+							lineWidth = GetLineWidth(font, line, end),
+							spaceWidth = 0;
+						for (std::u32string::const_iterator c(line); c != end; ++c)
+							if (IsSpace(*c)) spaceWidth += GetAdvance(font, c, end);
+						if (lineWidth <= width)
+						{
+							if (spaceWidth)
+							{
+								space = (spaceWidth + width - lineWidth) / spaceWidth;
+								break;
+							}
+							if (end - line >= 2)
+							{
+								letterSpace = (width - lineWidth) / (end - line - 1);
+								break;
+							}
+						}
+					}
+					case res::centerTextAlign:
+					offset = (width - GetLineWidth(font, line, end)) / 2;
+					break;
+					case res::rightTextAlign:
+					offset = width - GetLineWidth(font, line, end);
+					break;
+					default:;
+				}
+				// generate glyph coordinates
+				pen.x += offset;
+				for (std::u32string::const_iterator c(line); c != end; ++c)
+				{
+					if (!IsSpace(*c))
+						if (const res::Font::Glyph *glyph = GetGlyph(font, *c))
+						{
+							math::Vec2 co(pen);
+							co.x += glyph->bearing.x;
+							co.y -= glyph->bearing.y;
+							TextLayout::Glyph layoutGlyph =
+							{
+								font.glyphs.count(*c) ? *c : 0,
+								math::Aabb<2>(co, co + glyph->size)
+							};
+							layout.glyphs.push_back(layoutGlyph);
+						}
+					float advance = GetAdvance(font, c, end);
+					if (IsSpace(*c)) advance *= space;
+					pen.x += advance + letterSpace;
+				}
+				if (end == s.cend()) break;
+				line = std::find_if(end + 1, s.cend(),
+					[](char32_t c) { return c != '\n'; });
+				pen = math::Vec2(0, pen.y + font.lineHeight * (line - end));
+			}
+			return layout;
+		}
+
+		// text layout cache access
+		std::shared_ptr<const TextLayout> TextLayoutCache::Get(
+			const std::shared_ptr<const res::Font> &font,
+			const std::string &text, float width, bool wrap,
+			res::TextAlign align)
+		{
+			// the width doesn't affect unwrapped, left-aligned text
+			if (!wrap && align == res::leftTextAlign) width = 0;
+			Key key = {font.get(), text, width, wrap, align};
+			Index::iterator iter(index.find(key));
+			if (iter != index.end())
+			{
+				entries.splice(entries.begin(), entries, iter->second);
+				return iter->second->second.layout;
+			}
+			// generate new layout
+			Entry entry =
+			{
+				font,
+				std::make_shared<TextLayout>(LayoutText(*font, text, width, wrap, align))
+			};
+			entries.emplace_front(key, entry);
+			index.insert(std::make_pair(key, entries.begin()));
+			// evict least recently used layout
+			if (entries.size() > layoutCacheSize)
+			{
+				index.erase(entries.back().first);
+				entries.pop_back();
+			}
+			return entry.layout;
+		}
+
+		// text layout cache modifiers
+		void TextLayoutCache::Clear()
+		{
+			index.clear();
+			entries.clear();
+		}
+
+		// text layout cache key
+		bool TextLayoutCache::Key::operator ==(const Key &other) const
+		{
+			return
+				font  == other.font  &&
+				width == other.width &&
+				wrap  == other.wrap  &&
+				align == other.align &&
+				text  == other.text;
+		}
+		std::size_t TextLayoutCache::KeyHash::operator ()(const Key &key) const
+		{
+			return util::combine_hash(
+				util::combine_hash(
+					std::hash<const res::Font *>()(key.font),
+					std::hash<std::string>()(key.text)),
+				util::combine_hash(
+					std::hash<float>()(key.width),
+					key.align << 1 | key.wrap));
+		}
+
+		// vertex generation
+		void GetTextVertices(const TextLayout &layout, const GlyphAtlas &atlas,
+			const math::Vec2 &origin, const math::Vec2 &scale,
+			const math::RgbaColor<> &topColor,
+			const math::RgbaColor<> &bottomColor, float borderSize,
+			const math::RgbaColor<> &borderColor,
+			std::vector<TextVertex> &vertices)
+		{
+			vertices.clear();
+			vertices.reserve(layout.glyphs.size() * 4 * (borderSize ? 9 : 1));
+			// generate quads for each glyph, offset and in a single color
+			// for the border, or in a vertical gradient for the glyph
+			auto GenerateQuads = [&](const math::Vec2 &offset,
+				const math::RgbaColor<> &topColor,
+				const math::RgbaColor<> &bottomColor)
+			{
+				for (TextLayout::Glyphs::const_iterator glyph(layout.glyphs.begin()); glyph != layout.glyphs.end(); ++glyph)
+				{
+					const math::Aabb<2> *uv = atlas.GetSection(glyph->c);
+					if (!uv) continue;
+					math::Vec2
+						min(origin + glyph->co.min * scale + offset),
+						max(origin + glyph->co.max * scale + offset);
+					TextVertex quad[4] =
+					{
+						{{max.x, min.y}, {uv->max.x, uv->min.y}, {topColor.r,    topColor.g,    topColor.b,    topColor.a}},
+						{{min.x, min.y}, {uv->min.x, uv->min.y}, {topColor.r,    topColor.g,    topColor.b,    topColor.a}},
+						{{min.x, max.y}, {uv->min.x, uv->max.y}, {bottomColor.r, bottomColor.g, bottomColor.b, bottomColor.a}},
+						{{max.x, max.y}, {uv->max.x, uv->max.y}, {bottomColor.r, bottomColor.g, bottomColor.b, bottomColor.a}}
+					};
+					vertices.insert(vertices.end(), quad, quad + 4);
+				}
+			};
+			// generate border
+			if (borderSize)
+			{
+				math::Vec2
+					jitter(borderSize * scale),
+					diagJitter(jitter / std::sqrt(2.f));
+				const math::Vec2 offsets[] =
+				{
+					math::Vec2(-jitter.x, 0), // left
+					math::Vec2( jitter.x, 0), // right
+					math::Vec2(0, -jitter.y), // up
+					math::Vec2(0,  jitter.y), // down
+					math::Vec2(-diagJitter.x, -diagJitter.y), // up-left
+					math::Vec2( diagJitter.x, -diagJitter.y), // up-right
+					math::Vec2(-diagJitter.x,  diagJitter.y), // down-left
+					math::Vec2( diagJitter.x,  diagJitter.y)  // down-right
+				};
+				for (const math::Vec2 &offset : offsets)
+					GenerateQuads(offset, borderColor, borderColor);
+			}
+			// generate glyphs
+			GenerateQuads(math::Vec2(), topColor, bottomColor);
+		}
+	}
+}
@@ -0,0 +1,163 @@
+/**
+ * @copyright
+ *
+ * Copyright (c) 2006-2014 David Osborn
+ *
+ * Permission is granted to use and redistribute this software in source and
+ * binary form, with or without modification, subject to the following
+ * conditions:
+ *
+ * 1. Redistributions in source form must retain the above copyright notice,
+ *    this list of conditions, and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions, and the following disclaimer in the same place
+ *    and form as other copyright, license, and disclaimer information.
+ *
+ * 3. Redistributions in binary form must also include an acknowledgement in the
+ *    same place and form as other acknowledgements (such as the credits),
+ *    similar in substance to the following:
+ *
+ *       Portions of this software are based on the work of David Osborn.
+ *
+ * This software is provided "as is", without any express or implied warranty.
+ * In no event will the authors be liable for any damages arising out of the use
+ * of this software.
+ */
+
+#ifndef    page_local_vid_TextLayout_hpp
+#   define page_local_vid_TextLayout_hpp
+
+#	include <cstddef> // size_t
+#	include <list>
+#	include <memory> // shared_ptr
+#	include <string>
+#	include <unordered_map>
+#	include <utility> // pair
+#	include <vector>
+
+#	include "../math/Aabb.hpp"
+#	include "../math/Color.hpp" // RgbaColor
+#	include "../math/Vector.hpp"
+#	include "../res/type/Font.hpp" // TextAlign
+#	include "../util/class/Monostate.hpp"
+
+namespace page
+{
+	namespace vid
+	{
+		class GlyphAtlas;
+
+		/**
+		 * Text that has been wrapped, aligned and broken into glyphs.
+		 *
+		 * The glyphs are positioned in font units, relative to the top-left
+		 * corner of the text box, with Y increasing downward.
+		 */
+		struct TextLayout
+		{
+			struct Glyph
+			{
+				/**
+				 * The code point of the glyph in the font, which is zero if
+				 * the font doesn't have a glyph for the character.
+				 */
+				char32_t c;
+				math::Aabb<2> co;
+			};
+			typedef std::vector<Glyph> Glyphs;
+			Glyphs glyphs;
+		};
+
+		// layout
+		/**
+		 * Lays out UTF-8 encoded text in a box of the given width, in font
+		 * units.
+		 */
+		TextLayout LayoutText(const res::Font &, const std::string &text,
+			float width, bool wrap, res::TextAlign);
+
+		/**
+		 * A cache of recently used text layouts, so that text which is drawn
+		 * every frame doesn't have to be decoded, wrapped and aligned again.
+		 *
+		 * @note The cache is not thread-safe; it is meant to be used from the
+		 *       rendering thread.
+		 */
+		class TextLayoutCache : public util::Monostate<TextLayoutCache>
+		{
+			public:
+			// access
+			/**
+			 * @return The layout of the text, from the cache if possible.
+			 */
+			std::shared_ptr<const TextLayout> Get(
+				const std::shared_ptr<const res::Font> &,
+				const std::string &text, float width, bool wrap,
+				res::TextAlign);
+
+			// modifiers
+			void Clear();
+
+			private:
+			struct Key
+			{
+				const res::Font *font;
+				std::string text;
+				float width;
+				bool wrap;
+				res::TextAlign align;
+
+				bool operator ==(const Key &) const;
+			};
+			struct KeyHash
+			{
+				std::size_t operator ()(const Key &) const;
+			};
+			struct Entry
+			{
+				// holding the font keeps its address from being reused
+				// while the entry is alive
+				std::shared_ptr<const res::Font> font;
+				std::shared_ptr<const TextLayout> layout;
+			};
+
+			// the entries, from most to least recently used
+			typedef std::list<std::pair<Key, Entry>> Entries;
+			Entries entries;
+			typedef std::unordered_map<Key, Entries::iterator, KeyHash> Index;
+			Index index;
+		};
+
+		/**
+		 * A vertex of a glyph quad, laid out for a client-side vertex array.
+		 */
+		struct TextVertex
+		{
+			float co[2];
+			float uv[2];
+			float color[4];
+		};
+
+		// vertex generation
+		/**
+		 * Generates the quads for a text layout, in a single array, with
+		 * four vertices per quad.  If there is a border, it is made of eight
+		 * copies of the glyphs, offset in each direction, which come before
+		 * the glyphs themselves.
+		 *
+		 * Glyphs that aren't in the atlas are skipped.
+		 *
+		 * @param origin The position of the top-left corner of the box.
+		 * @param scale The size of a font unit.
+		 */
+		void GetTextVertices(const TextLayout &, const GlyphAtlas &,
+			const math::Vec2 &origin, const math::Vec2 &scale,
+			const math::RgbaColor<> &topColor,
+			const math::RgbaColor<> &bottomColor, float borderSize,
+			const math::RgbaColor<> &borderColor,
+			std::vector<TextVertex> &);
+	}
+}
+
+#endif
@@ -27,9 +27,9 @@
 
 #include <memory> // unique_ptr
 
-#include "../cfg/vars.hpp"
+#include "../cfg/Snapshot.hpp"
 #include "../phys/node/Camera.hpp" // Camera::GetOpacity, GetViewFrustum
-#include "../phys/Scene.hpp" // Scene::GetCameras
+#include "../phys/Scene.hpp" // Scene::{GetCameras,GetTickInterpolation}
 #include "../gui/UserInterface.hpp" // UserInterface::Draw
 #include "DrawContext.hpp" // DrawContext::{{alpha,median}Filter,GetFilterCaps,MakeViewContext,Push{Alpha,Median}Filter,ScaleBias}
 #include "ViewContext.hpp" // ViewContext::Draw
@@ -95,10 +95,10 @@ namespace page
 			DrawContext::FilterSaver filterSaver(context);
 			// FIXME: scale/bias for exposure
 			// FIXME: post-processing effects, such as rain on camera lens
-			if (*CVAR(opengl)::renderMedian &&
+			if (CSNAP(renderMedian) &&
 				context.GetFilterCaps() & DrawContext::medianFilter)
-				context.PushMedianFilter(*CVAR(opengl)::renderMedianLevel, true);
-			const std::unique_ptr<ViewContext> viewContext(context.MakeViewContext(GetViewFrustum(camera)));
+				context.PushMedianFilter(CSNAP(renderMedianLevel), true);
+			const std::unique_ptr<ViewContext> viewContext(context.MakeViewContext(GetViewFrustum(camera, scene.GetTickInterpolation())));
 			viewContext->Draw(scene);
 		}
 	}
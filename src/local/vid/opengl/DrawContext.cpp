@@ -47,17 +47,14 @@
 #include "TextureFormat.hpp" // defaultTextureFormat
 #include "ViewContext.hpp"
 
-// FIXME: for DrawText
-#include <algorithm> // find, find_if
-#include <cctype> // isspace
-#include <cmath> // ceil, sqrt
-#include <functional> // bind2nd, not_equal_to
-#include <vector>
+// for DrawText
+#include <cmath> // ceil
+#include <memory> // shared_ptr
 #include "../../cache/proxy/opengl/FontTextureProxy.hpp"
 #include "../../math/Color.hpp" // RgbaColor
-#include "../../res/type/Font.hpp" // GetAdvance, GetGlyph, Wrap
-#include "../../util/functional/locale.hpp" // isspace_function
-#include "FontTexture.hpp" // Bind, FontTexture::GetSection
+#include "../TextLayout.hpp" // GetTextVertices, TextLayout{,Cache}
+#include "ClientAttribGuard.hpp"
+#include "FontTexture.hpp" // Bind, FontTexture::{GetAtlas,Reserve}
 
 namespace page
 {
@@ -65,20 +62,6 @@ namespace page
 	{
 		namespace opengl
 		{
-			namespace
-			{
-				// FIXME: for DrawText
-				// glyph coordinates for font rendering
-				struct GlyphCoords
-				{
-					GlyphCoords(
-						const math::Aabb<2> &uv,
-						const math::Aabb<2> &co) : uv(uv), co(co) {}
-
-					math::Aabb<2> uv, co;
-				};
-			}
-
 			// construct/destroy
 			DrawContext::DrawContext(Driver &driver, Resources &res, const math::Aabb<2> &logicalBox) :
 				vid::DrawContext(driver, logicalBox), res(res),
@@ -176,95 +159,19 @@ namespace page
 			{
 				MatrixGuard matrixGuard;
 				FixMatrix(matrixGuard, true);
-				// FIXME: most of this can be moved into a platform-independant
-				// module; at the same time, the OpenGL part should make use of
-				// vertex arrays/buffers
-				// calculate metrics
-				const res::Font &font(*fontProxy);
+				// lay out text
+				const std::shared_ptr<const res::Font> font(fontProxy.lock());
 				math::Vec2 scale(fontSize / math::Vec2(GetFrameAspect(), 1));
 				float width = (box.max.x - box.min.x) / scale.x;
-				std::string wrappedText(wrap ? Wrap(font, text, width) : text);
-				math::Vec2 pen(box.min.x, box.min.y + font.maxBearing.y * scale.y);
-				// calculate glyph rendering coordinates
+				const std::shared_ptr<const TextLayout> layout(
+					GLOBAL(TextLayoutCache).Get(font, text, width, wrap, align));
+				// generate vertices
 				const FontTexture &texture(*cache::opengl::FontTextureProxy(fontProxy,
 					std::ceil(fontSize * (Size(GetFrame()) * Size(GetPixelLogicalBox())).y)));
-				typedef std::vector<GlyphCoords> Glyphs;
-				Glyphs glyphs;
-				glyphs.reserve(text.size());
-				for (std::string::iterator line(wrappedText.begin()); line != wrappedText.end();)
-				{
-					std::string::iterator end(std::find(line, wrappedText.end(), '\n'));
-					// calculate whitespace coefficient for justified alignment
-					float offset = 0, space = 1;
-					if (align == res::justifyTextAlign)
-					{
-						space = GetJustifiedScale(font, line, end, width);
-						if (space >= 1)
-						{
-							if (std::find_if(line, end, util::isspace_function<char>()) == end)
-							{
-								if (end - line >= 2)
-								{
-									for (std::string::iterator c(line + 1); c != end; ++c)
-									{
-										std::string::iterator::difference_type
-											lineDistance(line - wrappedText.begin()),
-											endDistance(end - wrappedText.begin());
-										c = wrappedText.insert(c, ' ') + 1;
-										line = wrappedText.begin() + lineDistance;
-										end = wrappedText.begin() + endDistance + 1;
-									}
-									space = GetJustifiedScale(font, line, end, width);
-								}
-								else
-								{
-									space = 1;
-									goto centerAlign;
-								}
-							}
-						}
-						else
-						{
-							space = 1;
-							goto centerAlign;
-						}
-					}
-					// calculate offset for center and right alignment
-					switch (align)
-					{
-						case res::centerTextAlign: centerAlign:
-						offset = GetCenteredOffset(font, line, end, width);
-						break;
-						case res::rightTextAlign:
-						offset = GetRightAlignedOffset(font, line, end, width);
-						break;
-					}
-					// generate glyph coordinates
-					pen.x += offset * scale.x;
-					for (std::string::const_iterator c(line); c != end; ++c)
-					{
-						if (const res::Font::Glyph *glyph = GetGlyph(font, *c))
-						{
-							math::Vec2 co(pen);
-							co.x += glyph->bearing.x * scale.x;
-							co.y -= glyph->bearing.y * scale.y;
-							glyphs.push_back(GlyphCoords(*texture.GetSection(*c),
-								math::Aabb<2>(co, co + glyph->size * scale)));
-						}
-						std::string::const_iterator next(c + 1);
-						float advance = (next != end ?
-							GetAdvance(font, *c, *next) :
-							GetAdvance(font, *c));
-						if (std::isspace(*c)) advance *= space;
-						pen.x += advance * scale.x;
-					}
-					if (end == wrappedText.end()) break;
-					end = std::find_if((line = end) + 1, wrappedText.end(),
-						std::bind2nd(std::not_equal_to<char>(), '\n'));
-					pen = math::Vec2(box.min.x,
-						pen.y + font.lineHeight * scale.y * (end - line));
-					line = end;
-				}
+				texture.Reserve(*layout);
+				GetTextVertices(*layout, texture.GetAtlas(), box.min, scale,
+					topColor, bottomColor, borderSize, borderColor, textVertices);
+				if (textVertices.empty()) return;
 				// enable clipping
 				ClipSaver clipSaver(*this);
 				PushClip(box); // FIXME: this used to be PushRootClip
@@ -272,72 +179,16 @@ namespace page
 				AttribGuard attribGuard;
 				glPushAttrib(GL_CURRENT_BIT | GL_ENABLE_BIT);
 				Bind(texture);
-				glEnable(GL_TEXTURE_2D);
-				glBegin(GL_QUADS);
-				// render borders
-				if (borderSize)
-				{
-					math::Vec2
-						jitter(borderSize * scale),
-						diagJitter(jitter / std::sqrt(2.f));
-					glColor4fv(&*math::RgbaColor<GLfloat>(borderColor).begin());
-					for (Glyphs::const_iterator glyph(glyphs.begin()); glyph != glyphs.end(); ++glyph)
-					{
-						const math::Aabb<2> &uv(glyph->uv), &co(glyph->co);
-						// left
-						glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x - jitter.x, co.min.y);
-						glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x - jitter.x, co.min.y);
-						glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x - jitter.x, co.max.y);
-						glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x - jitter.x, co.max.y);
-						// right
-						glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x + jitter.x, co.min.y);
-						glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x + jitter.x, co.min.y);
-						glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x + jitter.x, co.max.y);
-						glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x + jitter.x, co.max.y);
-						// up
-						glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x, co.min.y - jitter.y);
-						glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x, co.min.y - jitter.y);
-						glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x, co.max.y - jitter.y);
-						glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x, co.max.y - jitter.y);
-						// down
-						glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x, co.min.y + jitter.y);
-						glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x, co.min.y + jitter.y);
-						glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x, co.max.y + jitter.y);
-						glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x, co.max.y + jitter.y);
-						// up-left
-						glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x - diagJitter.x, co.min.y - diagJitter.y);
-						glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x - diagJitter.x, co.min.y - diagJitter.y);
-						glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x - diagJitter.x, co.max.y - diagJitter.y);
-						glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x - diagJitter.x, co.max.y - diagJitter.y);
-						// up-right
-						glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x + diagJitter.x, co.min.y - diagJitter.y);
-						glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x + diagJitter.x, co.min.y - diagJitter.y);
-						glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x + diagJitter.x, co.max.y - diagJitter.y);
-						glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x + diagJitter.x, co.max.y - diagJitter.y);
-						// down-left
-						glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x - diagJitter.x, co.min.y + diagJitter.y);
-						glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x - diagJitter.x, co.min.y + diagJitter.y);
-						glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x - diagJitter.x, co.max.y + diagJitter.y);
-						glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x - diagJitter.x, co.max.y + diagJitter.y);
-						// down-right
-						glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x + diagJitter.x, co.min.y + jitter.y);
-						glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x + diagJitter.x, co.min.y + jitter.y);
-						glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x + diagJitter.x, co.max.y + jitter.y);
-						glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x + diagJitter.x, co.max.y + jitter.y);
-					}
-				}
-				// render glyphs
-				for (Glyphs::const_iterator glyph(glyphs.begin()); glyph != glyphs.end(); ++glyph)
-				{
-					const math::Aabb<2> &uv(glyph->uv), &co(glyph->co);
-					glColor4fv(&*math::RgbaColor<GLfloat>(topColor).begin());
-					glTexCoord2f(uv.max.x, uv.min.y); glVertex2f(co.max.x, co.min.y);
-					glTexCoord2f(uv.min.x, uv.min.y); glVertex2f(co.min.x, co.min.y);
-					glColor4fv(&*math::RgbaColor<GLfloat>(bottomColor).begin());
-					glTexCoord2f(uv.min.x, uv.max.y); glVertex2f(co.min.x, co.max.y);
-					glTexCoord2f(uv.max.x, uv.max.y); glVertex2f(co.max.x, co.max.y);
-				}
-				glEnd();
+				ClientAttribGuard clientAttribGuard;
+				glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+				glEnableClientState(GL_VERTEX_ARRAY);
+				glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+				glEnableClientState(GL_COLOR_ARRAY);
+				glVertexPointer(2, GL_FLOAT, sizeof (TextVertex), textVertices.front().co);
+				glTexCoordPointer(2, GL_FLOAT, sizeof (TextVertex), textVertices.front().uv);
+				glColorPointer(4, GL_FLOAT, sizeof (TextVertex), textVertices.front().color);
+				// render borders and glyphs
+				glDrawArrays(GL_QUADS, 0, textVertices.size());
 			}
 
 			// full-scene rendering
@@ -28,7 +28,10 @@
 #ifndef    page_local_vid_opengl_DrawContext_hpp
 #   define page_local_vid_opengl_DrawContext_hpp
 
+#	include <vector>
+
 #	include "../DrawContext.hpp"
+#	include "../TextLayout.hpp" // TextVertex
 #	include "AttribGuard.hpp"
 #	include "MatrixGuard.hpp"
 
@@ -113,6 +116,9 @@ namespace page
 				AttribGuard attribGuard;
 				MatrixGuard matrixGuard;
 				bool matrixVolatile;
+
+				// reused between calls to DrawText
+				std::vector<TextVertex> textVertices;
 			};
 		}
 	}
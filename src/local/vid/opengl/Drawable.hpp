@@ -28,6 +28,8 @@
 #ifndef    page_local_vid_opengl_Drawable_hpp
 #   define page_local_vid_opengl_Drawable_hpp
 
+#	include <cstddef> // size_t
+
 #	include "Vertex.hpp" // VertexFormat
 
 namespace page
@@ -41,8 +43,16 @@ namespace page
 		{
 			struct Drawable
 			{
+				virtual ~Drawable() = default;
+
 				virtual void Update(const phys::Skin &) = 0;
 				virtual void Draw(const VertexFormat & = VertexFormat()) const = 0;
+
+				/**
+				 * @return An estimate of the amount of memory that is used by
+				 *         the vertex data, which may be in video memory.
+				 */
+				virtual std::size_t GetMemorySize() const = 0;
 			};
 
 			// factory function
@@ -25,14 +25,15 @@
  * of this software.
  */
 
-#include <algorithm> // transform
-#include <cctype> // isspace
+#include <algorithm> // min, transform
+#include <vector>
 
 #include "../../err/Exception.hpp"
 #include "../../math/pow2.hpp" // Pow2Ceil
 #include "../../res/type/Font.hpp"
-#include "ext.hpp" // ARB_texture_non_power_of_two
+#include "../TextLayout.hpp"
 #include "FontTexture.hpp"
+#include "get.hpp" // GetInteger
 #include "tex.hpp" // Compatibility, GetCompatibility
 
 namespace page
@@ -41,65 +42,90 @@ namespace page
 	{
 		namespace opengl
 		{
+			namespace
+			{
+				// calculate an initial texture size with room for about as
+				// many glyphs as there are in ASCII
+				math::Vec2u GetInitialSize(const res::Font &font, unsigned fontSize)
+				{
+					math::Vec2u size(Ceil(font.maxSize * fontSize) + 1);
+					size *= 8;
+					std::transform(size.begin(), size.end(), size.begin(), math::Pow2Ceil);
+					return Min(size, math::Vec2u(GetInteger(GL_MAX_TEXTURE_SIZE)));
+				}
+			}
+
 			// construct/destroy
-			FontTexture::FontTexture(const res::Font &font, unsigned fontSize)
+			FontTexture::FontTexture(const std::shared_ptr<const res::Font> &font, unsigned fontSize) :
+				font(font), fontSize(fontSize),
+				atlas(GetInitialSize(*font, fontSize))
 			{
-				// calculate best fitting texture size
-				math::Vec2u texSize;
-				math::Vec2u glyphSize(Ceil(font.maxSize * fontSize) + 1);
-				std::transform(glyphSize.begin(), glyphSize.end(), texSize.begin(), math::Pow2Ceil);
-				while (Content(texSize / glyphSize) < font.glyphs.size())
-					if (texSize.x < texSize.y) texSize.x *= 2;
-					else if (texSize.x > texSize.y) texSize.y *= 2;
-					else texSize[
-						Content(math::Vec2u(texSize.x * 2, texSize.y) / glyphSize) <
-						Content(math::Vec2u(texSize.x, texSize.y * 2) / glyphSize)] *= 2;
-				if (haveArbTextureNonPowerOfTwo)
-					texSize -= texSize % glyphSize;
 				// generate texture
 				if (glGenTextures(1, &handle), glGetError())
 					THROW((err::Exception<err::VidModuleTag, err::OpenglPlatformTag>("failed to generate texture")))
 				glBindTexture(GL_TEXTURE_2D, handle);
 				// FIXME: add support for other formats
-				std::vector<GLubyte> data(Content(texSize));
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, texSize.x, texSize.y, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &*data.begin());
+				std::vector<GLubyte> data(Content(atlas.GetSize()));
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, atlas.GetSize().x, atlas.GetSize().y, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &*data.begin());
 				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 				if (glGetError())
+				{
+					glDeleteTextures(1, &handle);
 					THROW((err::Exception<err::VidModuleTag, err::OpenglPlatformTag>("failed to initialize texture")))
-				// insert glyphs
+				}
+			}
+			FontTexture::~FontTexture()
+			{
+				glDeleteTextures(1, &handle);
+			}
+
+			// glyph insertion
+			void FontTexture::Reserve(const TextLayout &layout) const
+			{
+				for (TextLayout::Glyphs::const_iterator glyph(layout.glyphs.begin()); glyph != layout.glyphs.end(); ++glyph)
+					if (!atlas.GetSection(glyph->c)) Insert(glyph->c);
+			}
+			void FontTexture::Insert(char32_t c) const
+			{
+				// convert glyph to compatible format
+				res::Image img(GetCharImage(*font, c, fontSize));
+				Compatibility compat(GetCompatibility(img));
+				if (!compat.channels.empty()) img = Convert(img, compat.channels, 1);
+				else if (!IsAligned(img, 1)) img = Align(img, 1);
+				// find space for glyph
 				math::Vec2u pos;
-				for (res::Font::Glyphs::const_iterator iter(font.glyphs.begin()); iter != font.glyphs.end(); ++iter)
+				while (!atlas.Insert(c, img.size, pos)) Grow();
+				// insert texture
+				if (All(img.size))
 				{
-					if (std::isspace(iter->first)) continue;
-					// convert glyph to compatible format
-					res::Image img(GetCharImage(font, iter->first, fontSize));
-					Compatibility compat(GetCompatibility(img));
-					if (!compat.channels.empty()) img = Convert(img, compat.channels, 1);
-					else if (!IsAligned(img, 1)) img = Align(img, 1);
-					// insert texture
+					glBindTexture(GL_TEXTURE_2D, handle);
 					glTexSubImage2D(GL_TEXTURE_2D, 0, pos.x, pos.y, img.size.x, img.size.y, compat.format, compat.type, &*img.data.begin());
-					// insert section
-					math::Vec2
-						min(math::Vec2(pos) / texSize),
-						max(min + math::Vec2(img.size) / texSize);
-					sections.insert(std::make_pair(iter->first, math::Aabb<2>(min, max)));
-					// increment insertion position
-					if ((pos.x += glyphSize.x) > texSize.x - glyphSize.x)
-						pos = math::Vec2u(0, pos.y + glyphSize.y);
 				}
 			}
-			FontTexture::~FontTexture()
+			void FontTexture::Grow() const
 			{
-				glDeleteTextures(1, &handle);
+				// the atlas grows along its shorter side
+				math::Vec2u oldSize(atlas.GetSize());
+				if (std::min(oldSize.x, oldSize.y) * 2 > GLuint(GetInteger(GL_MAX_TEXTURE_SIZE)))
+					THROW((err::Exception<err::VidModuleTag, err::OpenglPlatformTag>("font texture exceeds maximum size")))
+				atlas.Grow();
+				math::Vec2u size(atlas.GetSize());
+				// copy the existing glyphs into the top-left corner of the
+				// larger texture
+				glBindTexture(GL_TEXTURE_2D, handle);
+				std::vector<GLubyte> oldData(Content(oldSize));
+				glGetTexImage(GL_TEXTURE_2D, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &*oldData.begin());
+				std::vector<GLubyte> data(Content(size));
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, size.x, size.y, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &*data.begin());
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, oldSize.x, oldSize.y, GL_ALPHA, GL_UNSIGNED_BYTE, &*oldData.begin());
+				if (glGetError())
+					THROW((err::Exception<err::VidModuleTag, err::OpenglPlatformTag>("failed to resize texture")))
 			}
 
-			// sections
-			const math::Aabb<2> *FontTexture::GetSection(char c) const
+			// atlas access
+			const GlyphAtlas &FontTexture::GetAtlas() const
 			{
-				Sections::const_iterator iter(sections.find(c));
-				return iter != sections.end() ||
-					(iter = sections.find(0)) != sections.end() ?
-					&iter->second : 0;
+				return atlas;
 			}
 
 			// handle access
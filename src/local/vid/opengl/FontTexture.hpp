@@ -28,11 +28,11 @@
 #ifndef    page_local_vid_opengl_FontTexture_hpp
 #   define page_local_vid_opengl_FontTexture_hpp
 
-#	include <unordered_map>
+#	include <memory> // shared_ptr
 
 #	include <GL/gl.h> // GLuint
 
-#	include "../../math/Aabb.hpp"
+#	include "../GlyphAtlas.hpp"
 
 namespace page
 {
@@ -40,24 +40,41 @@ namespace page
 
 	namespace vid
 	{
+		class TextLayout;
+
 		namespace opengl
 		{
+			/**
+			 * A texture that the glyphs of a font are packed into as they are
+			 * needed.  The texture grows when it runs out of space.
+			 */
 			struct FontTexture
 			{
 				// construct/destroy
-				FontTexture(const res::Font &, unsigned fontSize);
+				FontTexture(const std::shared_ptr<const res::Font> &, unsigned fontSize);
 				~FontTexture();
 
-				// sections
-				const math::Aabb<2> *GetSection(char) const;
+				// glyph insertion
+				/**
+				 * Inserts any glyphs in the layout that aren't in the texture
+				 * already.
+				 */
+				void Reserve(const TextLayout &) const;
+
+				// atlas access
+				const GlyphAtlas &GetAtlas() const;
 
 				// handle access
 				GLuint GetHandle() const;
 
 				private:
+				void Insert(char32_t) const;
+				void Grow() const;
+
+				std::shared_ptr<const res::Font> font;
+				unsigned fontSize;
 				mutable GLuint handle;
-				typedef std::unordered_map<char, math::Aabb<2>> Sections;
-				Sections sections;
+				mutable GlyphAtlas atlas;
 			};
 
 			// binding
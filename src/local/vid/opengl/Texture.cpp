@@ -43,7 +43,7 @@ namespace page
 		{
 			// construct/destroy
 			Texture::Texture(const math::RgbaColor<> &color) :
-				size(1), pow2Size(1)
+				size(1), pow2Size(1), memorySize(4)
 			{
 				glGenTextures(1, &handle);
 				glBindTexture(GL_TEXTURE_2D, handle);
@@ -65,6 +65,9 @@ namespace page
 					case luminanceTextureFormat: handle = MakeLuminanceTexture(img, mipmap, clamp); break;
 					default: assert(!"invalid texture format");
 				}
+				memorySize = pow2Size.x * pow2Size.y * (format == defaultTextureFormat ? 4 : 1);
+				// the mipmap chain adds a third to the base level
+				if (mipmap) memorySize += memorySize / 3;
 			}
 			Texture::~Texture()
 			{
@@ -80,6 +83,10 @@ namespace page
 			{
 				return pow2Size;
 			}
+			std::size_t Texture::GetMemorySize() const
+			{
+				return memorySize;
+			}
 
 			// handle access
 			GLuint Texture::GetHandle() const
@@ -28,6 +28,8 @@
 #ifndef    page_local_vid_opengl_Texture_hpp
 #   define page_local_vid_opengl_Texture_hpp
 
+#	include <cstddef> // size_t
+
 #	include <GL/gl.h> // GLuint
 
 #	include "../../math/fwd.hpp" // RgbaColor
@@ -61,12 +63,19 @@ namespace page
 				const math::Vec2u &GetSize() const;
 				const math::Vec2u &GetPow2Size() const;
 
+				/**
+				 * @return An estimate of the amount of video memory that is
+				 *         used by the texture, including its mipmaps.
+				 */
+				std::size_t GetMemorySize() const;
+
 				// handle access
 				GLuint GetHandle() const;
 
 				private:
 				GLuint handle;
 				math::Vec2u size, pow2Size;
+				std::size_t memorySize;
 			};
 
 			// binding
@@ -54,6 +54,12 @@ namespace page
 #	pragma pack(pop)
 
 			template <typename OutputIterator> void InitVertices(OutputIterator, const res::Mesh &);
+			/**
+			 * Updates the vertices with the skinned positions and normals.
+			 *
+			 * @pre The iterator points to contiguous storage for at least as
+			 *      many vertices as there are in the skin.
+			 */
 			template <typename Iterator> void UpdateVertices(Iterator, const phys::Skin &);
 
 			struct VertexFormat
@@ -25,6 +25,10 @@
  * of this software.
  */
 
+#include <cassert>
+#include <iterator> // iterator_traits, random_access_iterator_tag
+#include <type_traits> // is_same, remove_cv
+
 #include "../../phys/Skin.hpp"
 #include "../../res/type/Mesh.hpp"
 
@@ -53,18 +57,16 @@ namespace page
 			}
 			template <typename Iterator> void UpdateVertices(Iterator iter, const phys::Skin &skin)
 			{
-				for (phys::Skin::Vertices::const_iterator skinVertex(skin.vertices.begin()); skinVertex != skin.vertices.end(); ++skinVertex)
-				{
-					math::Vec3 co, no;
-					Update(*skinVertex, co, no);
-					iter->no[0] = no.x;
-					iter->no[1] = no.y;
-					iter->no[2] = no.z;
-					iter->co[0] = co.x;
-					iter->co[1] = co.y;
-					iter->co[2] = co.z;
-					++iter;
-				}
+				// phys::Update writes through a pointer to the first vertex
+				// with a fixed stride, so the vertices must be stored
+				// contiguously
+				typedef std::iterator_traits<Iterator> Traits;
+				static_assert(std::is_same<typename Traits::iterator_category, std::random_access_iterator_tag>::value, "vertices must be stored contiguously");
+				static_assert(std::is_same<typename std::remove_cv<typename Traits::value_type>::type, Vertex>::value, "vertices must have the layout of Vertex");
+				if (!skin.GetSize()) return;
+				auto &first(*iter);
+				assert(&*(iter + (skin.GetSize() - 1)) == &first + (skin.GetSize() - 1));
+				phys::Update(skin, first.co, first.no, sizeof first);
 				// FIXME: recalculate tangents if necessary
 			}
 		}
@@ -57,6 +57,12 @@ namespace page
 				PrepVertices(&*vertices.begin(), format);
 				DrawIndices(&*indices.begin(), indices.size());
 			}
+			std::size_t VertexArray::GetMemorySize() const
+			{
+				return
+					indices.capacity()  * sizeof(Index) +
+					vertices.capacity() * sizeof(Vertex);
+			}
 		}
 	}
 }
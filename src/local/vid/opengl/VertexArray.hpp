@@ -43,6 +43,7 @@ namespace page
 
 				void Update(const phys::Skin &);
 				void Draw(const VertexFormat &) const;
+				std::size_t GetMemorySize() const;
 
 				private:
 				typedef std::vector<Index> Indices;
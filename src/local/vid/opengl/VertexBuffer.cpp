@@ -41,7 +41,8 @@ namespace page
 		namespace opengl
 		{
 			VertexBuffer::VertexBuffer(const res::Mesh &mesh, GLenum usage) :
-				numIndices(mesh.faces.size() * 3)
+				numIndices(mesh.faces.size() * 3),
+				memorySize(sizeof(Index) * numIndices + sizeof(Vertex) * mesh.vertices.size())
 			{
 				assert(haveArbVertexBufferObject);
 				// initialize index buffer
@@ -98,6 +99,10 @@ namespace page
 				PrepVertices(0, format);
 				DrawIndices(0, numIndices);
 			}
+			std::size_t VertexBuffer::GetMemorySize() const
+			{
+				return memorySize;
+			}
 		}
 	}
 }
@@ -45,9 +45,11 @@ namespace page
 
 				void Update(const phys::Skin &);
 				void Draw(const VertexFormat &) const;
+				std::size_t GetMemorySize() const;
 
 				private:
 				unsigned numIndices;
+				std::size_t memorySize;
 				GLuint indices, vertices;
 			};
 		}
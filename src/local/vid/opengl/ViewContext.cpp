@@ -34,7 +34,7 @@
 #include "../../cache/proxy/AabbProxy.hpp"
 #include "../../cache/proxy/opengl/DrawableProxy.hpp"
 #include "../../cache/proxy/opengl/TextureProxy.hpp"
-#include "../../cfg/vars.hpp"
+#include "../../cfg/Snapshot.hpp"
 #include "../../math/Color.hpp" // Rgb{,a}Color
 #include "../../math/float.hpp" // DegToRad
 #include "../../math/interp.hpp" // HermiteConvolutionKernel
@@ -143,6 +143,7 @@ namespace page
 			void ViewContext::Draw(const phys::Scene &scene)
 			{
 				const Resources &res(GetBase().GetResources());
+				tickInterpolation = scene.GetTickInterpolation();
 				// retrieve visible forms
 				typedef phys::Scene::View<phys::Form>::Type Forms;
 				Forms forms(scene.GetVisibleForms(GetFrustum()));
@@ -161,11 +162,11 @@ namespace page
 				typedef phys::Scene::View<phys::Light>::Type Lights;
 				Lights lights(scene.GetInfluentialLights(GetFrustum()));
 				// select rendering path
-				if (*CVAR(opengl)::renderShader && res.HasShaderMaterial())
+				if (CSNAP(renderShader) && res.HasShaderMaterial())
 				{
 					// perform shadow mapping
 					boost::optional<ShadowAttachment> shadowAttachment;
-					if (*CVAR(opengl)::renderShadow && res.HasShadow())
+					if (CSNAP(renderShadow) && res.HasShadow())
 					{
 						math::Vec2u shadowRenderTargetSize(
 							res.GetShadow().GetRenderTargetPool().GetSize());
@@ -192,7 +193,7 @@ namespace page
 					// FIXME: implement
 					// draw emissive and specular glow
 					// TEST: disabled until we actually need emissive/specular
-					/*if (*CVAR(opengl)::renderGlow &&
+					/*if (CSNAP(renderGlow) &&
 						res.HasProgram(Resources::convolutionFilter5hProgram) &&
 						res.HasProgram(Resources::convolutionFilter5vProgram) &&
 						res.HasRenderTargetPool(Resources::rgbBlurRenderTargetPool))
@@ -226,7 +227,7 @@ namespace page
 						GetBase().Fill(glowRes.GetBuffer(), 1);
 					}*/
 					// draw outlines
-					if (*CVAR(opengl)::renderOutline &&
+					if (CSNAP(renderOutline) &&
 						res.HasShaderOutline() &&
 						res.HasProgram(Resources::normalProgram))
 					{
@@ -281,7 +282,7 @@ namespace page
 						// FIXME: implement; render opaque if opacity >= 50%
 					}
 					// draw outlines
-					if (*CVAR(opengl)::renderOutline)
+					if (CSNAP(renderOutline))
 					{
 						glDisable(GL_LIGHTING);
 						glDisable(GL_ALPHA_TEST);
@@ -291,10 +292,10 @@ namespace page
 					}
 				}
 				// draw debug overlays
-				if (*CVAR(debugDrawTrack) && scene.HasTrack()) Draw(scene.GetTrack());
-				if (*CVAR(debugDrawCollision)) Draw(scene.GetVisibleCollidables(GetFrustum()));
-				if (*CVAR(debugDrawBounds)) DrawBounds(forms);
-				if (*CVAR(debugDrawSkeleton)) DrawSkeleton(forms);
+				if (CSNAP(debugDrawTrack) && scene.HasTrack()) Draw(scene.GetTrack());
+				if (CSNAP(debugDrawCollision)) Draw(scene.GetVisibleCollidables(GetFrustum()));
+				if (CSNAP(debugDrawBounds)) DrawBounds(forms);
+				if (CSNAP(debugDrawSkeleton)) DrawSkeleton(forms);
 			}
 
 			// mesh rendering
@@ -303,14 +304,14 @@ namespace page
 				using std::bind;
 				using namespace std::placeholders;
 				Draw(form, bind(&ViewContext::PrepShaderMaterial, this, _1, _2, type, shadow),
-					*CVAR(opengl)::renderMultipass && type != shadowShaderType);
+					CSNAP(renderMultipass) && type != shadowShaderType);
 			}
 			void ViewContext::Draw(const phys::Form &form, FixedType type)
 			{
 				using std::bind;
 				using namespace std::placeholders;
 				Draw(form, bind(&ViewContext::PrepFixedMaterial, this, _1, _2, type),
-					*CVAR(opengl)::renderMultipass && type != zcullFixedType);
+					CSNAP(renderMultipass) && type != zcullFixedType);
 			}
 			void ViewContext::Draw(const phys::Scene::View<phys::Form>::Type &forms, ShaderType type, const boost::optional<ShadowAttachment> &shadow)
 			{
@@ -338,7 +339,7 @@ namespace page
 				glMatrixMode(GL_MODELVIEW);
 				MatrixGuard matrixGuard;
 				matrixGuard.Push();
-				glMultMatrixf(&*math::Matrix<4, 4, GLfloat>(form.GetMatrix()).begin());
+				glMultMatrixf(&*math::Matrix<4, 4, GLfloat>(form.GetInterpolatedMatrix(tickInterpolation)).begin());
 				// draw parts
 				for (phys::Form::Parts::const_iterator part(form.GetParts().begin()); part != form.GetParts().end(); ++part)
 					Draw(*part, prepMaterialCallback, multipass);
@@ -797,7 +798,7 @@ namespace page
 					default: assert(!"invalid shadow type");
 				}
 				// blur shadow map
-				if (*CVAR(opengl)::renderShadowBlur)
+				if (CSNAP(renderShadowBlur))
 				{
 					const Program
 						*blurhProgram = 0,
@@ -986,7 +987,7 @@ namespace page
 				glMatrixMode(GL_MODELVIEW);
 				MatrixGuard matrixGuard;
 				matrixGuard.Push();
-				glMultMatrixf(&*math::Matrix<4, 4, GLfloat>(pose.GetMatrix()).begin());
+				glMultMatrixf(&*math::Matrix<4, 4, GLfloat>(pose.GetInterpolatedMatrix(tickInterpolation)).begin());
 				// draw posed skeleton
 				AttribGuard attribGuard;
 				glPushAttrib(GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT | GL_DEPTH_BUFFER_BIT);
@@ -1036,7 +1037,7 @@ namespace page
 				// implementation changes, this function may be forgotten
 				const Resources &res(GetBase().GetResources());
 				return
-					*CVAR(opengl)::renderGlow &&
+					CSNAP(renderGlow) &&
 					res.HasProgram(Resources::convolutionFilter5hProgram) &&
 					res.HasProgram(Resources::convolutionFilter5vProgram) &&
 					res.HasRenderTargetPool(Resources::rgbBlurRenderTargetPool);
@@ -129,6 +129,9 @@ namespace page
 
 				AttribGuard attribGuard;
 				MatrixGuard matrixGuard;
+
+				// interpolation between the last two simulation ticks
+				float tickInterpolation = 1;
 			};
 		}
 	}